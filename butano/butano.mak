@@ -39,6 +39,9 @@ CFLAGS      :=	$(CWARNINGS) -g -O3 -mcpu=arm7tdmi -mtune=arm7tdmi -ffast-math -f
 CFLAGS      +=	$(INCLUDE)
 CFLAGS      +=	$(USERFLAGS)
 
+# Extra flags set by butano-benchmark-tool.py, appended to the project ones:
+CFLAGS      +=	$(BENCHMARKFLAGS)
+
 CPPWARNINGS	:=	-Wuseless-cast -Wnon-virtual-dtor -Woverloaded-virtual
 CXXFLAGS    :=	$(CFLAGS) $(CPPWARNINGS) -std=c++20 -fno-rtti -fno-exceptions
 
@@ -90,7 +93,7 @@ SFILES          :=	$(foreach dir,	$(SOURCES),	$(notdir $(wildcard $(dir)/*.s)))
 						$(foreach dir,	$(BTNSOURCES),	$(notdir $(wildcard $(dir)/*.s)))
 						
 BINFILES        :=	$(foreach dir,	$(DATA),	$(notdir $(wildcard $(dir)/*.*))) \
-						_btn_audio_soundbank.bin
+						_btn_audio_soundbank.bin _btn_audio_streams.bin
 						
 GRAPHICSFILES	:=	$(foreach dir,	$(GRAPHICS),	$(notdir $(wildcard $(dir)/*.bmp)))
 
@@ -117,9 +120,10 @@ export OFILES_SOURCES   :=  $(CPPFILES:.cpp=.o) $(CFILES:.c=.o) $(SFILES:.s=.o)
 export OFILES           :=  $(OFILES_BIN) $(OFILES_GRAPHICS) $(OFILES_SOURCES)
 
 #---------------------------------------------------------------------------------------------------------------------
-# Don't generate header files from audio soundbank (avoid rebuilding all sources when audio files are updated):
+# Don't generate header files from audio data (avoid rebuilding all sources when audio files are updated):
 #---------------------------------------------------------------------------------------------------------------------
-export HFILES           :=  $(filter-out _btn_audio_soundbank_bin.h,$(addsuffix .h,$(subst .,_,$(BINFILES))))
+export HFILES           :=  $(filter-out _btn_audio_soundbank_bin.h _btn_audio_streams_bin.h,\
+                                $(addsuffix .h,$(subst .,_,$(BINFILES))))
 
 export INCLUDE          :=  $(foreach dir,$(INCLUDES),-iquote $(CURDIR)/$(dir)) \
                                 $(foreach dir,$(LIBDIRS),-I$(dir)/include) \
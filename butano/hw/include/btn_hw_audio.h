@@ -10,12 +10,16 @@
 
 namespace btn::hw::audio
 {
-    void init();
+    using frame_mixer_type = void(*)(int samples_count, int8_t* left_samples, int8_t* right_samples);
+
+    void init(frame_mixer_type frame_mixer);
 
     void enable();
 
     void disable();
 
+    [[nodiscard]] int mixing_rate();
+
     [[nodiscard]] bool music_playing();
 
     void play_music(int id, int volume, bool loop);
@@ -32,6 +32,11 @@ namespace btn::hw::bg_blocks
         return bg_maps::cells_count() / bg_maps::blocks_count();
     }
 
+    [[nodiscard]] constexpr int big_map_hw_size()
+    {
+        return 32;
+    }
+
     namespace
     {
         [[nodiscard]] inline uint16_t* bg_block_vram(int block_index)
@@ -45,6 +50,13 @@ namespace btn::hw::bg_blocks
         return bg_block_vram(block_index);
     }
 
+    inline void copy_blocks(int source_block_index, int blocks_count, int destination_block_index)
+    {
+        uint16_t* source_vram_ptr = bg_block_vram(source_block_index);
+        uint16_t* destination_vram_ptr = bg_block_vram(destination_block_index);
+        memory::copy(*source_vram_ptr, blocks_count * half_words_per_block(), *destination_vram_ptr);
+    }
+
     inline void commit_tiles(const uint16_t* source_data_ptr, int block_index, int half_words)
     {
         uint16_t* destination_vram_ptr = bg_block_vram(block_index);
@@ -60,6 +72,17 @@ namespace btn::hw::bg_blocks
     BTN_CODE_IWRAM void _commit_map_offset(const uint16_t* source_data_ptr, int half_words, int tiles_offset,
                                            int palette_offset, uint16_t* destination_vram_ptr);
 
+    BTN_CODE_IWRAM void _commit_affine_map_tiles_offset(const uint16_t* source_data_ptr, int half_words,
+                                                        int tiles_offset, uint16_t* destination_vram_ptr);
+
+    // Big maps are streamed to a big_map_hw_size() x big_map_hw_size() hardware map used as a ring buffer:
+    // the map cell (x, y) is stored in the hardware cell (x % big_map_hw_size(), y % big_map_hw_size()).
+    BTN_CODE_IWRAM void commit_big_map_row(const uint16_t* source_data_ptr, int map_width, int map_height, int x,
+                                           int y, int tiles_offset, int palette_offset, int block_index);
+
+    BTN_CODE_IWRAM void commit_big_map_column(const uint16_t* source_data_ptr, int map_width, int map_height, int x,
+                                              int y, int tiles_offset, int palette_offset, int block_index);
+
     inline void commit_map(const uint16_t* source_data_ptr, int block_index, int half_words, int tiles_offset,
                            int palette_offset)
     {
@@ -88,6 +111,52 @@ namespace btn::hw::bg_blocks
             }
         }
     }
+
+    // Adds the given offsets to map cells already stored in VRAM:
+    inline void offset_map(int block_index, int half_words, int tiles_offset, int palette_offset)
+    {
+        uint16_t* vram_ptr = bg_block_vram(block_index);
+
+        if(tiles_offset)
+        {
+            if(palette_offset)
+            {
+                _commit_map_offset(vram_ptr, half_words, tiles_offset, palette_offset, vram_ptr);
+            }
+            else
+            {
+                _commit_map_tiles_offset(vram_ptr, half_words, tiles_offset, vram_ptr);
+            }
+        }
+        else if(palette_offset)
+        {
+            _commit_map_palette_offset(vram_ptr, half_words, palette_offset, vram_ptr);
+        }
+    }
+
+    // Affine map cells are one byte each, so each half word contains two map cells:
+    inline void commit_affine_map(const uint16_t* source_data_ptr, int block_index, int half_words, int tiles_offset)
+    {
+        uint16_t* destination_vram_ptr = bg_block_vram(block_index);
+
+        if(tiles_offset)
+        {
+            _commit_affine_map_tiles_offset(source_data_ptr, half_words, tiles_offset, destination_vram_ptr);
+        }
+        else
+        {
+            memory::copy(*source_data_ptr, half_words, *destination_vram_ptr);
+        }
+    }
+
+    inline void offset_affine_map(int block_index, int half_words, int tiles_offset)
+    {
+        if(tiles_offset)
+        {
+            uint16_t* vram_ptr = bg_block_vram(block_index);
+            _commit_affine_map_tiles_offset(vram_ptr, half_words, tiles_offset, vram_ptr);
+        }
+    }
 }
 
 #endif
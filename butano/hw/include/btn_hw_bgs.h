@@ -8,6 +8,7 @@
 
 #include "btn_size.h"
 #include "btn_memory.h"
+#include "btn_affine_bg_builder.h"
 #include "btn_regular_bg_builder.h"
 #include "btn_hw_tonc.h"
 
@@ -20,6 +21,12 @@ namespace btn::hw::bgs
         uint16_t cnt;
         uint16_t hofs;
         uint16_t vofs;
+        int16_t pa = 256;
+        int16_t pb = 0;
+        int16_t pc = 0;
+        int16_t pd = 256;
+        int dx = 0;
+        int dy = 0;
     };
 
     [[nodiscard]] constexpr int count()
@@ -32,6 +39,12 @@ namespace btn::hw::bgs
         bg.cnt = uint16_t(BG_PRIO(builder.priority()) | (builder.mosaic_enabled() << 6));
     }
 
+    inline void setup_affine(const affine_bg_builder& builder, handle& bg)
+    {
+        bg.cnt = uint16_t(BG_PRIO(builder.priority()) | (builder.mosaic_enabled() << 6) | BG_8BPP |
+                          (builder.wrapping_enabled() ? BG_WRAP : 0));
+    }
+
     inline void set_tiles_cbb(int tiles_cbb, uint16_t& bg_cnt)
     {
         BFN_SET(bg_cnt, tiles_cbb, BG_CBB);
@@ -58,6 +71,33 @@ namespace btn::hw::bgs
         BFN_SET(bg.cnt, size, BG_SIZE);
     }
 
+    inline void set_affine_map_dimensions(const size& map_dimensions, handle& bg)
+    {
+        int size;
+
+        switch(map_dimensions.width())
+        {
+
+        case 16:
+            size = 0;
+            break;
+
+        case 32:
+            size = 1;
+            break;
+
+        case 64:
+            size = 2;
+            break;
+
+        default:
+            size = 3;
+            break;
+        }
+
+        BFN_SET(bg.cnt, size, BG_SIZE);
+    }
+
     [[nodiscard]] inline palette_bpp_mode bpp_mode(const handle& bg)
     {
         return (bg.cnt & BG_8BPP) ? palette_bpp_mode::BPP_8 : palette_bpp_mode::BPP_4;
@@ -90,6 +130,20 @@ namespace btn::hw::bgs
         bg.vofs = uint16_t(y);
     }
 
+    inline void set_affine_mat(int pa, int pb, int pc, int pd, handle& bg)
+    {
+        bg.pa = int16_t(pa);
+        bg.pb = int16_t(pb);
+        bg.pc = int16_t(pc);
+        bg.pd = int16_t(pd);
+    }
+
+    inline void set_affine_reference_point(int dx, int dy, handle& bg)
+    {
+        bg.dx = dx;
+        bg.dy = dy;
+    }
+
     inline void set_priority(int priority, uint16_t& bg_cnt)
     {
         BFN_SET(bg_cnt, priority, BG_PRIO);
@@ -122,6 +176,23 @@ namespace btn::hw::bgs
         set_mosaic_enabled(mosaic_enabled, bg.cnt);
     }
 
+    [[nodiscard]] inline bool wrapping_enabled(const handle& bg)
+    {
+        return bg.cnt & BG_WRAP;
+    }
+
+    inline void set_wrapping_enabled(bool wrapping_enabled, handle& bg)
+    {
+        if(wrapping_enabled)
+        {
+            bg.cnt |= BG_WRAP;
+        }
+        else
+        {
+            bg.cnt &= ~BG_WRAP;
+        }
+    }
+
     inline void commit(const handle* bgs_ptr)
     {
         const handle& bg0 = bgs_ptr[0];
@@ -143,6 +214,23 @@ namespace btn::hw::bgs
         REG_BG3CNT = bg3.cnt;
         REG_BG3HOFS = bg3.hofs;
         REG_BG3VOFS = bg3.vofs;
+
+        // Affine registers are ignored by the GBA if the backgrounds are not affine:
+        BG_AFFINE& bg2_affine = REG_BG_AFFINE[2];
+        bg2_affine.pa = bg2.pa;
+        bg2_affine.pb = bg2.pb;
+        bg2_affine.pc = bg2.pc;
+        bg2_affine.pd = bg2.pd;
+        bg2_affine.dx = bg2.dx;
+        bg2_affine.dy = bg2.dy;
+
+        BG_AFFINE& bg3_affine = REG_BG_AFFINE[3];
+        bg3_affine.pa = bg3.pa;
+        bg3_affine.pb = bg3.pb;
+        bg3_affine.pc = bg3.pc;
+        bg3_affine.pd = bg3.pd;
+        bg3_affine.dx = bg3.dx;
+        bg3_affine.dy = bg3.dy;
     }
 
     [[nodiscard]] inline uint16_t* regular_horizontal_position_register(int id)
@@ -155,6 +243,36 @@ namespace btn::hw::bgs
         return reinterpret_cast<uint16_t*>(REG_BASE + 0x0012 + (0x0004 * id));
     }
 
+    [[nodiscard]] inline uint16_t* affine_pa_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x0020 + (0x0010 * (id - 2)));
+    }
+
+    [[nodiscard]] inline uint16_t* affine_pb_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x0022 + (0x0010 * (id - 2)));
+    }
+
+    [[nodiscard]] inline uint16_t* affine_pc_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x0024 + (0x0010 * (id - 2)));
+    }
+
+    [[nodiscard]] inline uint16_t* affine_pd_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x0026 + (0x0010 * (id - 2)));
+    }
+
+    [[nodiscard]] inline uint16_t* affine_dx_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x0028 + (0x0010 * (id - 2)));
+    }
+
+    [[nodiscard]] inline uint16_t* affine_dy_register(int id)
+    {
+        return reinterpret_cast<uint16_t*>(REG_BASE + 0x002C + (0x0010 * (id - 2)));
+    }
+
     [[nodiscard]] inline uint16_t* attributes_register(int id)
     {
         return reinterpret_cast<uint16_t*>(REG_BASE + 0x0008 + (0x0002 * id));
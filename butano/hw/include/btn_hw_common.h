@@ -6,20 +6,27 @@
 #ifndef BTN_HW_COMMON_H
 #define BTN_HW_COMMON_H
 
-/**
- * @brief Store data in EWRAM.
- */
-#define BTN_DATA_EWRAM __attribute__((section(".ewram")))
+#if defined(__arm__) || BTN_DOXYGEN
+    /**
+     * @brief Store data in EWRAM.
+     */
+    #define BTN_DATA_EWRAM __attribute__((section(".ewram")))
 
-/**
- * @brief Store ARM code in IWRAM.
- */
-#define BTN_CODE_IWRAM __attribute__((section(".iwram"), target("arm")))
+    /**
+     * @brief Store ARM code in IWRAM.
+     */
+    #define BTN_CODE_IWRAM __attribute__((section(".iwram"), target("arm")))
 
-/**
- * @brief Store Thumb code in EWRAM.
- */
-#define BTN_CODE_EWRAM __attribute__((section(".ewram")))
+    /**
+     * @brief Store Thumb code in EWRAM.
+     */
+    #define BTN_CODE_EWRAM __attribute__((section(".ewram")))
+#else
+    // Host builds (tests and benchmarks) don't have IWRAM nor EWRAM:
+    #define BTN_DATA_EWRAM
+    #define BTN_CODE_IWRAM
+    #define BTN_CODE_EWRAM
+#endif
 
 /**
  * @brief Creates a compiler level memory barrier forcing optimizer to not re-order memory accesses across the barrier.
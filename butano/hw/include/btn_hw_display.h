@@ -46,6 +46,11 @@ namespace btn::hw::display
         REG_DISPCNT_U16 = DCNT_MODE0 | DCNT_OBJ | DCNT_OBJ_1D;
     }
 
+    inline void set_mode(int mode)
+    {
+        BFN_SET(REG_DISPCNT_U16, mode, DCNT_MODE);
+    }
+
     inline void set_bg_enabled(int bg, bool enabled)
     {
         if(enabled)
@@ -200,6 +205,23 @@ namespace btn::hw::display
         return &REG_DISPCNT_U16_2;
     }
 
+    [[nodiscard]] inline int vcount()
+    {
+        return REG_VCOUNT;
+    }
+
+    inline void set_sprites_hblank_interval_free(bool free)
+    {
+        if(free)
+        {
+            REG_DISPCNT_U16 |= DCNT_OAM_HBL;
+        }
+        else
+        {
+            REG_DISPCNT_U16 &= unsigned(~DCNT_OAM_HBL);
+        }
+    }
+
     inline void sleep()
     {
         REG_DISPCNT_U16 |= DCNT_BLANK;
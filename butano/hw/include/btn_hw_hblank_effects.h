@@ -8,6 +8,7 @@
 
 #include "btn_config_hblank_effects.h"
 #include "btn_hw_irq.h"
+#include "btn_hw_hdma.h"
 
 namespace btn::hw::hblank_effects
 {
@@ -21,6 +22,12 @@ namespace btn::hw::hblank_effects
 
     BTN_CODE_IWRAM void commit_entries_ptr(entry* entries_ptr);
 
+    BTN_CODE_IWRAM void commit_hdma_entries(entry* entries_ptr, int entries_count);
+
+    [[nodiscard]] bool hdma_enabled();
+
+    BTN_CODE_IWRAM void _hdma_intr();
+
     BTN_CODE_IWRAM void _intr_0();
 
     BTN_CODE_IWRAM void _intr_1();
@@ -57,6 +64,11 @@ namespace btn::hw::hblank_effects
     {
         irq::replace_or_push_back(irq::id::HBLANK, _intr_0);
         irq::disable(irq::id::HBLANK);
+
+        // HDMA channels are restarted in the last VBlank scanline:
+        REG_DISPSTAT = (REG_DISPSTAT & ~DSTAT_VCT_MASK) | DSTAT_VCT(227);
+        irq::replace_or_push_back(irq::id::VCOUNT, _hdma_intr);
+        irq::disable(irq::id::VCOUNT);
     }
 
     inline void enable()
@@ -69,6 +81,21 @@ namespace btn::hw::hblank_effects
         irq::disable(irq::id::HBLANK);
     }
 
+    inline void enable_hdma()
+    {
+        irq::enable(irq::id::VCOUNT);
+    }
+
+    inline void disable_hdma()
+    {
+        irq::disable(irq::id::VCOUNT);
+
+        for(int channel = 0; channel < hdma::max_channels; ++channel)
+        {
+            hdma::stop(channel);
+        }
+    }
+
     inline void commit_entries_count(int entries_count)
     {
         switch(entries_count)
@@ -11,19 +11,22 @@
 namespace btn::hw::hdma
 {
 
-namespace
+// DMA1 and DMA2 are used by the audio mixer (direct sound FIFOs), so only DMA0 and DMA3 can be used for HDMA:
+constexpr const int max_channels = 2;
+
+[[nodiscard]] constexpr int hw_channel(int channel)
 {
-    constexpr const int channel = 3;
+    return channel == 0 ? 0 : 3;
 }
 
-inline void start(const uint16_t* source_ptr, int half_words, uint16_t* destination_ptr)
+inline void start(int channel, const uint16_t* source_ptr, int half_words, volatile uint16_t* destination_ptr)
 {
-    DMA_TRANSFER(destination_ptr, source_ptr, half_words, channel, DMA_HDMA);
+    DMA_TRANSFER(destination_ptr, source_ptr, half_words, hw_channel(channel), DMA_HDMA);
 }
 
-inline void stop()
+inline void stop(int channel)
 {
-    REG_DMA[channel].cnt = 0;
+    REG_DMA[hw_channel(channel)].cnt = 0;
 }
 
 }
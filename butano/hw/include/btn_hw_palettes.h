@@ -38,48 +38,6 @@ namespace btn::hw::palettes
         }
     }
 
-    inline void brightness(int value, int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-        clr_adj_brightness(tonc_colors_ptr, tonc_colors_ptr, unsigned(count), value);
-    }
-
-    inline void contrast(int value, int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-        clr_adj_contrast(tonc_colors_ptr, tonc_colors_ptr, unsigned(count), value);
-    }
-
-    inline void intensity(int value, int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-        clr_adj_intensity(tonc_colors_ptr, tonc_colors_ptr, unsigned(count), value);
-    }
-
-    inline void invert(int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-
-        for(int index = 0; index < count; ++index)
-        {
-            tonc_colors_ptr[index] = 32767 ^ tonc_colors_ptr[index];
-        }
-    }
-
-    inline void grayscale(int intensity, int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-        COLOR temp_colors[colors()];
-        clr_grayscale(temp_colors, tonc_colors_ptr, unsigned(count));
-        clr_blend_fast(tonc_colors_ptr, temp_colors, tonc_colors_ptr, unsigned(count), unsigned(intensity));
-    }
-
-    inline void fade(color fade_color, int intensity, int count, color* colors_ptr)
-    {
-        auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
-        clr_fade_fast(tonc_colors_ptr, uint16_t(fade_color.data()), tonc_colors_ptr, unsigned(count), unsigned(intensity));
-    }
-
     inline void rotate(int rotate_count, int colors_count, color* colors_ptr)
     {
         auto tonc_colors_ptr = reinterpret_cast<COLOR*>(colors_ptr);
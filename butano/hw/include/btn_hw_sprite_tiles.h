@@ -43,6 +43,9 @@ namespace btn::hw::sprite_tiles
         memory::copy(*source_tiles_ptr, count, *tile_vram(index));
     }
 
+    BTN_CODE_IWRAM void commit(const tile* source_tiles_ptr, const uint16_t* tile_indexes,
+                               const uint16_t* committed_tile_indexes, int index, int count);
+
     BTN_CODE_IWRAM void plot_tiles(int width, const tile* source_tiles_ptr, int source_height, int source_y,
                                    int destination_y, tile* destination_tiles_ptr);
 }
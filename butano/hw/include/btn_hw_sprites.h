@@ -159,6 +159,11 @@ namespace btn::hw::sprites
         BFN_SET(sprite.attr1, int(shape_size.size()), ATTR1_SIZE);
     }
 
+    [[nodiscard]] inline int tiles_id(const handle_type& sprite)
+    {
+        return BFN_GET(sprite.attr2, ATTR2_ID);
+    }
+
     inline void set_tiles(int tiles_id, handle_type& sprite)
     {
         BFN_SET(sprite.attr2, tiles_id, ATTR2_ID);
@@ -298,7 +303,7 @@ namespace btn::hw::sprites
 
     inline void commit(const handle_type& sprites_ref, int offset, int count)
     {
-        memory::copy((&sprites_ref)[offset], count, vram()[offset]);
+        btn::memory::copy((&sprites_ref)[offset], count, vram()[offset]);
     }
 
     [[nodiscard]] inline uint16_t* first_attributes_register(int id)
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_HW_SPRITES_MULTIPLEXER_H
+#define BTN_HW_SPRITES_MULTIPLEXER_H
+
+#include "btn_hw_sprites.h"
+
+namespace btn::hw::sprites_multiplexer
+{
+    // Hardware sprites rewritten before a scanline is displayed.
+    // They are rewritten in one H-Blank, so there shouldn't be more than a dozen of them.
+    // The fill member of each entry contains the index of the hardware sprite to rewrite:
+    class band
+    {
+
+    public:
+        const sprites::handle_type* entries_ptr;
+        int entries_count;
+        int scanline;
+    };
+
+    [[nodiscard]] constexpr int rewrite_scanlines()
+    {
+        // Hardware sprites are processed one scanline before they are displayed,
+        // so they are rewritten in the H-Blank of the scanline before that one:
+        return 2;
+    }
+
+    void commit(const band* bands_ptr, int bands_count);
+
+    void stop();
+
+    BTN_CODE_IWRAM void _intr();
+}
+
+#endif
@@ -12,6 +12,9 @@
 
 extern const uint8_t _btn_audio_soundbank_bin[];
 
+// Maxmod wave buffer write position, reset to the start of the wave buffer by mmVBlank when the DMA is restarted:
+extern "C" int8_t* mp_writepos;
+
 namespace btn::hw::audio
 {
 
@@ -35,6 +38,7 @@ namespace
 
     public:
         forward_list<sound_type, BTN_CFG_AUDIO_MAX_SOUND_CHANNELS> sounds_queue;
+        frame_mixer_type frame_mixer = nullptr;
         uint16_t stat_value = 0;
         uint16_t direct_sound_control_value = 0;
         volatile bool locked = false;
@@ -77,14 +81,68 @@ namespace
         }
     }
 
+    constexpr int _mixing_rate()
+    {
+        switch(BTN_CFG_AUDIO_MIXING_RATE)
+        {
+
+        case BTN_AUDIO_MIXING_RATE_8_KHZ:
+            return 8121;
+
+        case BTN_AUDIO_MIXING_RATE_10_KHZ:
+            return 10512;
+
+        case BTN_AUDIO_MIXING_RATE_13_KHZ:
+            return 13379;
+
+        case BTN_AUDIO_MIXING_RATE_16_KHZ:
+            return 15768;
+
+        case BTN_AUDIO_MIXING_RATE_18_KHZ:
+            return 18157;
+
+        case BTN_AUDIO_MIXING_RATE_21_KHZ:
+            return 21024;
+
+        case BTN_AUDIO_MIXING_RATE_27_KHZ:
+            return 26758;
+
+        case BTN_AUDIO_MIXING_RATE_31_KHZ:
+            return 31536;
+
+        default:
+            BTN_ERROR("Invalid maxing rate: ", BTN_CFG_AUDIO_MIXING_RATE);
+        }
+    }
+
     constexpr const int _max_channels = BTN_CFG_AUDIO_MAX_MUSIC_CHANNELS + BTN_CFG_AUDIO_MAX_SOUND_CHANNELS;
 
-    alignas(int) BTN_DATA_EWRAM uint8_t maxmod_engine_buffer[
-            _max_channels * (MM_SIZEOF_MODCH + MM_SIZEOF_ACTCH + MM_SIZEOF_MIXCH) + _mix_length()];
+    constexpr const int _wave_buffer_offset = _max_channels * (MM_SIZEOF_MODCH + MM_SIZEOF_ACTCH + MM_SIZEOF_MIXCH);
+
+    alignas(int) BTN_DATA_EWRAM uint8_t maxmod_engine_buffer[_wave_buffer_offset + _mix_length()];
 
     alignas(int) uint8_t maxmod_mixing_buffer[_mix_length()];
 
 
+    void _frame()
+    {
+        mmFrame();
+
+        // Maxmod mixes each frame in one half of its wave double buffer, and left samples of both halves are stored
+        // before the right ones. mmVBlank can run without a matching mmFrame call in lag frames,
+        // so the mixed half is retrieved from the maxmod write position instead of being tracked here:
+        if(frame_mixer_type frame_mixer = data.frame_mixer)
+        {
+            constexpr const int samples_count = _mix_length() / 4;
+            auto wave_buffer = reinterpret_cast<int8_t*>(maxmod_engine_buffer + _wave_buffer_offset);
+            int8_t* left_samples = mp_writepos - samples_count;
+            BTN_ASSERT(left_samples == wave_buffer || left_samples == wave_buffer + samples_count,
+                       "Invalid maxmod write position: ", int(left_samples - wave_buffer));
+
+            frame_mixer(samples_count, left_samples, left_samples + (samples_count * 2));
+        }
+    }
+
     void _check_sounds_queue()
     {
         if(data.sounds_queue.full())
@@ -119,8 +177,9 @@ namespace
     }
 }
 
-void init()
+void init(frame_mixer_type frame_mixer)
 {
+    data.frame_mixer = frame_mixer;
     irq::replace_or_push_back(irq::id::VBLANK, mmVBlank);
 
     mm_gba_system maxmod_info;
@@ -132,8 +191,7 @@ void init()
     maxmod_info.mixing_channels = mm_addr(maxmod_engine_buffer +
             (_max_channels * (MM_SIZEOF_MODCH + MM_SIZEOF_ACTCH)));
     maxmod_info.mixing_memory = mm_addr(maxmod_mixing_buffer);
-    maxmod_info.wave_memory = mm_addr(maxmod_engine_buffer +
-            (_max_channels * (MM_SIZEOF_MODCH + MM_SIZEOF_ACTCH + MM_SIZEOF_MIXCH)));
+    maxmod_info.wave_memory = mm_addr(maxmod_engine_buffer + _wave_buffer_offset);
     maxmod_info.soundbank = mm_addr(_btn_audio_soundbank_bin);
     mmInit(&maxmod_info);
 }
@@ -154,6 +212,11 @@ void disable()
     REG_SNDSTAT = 0;
 }
 
+int mixing_rate()
+{
+    return _mixing_rate();
+}
+
 bool music_playing()
 {
     return mmActive();
@@ -231,7 +294,7 @@ void disable_vblank_handler()
 
 void commit()
 {
-    mmFrame();
+    _frame();
 
     auto before_it = data.sounds_queue.before_begin();
     auto it = data.sounds_queue.begin();
@@ -255,7 +318,7 @@ void commit()
 
 void enable_vblank_handler()
 {
-    mmSetVBlankHandler(reinterpret_cast<void*>(mmFrame));
+    mmSetVBlankHandler(reinterpret_cast<void*>(_frame));
 }
 
 }
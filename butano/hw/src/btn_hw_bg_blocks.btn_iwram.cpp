@@ -8,6 +8,15 @@
 namespace btn::hw::bg_blocks
 {
 
+namespace
+{
+    [[nodiscard]] int _wrap(int value, int size)
+    {
+        int result = value % size;
+        return result < 0 ? result + size : result;
+    }
+}
+
 void _commit_map_tiles_offset(const uint16_t* source_data_ptr, int half_words, int tiles_offset,
                               uint16_t* destination_vram_ptr)
 {
@@ -46,4 +55,67 @@ void _commit_map_offset(const uint16_t* source_data_ptr, int half_words, int til
     }
 }
 
+void _commit_affine_map_tiles_offset(const uint16_t* source_data_ptr, int half_words, int tiles_offset,
+                                     uint16_t* destination_vram_ptr)
+{
+    // Tiles offset is added to the four map cells of each word at once (map cells can't overflow):
+    auto source_words_ptr = reinterpret_cast<const unsigned*>(source_data_ptr);
+    auto destination_words_ptr = reinterpret_cast<unsigned*>(destination_vram_ptr);
+    unsigned words_offset = unsigned(tiles_offset) * 0x01010101;
+
+    for(int index = 0, words = half_words / 2; index < words; ++index)
+    {
+        destination_words_ptr[index] = source_words_ptr[index] + words_offset;
+    }
+}
+
+void commit_big_map_row(const uint16_t* source_data_ptr, int map_width, int map_height, int x, int y,
+                        int tiles_offset, int palette_offset, int block_index)
+{
+    constexpr const int hw_size = big_map_hw_size();
+
+    int cells_offset = tiles_offset + (palette_offset << SE_PALBANK_SHIFT);
+    const uint16_t* source_row_ptr = source_data_ptr + (_wrap(y, map_height) * map_width);
+    uint16_t* destination_row_ptr = bg_block_vram(block_index) + ((y & (hw_size - 1)) * hw_size);
+    int source_x = _wrap(x, map_width);
+    int destination_x = x & (hw_size - 1);
+
+    for(int index = 0; index < hw_size; ++index)
+    {
+        destination_row_ptr[destination_x] = uint16_t(source_row_ptr[source_x] + cells_offset);
+        destination_x = (destination_x + 1) & (hw_size - 1);
+        ++source_x;
+
+        if(source_x == map_width)
+        {
+            source_x = 0;
+        }
+    }
+}
+
+void commit_big_map_column(const uint16_t* source_data_ptr, int map_width, int map_height, int x, int y,
+                           int tiles_offset, int palette_offset, int block_index)
+{
+    constexpr const int hw_size = big_map_hw_size();
+
+    int cells_offset = tiles_offset + (palette_offset << SE_PALBANK_SHIFT);
+    const uint16_t* source_column_ptr = source_data_ptr + _wrap(x, map_width);
+    uint16_t* destination_column_ptr = bg_block_vram(block_index) + (x & (hw_size - 1));
+    int source_y = _wrap(y, map_height);
+    int destination_y = y & (hw_size - 1);
+
+    for(int index = 0; index < hw_size; ++index)
+    {
+        destination_column_ptr[destination_y * hw_size] = uint16_t(source_column_ptr[source_y * map_width] +
+                                                                    cells_offset);
+        destination_y = (destination_y + 1) & (hw_size - 1);
+        ++source_y;
+
+        if(source_y == map_height)
+        {
+            source_y = 0;
+        }
+    }
+}
+
 }
@@ -15,6 +15,8 @@ namespace
 
     public:
         entry* entries_ptr = nullptr;
+        entry* hdma_entries_ptr = nullptr;
+        int hdma_entries_count = 0;
     };
 
     static_data data;
@@ -25,6 +27,38 @@ void commit_entries_ptr(entry* entries_ptr)
     data.entries_ptr = entries_ptr;
 }
 
+void commit_hdma_entries(entry* entries_ptr, int entries_count)
+{
+    for(int index = entries_count; index < data.hdma_entries_count; ++index)
+    {
+        hdma::stop(index);
+    }
+
+    data.hdma_entries_ptr = entries_ptr;
+    data.hdma_entries_count = entries_count;
+}
+
+bool hdma_enabled()
+{
+    return data.hdma_entries_count;
+}
+
+void _hdma_intr()
+{
+    // HDMA is not triggered in VBlank, so the first scanline value is written here
+    // and each channel copies the next scanline value in the current scanline HBlank
+    // (the last copy of each frame is done before VBlank, so its value is never displayed):
+    entry* entries_ptr = data.hdma_entries_ptr;
+
+    for(int index = 0, count = data.hdma_entries_count; index < count; ++index)
+    {
+        const entry& hdma_entry = entries_ptr[index];
+        hdma::stop(index);
+        *hdma_entry.dest = hdma_entry.src[0];
+        hdma::start(index, hdma_entry.src + 1, 1, hdma_entry.dest);
+    }
+}
+
 void _intr_0()
 {
 }
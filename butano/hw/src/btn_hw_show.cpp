@@ -123,25 +123,54 @@ namespace
         else
         {
             // Collect entries:
+            enum mode_type
+            {
+                TOTAL_MODE,
+                MAX_MODE,
+                P50_MODE,
+                P95_MODE,
+                P99_MODE,
+                SPIKES_MODE,
+                MODES_COUNT
+            };
+
+            constexpr const char* mode_titles[] = {
+                "PROFILER results - TOTAL ticks",
+                "PROFILER results - MAX ticks",
+                "PROFILER results - P50 frame ticks",
+                "PROFILER results - P95 frame ticks",
+                "PROFILER results - P99 frame ticks",
+                "PROFILER results - SPIKE frames",
+            };
+
             struct entry
             {
                 string_view id;
-                int64_t total_ticks;
-                int max_ticks;
+                int64_t values[MODES_COUNT];
             };
 
             vector<entry, BTN_CFG_PROFILER_MAX_ENTRIES * 2> entries;
-            int64_t total_ticks = 0;
-            int64_t max_ticks = 0;
-            bool show_total = true;
+            int64_t global_values[MODES_COUNT] = {};
+            int mode = TOTAL_MODE;
             bool rebuild = true;
 
             for(const auto& ticks_per_entry_pair : ticks_per_entry)
             {
                 auto& ticks_entry = ticks_per_entry_pair.second;
-                entries.push_back({ ticks_per_entry_pair.first, ticks_entry.total, ticks_entry.max });
-                total_ticks += ticks_entry.total;
-                max_ticks = btn::max(max_ticks, int64_t(ticks_entry.max));
+                _btn::profiler::frame_stats stats = _btn::profiler::stats(ticks_entry);
+                entries.push_back({ ticks_per_entry_pair.first, { ticks_entry.total, ticks_entry.max, stats.p50,
+                                    stats.p95, stats.p99, stats.spikes } });
+
+                // Nested entries are not added to the total to avoid counting them twice:
+                if(! ticks_entry.parent_id)
+                {
+                    global_values[TOTAL_MODE] += ticks_entry.total;
+                }
+
+                for(int max_mode = MAX_MODE; max_mode < SPIKES_MODE; ++max_mode)
+                {
+                    global_values[max_mode] = btn::max(global_values[max_mode], entries.back().values[max_mode]);
+                }
             }
 
             // Retrieve max width for indexes, labels and ticks:
@@ -169,18 +198,9 @@ namespace
                     current_index = 0;
 
                     // Sort entries by ticks (higher to lower):
-                    if(show_total)
-                    {
-                        sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
-                            return a.total_ticks > b.total_ticks;
-                        });
-                    }
-                    else
-                    {
-                        sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
-                            return a.max_ticks > b.max_ticks;
-                        });
-                    }
+                    sort(entries.begin(), entries.end(), [mode](const entry& a, const entry& b) {
+                        return a.values[mode] > b.values[mode];
+                    });
 
                     // Calculate columns width:
                     for(int index = 0; index < num_entries; ++index)
@@ -195,7 +215,7 @@ namespace
                         max_id_width = max(max_id_width, int(tte_get_text_size(buffer_stream.str().c_str()).x));
 
                         buffer.clear();
-                        buffer_stream << (show_total ? entry.total_ticks : entry.max_ticks);
+                        buffer_stream << entry.values[mode];
                         max_ticks_width = max(max_ticks_width, int(tte_get_text_size(buffer_stream.str().c_str()).x));
                     }
 
@@ -203,20 +223,10 @@ namespace
                 }
 
                 // Print title:
-                int64_t global_var;
+                int64_t global_var = global_values[mode];
                 tte_set_pos(init_x, init_y);
                 tte_set_ink(colors::green.data());
-
-                if(show_total)
-                {
-                    tte_write("PROFILER results - TOTAL ticks");
-                    global_var = total_ticks;
-                }
-                else
-                {
-                    tte_write("PROFILER results - MAX ticks");
-                    global_var = max_ticks;
-                }
+                tte_write(mode_titles[mode]);
 
                 if(num_entries > max_visible_entries)
                 {
@@ -253,7 +263,7 @@ namespace
                     tte_set_pos(x + max_id_width + margin, y);
                     tte_get_pos(&x, &y);
 
-                    int64_t entry_var = show_total ? entry.total_ticks : entry.max_ticks;
+                    int64_t entry_var = entry.values[mode];
                     buffer.clear();
                     buffer_stream << entry_var;
                     tte_set_ink(colors::yellow.data());
@@ -279,7 +289,7 @@ namespace
 
                     if(keypad::a_pressed())
                     {
-                        show_total = ! show_total;
+                        mode = (mode + 1) % MODES_COUNT;
                         rebuild = true;
                         tte_erase_screen();
                         break;
@@ -11,6 +11,66 @@
 namespace btn::hw::sprite_tiles
 {
 
+namespace
+{
+    [[nodiscard]] unsigned _flip_row(unsigned row)
+    {
+        // Swaps the nibbles of each byte, and then the bytes:
+        row = ((row >> 4) & 0x0F0F0F0F) | ((row & 0x0F0F0F0F) << 4);
+        return __builtin_bswap32(row);
+    }
+}
+
+void commit(const tile* source_tiles_ptr, const uint16_t* tile_indexes, const uint16_t* committed_tile_indexes,
+            int index, int count)
+{
+    // Tile index format (see sprite_tiles_item): bits 0-13 unique tile index, bit 14 h flip, bit 15 v flip.
+
+    tile* destination_tiles_ptr = tile_vram(index);
+
+    for(int tile_index = 0; tile_index < count; ++tile_index)
+    {
+        unsigned tile_index_data = tile_indexes[tile_index];
+
+        if(committed_tile_indexes && committed_tile_indexes[tile_index] == tile_index_data)
+        {
+            continue;
+        }
+
+        const tile& source_tile = source_tiles_ptr[tile_index_data & 0x3FFF];
+        tile& destination_tile = destination_tiles_ptr[tile_index];
+
+        switch(tile_index_data >> 14)
+        {
+
+        case 0:
+            destination_tile = source_tile;
+            break;
+
+        case 1:
+            for(int row = 0; row < 8; ++row)
+            {
+                destination_tile.data[row] = _flip_row(source_tile.data[row]);
+            }
+            break;
+
+        case 2:
+            for(int row = 0; row < 8; ++row)
+            {
+                destination_tile.data[row] = source_tile.data[7 - row];
+            }
+            break;
+
+        default:
+            for(int row = 0; row < 8; ++row)
+            {
+                destination_tile.data[row] = _flip_row(source_tile.data[7 - row]);
+            }
+            break;
+        }
+    }
+}
+
 void plot_tiles(int width, const tile* source_tiles_ptr, int source_height, int source_y, int destination_y,
                 tile* destination_tiles_ptr)
 {
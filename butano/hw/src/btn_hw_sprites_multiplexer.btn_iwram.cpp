@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/btn_hw_sprites_multiplexer.h"
+
+#include "../include/btn_hw_irq.h"
+#include "../include/btn_hw_display.h"
+#include "../include/btn_hw_hblank_effects.h"
+
+namespace btn::hw::sprites_multiplexer
+{
+
+namespace
+{
+    constexpr const int hdma_restart_scanline = 227;
+
+    class static_data
+    {
+
+    public:
+        const band* bands_ptr = nullptr;
+        int bands_count = 0;
+        int band_index = 0;
+        bool active = false;
+    };
+
+    static_data data;
+
+    void _set_vcount_scanline(int scanline)
+    {
+        REG_DISPSTAT = uint16_t((REG_DISPSTAT & ~DSTAT_VCT_MASK) | DSTAT_VCT(scanline));
+    }
+}
+
+void commit(const band* bands_ptr, int bands_count)
+{
+    BTN_ASSERT(bands_count > 0, "Invalid bands count: ", bands_count);
+
+    data.bands_ptr = bands_ptr;
+    data.bands_count = bands_count;
+    data.band_index = 0;
+
+    if(! data.active)
+    {
+        data.active = true;
+
+        // OAM can't be written in H-Blank unless the H-Blank interval is free for it:
+        display::set_sprites_hblank_interval_free(true);
+
+        // The VCOUNT interrupt is shared with the H-Blank effects HDMA restart:
+        irq::replace_or_push_back(irq::id::VCOUNT, _intr);
+    }
+
+    // The VCOUNT target is left in the last VBlank scanline, so H-Blank effects HDMA channels are restarted
+    // before the first band is rewritten.
+    // H-Blank effects can disable the VCOUNT interrupt, so it is enabled every frame:
+    irq::enable(irq::id::VCOUNT);
+}
+
+void stop()
+{
+    if(data.active)
+    {
+        data.active = false;
+        display::set_sprites_hblank_interval_free(false);
+        irq::replace_or_push_back(irq::id::VCOUNT, hblank_effects::_hdma_intr);
+        _set_vcount_scanline(hdma_restart_scanline);
+
+        if(! hblank_effects::hdma_enabled())
+        {
+            irq::disable(irq::id::VCOUNT);
+        }
+    }
+}
+
+void _intr()
+{
+    if(REG_VCOUNT == hdma_restart_scanline)
+    {
+        hblank_effects::_hdma_intr();
+        data.band_index = 0;
+        _set_vcount_scanline(data.bands_ptr[0].scanline - rewrite_scanlines());
+        return;
+    }
+
+    int band_index = data.band_index;
+    const band& current_band = data.bands_ptr[band_index];
+    const sprites::handle_type* entries_ptr = current_band.entries_ptr;
+    sprites::handle_type* vram = reinterpret_cast<sprites::handle_type*>(MEM_OAM);
+
+    while(! (REG_DISPSTAT & DSTAT_IN_HBL))
+    {
+    }
+
+    for(int index = 0, count = current_band.entries_count; index < count; ++index)
+    {
+        const sprites::handle_type& entry = entries_ptr[index];
+        sprites::copy_handle(entry, vram[entry.fill]);
+    }
+
+    ++band_index;
+    data.band_index = band_index;
+
+    if(band_index < data.bands_count)
+    {
+        _set_vcount_scanline(data.bands_ptr[band_index].scanline - rewrite_scanlines());
+    }
+    else
+    {
+        _set_vcount_scanline(hdma_restart_scanline);
+    }
+}
+
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_ITEM_H
+#define BTN_AFFINE_BG_ITEM_H
+
+/**
+ * @file
+ * btn::affine_bg_item header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup tool
+ */
+
+#include "btn_fixed_fwd.h"
+#include "btn_bg_tiles_item.h"
+#include "btn_bg_palette_item.h"
+#include "btn_affine_bg_map_item.h"
+
+namespace btn
+{
+
+class fixed_point;
+class affine_bg_ptr;
+
+/**
+ * @brief Contains the required information to generate affine backgrounds and their maps.
+ *
+ * The assets conversion tools generate an object of this type in the build folder for each *.bmp file
+ * with `affine_bg` type.
+ *
+ * Tiles, colors and map cells are not copied but referenced,
+ * so they should outlive the affine_bg_item to avoid dangling references.
+ *
+ * Affine backgrounds only support 8 bits per pixel tiles and palettes.
+ *
+ * @ingroup affine_bg
+ * @ingroup tool
+ */
+class affine_bg_item
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param tiles_ref Reference to affine background tiles.
+     *
+     * The tiles are not copied but referenced,
+     * so they should outlive the affine_bg_item to avoid dangling references.
+     *
+     * @param colors_ref Reference to an array of multiples of 16 colors.
+     *
+     * The colors are not copied but referenced,
+     * so they should outlive the affine_bg_item to avoid dangling references.
+     *
+     * @param map_cells_ref Affine background map cells to reference.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_item to avoid dangling references.
+     *
+     * @param map_dimensions Size in map cells of the referenced map cells.
+     */
+    constexpr affine_bg_item(const span<const tile>& tiles_ref, const span<const color>& colors_ref,
+                             const affine_bg_map_cell& map_cells_ref, const size& map_dimensions) :
+        affine_bg_item(bg_tiles_item(tiles_ref), bg_palette_item(colors_ref, palette_bpp_mode::BPP_8),
+                       affine_bg_map_item(map_cells_ref, map_dimensions))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param tiles_item It creates the tiles of the output affine backgrounds.
+     * @param palette_item It creates the color palette of the output affine backgrounds.
+     * @param map_item It creates the map of the output affine backgrounds.
+     */
+    constexpr affine_bg_item(const bg_tiles_item& tiles_item, const bg_palette_item& palette_item,
+                             const affine_bg_map_item& map_item) :
+        _tiles_item(tiles_item),
+        _palette_item(palette_item),
+        _map_item(map_item)
+    {
+        BTN_ASSERT(palette_item.bpp_mode() == palette_bpp_mode::BPP_8, "Affine backgrounds only support 8BPP");
+        BTN_ASSERT(tiles_item.valid_tiles_count(palette_bpp_mode::BPP_8) &&
+                   tiles_item.tiles_ref().size() <= max_tiles_count(),
+                   "Invalid tiles count: ", tiles_item.tiles_ref().size());
+    }
+
+    /**
+     * @brief Returns the maximum number of tiles referenced by affine backgrounds.
+     *
+     * Affine background map cells are one byte each, so they can only reference 256 8 bits per pixel tiles,
+     * which are 512 tiles.
+     */
+    [[nodiscard]] static constexpr int max_tiles_count()
+    {
+        return 512;
+    }
+
+    /**
+     * @brief Returns the item used to create the tiles of the output affine backgrounds.
+     */
+    [[nodiscard]] constexpr const bg_tiles_item& tiles_item() const
+    {
+        return _tiles_item;
+    }
+
+    /**
+     * @brief Returns the item used to create the color palette of the output affine backgrounds.
+     */
+    [[nodiscard]] constexpr const bg_palette_item& palette_item() const
+    {
+        return _palette_item;
+    }
+
+    /**
+     * @brief Returns the item used to create the map of the output affine backgrounds.
+     */
+    [[nodiscard]] constexpr const affine_bg_map_item& map_item() const
+    {
+        return _map_item;
+    }
+
+    /**
+     * @brief Creates an affine_bg_ptr using the information contained in this item.
+     * @param x Horizontal position of the affine background.
+     * @param y Vertical position of the affine background.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] affine_bg_ptr create_bg(fixed x, fixed y) const;
+
+    /**
+     * @brief Creates an affine_bg_ptr using the information contained in this item.
+     * @param position Position of the affine background.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] affine_bg_ptr create_bg(const fixed_point& position) const;
+
+    /**
+     * @brief Creates an affine_bg_ptr using the information contained in this item.
+     * @param x Horizontal position of the affine background.
+     * @param y Vertical position of the affine background.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_ptr> create_bg_optional(fixed x, fixed y) const;
+
+    /**
+     * @brief Creates an affine_bg_ptr using the information contained in this item.
+     * @param position Position of the affine background.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_ptr> create_bg_optional(const fixed_point& position) const;
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> find_map() const;
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it.
+     */
+    [[nodiscard]] affine_bg_map_ptr create_map() const;
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the information provided by this item.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the information provided by this item is already referenced or not,
+     * you should use the create_map method instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @return affine_bg_map_ptr which references the information provided by this item.
+     */
+    [[nodiscard]] affine_bg_map_ptr create_new_map() const;
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> create_map_optional() const;
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the information provided by this item.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the information provided by this item is already referenced or not,
+     * you should use the create_map_optional method instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @return affine_bg_map_ptr which references the information provided by this item
+     * if the affine_bg_map_ptr can be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> create_new_map_optional() const;
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const affine_bg_item& a, const affine_bg_item& b) = default;
+
+private:
+    bg_tiles_item _tiles_item;
+    bg_palette_item _palette_item;
+    affine_bg_map_item _map_item;
+};
+
+}
+
+#endif
+
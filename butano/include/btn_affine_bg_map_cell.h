@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_MAP_CELL_H
+#define BTN_AFFINE_BG_MAP_CELL_H
+
+/**
+ * @file
+ * btn::affine_bg_map_cell header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ */
+
+#include "btn_common.h"
+
+namespace btn
+{
+
+using affine_bg_map_cell = uint8_t; //!< Affine background map cell type alias.
+
+}
+
+#endif
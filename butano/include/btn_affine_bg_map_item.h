@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_MAP_ITEM_H
+#define BTN_AFFINE_BG_MAP_ITEM_H
+
+/**
+ * @file
+ * btn::affine_bg_map_item header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ * @ingroup tool
+ */
+
+#include "btn_size.h"
+#include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
+#include "btn_affine_bg_map_cell.h"
+
+namespace btn
+{
+
+class bg_tiles_ptr;
+class bg_palette_ptr;
+class affine_bg_map_ptr;
+
+/**
+ * @brief Contains the required information to generate affine background maps.
+ *
+ * The assets conversion tools generate an object of this type in the build folder for each *.bmp file
+ * with `affine_bg` type.
+ *
+ * The map cells are not copied but referenced, so they should outlive the affine_bg_map_item
+ * to avoid dangling references.
+ *
+ * Affine maps are always square, and their size must be 16x16, 32x32, 64x64 or 128x128 map cells.
+ * Their map cells are one byte each, so at most 256 8 bits per pixel tiles can be referenced.
+ *
+ * The referenced map cells must be aligned to 4 bytes (the assets conversion tools align them).
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ * @ingroup tool
+ */
+class affine_bg_map_item
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param cells_ref Reference to one or more affine background map cells.
+     *
+     * The map cells are not copied but referenced, so they should outlive the affine_bg_map_item
+     * to avoid dangling references.
+     *
+     * @param dimensions Size in map cells of the referenced map cells.
+     */
+    constexpr affine_bg_map_item(const affine_bg_map_cell& cells_ref, const size& dimensions) :
+        affine_bg_map_item(cells_ref, dimensions, compression_type::NONE)
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param cells_ref Reference to one or more affine background map cells.
+     *
+     * If the map cells are compressed, cells_ref must reference the compressed data.
+     *
+     * The map cells are not copied but referenced, so they should outlive the affine_bg_map_item
+     * to avoid dangling references.
+     *
+     * @param dimensions Size in map cells of the referenced map cells.
+     * @param compression Compression type of the referenced map cells.
+     */
+    constexpr affine_bg_map_item(const affine_bg_map_cell& cells_ref, const size& dimensions,
+                                 compression_type compression) :
+        _cells_ptr(&cells_ref),
+        _dimensions(dimensions),
+        _compression(compression)
+    {
+        BTN_ASSERT(valid_dimensions(dimensions),
+                   "Invalid dimensions: ", dimensions.width(), " - ", dimensions.height());
+    }
+
+    /**
+     * @brief Indicates if the given size in map cells is supported by affine background maps.
+     */
+    [[nodiscard]] static constexpr bool valid_dimensions(const size& dimensions)
+    {
+        int width = dimensions.width();
+        return width == dimensions.height() && (width == 16 || width == 32 || width == 64 || width == 128);
+    }
+
+    /**
+     * @brief Returns the referenced map cells.
+     */
+    [[nodiscard]] constexpr const affine_bg_map_cell& cells_ref() const
+    {
+        return *_cells_ptr;
+    }
+
+    /**
+     * @brief Returns the size in map cells of the referenced map cells.
+     */
+    [[nodiscard]] constexpr const size& dimensions() const
+    {
+        return _dimensions;
+    }
+
+    /**
+     * @brief Returns the compression type of the referenced map cells.
+     */
+    [[nodiscard]] constexpr compression_type compression() const
+    {
+        return _compression;
+    }
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * @param tiles Referenced tiles of the map to search.
+     * @param palette Referenced color palette of the map to search.
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> find_map(const bg_tiles_ptr& tiles,
+                                                        const bg_palette_ptr& palette) const;
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it.
+     */
+    [[nodiscard]] affine_bg_map_ptr create_map(bg_tiles_ptr tiles, bg_palette_ptr palette) const;
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the information provided by this item.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the information provided by this item is already referenced or not,
+     * you should use the create_map method instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the information provided by this item.
+     */
+    [[nodiscard]] affine_bg_map_ptr create_new_map(bg_tiles_ptr tiles, bg_palette_ptr palette) const;
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the information provided by this item.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the information provided by this item if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> create_map_optional(bg_tiles_ptr tiles, bg_palette_ptr palette) const;
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the information provided by this item.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the information provided by this item is already referenced or not,
+     * you should use the create_map_optional method instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the information provided by this item
+     * if the affine_bg_map_ptr can be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] optional<affine_bg_map_ptr> create_new_map_optional(bg_tiles_ptr tiles,
+                                                                       bg_palette_ptr palette) const;
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const affine_bg_map_item& a, const affine_bg_map_item& b) = default;
+
+private:
+    const affine_bg_map_cell* _cells_ptr;
+    size _dimensions;
+    compression_type _compression;
+};
+
+}
+
+#endif
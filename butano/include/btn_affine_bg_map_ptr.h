@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_MAP_PTR_H
+#define BTN_AFFINE_BG_MAP_PTR_H
+
+/**
+ * @file
+ * btn::affine_bg_map_ptr header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ */
+
+#include "btn_utility.h"
+#include "btn_span_fwd.h"
+#include "btn_functional.h"
+#include "btn_optional_fwd.h"
+#include "btn_affine_bg_map_cell.h"
+
+namespace btn
+{
+
+class size;
+class bg_tiles_ptr;
+class bg_tiles_item;
+class bg_palette_ptr;
+class bg_palette_item;
+class affine_bg_item;
+class affine_bg_map_item;
+
+/**
+ * @brief std::shared_ptr like smart pointer that retains shared ownership of an affine background map.
+ *
+ * Several affine_bg_map_ptr objects may own the same affine background.
+ *
+ * The affine background map is released when the last remaining affine_bg_map_ptr owning it is destroyed.
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ */
+class affine_bg_map_ptr
+{
+
+public:
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * @param cells_ref Reference to the map cells to search.
+     * @param dimensions Size in map cells of the map to search.
+     * @param tiles Referenced tiles of the map to search.
+     * @param palette Referenced color palette of the map to search.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> find(
+            const affine_bg_map_cell& cells_ref, const size& dimensions, const bg_tiles_ptr& tiles,
+            const bg_palette_ptr& palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * @param map_item affine_bg_map_item which references the map cells to search.
+     * @param tiles Referenced tiles of the map to search.
+     * @param palette Referenced color palette of the map to search.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> find(
+            const affine_bg_map_item& map_item, const bg_tiles_ptr& tiles, const bg_palette_ptr& palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * @param item affine_bg_item which references the tiles, the color palette and the map cells to search.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> find(const affine_bg_item& item);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param cells_ref Reference to the map cells to search or handle.
+     * @param dimensions Size in map cells of the map to search or handle.
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create(
+            const affine_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param map_item affine_bg_map_item which references the map cells to search or handle.
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create(
+            const affine_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param item affine_bg_item which references the tiles, the color palette and the map cells to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create(const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param cells_ref Reference to the map cells to handle.
+     * @param dimensions Size in map cells of the map to handle.
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the given information.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create_new(
+            const affine_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param map_item affine_bg_map_item which references the map cells to handle.
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the given information.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create_new(
+            const affine_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param item affine_bg_item which references the tiles, the color palette and the map cells to handle.
+     * @return affine_bg_map_ptr which references the given information.
+     */
+    [[nodiscard]] static affine_bg_map_ptr create_new(const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references a chunk of VRAM map cells not visible on the screen.
+     * @param dimensions Size in map cells of the map to allocate.
+     * @param tiles Referenced tiles of the map to allocate.
+     * @param palette Referenced color palette of the map to allocate.
+     * @return affine_bg_map_ptr which references a chunk of VRAM map cells not visible on the screen.
+     */
+    [[nodiscard]] static affine_bg_map_ptr allocate(
+            const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param cells_ref Reference to the map cells to search or handle.
+     * @param dimensions Size in map cells of the map to search or handle.
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it if it could be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_optional(
+            const affine_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param map_item affine_bg_map_item which references the map cells to search or handle.
+     * @param tiles Referenced tiles of the map to search or handle.
+     * @param palette Referenced color palette of the map to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it if the affine_bg_map_ptr can be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_optional(
+            const affine_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Searches for an affine_bg_map_ptr which references the given information.
+     * If it is not found, it creates an affine_bg_map_ptr which references it.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param item affine_bg_item which references the tiles, the color palette and the map cells to search or handle.
+     * @return affine_bg_map_ptr which references the given information if it has been found;
+     * otherwise it returns an affine_bg_map_ptr which references it if the affine_bg_map_ptr can be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_optional(const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param cells_ref Reference to the map cells to handle.
+     * @param dimensions Size in map cells of the map to handle.
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the given information if the affine_bg_map_ptr can be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_new_optional(
+            const affine_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param map_item affine_bg_map_item which references the map cells to handle.
+     * @param tiles Referenced tiles of the map to handle.
+     * @param palette Referenced color palette of the map to handle.
+     * @return affine_bg_map_ptr which references the given information if the affine_bg_map_ptr can be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_new_optional(
+            const affine_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references the given map cells.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     * If you are not sure if the given map cells are already referenced or not,
+     * you should use the static create methods instead.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param item affine_bg_item which references the tiles, the color palette and the map cells to handle.
+     * @return affine_bg_map_ptr which references the given information if the affine_bg_map_ptr can be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> create_new_optional(const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_map_ptr which references a chunk of VRAM map cells not visible on the screen.
+     * @param dimensions Size in map cells of the map to allocate.
+     * @param tiles Referenced tiles of the map to allocate.
+     * @param palette Referenced color palette of the map to allocate.
+     * @return affine_bg_map_ptr which references a chunk of VRAM map cells not visible on the screen
+     * if the affine_bg_map_ptr can be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_map_ptr> allocate_optional(
+            const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Copy constructor.
+     * @param other affine_bg_map_ptr to copy.
+     */
+    affine_bg_map_ptr(const affine_bg_map_ptr& other);
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other affine_bg_map_ptr to copy.
+     * @return Reference to this.
+     */
+    affine_bg_map_ptr& operator=(const affine_bg_map_ptr& other);
+
+    /**
+     * @brief Move constructor.
+     * @param other affine_bg_map_ptr to move.
+     */
+    affine_bg_map_ptr(affine_bg_map_ptr&& other) noexcept :
+        affine_bg_map_ptr(other._handle)
+    {
+        other._handle = -1;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other affine_bg_map_ptr to move.
+     * @return Reference to this.
+     */
+    affine_bg_map_ptr& operator=(affine_bg_map_ptr&& other) noexcept
+    {
+        btn::swap(_handle, other._handle);
+        return *this;
+    }
+
+    /**
+     * @brief Releases the referenced map cells if no more affine_bg_map_ptr objects reference to them.
+     */
+    ~affine_bg_map_ptr()
+    {
+        if(_handle >= 0)
+        {
+            _destroy();
+        }
+    }
+
+    /**
+     * @brief Returns the internal id.
+     */
+    [[nodiscard]] int id() const;
+
+    /**
+     * @brief Returns the size in map cells of the referenced map.
+     */
+    [[nodiscard]] size dimensions() const;
+
+    /**
+     * @brief Returns the referenced map cells unless it was created with allocate or allocate_optional,
+     * or the referenced map cells are compressed.
+     * In that case, it returns `nullopt`.
+     */
+    [[nodiscard]] optional<span<const affine_bg_map_cell>> cells_ref() const;
+
+    /**
+     * @brief Sets the map cells to handle.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * @param cells_ref Reference to the map cells to handle.
+     * @param dimensions Size in map cells of the map to handle.
+     */
+    void set_cells_ref(const affine_bg_map_cell& cells_ref, const size& dimensions);
+
+    /**
+     * @brief Sets the map cells to handle.
+     *
+     * The map system does not support multiple affine_bg_map_ptr items referencing to the same map cells.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the affine_bg_map_ptr to avoid dangling references.
+     *
+     * If the map cells are compressed and they don't fit in the VRAM commits budget,
+     * they are decompressed over multiple frames in an EWRAM buffer,
+     * and the previous map cells are displayed until the new ones are copied to VRAM at once.
+     *
+     * @param map_item affine_bg_map_item which references the map cells to handle.
+     */
+    void set_cells_ref(const affine_bg_map_item& map_item);
+
+    /**
+     * @brief Uploads the referenced map cells to VRAM again to make visible the possible changes in them.
+     */
+    void reload_cells_ref();
+
+    /**
+     * @brief Returns the referenced tiles.
+     */
+    [[nodiscard]] const bg_tiles_ptr& tiles() const;
+
+    /**
+     * @brief Sets the referenced tiles.
+     * @param tiles bg_tiles_ptr to copy.
+     *
+     * It must be compatible with the referenced color palette.
+     */
+    void set_tiles(const bg_tiles_ptr& tiles);
+
+    /**
+     * @brief Sets the referenced tiles.
+     * @param tiles bg_tiles_ptr to move.
+     *
+     * It must be compatible with the referenced color palette.
+     */
+    void set_tiles(bg_tiles_ptr&& tiles);
+
+    /**
+     * @brief Replaces the referenced tiles with a new tile set created with the given bg_tiles_item.
+     *
+     * Before creating a new background tile set, the bg_tiles_ptr referenced by this map is removed,
+     * so VRAM usage is reduced.
+     *
+     * The new background tiles must be compatible with the referenced color palette.
+     *
+     * @param tiles_item It creates the new background tiles to reference.
+     */
+    void set_tiles(const bg_tiles_item& tiles_item);
+
+    /**
+     * @brief Returns the referenced color palette.
+     */
+    [[nodiscard]] const bg_palette_ptr& palette() const;
+
+    /**
+     * @brief Sets the referenced color palette.
+     * @param palette bg_palette_ptr to copy.
+     *
+     * It must be compatible with the referenced tiles.
+     */
+    void set_palette(const bg_palette_ptr& palette);
+
+    /**
+     * @brief Sets the referenced color palette.
+     * @param palette bg_palette_ptr to move.
+     *
+     * It must be compatible with the referenced tiles.
+     */
+    void set_palette(bg_palette_ptr&& palette);
+
+    /**
+     * @brief Replaces the referenced color palette with a new tile set created with the given bg_palette_item.
+     *
+     * Before creating a new color palette, the bg_palette_ptr referenced by this map is removed,
+     * so VRAM usage is reduced.
+     *
+     * The new color palette must be compatible with the referenced tiles.
+     *
+     * @param palette_item It creates the new color palette to reference.
+     */
+    void set_palette(const bg_palette_item& palette_item);
+
+    /**
+     * @brief Sets the tiles and the color palette to reference.
+     * @param tiles bg_tiles_ptr to reference.
+     * @param palette bg_palette_ptr to reference.
+     */
+    void set_tiles_and_palette(bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Replaces the referenced tiles and color palette
+     * with the created with the given bg_tiles_item and bg_palette_item.
+     *
+     * Before creating new resources, the resources referenced by this map are removed,
+     * so VRAM usage is reduced.
+     *
+     * @param tiles_item It creates the new background tiles to reference.
+     * @param palette_item It creates the color palette to reference.
+     */
+    void set_tiles_and_palette(const bg_tiles_item& tiles_item, const bg_palette_item& palette_item);
+
+    /**
+     * @brief Returns the allocated memory in VRAM
+     * if this affine_bg_map_cell was created with allocate or allocate_optional; `nullopt` otherwise.
+     *
+     * VRAM doesn't support 8 bits writes, so map cells must be written in pairs (16 bits at a time).
+     */
+    [[nodiscard]] optional<span<affine_bg_map_cell>> vram();
+
+    /**
+     * @brief Returns the hash of the internal handle.
+     */
+    [[nodiscard]] unsigned hash() const
+    {
+        return make_hash(_handle);
+    }
+
+    /**
+     * @brief Exchanges the contents of this affine_bg_map_ptr with those of the other one.
+     * @param other affine_bg_map_ptr to exchange the contents with.
+     */
+    void swap(affine_bg_map_ptr& other)
+    {
+        btn::swap(_handle, other._handle);
+    }
+
+    /**
+     * @brief Exchanges the contents of an affine_bg_map_ptr with those of another one.
+     * @param a First affine_bg_map_ptr to exchange the contents with.
+     * @param b Second affine_bg_map_ptr to exchange the contents with.
+     */
+    friend void swap(affine_bg_map_ptr& a, affine_bg_map_ptr& b)
+    {
+        btn::swap(a._handle, b._handle);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] friend bool operator==(const affine_bg_map_ptr& a, const affine_bg_map_ptr& b) = default;
+
+private:
+    int8_t _handle;
+
+    explicit affine_bg_map_ptr(int handle) :
+        _handle(int8_t(handle))
+    {
+    }
+
+    void _destroy();
+};
+
+
+/**
+ * @brief Hash support for affine_bg_map_ptr.
+ *
+ * @ingroup affine_bg
+ * @ingroup bg_map
+ * @ingroup functional
+ */
+template<>
+struct hash<affine_bg_map_ptr>
+{
+    /**
+     * @brief Returns the hash of the given affine_bg_map_ptr.
+     */
+    [[nodiscard]] unsigned operator()(const affine_bg_map_ptr& value) const
+    {
+        return value.hash();
+    }
+};
+
+}
+
+#endif
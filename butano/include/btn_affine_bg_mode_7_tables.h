@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_MODE_7_TABLES_H
+#define BTN_AFFINE_BG_MODE_7_TABLES_H
+
+/**
+ * @file
+ * btn::affine_bg_mode_7_tables header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup hblank_effect
+ */
+
+#include "btn_span.h"
+#include "btn_fixed.h"
+#include "btn_display.h"
+
+namespace btn
+{
+
+/**
+ * @brief Per screen horizontal line affine registers values which display an affine background
+ * as a perspective floor (also known as Mode 7).
+ *
+ * The tables are intended to be referenced by affine_bg_pa_register_hblank_effect_ptr,
+ * affine_bg_pc_register_hblank_effect_ptr, affine_bg_dx_register_hblank_effect_ptr
+ * and affine_bg_dy_register_hblank_effect_ptr objects, and they can be rebuilt each frame.
+ *
+ * The second and fourth affine registers are not needed, since the reference point is set in each screen
+ * horizontal line.
+ *
+ * @ingroup affine_bg
+ * @ingroup hblank_effect
+ */
+class affine_bg_mode_7_tables
+{
+
+public:
+    /**
+     * @brief Returns the values to commit to the first GBA register of the affine matrix
+     * of an affine background in each screen horizontal line.
+     */
+    [[nodiscard]] span<const int16_t> pa_values_ref() const
+    {
+        return _pa_values;
+    }
+
+    /**
+     * @brief Returns the values to commit to the third GBA register of the affine matrix
+     * of an affine background in each screen horizontal line.
+     */
+    [[nodiscard]] span<const int16_t> pc_values_ref() const
+    {
+        return _pc_values;
+    }
+
+    /**
+     * @brief Returns the values to commit to the horizontal reference point GBA register
+     * of an affine background in each screen horizontal line.
+     */
+    [[nodiscard]] span<const int> dx_values_ref() const
+    {
+        return _dx_values;
+    }
+
+    /**
+     * @brief Returns the values to commit to the vertical reference point GBA register
+     * of an affine background in each screen horizontal line.
+     */
+    [[nodiscard]] span<const int> dy_values_ref() const
+    {
+        return _dy_values;
+    }
+
+    /**
+     * @brief Rebuilds the tables for the given camera.
+     * @param camera_x Horizontal position of the camera in the affine background map (in pixels).
+     * @param camera_z Vertical position of the camera in the affine background map (in pixels).
+     * @param camera_height Height of the camera over the affine background (in pixels, greater than 0).
+     * @param camera_angle Camera rotation angle in degrees, in the range [0, 360].
+     * @param horizon_y Screen horizontal line of the horizon, in the range [0, 159].
+     * Screen horizontal lines above or at the horizon display the top-left pixel of the map,
+     * so they should be hidden with a window or with another background.
+     * @param focal_distance Distance between the camera and the screen (in pixels, greater than 0).
+     */
+    BTN_CODE_IWRAM void update(fixed camera_x, fixed camera_z, fixed camera_height, fixed camera_angle,
+                               int horizon_y, int focal_distance);
+
+private:
+    alignas(int) int16_t _pa_values[display::height()] = {};
+    alignas(int) int16_t _pc_values[display::height()] = {};
+    int _dx_values[display::height()] = {};
+    int _dy_values[display::height()] = {};
+};
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_PD_REGISTER_HBLANK_EFFECT_PTR_H
+#define BTN_AFFINE_BG_PD_REGISTER_HBLANK_EFFECT_PTR_H
+
+/**
+ * @file
+ * btn::affine_bg_pd_register_hblank_effect_ptr header file.
+ *
+ * @ingroup affine_bg
+ * @ingroup hblank_effect
+ */
+
+#include "btn_affine_bg_ptr.h"
+#include "btn_hblank_effect_ptr.h"
+
+namespace btn
+{
+
+/**
+ * @brief std::shared_ptr like smart pointer that retains shared ownership of a H-Blank effect which changes
+ * the values to commit to the fourth GBA register of the affine matrix of an affine background
+ * in each screen horizontal line.
+ *
+ * @ingroup affine_bg
+ * @ingroup hblank_effect
+ */
+class affine_bg_pd_register_hblank_effect_ptr : public hblank_effect_ptr
+{
+
+public:
+    /**
+     * @brief Creates an affine_bg_pd_register_hblank_effect_ptr which changes the values to commit
+     * to the fourth GBA register of the affine matrix of an affine background.
+     * @param bg Affine background to be modified.
+     * @param values_ref Reference to an array of 160 values to commit
+     * to the fourth GBA register of the affine matrix of the given affine background
+     * in each screen horizontal line.
+     *
+     * The values are not copied but referenced, so they should outlive
+     * affine_bg_pd_register_hblank_effect_ptr to avoid dangling references.
+     *
+     * @return The requested affine_bg_pd_register_hblank_effect_ptr.
+     */
+    [[nodiscard]] static affine_bg_pd_register_hblank_effect_ptr create(
+            affine_bg_ptr bg, const span<const int16_t>& values_ref);
+
+    /**
+     * @brief Creates an affine_bg_pd_register_hblank_effect_ptr which changes the values to commit
+     * to the fourth GBA register of the affine matrix of an affine background.
+     * @param bg Affine background to be modified.
+     * @param values_ref Reference to an array of 160 values to commit
+     * to the fourth GBA register of the affine matrix of the given affine background
+     * in each screen horizontal line.
+     *
+     * The values are not copied but referenced, so they should outlive
+     * affine_bg_pd_register_hblank_effect_ptr to avoid dangling references.
+     *
+     * @return The requested affine_bg_pd_register_hblank_effect_ptr if it could be allocated;
+     * `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_pd_register_hblank_effect_ptr> create_optional(
+            affine_bg_ptr bg, const span<const int16_t>& values_ref);
+
+    /**
+     * @brief Returns the affine background modified by this H-Blank effect.
+     */
+    [[nodiscard]] const affine_bg_ptr& bg() const
+    {
+        return _bg;
+    }
+
+    /**
+     * @brief Returns the referenced array of 160 values to commit
+     * to the fourth GBA register of the affine matrix of an affine background in each screen horizontal line.
+     *
+     * The values are not copied but referenced, so they should outlive
+     * affine_bg_pd_register_hblank_effect_ptr to avoid dangling references.
+     */
+    [[nodiscard]] span<const int16_t> values_ref() const;
+
+    /**
+     * @brief Sets the reference to an array of 160 values to commit
+     * to the fourth GBA register of the affine matrix of an affine background in each screen horizontal line.
+     *
+     * The values are not copied but referenced, so they should outlive
+     * affine_bg_pd_register_hblank_effect_ptr to avoid dangling references.
+     */
+    void set_values_ref(const span<const int16_t>& values_ref);
+
+    /**
+     * @brief Rereads the content of the referenced values to commit
+     * to the fourth GBA register of the affine matrix of an affine background in each screen horizontal line.
+     *
+     * The values are not copied but referenced, so they should outlive
+     * affine_bg_pd_register_hblank_effect_ptr to avoid dangling references.
+     */
+    void reload_values_ref();
+
+    /**
+     * @brief Exchanges the contents of this affine_bg_pd_register_hblank_effect_ptr with those of the other one.
+     * @param other affine_bg_pd_register_hblank_effect_ptr to exchange the contents with.
+     */
+    void swap(affine_bg_pd_register_hblank_effect_ptr& other);
+
+    /**
+     * @brief Exchanges the contents of an affine_bg_pd_register_hblank_effect_ptr with those of another one.
+     * @param a First affine_bg_pd_register_hblank_effect_ptr to exchange the contents with.
+     * @param b Second affine_bg_pd_register_hblank_effect_ptr to exchange the contents with.
+     */
+    friend void swap(affine_bg_pd_register_hblank_effect_ptr& a, affine_bg_pd_register_hblank_effect_ptr& b)
+    {
+        a.swap(b);
+    }
+
+private:
+    affine_bg_ptr _bg;
+
+    affine_bg_pd_register_hblank_effect_ptr(int id, affine_bg_ptr&& bg);
+};
+
+}
+
+#endif
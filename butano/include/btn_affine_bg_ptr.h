@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_PTR_H
+#define BTN_AFFINE_BG_PTR_H
+
+/**
+ * @file
+ * btn::affine_bg_ptr header file.
+ *
+ * @ingroup affine_bg
+ */
+
+#include "btn_utility.h"
+#include "btn_fixed_fwd.h"
+#include "btn_functional.h"
+#include "btn_optional_fwd.h"
+
+namespace btn
+{
+
+class size;
+class window;
+class camera_ptr;
+class fixed_point;
+class bg_tiles_ptr;
+class bg_tiles_item;
+class bg_palette_ptr;
+class bg_palette_item;
+class affine_bg_item;
+class affine_bg_builder;
+class affine_bg_map_ptr;
+class affine_bg_map_item;
+
+/**
+ * @brief std::shared_ptr like smart pointer that retains shared ownership of an affine background.
+ *
+ * Several affine_bg_ptr objects may own the same affine background.
+ *
+ * The affine background is released when the last remaining affine_bg_ptr owning it is destroyed.
+ *
+ * @ingroup affine_bg
+ */
+class affine_bg_ptr
+{
+
+public:
+    /**
+     * @brief Creates an affine_bg_ptr from the given affine_bg_item.
+     * @param x Horizontal position of the affine background.
+     * @param y Vertical position of the affine background.
+     * @param item affine_bg_item containing the required information to generate the affine background.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] static affine_bg_ptr create(fixed x, fixed y, const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_ptr from the given affine_bg_item.
+     * @param position Position of the affine background.
+     * @param item affine_bg_item containing the required information to generate the affine background.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] static affine_bg_ptr create(const fixed_point& position, const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_ptr from an affine_bg_builder reference.
+     * @param builder affine_bg_builder reference.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] static affine_bg_ptr create(const affine_bg_builder& builder);
+
+    /**
+     * @brief Creates an affine_bg_ptr from a moved affine_bg_builder.
+     * @param builder affine_bg_builder to move.
+     * @return The requested affine_bg_ptr.
+     */
+    [[nodiscard]] static affine_bg_ptr create(affine_bg_builder&& builder);
+
+    /**
+     * @brief Creates an affine_bg_ptr from the given affine_bg_item.
+     * @param x Horizontal position of the affine background.
+     * @param y Vertical position of the affine background.
+     * @param item affine_bg_item containing the required information to generate the affine background.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_ptr> create_optional(fixed x, fixed y, const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_ptr from the given affine_bg_item.
+     * @param position Position of the affine background.
+     * @param item affine_bg_item containing the required information to generate the affine background.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_ptr> create_optional(const fixed_point& position,
+                                                                  const affine_bg_item& item);
+
+    /**
+     * @brief Creates an affine_bg_ptr from an affine_bg_builder reference.
+     * @param builder affine_bg_builder reference.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_ptr> create_optional(const affine_bg_builder& builder);
+
+    /**
+     * @brief Creates an affine_bg_ptr from a moved affine_bg_builder.
+     * @param builder affine_bg_builder to move.
+     * @return The requested affine_bg_ptr if it could be allocated; `nullopt` otherwise.
+     */
+    [[nodiscard]] static optional<affine_bg_ptr> create_optional(affine_bg_builder&& builder);
+
+    /**
+     * @brief Copy constructor.
+     * @param other affine_bg_ptr to copy.
+     */
+    affine_bg_ptr(const affine_bg_ptr& other);
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other affine_bg_ptr to copy.
+     * @return Reference to this.
+     */
+    affine_bg_ptr& operator=(const affine_bg_ptr& other);
+
+    /**
+     * @brief Move constructor.
+     * @param other affine_bg_ptr to move.
+     */
+    affine_bg_ptr(affine_bg_ptr&& other) noexcept :
+        affine_bg_ptr(other._handle)
+    {
+        other._handle = nullptr;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other affine_bg_ptr to move.
+     * @return Reference to this.
+     */
+    affine_bg_ptr& operator=(affine_bg_ptr&& other) noexcept
+    {
+        btn::swap(_handle, other._handle);
+        return *this;
+    }
+
+    /**
+     * @brief Releases the referenced affine background if no more affine_bg_ptr objects reference to it.
+     */
+    ~affine_bg_ptr()
+    {
+        if(_handle)
+        {
+            _destroy();
+        }
+    }
+
+    /**
+     * @brief Returns the size in pixels of the affine background.
+     */
+    [[nodiscard]] size dimensions() const;
+
+    /**
+     * @brief Returns the tiles used by this affine background.
+     */
+    [[nodiscard]] const bg_tiles_ptr& tiles() const;
+
+    /**
+     * @brief Sets the tiles used by this affine background.
+     * @param tiles bg_tiles_ptr to copy.
+     *
+     * It must be compatible with the current map of the affine background.
+     */
+    void set_tiles(const bg_tiles_ptr& tiles);
+
+    /**
+     * @brief Sets the tiles used by this affine background.
+     * @param tiles bg_tiles_ptr to move.
+     *
+     * It must be compatible with the current map of the affine background.
+     */
+    void set_tiles(bg_tiles_ptr&& tiles);
+
+    /**
+     * @brief Replaces the tiles used by this affine background
+     * with a new tile set created with the given bg_tiles_item.
+     *
+     * Before creating a new background tile set, the bg_tiles_ptr used by this affine background is removed,
+     * so VRAM usage is reduced.
+     *
+     * The new background tiles must be compatible with the current map of the affine background.
+     *
+     * @param tiles_item It creates the new background tiles to use by this affine background.
+     */
+    void set_tiles(const bg_tiles_item& tiles_item);
+
+    /**
+     * @brief Returns the color palette used by this affine background.
+     */
+    [[nodiscard]] const bg_palette_ptr& palette() const;
+
+    /**
+     * @brief Sets the color palette to use by this affine background.
+     * @param palette bg_palette_ptr to copy.
+     *
+     * It must be compatible with the current map of the affine background.
+     */
+    void set_palette(const bg_palette_ptr& palette);
+
+    /**
+     * @brief Sets the color palette to use by this affine background.
+     * @param palette bg_palette_ptr to move.
+     *
+     * It must be compatible with the current map of the affine background.
+     */
+    void set_palette(bg_palette_ptr&& palette);
+
+    /**
+     * @brief Replaces the color palette used by this affine background
+     * with a new one created with the given bg_palette_item.
+     *
+     * Before creating a new color palette, the bg_palette_ptr used by this affine background is removed,
+     * so VRAM usage is reduced.
+     *
+     * The new color palette must be compatible with the current map of the affine background.
+     *
+     * @param palette_item It creates the color palette to use by this affine background.
+     */
+    void set_palette(const bg_palette_item& palette_item);
+
+    /**
+     * @brief Sets the tiles and the color palette to use by this affine background.
+     *
+     * The given parameters must be compatible with the current map of the affine background.
+     *
+     * @param tiles bg_tiles_ptr to set.
+     * @param palette bg_palette_ptr to set.
+     */
+    void set_tiles_and_palette(bg_tiles_ptr tiles, bg_palette_ptr palette);
+
+    /**
+     * @brief Replaces the tiles and the color palette used by this affine background
+     * with the created with the given bg_tiles_item and bg_palette_item.
+     *
+     * Before creating new resources, the resources used by this affine background are removed,
+     * so VRAM usage is reduced.
+     *
+     * @param tiles_item It creates the new background tiles to use by this affine background.
+     * @param palette_item It creates the color palette to use by this affine background.
+     */
+    void set_tiles_and_palette(const bg_tiles_item& tiles_item, const bg_palette_item& palette_item);
+
+    /**
+     * @brief Returns the map used by this affine background.
+     */
+    [[nodiscard]] const affine_bg_map_ptr& map() const;
+
+    /**
+     * @brief Sets the map used by this affine background.
+     * @param map affine_bg_map_ptr to copy.
+     */
+    void set_map(const affine_bg_map_ptr& map);
+
+    /**
+     * @brief Sets the map used by this affine background.
+     * @param map affine_bg_map_ptr to move.
+     */
+    void set_map(affine_bg_map_ptr&& map);
+
+    /**
+     * @brief Replaces the map used by this affine background
+     * with a new map created with the given affine_bg_map_item.
+     *
+     * Before creating a new map, the affine_bg_map_ptr used by this affine background is removed,
+     * so VRAM usage is reduced.
+     *
+     * @param map_item It creates the new map to use by this affine background.
+     */
+    void set_map(const affine_bg_map_item& map_item);
+
+    /**
+     * @brief Replaces the tiles, the color palette and the map used by this affine background
+     * with the created with the given affine_bg_item.
+     *
+     * Before creating new resources, the resources used by this affine background are removed,
+     * so VRAM usage is reduced.
+     *
+     * @param item It creates the resources to use by this affine background.
+     */
+    void set_item(const affine_bg_item& item);
+
+    /**
+     * @brief Returns the horizontal position of the affine background (relative to its camera, if it has one).
+     */
+    [[nodiscard]] fixed x() const;
+
+    /**
+     * @brief Sets the horizontal position of the affine background (relative to its camera, if it has one).
+     */
+    void set_x(fixed x);
+
+    /**
+     * @brief Returns the vertical position of the affine background (relative to its camera, if it has one).
+     */
+    [[nodiscard]] fixed y() const;
+
+    /**
+     * @brief Sets the vertical position of the affine background (relative to its camera, if it has one).
+     */
+    void set_y(fixed y);
+
+    /**
+     * @brief Returns the position of the affine background (relative to its camera, if it has one).
+     */
+    [[nodiscard]] const fixed_point& position() const;
+
+    /**
+     * @brief Sets the position of the affine background (relative to its camera, if it has one).
+     * @param x Horizontal position of the affine background (relative to its camera, if it has one).
+     * @param y Vertical position of the affine background (relative to its camera, if it has one).
+     */
+    void set_position(fixed x, fixed y);
+
+    /**
+     * @brief Sets the position of the affine background (relative to its camera, if it has one).
+     */
+    void set_position(const fixed_point& position);
+
+    /**
+     * @brief Returns the rotation angle in degrees of the affine background.
+     */
+    [[nodiscard]] fixed rotation_angle() const;
+
+    /**
+     * @brief Sets the rotation angle in degrees of the affine background.
+     * @param rotation_angle Rotation angle in degrees, in the range [0..360].
+     */
+    void set_rotation_angle(fixed rotation_angle);
+
+    /**
+     * @brief Returns the horizontal scale of the affine background.
+     */
+    [[nodiscard]] fixed horizontal_scale() const;
+
+    /**
+     * @brief Sets the horizontal scale of the affine background.
+     */
+    void set_horizontal_scale(fixed horizontal_scale);
+
+    /**
+     * @brief Returns the vertical scale of the affine background.
+     */
+    [[nodiscard]] fixed vertical_scale() const;
+
+    /**
+     * @brief Sets the vertical scale of the affine background.
+     */
+    void set_vertical_scale(fixed vertical_scale);
+
+    /**
+     * @brief Sets the scale of the affine background.
+     */
+    void set_scale(fixed scale);
+
+    /**
+     * @brief Sets the scale of the affine background.
+     * @param horizontal_scale Horizontal scale of the affine background.
+     * @param vertical_scale Vertical scale of the affine background.
+     */
+    void set_scale(fixed horizontal_scale, fixed vertical_scale);
+
+    /**
+     * @brief Returns the priority of the affine background relative to sprites and other backgrounds.
+     *
+     * Backgrounds with higher priorities are drawn first
+     * (and therefore can be covered by later sprites and backgrounds).
+     */
+    [[nodiscard]] int priority() const;
+
+    /**
+     * @brief Sets the priority of the affine background relative to sprites and other backgrounds.
+     *
+     * Backgrounds with higher priorities are drawn first
+     * (and therefore can be covered by later sprites and backgrounds).
+     *
+     * @param priority Priority in the range [0..3].
+     */
+    void set_priority(int priority);
+
+    /**
+     * @brief Returns the priority of the affine background relative to other backgrounds, excluding sprites.
+     *
+     * Backgrounds with higher z orders are drawn first (and therefore can be covered by later backgrounds).
+     */
+    [[nodiscard]] int z_order() const;
+
+    /**
+     * @brief Sets the priority of the affine background relative to other backgrounds, excluding sprites.
+     *
+     * Backgrounds with higher z orders are drawn first (and therefore can be covered by later backgrounds).
+     *
+     * @param z_order Priority relative to other backgrounds, excluding sprites, in the range [-32767..32767].
+     */
+    void set_z_order(int z_order);
+
+    /**
+     * @brief Modify this affine background to be drawn above all of the other backgrounds with the same priorities.
+     */
+    void put_above();
+
+    /**
+     * @brief Indicates if the mosaic effect must be applied to this affine background or not.
+     */
+    [[nodiscard]] bool mosaic_enabled() const;
+
+    /**
+     * @brief Sets if the mosaic effect must be applied to this affine background or not.
+     */
+    void set_mosaic_enabled(bool mosaic_enabled);
+
+    /**
+     * @brief Indicates if blending must be applied to this affine background or not.
+     */
+    [[nodiscard]] bool blending_enabled() const;
+
+    /**
+     * @brief Sets if blending must be applied to this affine background or not.
+     */
+    void set_blending_enabled(bool blending_enabled);
+
+    /**
+     * @brief Indicates if this affine background wraps around at the edges or not.
+     */
+    [[nodiscard]] bool wrapping_enabled() const;
+
+    /**
+     * @brief Sets if this affine background must wrap around at the edges or not.
+     * @param wrapping_enabled `true` if this affine background must wrap around at the edges;
+     * `false` if the area outside of it must be transparent.
+     */
+    void set_wrapping_enabled(bool wrapping_enabled);
+
+    /**
+     * @brief Indicates if this affine background must be committed to the GBA or not.
+     */
+    [[nodiscard]] bool visible() const;
+
+    /**
+     * @brief Sets if this affine background must be committed to the GBA or not.
+     */
+    void set_visible(bool visible);
+
+    /**
+     * @brief Indicates if this affine background is visible in the given window or not.
+     */
+    [[nodiscard]] bool visible_in_window(const window& window) const;
+
+    /**
+     * @brief Sets if this affine background must be visible in the given window or not.
+     */
+    void set_visible_in_window(bool visible, window& window);
+
+    /**
+     * @brief Returns the camera_ptr attached to this affine background (if any).
+     */
+    [[nodiscard]] const optional<camera_ptr>& camera() const;
+
+    /**
+     * @brief Sets the camera_ptr attached to this affine background.
+     * @param camera camera_ptr to copy to this affine background.
+     */
+    void set_camera(const camera_ptr& camera);
+
+    /**
+     * @brief Sets the camera_ptr attached to this affine background.
+     * @param camera camera_ptr to move to this affine background.
+     */
+    void set_camera(camera_ptr&& camera);
+
+    /**
+     * @brief Removes the camera_ptr attached to this affine background (if any).
+     */
+    void remove_camera();
+
+    /**
+     * @brief Returns the internal handle.
+     */
+    [[nodiscard]] const void* handle() const
+    {
+        return _handle;
+    }
+
+    /**
+     * @brief Exchanges the contents of this affine_bg_ptr with those of the other one.
+     * @param other affine_bg_ptr to exchange the contents with.
+     */
+    void swap(affine_bg_ptr& other)
+    {
+        btn::swap(_handle, other._handle);
+    }
+
+    /**
+     * @brief Exchanges the contents of an affine_bg_ptr with those of another one.
+     * @param a First affine_bg_ptr to exchange the contents with.
+     * @param b Second affine_bg_ptr to exchange the contents with.
+     */
+    friend void swap(affine_bg_ptr& a, affine_bg_ptr& b)
+    {
+        btn::swap(a._handle, b._handle);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] friend bool operator==(const affine_bg_ptr& a, const affine_bg_ptr& b) = default;
+
+private:
+    using handle_type = void*;
+
+    handle_type _handle;
+
+    explicit affine_bg_ptr(handle_type handle) :
+        _handle(handle)
+    {
+    }
+
+    void _destroy();
+};
+
+
+/**
+ * @brief Hash support for affine_bg_ptr.
+ *
+ * @ingroup affine_bg
+ * @ingroup functional
+ */
+template<>
+struct hash<affine_bg_ptr>
+{
+    /**
+     * @brief Returns the hash of the given affine_bg_ptr.
+     */
+    [[nodiscard]] unsigned operator()(const affine_bg_ptr& value) const
+    {
+        return make_hash(value.handle());
+    }
+};
+
+}
+
+#endif
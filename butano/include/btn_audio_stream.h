@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AUDIO_STREAM_H
+#define BTN_AUDIO_STREAM_H
+
+/**
+ * @file
+ * btn::audio_stream header file.
+ *
+ * @ingroup audio_stream
+ */
+
+#include "btn_fixed_fwd.h"
+
+namespace btn
+{
+    class audio_stream_item;
+}
+
+/**
+ * @brief Audio stream related functions.
+ *
+ * Only one audio stream can be played at the same time, alongside music and sound effects.
+ *
+ * @ingroup audio_stream
+ */
+namespace btn::audio_stream
+{
+    /**
+     * @brief Indicates if currently there's any audio stream playing or not.
+     */
+    [[nodiscard]] bool playing();
+
+    /**
+     * @brief Plays the audio stream specified by the given audio_stream_item with default settings.
+     *
+     * Default settings are volume = 1 and loop disabled.
+     */
+    void play(const audio_stream_item& item);
+
+    /**
+     * @brief Plays the audio stream specified by the given audio_stream_item.
+     * @param item Specifies the audio stream to play.
+     * @param volume Volume level, in the range [0..1].
+     */
+    void play(const audio_stream_item& item, fixed volume);
+
+    /**
+     * @brief Plays the audio stream specified by the given audio_stream_item.
+     * @param item Specifies the audio stream to play.
+     * @param volume Volume level, in the range [0..1].
+     * @param loop Indicates if it must be played until it is stopped manually or until end.
+     */
+    void play(const audio_stream_item& item, fixed volume, bool loop);
+
+    /**
+     * @brief Stops playback of the active audio stream.
+     */
+    void stop();
+
+    /**
+     * @brief Indicates if the active audio stream has been paused or not.
+     */
+    [[nodiscard]] bool paused();
+
+    /**
+     * @brief Pauses playback of the active audio stream.
+     */
+    void pause();
+
+    /**
+     * @brief Resumes playback of the paused audio stream.
+     */
+    void resume();
+
+    /**
+     * @brief Returns the volume of the active audio stream.
+     */
+    [[nodiscard]] fixed volume();
+
+    /**
+     * @brief Sets the volume of the active audio stream.
+     * @param volume Volume level, in the range [0..1].
+     */
+    void set_volume(fixed volume);
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AUDIO_STREAM_ITEM_H
+#define BTN_AUDIO_STREAM_ITEM_H
+
+/**
+ * @file
+ * btn::audio_stream_item header file.
+ *
+ * @ingroup audio_stream
+ * @ingroup tool
+ */
+
+#include "btn_assert.h"
+#include "btn_fixed_fwd.h"
+
+namespace btn
+{
+
+/**
+ * @brief Contains the required information to play an audio stream.
+ *
+ * The assets conversion tools generate an object of this type in the build folder
+ * for each *.wav file with a companion *.json file specifying that it is an audio stream.
+ *
+ * Audio stream data is stored as mono IMA-ADPCM blocks of 256 bytes (505 samples per block).
+ *
+ * @ingroup audio_stream
+ * @ingroup tool
+ */
+class audio_stream_item
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param data_ptr Pointer to the IMA-ADPCM blocks.
+     * @param blocks_count Number of IMA-ADPCM blocks.
+     * @param sample_rate Sample rate in Hz.
+     */
+    constexpr audio_stream_item(const uint8_t* data_ptr, int blocks_count, int sample_rate) :
+        _data_ptr(data_ptr),
+        _blocks_count(blocks_count),
+        _sample_rate(sample_rate)
+    {
+        BTN_ASSERT(data_ptr, "Data is null");
+        BTN_ASSERT(blocks_count > 0, "Invalid blocks count: ", blocks_count);
+        BTN_ASSERT(sample_rate > 0, "Invalid sample rate: ", sample_rate);
+    }
+
+    /**
+     * @brief Returns the pointer to the IMA-ADPCM blocks.
+     */
+    [[nodiscard]] constexpr const uint8_t* data_ptr() const
+    {
+        return _data_ptr;
+    }
+
+    /**
+     * @brief Returns the number of IMA-ADPCM blocks.
+     */
+    [[nodiscard]] constexpr int blocks_count() const
+    {
+        return _blocks_count;
+    }
+
+    /**
+     * @brief Returns the sample rate in Hz.
+     */
+    [[nodiscard]] constexpr int sample_rate() const
+    {
+        return _sample_rate;
+    }
+
+    /**
+     * @brief Plays the audio stream specified by this item with default settings.
+     *
+     * Default settings are volume = 1 and loop disabled.
+     */
+    void play() const;
+
+    /**
+     * @brief Plays the audio stream specified by this item.
+     * @param volume Volume level, in the range [0..1].
+     */
+    void play(fixed volume) const;
+
+    /**
+     * @brief Plays the audio stream specified by this item.
+     * @param volume Volume level, in the range [0..1].
+     * @param loop Indicates if it must be played until it is stopped manually or until end.
+     */
+    void play(fixed volume, bool loop) const;
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const audio_stream_item& a,
+                                                   const audio_stream_item& b) = default;
+
+private:
+    const uint8_t* _data_ptr;
+    int _blocks_count;
+    int _sample_rate;
+};
+
+}
+
+#endif
@@ -15,6 +15,7 @@
  */
 
 #include "btn_common.h"
+#include "btn_fixed_fwd.h"
 
 /**
  * @brief Background tiles related functions.
@@ -44,6 +45,17 @@ namespace btn::bg_tiles
      * that can be created with bg_tiles_ptr static constructors.
      */
     [[nodiscard]] int available_blocks_count();
+
+    /**
+     * @brief Returns the fragmentation of the available background blocks,
+     * in the range [0..1] (0 = not fragmented, 1 = fully fragmented).
+     *
+     * Background tiles and maps share the same blocks, so it is the same for both of them.
+     *
+     * It is reduced over multiple frames by moving used background tiles and maps to lower VRAM locations
+     * (see BTN_CFG_BG_BLOCKS_COMPACTION_MAX_BYTES_PER_FRAME).
+     */
+    [[nodiscard]] fixed fragmentation();
 }
 
 #endif
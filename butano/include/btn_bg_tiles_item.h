@@ -18,6 +18,7 @@
 #include "btn_span.h"
 #include "btn_tile.h"
 #include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
 #include "btn_palette_bpp_mode.h"
 
 namespace btn
@@ -49,7 +50,25 @@ public:
      * to avoid dangling references.
      */
     constexpr explicit bg_tiles_item(const span<const tile>& tiles_ref) :
-        _tiles_ref(tiles_ref)
+        bg_tiles_item(tiles_ref, compression_type::NONE)
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param tiles_ref Reference to one or more background tiles.
+     *
+     * If the tiles are compressed, tiles_ref data must point to the compressed data
+     * and tiles_ref size must be the number of tiles once decompressed.
+     *
+     * The tiles are not copied but referenced, so they should outlive the bg_tiles_item
+     * to avoid dangling references.
+     *
+     * @param compression Compression type of the referenced tiles.
+     */
+    constexpr bg_tiles_item(const span<const tile>& tiles_ref, compression_type compression) :
+        _tiles_ref(tiles_ref),
+        _compression(compression)
     {
         BTN_ASSERT(valid_tiles_count(palette_bpp_mode::BPP_4) || valid_tiles_count(palette_bpp_mode::BPP_8),
                    "Invalid tiles count: ", _tiles_ref.size());
@@ -66,6 +85,14 @@ public:
         return _tiles_ref;
     }
 
+    /**
+     * @brief Returns the compression type of the referenced tiles.
+     */
+    [[nodiscard]] constexpr compression_type compression() const
+    {
+        return _compression;
+    }
+
     /**
      * @brief Indicates if the referenced tiles are valid for the specified bits per pixel or not.
      */
@@ -148,7 +175,8 @@ public:
      */
     [[nodiscard]] constexpr friend bool operator==(const bg_tiles_item& a, const bg_tiles_item& b)
     {
-        return a._tiles_ref.data() == b._tiles_ref.data() && a._tiles_ref.size() == b._tiles_ref.size();
+        return a._tiles_ref.data() == b._tiles_ref.data() && a._tiles_ref.size() == b._tiles_ref.size() &&
+                a._compression == b._compression;
     }
 
     /**
@@ -164,6 +192,7 @@ public:
 
 private:
     span<const tile> _tiles_ref;
+    compression_type _compression;
 };
 
 }
@@ -251,7 +251,8 @@ public:
     [[nodiscard]] bool valid_tiles_count(palette_bpp_mode bpp_mode) const;
 
     /**
-     * @brief Returns the referenced tiles unless it was created with allocate or allocate_optional.
+     * @brief Returns the referenced tiles unless it was created with allocate or allocate_optional,
+     * or the referenced tiles are compressed.
      * In that case, it returns `nullopt`.
      */
     [[nodiscard]] optional<span<const tile>> tiles_ref() const;
@@ -278,6 +279,10 @@ public:
      * Remember also that the tiles are not copied but referenced,
      * so they should outlive the bg_tiles_ptr to avoid dangling references.
      *
+     * If the tiles are compressed and they don't fit in the VRAM commits budget,
+     * they are decompressed over multiple frames in an EWRAM buffer,
+     * and the previous tiles are displayed until the new ones are copied to VRAM at once.
+     *
      * @param tiles_item bg_tiles_item which references the tiles to handle.
      */
     void set_tiles_ref(const bg_tiles_item& tiles_item);
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_COLLISION_GRID_H
+#define BTN_COLLISION_GRID_H
+
+/**
+ * @file
+ * btn::icollision_grid and btn::collision_grid header file.
+ *
+ * @ingroup collision
+ */
+
+#include "btn_vector.h"
+#include "btn_utility.h"
+#include "btn_fixed_rect.h"
+#include "btn_power_of_two.h"
+
+namespace btn
+{
+
+/**
+ * @brief Base class of collision_grid.
+ *
+ * Broad-phase collision structure: it splits the space in a uniform grid of square cells,
+ * and each rectangle is stored in the cell which contains its center.
+ *
+ * Rectangles can't be bigger than a cell, so queries only have to check the cells which overlap them,
+ * plus one cell around them.
+ *
+ * Rectangles outside the grid are stored in its border cells.
+ *
+ * Queries don't allocate memory and they are executed from IWRAM.
+ *
+ * @ingroup collision
+ */
+class icollision_grid
+{
+
+public:
+    icollision_grid(const icollision_grid& other) = delete;
+
+    icollision_grid& operator=(const icollision_grid& other) = delete;
+
+    /**
+     * @brief Returns the number of stored rectangles.
+     */
+    [[nodiscard]] int size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the maximum number of stored rectangles.
+     */
+    [[nodiscard]] int max_size() const
+    {
+        return _max_size;
+    }
+
+    /**
+     * @brief Indicates if it doesn't contain any rectangle.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Indicates if it can't contain any more rectangles.
+     */
+    [[nodiscard]] bool full() const
+    {
+        return _size == _max_size;
+    }
+
+    /**
+     * @brief Returns the number of columns of the grid.
+     */
+    [[nodiscard]] int columns() const
+    {
+        return _columns;
+    }
+
+    /**
+     * @brief Returns the number of rows of the grid.
+     */
+    [[nodiscard]] int rows() const
+    {
+        return _rows;
+    }
+
+    /**
+     * @brief Returns the size in pixels of each cell of the grid.
+     */
+    [[nodiscard]] int cell_size() const
+    {
+        return 1 << _cell_size_shift;
+    }
+
+    /**
+     * @brief Indicates if the given rectangle id is stored or not.
+     */
+    [[nodiscard]] bool contains(int id) const
+    {
+        return id >= 0 && id < _max_size && _items[id].cell >= 0;
+    }
+
+    /**
+     * @brief Returns the rectangle with the given id.
+     */
+    [[nodiscard]] fixed_rect rect(int id) const;
+
+    /**
+     * @brief Stores a rectangle.
+     * @param rect Rectangle to store. It can't be bigger than a cell.
+     * @return Id of the stored rectangle.
+     */
+    [[nodiscard]] int add(const fixed_rect& rect);
+
+    /**
+     * @brief Moves or resizes a stored rectangle.
+     *
+     * The rectangle is moved to another cell only if its center changes of cell.
+     *
+     * @param id Id of the rectangle to update.
+     * @param rect New rectangle. It can't be bigger than a cell.
+     */
+    BTN_CODE_IWRAM void set_rect(int id, const fixed_rect& rect);
+
+    /**
+     * @brief Removes the rectangle with the given id.
+     */
+    void remove(int id);
+
+    /**
+     * @brief Removes all stored rectangles.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the id of a stored rectangle which intersects with the given one,
+     * or -1 if there's no stored rectangle which intersects with it.
+     */
+    [[nodiscard]] BTN_CODE_IWRAM int intersecting(const fixed_rect& rect) const;
+
+    /**
+     * @brief Retrieves the ids of the stored rectangles which intersect with the given one.
+     * @param rect Rectangle to check.
+     * @param ids The found ids are stored in this vector.
+     *
+     * Keep in mind that this vector is not cleared before storing the ids.
+     *
+     * @return `true` if all found ids fit in the given vector, otherwise `false`.
+     */
+    BTN_CODE_IWRAM bool intersecting(const fixed_rect& rect, ivector<int>& ids) const;
+
+    /**
+     * @brief Retrieves the pairs of stored rectangles which intersect between them.
+     * @param pairs The found pairs of ids are stored in this vector (the first id is always less than the second).
+     *
+     * Keep in mind that this vector is not cleared before storing the pairs.
+     *
+     * @return `true` if all found pairs fit in the given vector, otherwise `false`.
+     */
+    BTN_CODE_IWRAM bool intersecting_pairs(ivector<pair<int, int>>& pairs) const;
+
+    /**
+     * @brief Retrieves the pairs of rectangles of this grid and of another one which intersect between them.
+     * @param other Another collision grid.
+     * @param pairs The found pairs of ids are stored in this vector
+     * (the first id is from this grid and the second one is from the other grid).
+     *
+     * Keep in mind that this vector is not cleared before storing the pairs.
+     *
+     * @return `true` if all found pairs fit in the given vector, otherwise `false`.
+     */
+    BTN_CODE_IWRAM bool intersecting_pairs(const icollision_grid& other, ivector<pair<int, int>>& pairs) const;
+
+protected:
+    /// @cond DO_NOT_DOCUMENT
+
+    class item_type
+    {
+
+    public:
+        int left;
+        int top;
+        int right;
+        int bottom;
+        int16_t prev;
+        int16_t next;
+        int16_t cell;
+    };
+
+    icollision_grid(item_type* items, int16_t* cells, int max_size, int columns, int rows, int cell_size_shift) :
+        _items(items),
+        _cells(cells),
+        _max_size(max_size),
+        _columns(columns),
+        _rows(rows),
+        _cell_size_shift(cell_size_shift)
+    {
+    }
+
+    /// @endcond
+
+private:
+    item_type* _items;
+    int16_t* _cells;
+    int _max_size;
+    int _columns;
+    int _rows;
+    int _cell_size_shift;
+    int _size = 0;
+    int _free_id = 0;
+
+    BTN_CODE_IWRAM void _place(int id, const fixed_rect& rect);
+
+    BTN_CODE_IWRAM void _unlink(int id);
+
+    template<typename Function>
+    bool _for_each_intersecting(int left, int top, int right, int bottom, const Function& function) const;
+};
+
+
+/**
+ * @brief Broad-phase collision structure with a fixed capacity.
+ *
+ * It splits the space in a uniform grid of square cells centered in the origin,
+ * and each rectangle is stored in the cell which contains its center.
+ *
+ * @tparam MaxSize Maximum number of stored rectangles.
+ * @tparam Columns Number of columns of the grid.
+ * @tparam Rows Number of rows of the grid.
+ * @tparam CellSize Size in pixels of each cell of the grid (it must be a power of two).
+ *
+ * @ingroup collision
+ */
+template<int MaxSize, int Columns, int Rows, int CellSize>
+class collision_grid : public icollision_grid
+{
+    static_assert(MaxSize > 0 && MaxSize <= INT16_MAX);
+    static_assert(Columns > 0 && Rows > 0 && Columns * Rows <= INT16_MAX);
+    static_assert(CellSize > 0 && power_of_two(CellSize));
+
+public:
+    /**
+     * @brief Default constructor.
+     */
+    collision_grid() :
+        icollision_grid(_items_array, _cells_array, MaxSize, Columns, Rows, _cell_size_shift())
+    {
+        clear();
+    }
+
+private:
+    item_type _items_array[MaxSize];
+    int16_t _cells_array[Columns * Rows];
+
+    [[nodiscard]] static constexpr int _cell_size_shift()
+    {
+        int result = 0;
+
+        while((1 << result) < CellSize)
+        {
+            ++result;
+        }
+
+        return result;
+    }
+};
+
+}
+
+#endif
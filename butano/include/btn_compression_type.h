@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_COMPRESSION_TYPE_H
+#define BTN_COMPRESSION_TYPE_H
+
+/**
+ * @file
+ * btn::compression_type header file.
+ *
+ * @ingroup tool
+ */
+
+#include "btn_common.h"
+
+namespace btn
+{
+
+/**
+ * @brief Specifies the available compression types.
+ *
+ * Compressed data must have the same format as the one expected by the GBA BIOS decompression functions:
+ * a 32-bit header with the compression type in bits 4-7 and the decompressed size in bits 8-31.
+ *
+ * @ingroup tool
+ */
+enum class compression_type : uint8_t
+{
+    NONE, //!< Uncompressed data.
+    LZ77, //!< LZ77 compressed data.
+    RUN_LENGTH, //!< Run-length encoded data.
+    HUFFMAN //!< Huffman compressed data.
+};
+
+}
+
+#endif
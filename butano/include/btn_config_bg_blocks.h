@@ -26,6 +26,23 @@
     #define BTN_CFG_BG_BLOCKS_MAX_ITEMS 16
 #endif
 
+/**
+ * @def BTN_CFG_BG_BLOCKS_COMPACTION_MAX_BYTES_PER_FRAME
+ *
+ * Specifies the maximum number of bytes that can be copied in a V-Blank period
+ * to move background tile sets and maps to the free space before them.
+ *
+ * Moving tile sets and maps merges free space fragments, so bigger ones can be created later.
+ * Allocated tile sets and maps are never moved, and tile sets keep their offset in their character base block.
+ *
+ * Set it to 0 to disable background blocks compaction.
+ *
+ * @ingroup bg
+ */
+#ifndef BTN_CFG_BG_BLOCKS_COMPACTION_MAX_BYTES_PER_FRAME
+    #define BTN_CFG_BG_BLOCKS_COMPACTION_MAX_BYTES_PER_FRAME 8192
+#endif
+
 /**
  * @def BTN_CFG_BG_BLOCKS_LOG_ENABLED
  *
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_CONFIG_CORE_H
+#define BTN_CONFIG_CORE_H
+
+/**
+ * @file
+ * Core configuration header file.
+ *
+ * @ingroup core
+ */
+
+#include "btn_common.h"
+
+/**
+ * @def BTN_CFG_CORE_BENCHMARK_FRAMES
+ *
+ * Specifies the number of frames whose CPU and V-Blank usage are logged for butano-benchmark-tool.
+ *
+ * They are logged when the specified number of frames have been updated.
+ * If the profiler is enabled, its results are logged too.
+ *
+ * If it is zero, nothing is logged.
+ *
+ * @ingroup core
+ */
+#ifndef BTN_CFG_CORE_BENCHMARK_FRAMES
+    #define BTN_CFG_CORE_BENCHMARK_FRAMES 0
+#endif
+
+/**
+ * @def BTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS
+ *
+ * If it is defined, core::init() replays these keypad commands (recorded with the keypad logger)
+ * instead of reading the keypad of the GBA.
+ *
+ * @ingroup core
+ */
+#if BTN_DOXYGEN
+    #define BTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS ""
+#endif
+
+#endif
@@ -13,7 +13,7 @@
  * @ingroup hblank_effect
  */
 
-#include "btn_common.h"
+#include "btn_hblank_effects_backend.h"
 
 /**
  * @def BTN_CFG_HBLANK_EFFECTS_MAX_ITEMS
@@ -26,4 +26,19 @@
     #define BTN_CFG_HBLANK_EFFECTS_MAX_ITEMS 8
 #endif
 
+/**
+ * @def BTN_CFG_HBLANK_EFFECTS_BACKEND
+ *
+ * Specifies how H-Blank effects are committed to the hardware.
+ *
+ * Values not specified in BTN_HBLANK_EFFECTS_BACKEND_* macros are not allowed.
+ *
+ * Their CPU cost can be compared with btn::core::cpu_usage.
+ *
+ * @ingroup hblank_effect
+ */
+#ifndef BTN_CFG_HBLANK_EFFECTS_BACKEND
+    #define BTN_CFG_HBLANK_EFFECTS_BACKEND BTN_HBLANK_EFFECTS_BACKEND_HDMA
+#endif
+
 #endif
@@ -50,4 +50,33 @@
     #define BTN_CFG_LOG_MAX_SIZE 0x100
 #endif
 
+/**
+ * @def BTN_CFG_LOG_DEFERRED
+ *
+ * Specifies if BTN_LOG calls are deferred or not.
+ *
+ * Deferred BTN_LOG calls don't build any text: they only store a format id and the raw values of their parameters
+ * in a ring buffer, which is written to the log backend when core::update() has idle time.
+ *
+ * Messages are rebuilt with the butano-log-tool.py script.
+ *
+ * @ingroup log
+ */
+#ifndef BTN_CFG_LOG_DEFERRED
+    #define BTN_CFG_LOG_DEFERRED false
+#endif
+
+/**
+ * @def BTN_CFG_LOG_DEFERRED_BUFFER_SIZE
+ *
+ * Specifies the size in bytes of the ring buffer used by deferred BTN_LOG calls.
+ *
+ * Messages which don't fit in it are discarded and counted.
+ *
+ * @ingroup log
+ */
+#ifndef BTN_CFG_LOG_DEFERRED_BUFFER_SIZE
+    #define BTN_CFG_LOG_DEFERRED_BUFFER_SIZE 0x1000
+#endif
+
 #endif
@@ -16,15 +16,30 @@
 #include "btn_common.h"
 
 /**
- * @def BTN_CFG_MEMORY_MAX_EWRAM_ALLOC_ITEMS
+ * @def BTN_CFG_MEMORY_EWRAM_POOLS_COUNT
  *
- * Specifies the maximum number of memory blocks that can be allocated in EWRAM with
- * btn::malloc, btn::memory::ewram_alloc and the new operator.
+ * Specifies the number of small blocks pools used by btn::malloc, btn::memory::ewram_alloc and the new operator.
+ *
+ * Each pool stores blocks of a fixed size (4 bytes, 8 bytes, 12 bytes...), so blocks smaller or equal than
+ * BTN_CFG_MEMORY_EWRAM_POOLS_COUNT * 4 bytes (including a 4 bytes header) are allocated and deallocated faster.
+ *
+ * If it is 0, pools are disabled.
+ *
+ * @ingroup memory
+ */
+#ifndef BTN_CFG_MEMORY_EWRAM_POOLS_COUNT
+    #define BTN_CFG_MEMORY_EWRAM_POOLS_COUNT 16
+#endif
+
+/**
+ * @def BTN_CFG_MEMORY_EWRAM_POOL_PAGE_CHUNKS
+ *
+ * Specifies the number of blocks allocated at once by each small blocks pool.
  *
  * @ingroup memory
  */
-#ifndef BTN_CFG_MEMORY_MAX_EWRAM_ALLOC_ITEMS
-    #define BTN_CFG_MEMORY_MAX_EWRAM_ALLOC_ITEMS 16
+#ifndef BTN_CFG_MEMORY_EWRAM_POOL_PAGE_CHUNKS
+    #define BTN_CFG_MEMORY_EWRAM_POOL_PAGE_CHUNKS 16
 #endif
 
 #endif
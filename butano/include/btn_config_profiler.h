@@ -48,4 +48,28 @@
     #define BTN_CFG_PROFILER_MAX_ENTRIES 32
 #endif
 
+/**
+ * @def BTN_CFG_PROFILER_MAX_DEPTH
+ *
+ * Specifies the maximum number of code blocks that can be profiled at the same time (nested code blocks).
+ *
+ * @ingroup profiler
+ */
+#ifndef BTN_CFG_PROFILER_MAX_DEPTH
+    #define BTN_CFG_PROFILER_MAX_DEPTH 8
+#endif
+
+/**
+ * @def BTN_CFG_PROFILER_MAX_FRAMES
+ *
+ * Specifies the number of frames whose elapsed ticks are stored for each code block.
+ *
+ * Percentiles and spikes are calculated from them.
+ *
+ * @ingroup profiler
+ */
+#ifndef BTN_CFG_PROFILER_MAX_FRAMES
+    #define BTN_CFG_PROFILER_MAX_FRAMES 64
+#endif
+
 #endif
@@ -27,6 +27,24 @@
     #define BTN_CFG_SPRITE_TILES_MAX_ITEMS 128
 #endif
 
+/**
+ * @def BTN_CFG_SPRITE_TILES_COMPACTION_MAX_BYTES_PER_FRAME
+ *
+ * Specifies the maximum number of bytes that can be copied in a V-Blank period
+ * to move sprite tile sets to the free space before them.
+ *
+ * Moving tile sets merges free space fragments, so bigger tile sets can be created later.
+ * Allocated tile sets are never moved, and sprite third attributes H-Blank effects are not updated when
+ * their tile sets are moved.
+ *
+ * Set it to 0 to disable sprite tiles compaction.
+ *
+ * @ingroup sprite
+ */
+#ifndef BTN_CFG_SPRITE_TILES_COMPACTION_MAX_BYTES_PER_FRAME
+    #define BTN_CFG_SPRITE_TILES_COMPACTION_MAX_BYTES_PER_FRAME 4096
+#endif
+
 /**
  * @def BTN_CFG_SPRITE_TILES_LOG_ENABLED
  *
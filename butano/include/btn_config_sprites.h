@@ -43,4 +43,34 @@
     #define BTN_CFG_SPRITES_MAX_SORT_LAYERS 16
 #endif
 
+/**
+ * @def BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT
+ *
+ * Specifies the height in pixels of the horizontal screen bands used by the sprites multiplexer
+ * (see btn::sprites::set_multiplexer_enabled).
+ *
+ * Smaller bands allow to reuse hardware sprites sooner, but more interrupts are needed to rewrite them.
+ *
+ * @ingroup sprite
+ */
+#ifndef BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT
+    #define BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT 32
+#endif
+
+/**
+ * @def BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES
+ *
+ * Specifies the maximum number of hardware sprites which can be rewritten before each horizontal screen band
+ * by the sprites multiplexer (see btn::sprites::set_multiplexer_enabled).
+ *
+ * Hardware sprites are rewritten in one H-Blank, which only has time for about a dozen of them.
+ * If more are rewritten, the last ones are written while the sprites of the band are being processed,
+ * so they are displayed torn or not displayed at all.
+ *
+ * @ingroup sprite
+ */
+#ifndef BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES
+    #define BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES 12
+#endif
+
 #endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_CONFIG_VRAM_COMMITS_H
+#define BTN_CONFIG_VRAM_COMMITS_H
+
+/**
+ * @file
+ * VRAM commits configuration header file.
+ *
+ * @ingroup core
+ */
+
+#include "btn_common.h"
+
+/**
+ * @def BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME
+ *
+ * Specifies the default maximum number of bytes that can be uploaded to VRAM in a V-Blank period.
+ *
+ * Uploads that don't fit in this budget are delayed to the next frames.
+ *
+ * @ingroup core
+ */
+#ifndef BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME
+    #define BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME 16384
+#endif
+
+/**
+ * @def BTN_CFG_VRAM_COMMITS_MAX_DEFERRED_FRAMES
+ *
+ * Specifies the maximum number of frames that an upload can be delayed.
+ *
+ * When this limit is reached, the upload is done even if it doesn't fit in the V-Blank budget.
+ *
+ * @ingroup core
+ */
+#ifndef BTN_CFG_VRAM_COMMITS_MAX_DEFERRED_FRAMES
+    #define BTN_CFG_VRAM_COMMITS_MAX_DEFERRED_FRAMES 4
+#endif
+
+#endif
@@ -35,6 +35,9 @@ namespace btn::core
 {
     /**
      * @brief This function must be called before using butano, and it must be called only once.
+     *
+     * If BTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS is defined, its keypad commands are replayed
+     * instead of reading the keypad of the GBA.
      */
     void init();
 
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_DEFERRED_LOG_H
+#define BTN_DEFERRED_LOG_H
+
+/**
+ * @file
+ * Deferred BTN_LOG calls header file.
+ *
+ * @ingroup log
+ */
+
+#include "btn_config_log.h"
+
+#if (BTN_CFG_LOG_ENABLED && BTN_CFG_LOG_DEFERRED) || BTN_DOXYGEN
+    #include "btn_memory.h"
+    #include "btn_sstream.h"
+    #include "btn_string_view.h"
+    #include "btn_type_traits.h"
+    #include "btn_istring_base.h"
+
+    /**
+     * @brief Deferred BTN_LOG calls related functions.
+     *
+     * Enabled when BTN_CFG_LOG_DEFERRED is true.
+     *
+     * @ingroup log
+     */
+    namespace btn::deferred_log
+    {
+        /**
+         * @brief Writes all pending messages to the log backend.
+         *
+         * Pending messages are written by core::update() only when it has idle time,
+         * so this function allows to make sure that they are written before a long operation or a reset.
+         */
+        void flush();
+
+        /**
+         * @brief Returns the number of messages discarded because they didn't fit in the ring buffer.
+         */
+        [[nodiscard]] int dropped_messages_count();
+    }
+
+    /// @cond DO_NOT_DOCUMENT
+
+    namespace _btn::deferred_log
+    {
+        // Each message is stored as the address of its format followed by the raw values of its parameters.
+        // The format is a null terminated array with the tag of each parameter, so its address identifies
+        // the types of the parameters.
+        //
+        // Parameters are stored in words:
+        // 'b' bool, 'c' char, 'i' signed integer, 'u' unsigned integer, 'p' pointer: one word.
+        // 'l' signed 64-bit integer, 'L' unsigned 64-bit integer: two words (low word first).
+        // 'n' nullptr: no words.
+        // 's' char array: its ROM address, or 0 followed by a text if it is not stored in ROM.
+        // 't' text: its size in characters, followed by its characters.
+        // fixed_tag + precision: fixed point value.
+        //
+        // Parameters of other types are stored as text built with ostringstream.
+
+        constexpr const unsigned char fixed_tag = 0x80;
+
+        // Returns nullptr if the ring buffer doesn't have enough space:
+        [[nodiscard]] unsigned* reserve(int words);
+
+        void idle_flush();
+
+        [[nodiscard]] inline bool rom_address(const void* ptr)
+        {
+            auto address = uintptr_t(ptr);
+            return address >= 0x08000000 && address < 0x0A000000;
+        }
+
+        [[nodiscard]] constexpr int text_words(int size)
+        {
+            return 1 + ((size + 3) / 4);
+        }
+
+        inline unsigned* write_text(const char* data, int size, unsigned* output)
+        {
+            *output = unsigned(size);
+            ++output;
+
+            if(size)
+            {
+                _btn::memory::unsafe_copy_bytes(data, size, output);
+            }
+
+            return output + ((size + 3) / 4);
+        }
+
+        template<typename Type>
+        class arg_traits
+        {
+
+        public:
+            static constexpr const unsigned char tag = 't';
+
+            [[nodiscard]] static int words(const Type& value)
+            {
+                return text_words(_text(value).size());
+            }
+
+            static unsigned* write(const Type& value, unsigned* output)
+            {
+                const btn::istring_base& text = _text(value);
+                return write_text(text.data(), text.size(), output);
+            }
+
+        private:
+            [[nodiscard]] static const btn::istring_base& _text(const Type& value)
+            {
+                // Built for each call, since these parameters should not be used in hot paths:
+                static char buffer[BTN_CFG_LOG_MAX_SIZE];
+                static btn::istring_base text(buffer);
+                text.clear();
+
+                btn::ostringstream stream(text);
+                stream << value;
+                return text;
+            }
+        };
+
+        template<typename Type> requires(btn::is_integral_v<Type> && sizeof(Type) <= 4)
+        class arg_traits<Type>
+        {
+
+        public:
+            static constexpr const unsigned char tag = btn::is_signed_v<Type> ? 'i' : 'u';
+
+            [[nodiscard]] static constexpr int words(Type)
+            {
+                return 1;
+            }
+
+            static unsigned* write(Type value, unsigned* output)
+            {
+                *output = unsigned(value);
+                return output + 1;
+            }
+        };
+
+        template<typename Type> requires(btn::is_integral_v<Type> && sizeof(Type) == 8)
+        class arg_traits<Type>
+        {
+
+        public:
+            static constexpr const unsigned char tag = btn::is_signed_v<Type> ? 'l' : 'L';
+
+            [[nodiscard]] static constexpr int words(Type)
+            {
+                return 2;
+            }
+
+            static unsigned* write(Type value, unsigned* output)
+            {
+                auto unsigned_value = uint64_t(value);
+                output[0] = unsigned(unsigned_value);
+                output[1] = unsigned(unsigned_value >> 32);
+                return output + 2;
+            }
+        };
+
+        template<>
+        class arg_traits<bool>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 'b';
+
+            [[nodiscard]] static constexpr int words(bool)
+            {
+                return 1;
+            }
+
+            static unsigned* write(bool value, unsigned* output)
+            {
+                *output = value;
+                return output + 1;
+            }
+        };
+
+        template<>
+        class arg_traits<char>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 'c';
+
+            [[nodiscard]] static constexpr int words(char)
+            {
+                return 1;
+            }
+
+            static unsigned* write(char value, unsigned* output)
+            {
+                *output = uint8_t(value);
+                return output + 1;
+            }
+        };
+
+        template<int Precision>
+        class arg_traits<btn::fixed_t<Precision>>
+        {
+
+        public:
+            static constexpr const unsigned char tag = fixed_tag + Precision;
+
+            [[nodiscard]] static constexpr int words(btn::fixed_t<Precision>)
+            {
+                return 1;
+            }
+
+            static unsigned* write(btn::fixed_t<Precision> value, unsigned* output)
+            {
+                *output = unsigned(value.data());
+                return output + 1;
+            }
+        };
+
+        template<>
+        class arg_traits<btn::nullptr_t>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 'n';
+
+            [[nodiscard]] static constexpr int words(btn::nullptr_t)
+            {
+                return 0;
+            }
+
+            static unsigned* write(btn::nullptr_t, unsigned* output)
+            {
+                return output;
+            }
+        };
+
+        template<typename Type>
+        class arg_traits<Type*>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 'p';
+
+            [[nodiscard]] static constexpr int words(const Type*)
+            {
+                return 1;
+            }
+
+            static unsigned* write(const Type* value, unsigned* output)
+            {
+                *output = unsigned(uintptr_t(value));
+                return output + 1;
+            }
+        };
+
+        template<>
+        class arg_traits<const char*>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 's';
+
+            [[nodiscard]] static int words(const char* value)
+            {
+                // Text literals are stored in ROM, so only their address is needed:
+                return rom_address(value) ? 1 : 1 + text_words(btn::string_view(value).size());
+            }
+
+            static unsigned* write(const char* value, unsigned* output)
+            {
+                if(rom_address(value))
+                {
+                    *output = unsigned(uintptr_t(value));
+                    return output + 1;
+                }
+
+                *output = 0;
+
+                btn::string_view view(value);
+                return write_text(view.data(), view.size(), output + 1);
+            }
+        };
+
+        template<>
+        class arg_traits<char*> : public arg_traits<const char*>
+        {
+        };
+
+        template<int Size>
+        class arg_traits<char[Size]> : public arg_traits<const char*>
+        {
+        };
+
+        template<>
+        class arg_traits<btn::string_view>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 't';
+
+            [[nodiscard]] static constexpr int words(const btn::string_view& value)
+            {
+                return text_words(value.size());
+            }
+
+            static unsigned* write(const btn::string_view& value, unsigned* output)
+            {
+                return write_text(value.data(), value.size(), output);
+            }
+        };
+
+        template<typename Type> requires(btn::is_base_of_v<btn::istring_base, Type>)
+        class arg_traits<Type>
+        {
+
+        public:
+            static constexpr const unsigned char tag = 't';
+
+            [[nodiscard]] static int words(const btn::istring_base& value)
+            {
+                return text_words(value.size());
+            }
+
+            static unsigned* write(const btn::istring_base& value, unsigned* output)
+            {
+                return write_text(value.data(), value.size(), output);
+            }
+        };
+
+        template<typename... Args>
+        inline constexpr const unsigned char format[] = { arg_traits<Args>::tag..., 0 };
+
+        template<typename... Args>
+        void write(const Args&... args)
+        {
+            int words = (1 + ... + arg_traits<Args>::words(args));
+
+            if(unsigned* output = reserve(words))
+            {
+                *output = unsigned(uintptr_t(format<Args...>));
+                ++output;
+                ((output = arg_traits<Args>::write(args, output)), ...);
+            }
+        }
+    }
+
+    /// @endcond
+#endif
+
+#endif
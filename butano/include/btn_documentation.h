@@ -186,6 +186,15 @@
  * @ingroup audio
  */
 
+/**
+ * @defgroup audio_stream Audio streams
+ *
+ * Long waveform audio files (like voices or recorded music) compressed as IMA-ADPCM,
+ * decoded a few samples at a time and mixed with Maxmod output.
+ *
+ * @ingroup audio
+ */
+
 /**
  * @defgroup keypad Keypad
  *
@@ -240,6 +249,12 @@
  * @ingroup display
  */
 
+/**
+ * @defgroup collision Collisions
+ *
+ * Broad-phase collision detection between rectangles.
+ */
+
 /**
  * @defgroup memory Memory
  *
@@ -287,6 +302,10 @@
  *
  * It supports printing on only one emulator at once.
  * The supported emulator can be changed by overloading the definition of @a BTN_CFG_LOG_BACKEND @a .
+ *
+ * If @a BTN_CFG_LOG_DEFERRED @a is true, BTN_LOG calls only store their parameters in a ring buffer,
+ * which is written to the log when there's idle time. The messages are rebuilt from the emulator log
+ * and the ROM with `tools/butano-log-tool.py --input <log file> --rom <ROM file>`.
  */
 
 /**
@@ -870,6 +889,17 @@
  * * `"type"`: must be `"sprite"` for sprites.
  * * `"height"`: height of each sprite image in pixels.
  * For example, if the specified height is 32, an image with 128 pixels of height contains 4 sprite images.
+ * * `"tiles_deduplication"`: optional field which indicates if repeated and flipped tiles of all sprite images
+ * must be stored only once (16 color images only). Only the tiles that change are copied to VRAM
+ * when the sprite image is changed, so it is recommended for big animated sprites. It is `false` by default.
+ * * `"compression"`: optional field which specifies the compression of the tiles data:
+ *   * `"none"`: uncompressed data (the default).
+ *   * `"lz77"`: LZ77 compressed data.
+ *   * `"run_length"`: run-length encoded data.
+ *   * `"huffman"`: Huffman compressed data.
+ * Compressed sprites must contain only one sprite image and can't be deduplicated.
+ * Compressed tiles which don't fit in the VRAM upload budget of a frame are decompressed over multiple frames
+ * in an EWRAM buffer, and then copied to VRAM at once.
  *
  * If the conversion process has finished successfully,
  * a btn::sprite_item should have been generated in the `build` folder.
@@ -899,11 +929,18 @@
  * * `"bpp_mode"`: optional field which specifies the bits per pixel of the regular background:
  *   * `"bpp_8"`: up to 256 colors per @ref tile "tile".
  *   * `"bpp_4_auto"`: up to 16 colors per @ref tile "tile".
- * Butano tries to quantize the image to fit the color palette into the required one.
+ * Butano tries to quantize the image to fit the color palette into the required one:
+ * the colors of each tile are packed into up to 16 palettes of 16 colors, and the palette of each tile
+ * is stored in the map.
  *   * `"bpp_4_manual"`: up to 16 colors per @ref tile "tile".
  * Butano expects that the image color palette is already valid for this mode.
  *
  * The default is `"bpp_4_manual"` for 16 color images and `"bpp_8"` for 256 color images.
+ * * `"tile_colors_reduction"`: optional field which specifies if the tiles with more than 15 colors
+ * (plus the transparent one) should be reduced in `"bpp_4_auto"` mode by replacing their less used colors
+ * with the closest remaining ones. The default is `false`.
+ * * `"compression"`: optional field which specifies the compression of the tiles and map data.
+ * Valid values are the same as for sprites. Big backgrounds can't be compressed.
  *
  * If the conversion process has finished successfully,
  * a btn::regular_bg_item should have been generated in the `build` folder.
@@ -964,6 +1001,47 @@
  * @code{.cpp}
  * btn::sound_items::sfx.play();
  * @endcode
+ *
+ *
+ * @subsection import_audio_stream Audio streams
+ *
+ * Waveform audio files (8 or 16-bits, mono or stereo) are imported as audio streams instead of sound effects
+ * if they come with a JSON file with the same name and the `*.json` extension:
+ *
+ * @code{.json}
+ * {
+ *     "type": "stream",
+ *     "sample_rate": 16000
+ * }
+ * @endcode
+ *
+ * The `sample_rate` field is optional. If it is specified, the audio file is resampled to it
+ * (the maximum sample rate is 32768 Hz).
+ *
+ * Audio streams are compressed as mono IMA-ADPCM (4-bits per sample), and only one of them can be played
+ * at the same time, alongside music and sound effects.
+ *
+ * If the conversion process has finished successfully,
+ * a bunch of btn::audio_stream_item objects under the `btn::audio_stream_items` namespace
+ * should have been generated in the `build` folder for all audio stream files.
+ * You can use these items to play audio streams with only one line of C++ code:
+ *
+ * @code{.cpp}
+ * btn::audio_stream_items::voice.play();
+ * @endcode
+ *
+ *
+ * @section import_cache Build cache
+ *
+ * Assets are processed in parallel, and only when their contents change (touching a file doesn't rebuild it).
+ *
+ * Generated files are stored in a cache indexed by the contents of their input files,
+ * so switching branches or cleaning the `build` folder doesn't process the same assets again.
+ * The cache is stored in the `build/_btn_asset_cache` folder by default,
+ * but it can be shared between multiple clones of the same project by setting the `BUTANO_ASSET_CACHE`
+ * environment variable to the path of another folder.
+ *
+ * Music and sound effects are processed together by mmutil, so changing one of them processes all of them again.
  */
 
 
@@ -219,7 +219,7 @@ struct hash<Type*>
      */
     [[nodiscard]] constexpr unsigned operator()(const Type* ptr) const
     {
-        return hash<unsigned>()(unsigned(ptr));
+        return hash<unsigned>()(unsigned(reinterpret_cast<uintptr_t>(ptr)));
     }
 };
 
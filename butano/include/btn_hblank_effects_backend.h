@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_HBLANK_EFFECTS_BACKEND_H
+#define BTN_HBLANK_EFFECTS_BACKEND_H
+
+/**
+ * @file
+ * Available H-Blank effects backends header file.
+ *
+ * @ingroup hblank_effect
+ */
+
+#include "btn_common.h"
+
+/**
+ * @def BTN_HBLANK_EFFECTS_BACKEND_IRQ
+ *
+ * H-Blank effects are committed by an interrupt handler called in every scanline.
+ *
+ * @ingroup hblank_effect
+ */
+#define BTN_HBLANK_EFFECTS_BACKEND_IRQ  0
+
+/**
+ * @def BTN_HBLANK_EFFECTS_BACKEND_HDMA
+ *
+ * H-Blank effects are committed by DMA channels triggered in every scanline (HDMA).
+ *
+ * Since only two DMA channels are available (DMA0 and DMA3, the other ones are used by the audio mixer),
+ * the remaining H-Blank effects are committed by an interrupt handler called in every scanline.
+ *
+ * @ingroup hblank_effect
+ */
+#define BTN_HBLANK_EFFECTS_BACKEND_HDMA 1
+
+#endif
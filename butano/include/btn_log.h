@@ -40,6 +40,9 @@
  * }
  * @endcode
  *
+ * If BTN_CFG_LOG_DEFERRED is true, the text is not built by this call: the parameters are stored in a ring buffer
+ * and written to the log backend later (see btn::deferred_log).
+ *
  * @ingroup log
  */
 
@@ -47,15 +50,25 @@
     #include "btn_sstream.h"
     #include "btn_istring_base.h"
 
-    #define BTN_LOG(...) \
-        do \
-        { \
-            char _btn_string[BTN_CFG_LOG_MAX_SIZE]; \
-            btn::istring_base _btn_istring(_btn_string); \
-            btn::ostringstream _btn_string_stream(_btn_istring); \
-            _btn_string_stream.append_args(__VA_ARGS__); \
-            btn::log(_btn_istring); \
-        } while(false)
+    #if BTN_CFG_LOG_DEFERRED
+        #include "btn_deferred_log.h"
+
+        #define BTN_LOG(...) \
+            do \
+            { \
+                _btn::deferred_log::write(__VA_ARGS__); \
+            } while(false)
+    #else
+        #define BTN_LOG(...) \
+            do \
+            { \
+                char _btn_string[BTN_CFG_LOG_MAX_SIZE]; \
+                btn::istring_base _btn_istring(_btn_string); \
+                btn::ostringstream _btn_string_stream(_btn_istring); \
+                _btn_string_stream.append_args(__VA_ARGS__); \
+                btn::log(_btn_istring); \
+            } while(false)
+    #endif
 
     namespace btn
     {
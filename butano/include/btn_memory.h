@@ -14,6 +14,7 @@
  * @ingroup memory
  */
 
+#include "btn_fixed.h"
 #include "btn_assert.h"
 #include "btn_utility.h"
 #include "btn_alignment.h"
@@ -481,9 +482,36 @@ namespace btn::memory
 
     /**
      * @brief Returns the items that still can be allocated in EWRAM with ewram_alloc.
+     *
+     * There's no fixed limit of items, so it returns the items that could be allocated
+     * if they were as small as possible.
      */
     [[nodiscard]] int available_items_ewram();
 
+    /**
+     * @brief Returns the size in bytes of the biggest item that can be allocated in EWRAM with ewram_alloc
+     * without using the small items pools.
+     */
+    [[nodiscard]] int largest_available_alloc_ewram();
+
+    /**
+     * @brief Returns the number of free (not contiguous) memory blocks in EWRAM.
+     */
+    [[nodiscard]] int free_blocks_ewram();
+
+    /**
+     * @brief Returns the bytes reserved in EWRAM by the small items pools, including not allocated items.
+     */
+    [[nodiscard]] int used_pools_ewram();
+
+    /**
+     * @brief Returns the EWRAM fragmentation, in the range [0..1].
+     *
+     * 0 means that all available bytes can be allocated in a single item,
+     * and 1 means that available bytes are split in a lot of small blocks.
+     */
+    [[nodiscard]] fixed fragmentation_ewram();
+
     /**
      * @brief Returns the bytes of all static objects in IWRAM.
      */
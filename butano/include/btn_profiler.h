@@ -21,6 +21,8 @@
  *
  * Defines the start of a code block in which elapsed time is going to be measured.
  *
+ * Code blocks can be nested: the elapsed time of a code block includes the elapsed time of its children.
+ *
  * @param id Small text string which identifies the code block.
  *
  * @ingroup profiler
@@ -39,6 +41,8 @@
  *
  * Forgets all elapsed time measures.
  *
+ * It can't be called when there's an active code block.
+ *
  * @ingroup profiler
  */
 
@@ -56,6 +60,15 @@
          * @brief Stops the execution and shows the profiling results on the screen.
          */
         [[noreturn]] void show();
+
+        /**
+         * @brief Logs the profiling results in a compact binary format.
+         *
+         * Logged results can be converted to a flame chart with the butano-profiler-tool.py script.
+         *
+         * It does nothing if logging is disabled.
+         */
+        void dump();
     }
 
     /// @cond DO_NOT_DOCUMENT
@@ -66,6 +79,19 @@
         {
             int64_t total = 0;
             int max = 0;
+            int max_frame = 0;
+            int max_frame_index = 0;
+            int current_frame = 0;
+            int frames_index = 0;
+            const char* parent_id = nullptr;
+        };
+
+        struct frame_stats
+        {
+            int p50 = 0;
+            int p95 = 0;
+            int p99 = 0;
+            int spikes = 0;
         };
 
         using ticks_map = btn::unordered_map<const char*, ticks, BTN_CFG_PROFILER_MAX_ENTRIES * 2>;
@@ -74,8 +100,18 @@
 
         void stop();
 
+        void next_frame();
+
         [[nodiscard]] const ticks_map& ticks_per_entry();
 
+        [[nodiscard]] int stored_frames();
+
+        [[nodiscard]] int frames_count();
+
+        [[nodiscard]] int frame_ticks(const ticks& ticks, int frame);
+
+        [[nodiscard]] frame_stats stats(const ticks& ticks);
+
         void reset();
     }
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_RECIPROCAL_DIVISION_H
+#define BTN_RECIPROCAL_DIVISION_H
+
+/**
+ * @file
+ * btn::reciprocal_division and btn::fixed_reciprocal_division_t header file.
+ *
+ * @ingroup math
+ */
+
+#include "btn_span.h"
+#include "btn_fixed.h"
+#include "btn_type_traits.h"
+
+/// @cond DO_NOT_DOCUMENT
+
+namespace _btn
+{
+    [[nodiscard]] constexpr unsigned constexpr_reciprocal_impl(unsigned normalized_divisor)
+    {
+        uint64_t result = (uint64_t(1) << 63) / normalized_divisor;
+        return result > 0xFFFFFFFF ? 0xFFFFFFFF : unsigned(result);
+    }
+
+    [[nodiscard]] BTN_CODE_IWRAM unsigned reciprocal_impl(unsigned normalized_divisor);
+}
+
+/// @endcond
+
+
+namespace btn
+{
+
+template<int Precision>
+class fixed_reciprocal_division_t;
+
+/**
+ * @brief Divides integer values by the same integer divisor with a multiplication by its reciprocal,
+ * instead of calling the division routine for each value.
+ *
+ * The reciprocal is estimated from btn::reciprocal_lut with two Newton-Raphson iterations,
+ * and quotients are corrected with their remainder, so results are the same as the ones of the division operator.
+ *
+ * It is worth it when the same divisor is used more than once.
+ *
+ * @ingroup math
+ */
+class reciprocal_division
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param divisor Non zero divisor.
+     */
+    constexpr explicit reciprocal_division(int divisor) :
+        _divisor(divisor)
+    {
+        BTN_ASSERT(divisor, "Divisor is zero");
+
+        _unsigned_divisor = divisor < 0 ? 0u - unsigned(divisor) : unsigned(divisor);
+
+        int divisor_log2 = 31 - __builtin_clz(_unsigned_divisor);
+        unsigned normalized_divisor = _unsigned_divisor << (31 - divisor_log2);
+        _shift = 32 + divisor_log2;
+
+        if(is_constant_evaluated())
+        {
+            _reciprocal = _btn::constexpr_reciprocal_impl(normalized_divisor);
+        }
+        else
+        {
+            _reciprocal = _btn::reciprocal_impl(normalized_divisor);
+        }
+    }
+
+    /**
+     * @brief Returns the divisor.
+     */
+    [[nodiscard]] constexpr int divisor() const
+    {
+        return _divisor;
+    }
+
+    /**
+     * @brief Returns the division of the given integer value by the divisor,
+     * with the same result as the division operator.
+     */
+    [[nodiscard]] constexpr int divide(int value) const
+    {
+        return _divide(value, 0);
+    }
+
+    /**
+     * @brief Returns the division of the given fixed point value by the divisor,
+     * with the same result as fixed_t::division(int).
+     */
+    template<int Precision>
+    [[nodiscard]] constexpr fixed_t<Precision> divide(fixed_t<Precision> value) const
+    {
+        return fixed_t<Precision>::from_data(_divide(value.data(), 0));
+    }
+
+    /**
+     * @brief Divides the given integer values by the divisor.
+     * @param values Integer values to divide.
+     * @param results Destination of the divisions. It can be the same as the given values.
+     */
+    void divide(const span<const int>& values, span<int> results) const
+    {
+        BTN_ASSERT(values.size() == results.size(), "Invalid results size: ", values.size(), " - ", results.size());
+
+        _divide(values.data(), results.data(), values.size(), 0);
+    }
+
+    /**
+     * @brief Divides the given fixed point values by the divisor.
+     * @param values Fixed point values to divide.
+     * @param results Destination of the divisions. It can be the same as the given values.
+     */
+    template<int Precision>
+    void divide(const span<const fixed_t<Precision>>& values, span<fixed_t<Precision>> results) const
+    {
+        static_assert(sizeof(fixed_t<Precision>) == sizeof(int));
+        BTN_ASSERT(values.size() == results.size(), "Invalid results size: ", values.size(), " - ", results.size());
+
+        _divide(reinterpret_cast<const int*>(values.data()), reinterpret_cast<int*>(results.data()), values.size(),
+                0);
+    }
+
+private:
+    template<int Precision>
+    friend class fixed_reciprocal_division_t;
+
+    int _divisor;
+    unsigned _unsigned_divisor = 0;
+    unsigned _reciprocal = 0;
+    int _shift = 0;
+
+    [[nodiscard]] constexpr int _divide(int value, int value_shift) const
+    {
+        unsigned unsigned_value = value < 0 ? 0u - unsigned(value) : unsigned(value);
+
+        // The reciprocal is never bigger than the real one, so the quotient is only corrected upwards:
+        uint64_t quotient = (uint64_t(unsigned_value) * _reciprocal) >> (_shift - value_shift);
+        uint64_t remainder = (uint64_t(unsigned_value) << value_shift) - (quotient * _unsigned_divisor);
+
+        while(remainder >= _unsigned_divisor)
+        {
+            ++quotient;
+            remainder -= _unsigned_divisor;
+        }
+
+        unsigned result = unsigned(quotient);
+        return (value < 0) != (_divisor < 0) ? int(0u - result) : int(result);
+    }
+
+    BTN_CODE_IWRAM void _divide(const int* values, int* results, int count, int value_shift) const;
+};
+
+
+/**
+ * @brief Divides fixed point values by the same fixed point divisor with a multiplication by its reciprocal,
+ * instead of calling the 64 bits division routine for each value.
+ *
+ * Results are the same as the ones of fixed_t::safe_division(fixed_t).
+ *
+ * @tparam Precision Number of bits used for the fractional part.
+ *
+ * @ingroup math
+ */
+template<int Precision>
+class fixed_reciprocal_division_t
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param divisor Divisor with a non zero internal data.
+     */
+    constexpr explicit fixed_reciprocal_division_t(fixed_t<Precision> divisor) :
+        _reciprocal_division(divisor.data())
+    {
+    }
+
+    /**
+     * @brief Returns the divisor.
+     */
+    [[nodiscard]] constexpr fixed_t<Precision> divisor() const
+    {
+        return fixed_t<Precision>::from_data(_reciprocal_division.divisor());
+    }
+
+    /**
+     * @brief Returns the division of the given fixed point value by the divisor,
+     * with the same result as fixed_t::safe_division(fixed_t).
+     */
+    [[nodiscard]] constexpr fixed_t<Precision> divide(fixed_t<Precision> value) const
+    {
+        return fixed_t<Precision>::from_data(_reciprocal_division._divide(value.data(), Precision));
+    }
+
+    /**
+     * @brief Divides the given fixed point values by the divisor.
+     * @param values Fixed point values to divide.
+     * @param results Destination of the divisions. It can be the same as the given values.
+     */
+    void divide(const span<const fixed_t<Precision>>& values, span<fixed_t<Precision>> results) const
+    {
+        static_assert(sizeof(fixed_t<Precision>) == sizeof(int));
+        BTN_ASSERT(values.size() == results.size(), "Invalid results size: ", values.size(), " - ", results.size());
+
+        _reciprocal_division._divide(reinterpret_cast<const int*>(values.data()),
+                                     reinterpret_cast<int*>(results.data()), values.size(), Precision);
+    }
+
+private:
+    reciprocal_division _reciprocal_division;
+};
+
+
+using fixed_reciprocal_division = fixed_reciprocal_division_t<12>; //!< Default precision fixed_reciprocal_division_t alias.
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_RECIPROCAL_LUT_H
+#define BTN_RECIPROCAL_LUT_H
+
+/**
+ * @file
+ * btn::reciprocal_lut header file.
+ *
+ * @ingroup math
+ */
+
+#include "btn_array.h"
+
+namespace btn
+{
+
+/**
+ * @brief Returns the LUT used to estimate the reciprocal of values in the [1, 2) range.
+ *
+ * Each entry stores the reciprocal of the center of one of the 256 subranges of [1, 2),
+ * with 16 bits for the fractional part.
+ *
+ * @ingroup math
+ */
+[[nodiscard]] constexpr array<uint16_t, 256> create_reciprocal_lut()
+{
+    array<uint16_t, 256> result = {};
+
+    for(int index = 0; index < 256; ++index)
+    {
+        result[index] = uint16_t((1 << 25) / (513 + (index * 2)));
+    }
+
+    return result;
+}
+
+/**
+ * @brief LUT used to estimate the reciprocal of values in the [1, 2) range.
+ *
+ * @ingroup math
+ */
+constexpr const array<uint16_t, 256> reciprocal_lut = create_reciprocal_lut();
+
+}
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "btn_size.h"
 #include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
 #include "btn_regular_bg_map_cell.h"
 
 namespace btn
@@ -35,6 +36,10 @@ class regular_bg_map_ptr;
  * The map cells are not copied but referenced, so they should outlive the regular_bg_map_item
  * to avoid dangling references.
  *
+ * Maps which don't fit in the hardware map sizes (32x32, 64x32, 32x64 or 64x64 map cells) are big maps:
+ * their map cells must be stored row by row, and they are streamed to a 32x32 hardware map
+ * as the background moves, so their size is not limited by the available VRAM.
+ *
  * @ingroup regular_bg
  * @ingroup bg_map
  * @ingroup tool
@@ -53,11 +58,53 @@ public:
      * @param dimensions Size in map cells of the referenced map cells.
      */
     constexpr regular_bg_map_item(const regular_bg_map_cell& cells_ref, const size& dimensions) :
+        regular_bg_map_item(cells_ref, dimensions, compression_type::NONE)
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param cells_ref Reference to one or more regular background map cells.
+     *
+     * If the map cells are compressed, cells_ref must reference the compressed data.
+     *
+     * The map cells are not copied but referenced, so they should outlive the regular_bg_map_item
+     * to avoid dangling references.
+     *
+     * @param dimensions Size in map cells of the referenced map cells.
+     * @param compression Compression type of the referenced map cells.
+     */
+    constexpr regular_bg_map_item(const regular_bg_map_cell& cells_ref, const size& dimensions,
+                                  compression_type compression) :
         _cells_ptr(&cells_ref),
-        _dimensions(dimensions)
+        _dimensions(dimensions),
+        _compression(compression)
+    {
+        BTN_ASSERT(dimensions.width() >= 32 && dimensions.width() <= max_big_dimension(),
+                   "Invalid width: ", dimensions.width());
+        BTN_ASSERT(dimensions.height() >= 32 && dimensions.height() <= max_big_dimension(),
+                   "Invalid height: ", dimensions.height());
+        BTN_ASSERT(compression == compression_type::NONE || ! big(dimensions),
+                   "Big maps can't be compressed");
+    }
+
+    /**
+     * @brief Returns the maximum width or height in map cells of a big map.
+     */
+    [[nodiscard]] static constexpr int max_big_dimension()
     {
-        BTN_ASSERT(dimensions.width() == 32 || dimensions.width() == 64, "Invalid width: ", dimensions.width());
-        BTN_ASSERT(dimensions.height() == 32 || dimensions.height() == 64, "Invalid height: ", dimensions.height());
+        return 8192;
+    }
+
+    /**
+     * @brief Indicates if the given size in map cells doesn't fit in the hardware map sizes,
+     * so a map with it must be streamed.
+     */
+    [[nodiscard]] static constexpr bool big(const size& dimensions)
+    {
+        int width = dimensions.width();
+        int height = dimensions.height();
+        return (width != 32 && width != 64) || (height != 32 && height != 64);
     }
 
     /**
@@ -76,6 +123,23 @@ public:
         return _dimensions;
     }
 
+    /**
+     * @brief Returns the compression type of the referenced map cells.
+     */
+    [[nodiscard]] constexpr compression_type compression() const
+    {
+        return _compression;
+    }
+
+    /**
+     * @brief Indicates if the referenced map cells don't fit in the hardware map sizes,
+     * so they must be streamed.
+     */
+    [[nodiscard]] constexpr bool big() const
+    {
+        return big(_dimensions);
+    }
+
     /**
      * @brief Searches for a regular_bg_map_ptr which references the information provided by this item.
      * @param tiles Referenced tiles of the map to search.
@@ -156,6 +220,7 @@ public:
 private:
     const regular_bg_map_cell* _cells_ptr;
     size _dimensions;
+    compression_type _compression;
 };
 
 }
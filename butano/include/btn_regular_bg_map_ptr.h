@@ -356,13 +356,22 @@ public:
      */
     [[nodiscard]] size dimensions() const;
 
+    /**
+     * @brief Indicates if the referenced map doesn't fit in the hardware map sizes,
+     * so it is streamed to VRAM as the background which shows it moves.
+     *
+     * A big map should be shown by only one background at a time.
+     */
+    [[nodiscard]] bool big() const;
+
     /**
      * @brief Returns the bits per pixel of the referenced color palette.
      */
     [[nodiscard]] palette_bpp_mode bpp_mode() const;
 
     /**
-     * @brief Returns the referenced map cells unless it was created with allocate or allocate_optional.
+     * @brief Returns the referenced map cells unless it was created with allocate or allocate_optional,
+     * or the referenced map cells are compressed.
      * In that case, it returns `nullopt`.
      */
     [[nodiscard]] optional<span<const regular_bg_map_cell>> cells_ref() const;
@@ -380,6 +389,22 @@ public:
      */
     void set_cells_ref(const regular_bg_map_cell& cells_ref, const size& dimensions);
 
+    /**
+     * @brief Sets the map cells to handle.
+     *
+     * The map system does not support multiple regular_bg_map_ptr items referencing to the same map cells.
+     *
+     * The map cells are not copied but referenced,
+     * so they should outlive the regular_bg_map_ptr to avoid dangling references.
+     *
+     * If the map cells are compressed and they don't fit in the VRAM commits budget,
+     * they are decompressed over multiple frames in an EWRAM buffer,
+     * and the previous map cells are displayed until the new ones are copied to VRAM at once.
+     *
+     * @param map_item regular_bg_map_item which references the map cells to handle.
+     */
+    void set_cells_ref(const regular_bg_map_item& map_item);
+
     /**
      * @brief Uploads the referenced map cells to VRAM again to make visible the possible changes in them.
      */
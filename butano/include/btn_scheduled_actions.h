@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_SCHEDULED_ACTIONS_H
+#define BTN_SCHEDULED_ACTIONS_H
+
+/**
+ * @file
+ * btn::scheduled_actions header file.
+ *
+ * @ingroup action
+ */
+
+#include "btn_vector.h"
+#include "btn_utility.h"
+#include "btn_intrusive_list.h"
+#include "btn_template_actions.h"
+#include "btn_value_template_actions.h"
+
+namespace btn
+{
+
+/**
+ * @brief Base class of scheduled_actions.
+ *
+ * It registers itself in the actions scheduler, which updates it once per core::update() call.
+ *
+ * @ingroup action
+ */
+class scheduled_actions_base : public intrusive_list_node_type
+{
+
+public:
+    scheduled_actions_base(const scheduled_actions_base& other) = delete;
+
+    scheduled_actions_base& operator=(const scheduled_actions_base& other) = delete;
+
+    /**
+     * @brief Destructor.
+     *
+     * It unregisters itself from the actions scheduler.
+     */
+    virtual ~scheduled_actions_base();
+
+    /**
+     * @brief Updates all stored actions.
+     *
+     * It is called by core::update(), so it doesn't need to be called by the user.
+     */
+    virtual void update() = 0;
+
+protected:
+    /**
+     * @brief Default constructor.
+     *
+     * It registers itself in the actions scheduler.
+     */
+    scheduled_actions_base();
+};
+
+
+/**
+ * @brief Pool of actions of the same type, updated by the actions scheduler once per core::update() call.
+ *
+ * Actions are stored contiguously and updated in the same loop, without being updated one by one by the user.
+ *
+ * Actions based on by_template_action or by_value_template_action which modify the same target
+ * are kept together, so their deltas are added before writing the property only once.
+ *
+ * Actions with a done() method are removed when they are done.
+ *
+ * The update time of all scheduled actions is profiled as "eng_actions_update" when BTN_CFG_PROFILER_LOG_ENGINE is true.
+ *
+ * @tparam Action Type of the stored actions.
+ * @tparam MaxSize Maximum number of stored actions.
+ *
+ * @ingroup action
+ */
+template<typename Action, int MaxSize>
+class scheduled_actions : public scheduled_actions_base
+{
+    static_assert(MaxSize > 0);
+
+public:
+    using value_type = Action; //!< Value type alias.
+    using size_type = int; //!< Size type alias.
+    using reference = Action&; //!< Reference alias.
+    using const_reference = const Action&; //!< Const reference alias.
+    using iterator = Action*; //!< Iterator alias.
+    using const_iterator = const Action*; //!< Const iterator alias.
+
+    /**
+     * @brief Default constructor.
+     */
+    scheduled_actions() = default;
+
+    /**
+     * @brief Returns the number of stored actions.
+     */
+    [[nodiscard]] size_type size() const
+    {
+        return _actions.size();
+    }
+
+    /**
+     * @brief Returns the maximum number of stored actions.
+     */
+    [[nodiscard]] constexpr size_type max_size() const
+    {
+        return MaxSize;
+    }
+
+    /**
+     * @brief Indicates if it doesn't contain any action.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return _actions.empty();
+    }
+
+    /**
+     * @brief Indicates if it can't contain any more actions.
+     */
+    [[nodiscard]] bool full() const
+    {
+        return _actions.full();
+    }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the stored actions.
+     */
+    [[nodiscard]] const_iterator begin() const
+    {
+        return _actions.data();
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning of the stored actions.
+     */
+    [[nodiscard]] iterator begin()
+    {
+        return _actions.data();
+    }
+
+    /**
+     * @brief Returns a const iterator to the end of the stored actions.
+     */
+    [[nodiscard]] const_iterator end() const
+    {
+        return _actions.data() + _actions.size();
+    }
+
+    /**
+     * @brief Returns an iterator to the end of the stored actions.
+     */
+    [[nodiscard]] iterator end()
+    {
+        return _actions.data() + _actions.size();
+    }
+
+    /**
+     * @brief Copies an action into the pool.
+     * @param action Action to copy.
+     * @return Reference to the stored action.
+     */
+    reference push(const Action& action)
+    {
+        return push(Action(action));
+    }
+
+    /**
+     * @brief Moves an action into the pool.
+     * @param action Action to move.
+     * @return Reference to the stored action.
+     */
+    reference push(Action&& action)
+    {
+        BTN_ASSERT(! full(), "Actions pool is full");
+
+        if constexpr(_by_value_action(static_cast<const Action*>(nullptr)))
+        {
+            // Actions with the same target are kept together, so they can be collapsed in only one loop:
+            for(int index = _actions.size() - 1; index >= 0; --index)
+            {
+                if(_action_value(_actions[index]) == _action_value(action))
+                {
+                    auto position = _actions.begin() + index + 1;
+                    return *_actions.insert(position, move(action));
+                }
+            }
+        }
+
+        _actions.push_back(move(action));
+        return _actions.back();
+    }
+
+    /**
+     * @brief Constructs and stores an action into the pool.
+     * @param args Parameters of the action to store.
+     * @return Reference to the stored action.
+     */
+    template<typename... Args>
+    reference emplace(Args&&... args)
+    {
+        return push(Action(forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Removes the action referenced by the given iterator.
+     * @param position Iterator to the action to remove.
+     * @return Iterator following the removed action.
+     */
+    iterator erase(const_iterator position)
+    {
+        int index = position - begin();
+        _actions.erase(_actions.begin() + index);
+        return begin() + index;
+    }
+
+    /**
+     * @brief Removes all stored actions.
+     */
+    void clear()
+    {
+        _actions.clear();
+    }
+
+    /**
+     * @brief Updates all stored actions.
+     *
+     * It is called by core::update(), so it doesn't need to be called by the user.
+     */
+    void update() final
+    {
+        int size = _actions.size();
+
+        if constexpr(_by_action(static_cast<const Action*>(nullptr)))
+        {
+            // All actions modify the same property, so it is written only once:
+            if(size)
+            {
+                auto delta_property = _action_delta(_actions[0]);
+
+                for(int index = 1; index < size; ++index)
+                {
+                    delta_property += _action_delta(_actions[index]);
+                }
+
+                _set_by_property(_actions[0], delta_property);
+            }
+        }
+        else if constexpr(_by_value_action(static_cast<const Action*>(nullptr)))
+        {
+            // Actions with the same target are together, so their deltas are added before writing the property:
+            int index = 0;
+
+            while(index < size)
+            {
+                Action& action = _actions[index];
+                auto delta_property = _action_delta(action);
+                ++index;
+
+                while(index < size && _action_value(_actions[index]) == _action_value(action))
+                {
+                    delta_property += _action_delta(_actions[index]);
+                    ++index;
+                }
+
+                _set_by_value_property(action, delta_property);
+            }
+        }
+        else
+        {
+            for(int index = 0; index < size; ++index)
+            {
+                _actions[index].update();
+            }
+
+            if constexpr(requires(const Action& action) { action.done(); })
+            {
+                erase_if(_actions, [](const Action& action)
+                {
+                    return action.done();
+                });
+            }
+        }
+    }
+
+private:
+    vector<Action, MaxSize> _actions;
+
+    template<typename Property, class PropertyManager>
+    [[nodiscard]] static constexpr bool _by_action(const by_template_action<Property, PropertyManager>*)
+    {
+        return true;
+    }
+
+    [[nodiscard]] static constexpr bool _by_action(const void*)
+    {
+        return false;
+    }
+
+    template<typename Value, typename Property, class PropertyManager>
+    [[nodiscard]] static constexpr bool _by_value_action(
+            const by_value_template_action<Value, Property, PropertyManager>*)
+    {
+        return true;
+    }
+
+    [[nodiscard]] static constexpr bool _by_value_action(const void*)
+    {
+        return false;
+    }
+
+    template<typename Property, class PropertyManager>
+    [[nodiscard]] static const Property& _action_delta(const by_template_action<Property, PropertyManager>& action)
+    {
+        return action._delta_property;
+    }
+
+    template<typename Value, typename Property, class PropertyManager>
+    [[nodiscard]] static const Property& _action_delta(
+            const by_value_template_action<Value, Property, PropertyManager>& action)
+    {
+        return action._delta_property;
+    }
+
+    template<typename Value, typename Property, class PropertyManager>
+    [[nodiscard]] static const Value& _action_value(
+            const by_value_template_action<Value, Property, PropertyManager>& action)
+    {
+        return action._value;
+    }
+
+    template<typename Property, class PropertyManager>
+    static void _set_by_property(by_template_action<Property, PropertyManager>&, const Property& delta_property)
+    {
+        PropertyManager::set(PropertyManager::get() + delta_property);
+    }
+
+    template<typename Value, typename Property, class PropertyManager>
+    static void _set_by_value_property(by_value_template_action<Value, Property, PropertyManager>& action,
+                                       const Property& delta_property)
+    {
+        PropertyManager::set(PropertyManager::get(action._value) + delta_property, action._value);
+    }
+};
+
+}
+
+#endif
@@ -65,6 +65,18 @@ public:
      */
     [[nodiscard]] static optional<sprite_affine_mat_ptr> create_optional(const sprite_affine_mat_attributes& attributes);
 
+    /**
+     * @brief Searches for a shared affine transformation matrix with the same register values
+     * than the specified attributes. If it is not found, it creates a shared matrix with them.
+     *
+     * Shared matrices are referenced by all the sprites which need the same transformation,
+     * so they can't be modified.
+     *
+     * @param attributes sprite_affine_mat_attributes of the output matrix.
+     * @return The requested sprite_affine_mat_ptr.
+     */
+    [[nodiscard]] static sprite_affine_mat_ptr create_shared(const sprite_affine_mat_attributes& attributes);
+
     /**
      * @brief Copy constructor.
      * @param other sprite_affine_mat_ptr to copy.
@@ -119,6 +131,13 @@ public:
         return _id;
     }
 
+    /**
+     * @brief Indicates if the referenced matrix has been created with create_shared() or not.
+     *
+     * Shared matrices can't be modified.
+     */
+    [[nodiscard]] bool shared() const;
+
     /**
      * @brief Returns the rotation angle in degrees.
      */
@@ -35,6 +35,29 @@ namespace btn::sprite_affine_mats
      * that can be managed with sprite_affine_mat_ptr objects.
      */
     [[nodiscard]] int available_count();
+
+    /**
+     * @brief Indicates if the sprite affine transformation matrices created by sprite_ptr and sprite_builder
+     * are shared between sprites or not.
+     */
+    [[nodiscard]] bool sharing_enabled();
+
+    /**
+     * @brief Sets if the sprite affine transformation matrices created by sprite_ptr and sprite_builder
+     * must be shared between sprites or not.
+     *
+     * When sharing is enabled, the matrices created by calling the rotation and scale methods
+     * of sprite_ptr and sprite_builder are created with sprite_affine_mat_ptr::create_shared(),
+     * so all sprites with the same transformation (the same register values) use the same matrix.
+     *
+     * Sprites with a shared matrix are moved to another shared matrix when their transformation changes
+     * (the matrix is updated in place if no other sprite uses it), so hundreds of sprites
+     * can be rotated and scaled as long as they have 32 or less different transformations at the same time.
+     *
+     * Keep in mind that the rotation angle and the scale returned by sprites with a shared matrix are the ones
+     * of the sprite which created it, which can differ slightly from the requested ones.
+     */
+    void set_sharing_enabled(bool sharing_enabled);
 }
 
 #endif
@@ -73,9 +73,10 @@ public:
         _tiles_item(tiles_item),
         _palette_item(palette_item)
     {
-        BTN_ASSERT(tiles_item.tiles_ref().size() ==
-                   _shape_size.tiles_count(palette_item.bpp_mode()) * tiles_item.graphics_count(),
+        BTN_ASSERT(tiles_item.tiles_count_per_graphic() == _shape_size.tiles_count(palette_item.bpp_mode()),
                    "Invalid shape or size");
+        BTN_ASSERT(! tiles_item.deduplicated() || palette_item.bpp_mode() == palette_bpp_mode::BPP_4,
+                   "8BPP deduplicated tiles not supported");
     }
 
     /**
@@ -34,6 +34,7 @@ class sprite_palette_item;
 class sprite_affine_mat_ptr;
 class sprite_first_attributes;
 class sprite_third_attributes;
+class sprite_affine_mat_attributes;
 class sprite_affine_second_attributes;
 class sprite_regular_second_attributes;
 enum class sprite_double_size_mode;
@@ -798,6 +799,8 @@ private:
     {
     }
 
+    void _create_affine_mat(const sprite_affine_mat_attributes& affine_mat_attributes);
+
     void _destroy();
 };
 
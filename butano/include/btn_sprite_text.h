@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_SPRITE_TEXT_H
+#define BTN_SPRITE_TEXT_H
+
+/**
+ * @file
+ * btn::isprite_text and btn::sprite_text header file.
+ *
+ * @ingroup sprite
+ * @ingroup text
+ */
+
+#include "btn_vector.h"
+#include "btn_sprite_ptr.h"
+#include "btn_fixed_point.h"
+
+namespace btn
+{
+
+class string_view;
+class sprite_text_generator;
+
+/**
+ * @brief Base class of sprite_text.
+ *
+ * It keeps the sprites generated by a sprite_text_generator and updates them in place when the text changes:
+ * only the characters which are different are painted again, and only the sprites which are needed
+ * are created or destroyed.
+ *
+ * When text is printed in multiple characters per sprite, characters with the same position and width
+ * are repainted only if they change, so VRAM writes scale with the number of changed characters.
+ *
+ * When text is printed in one sprite per character, character tiles are shared by all sprites
+ * (no matter the generator which created them), so changed characters are updated without VRAM writes
+ * if their tiles are already loaded.
+ *
+ * @ingroup sprite
+ * @ingroup text
+ */
+class isprite_text
+{
+
+public:
+    /**
+     * @brief Layout of a painted character.
+     */
+    class glyph
+    {
+
+    public:
+        int16_t x; //!< Horizontal position relative to the text left edge.
+        uint16_t graphics_index; //!< Index of the character graphics in the font.
+        uint8_t sprite_index; //!< Index of the sprite in which the character is painted.
+        uint8_t column; //!< First column of the character in its sprite.
+        uint8_t width; //!< Width of the character in pixels.
+    };
+
+    isprite_text(const isprite_text& other) = delete;
+
+    isprite_text& operator=(const isprite_text& other) = delete;
+
+    /**
+     * @brief Returns the sprite_text_generator used to update the text.
+     */
+    [[nodiscard]] const sprite_text_generator& generator() const
+    {
+        return *_generator;
+    }
+
+    /**
+     * @brief Returns the position of the text.
+     */
+    [[nodiscard]] const fixed_point& position() const
+    {
+        return _position;
+    }
+
+    /**
+     * @brief Sets the position of the text.
+     *
+     * Sprites are moved without being painted again.
+     */
+    void set_position(const fixed_point& position);
+
+    /**
+     * @brief Returns the sprites which show the text.
+     */
+    [[nodiscard]] const ivector<sprite_ptr>& sprites() const
+    {
+        return _sprites;
+    }
+
+    /**
+     * @brief Returns the layout of the painted characters.
+     */
+    [[nodiscard]] const ivector<glyph>& glyphs() const
+    {
+        return *_glyphs;
+    }
+
+    /**
+     * @brief Sets the text to show, painting only the characters which have changed.
+     *
+     * The generator font and the print mode (one sprite per character or not) must not change between updates.
+     */
+    void set_text(const string_view& text);
+
+    /**
+     * @brief Releases all sprites.
+     */
+    void clear()
+    {
+        _sprites.clear();
+        _glyphs->clear();
+    }
+
+protected:
+    /**
+     * @brief Constructor.
+     * @param generator sprite_text_generator used to update the text. It must outlive this object.
+     * @param position Position of the text.
+     * @param sprites Vector in which the text sprites are stored.
+     * @param glyphs Vector in which the layout of the painted characters is stored.
+     * @param new_glyphs Vector used to store the new layout of the painted characters while updating them.
+     */
+    isprite_text(const sprite_text_generator& generator, const fixed_point& position, ivector<sprite_ptr>& sprites,
+                 ivector<glyph>& glyphs, ivector<glyph>& new_glyphs) :
+        _generator(&generator),
+        _sprites(sprites),
+        _glyphs(&glyphs),
+        _new_glyphs(&new_glyphs),
+        _position(position)
+    {
+    }
+
+private:
+    friend class sprite_text_generator;
+
+    const sprite_text_generator* _generator;
+    ivector<sprite_ptr>& _sprites;
+    ivector<glyph>* _glyphs;
+    ivector<glyph>* _new_glyphs;
+    fixed_point _position;
+};
+
+
+/**
+ * @brief Keeps the sprites generated by a sprite_text_generator and updates them in place when the text changes.
+ *
+ * @tparam MaxSprites Maximum number of sprites.
+ * @tparam MaxCharacters Maximum number of painted characters (without spaces).
+ *
+ * @ingroup sprite
+ * @ingroup text
+ */
+template<int MaxSprites, int MaxCharacters = MaxSprites * 4>
+class sprite_text : public isprite_text
+{
+    static_assert(MaxSprites > 0 && MaxSprites <= 128);
+    static_assert(MaxCharacters > 0);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param generator sprite_text_generator used to update the text. It must outlive this object.
+     * @param position Position of the text.
+     */
+    sprite_text(const sprite_text_generator& generator, const fixed_point& position) :
+        isprite_text(generator, position, _sprites_vector, _glyphs_vectors[0], _glyphs_vectors[1])
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param generator sprite_text_generator used to update the text. It must outlive this object.
+     * @param position Position of the text.
+     * @param text Text to show.
+     */
+    sprite_text(const sprite_text_generator& generator, const fixed_point& position, const string_view& text) :
+        sprite_text(generator, position)
+    {
+        set_text(text);
+    }
+
+private:
+    vector<sprite_ptr, MaxSprites> _sprites_vector;
+    vector<glyph, MaxCharacters> _glyphs_vectors[2];
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@ namespace btn
 
 class sprite_ptr;
 class fixed_point;
+class isprite_text;
 
 /**
  * @brief Generates sprites containing text from a given sprite_font.
@@ -35,6 +36,8 @@ class fixed_point;
  *
  * Also, UTF-8 characters are supported.
  *
+ * Text which changes often can be updated in place with a sprite_text.
+ *
  * @ingroup sprite
  * @ingroup text
  */
@@ -54,13 +57,13 @@ public:
 
     /**
      * @brief Constructor.
-     * @param font Sprite font for drawing text.
+     * @param font Sprite font for drawing text. Its tiles can't be deduplicated.
      */
     explicit sprite_text_generator(const sprite_font& font);
 
     /**
      * @brief Constructor.
-     * @param font Sprite font for drawing text.
+     * @param font Sprite font for drawing text. Its tiles can't be deduplicated.
      * @param palette_item 16 colors (4 bits per pixel) sprite_palette_item
      * that generates the color palette used by the text sprites.
      */
@@ -271,6 +274,8 @@ public:
                                          ivector<sprite_ptr>& output_sprites) const;
 
 private:
+    friend class isprite_text;
+
     sprite_font _font;
     sprite_palette_item _palette_item;
     unordered_map<int, int, BTN_CFG_SPRITE_TEXT_MAX_UTF8_CHARACTERS> _utf8_characters_map;
@@ -279,6 +284,8 @@ private:
     int _z_order = 0;
     bool _one_sprite_per_character = false;
 
+    void _update_text(const string_view& text, isprite_text& sprite_text) const;
+
     void _build_utf8_characters_map();
 };
 
@@ -14,6 +14,7 @@
  * @ingroup tile
  */
 
+#include "btn_fixed_fwd.h"
 #include "btn_config_log.h"
 #include "btn_config_doxygen.h"
 
@@ -46,6 +47,15 @@ namespace btn::sprite_tiles
      */
     [[nodiscard]] int available_items_count();
 
+    /**
+     * @brief Returns the fragmentation of the available sprite tiles,
+     * in the range [0..1] (0 = not fragmented, 1 = fully fragmented).
+     *
+     * It is reduced over multiple frames by moving used sprite tiles to lower VRAM locations
+     * (see BTN_CFG_SPRITE_TILES_COMPACTION_MAX_BYTES_PER_FRAME).
+     */
+    [[nodiscard]] fixed fragmentation();
+
     #if BTN_CFG_LOG_ENABLED || BTN_DOXYGEN
         /**
          * @brief Logs the current status of the sprite tiles manager.
@@ -18,6 +18,7 @@
 #include "btn_span.h"
 #include "btn_tile.h"
 #include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
 
 namespace btn
 {
@@ -32,6 +33,9 @@ class sprite_tiles_ptr;
  *
  * The tiles are not copied but referenced, so they should outlive the sprite_tiles_item to avoid dangling references.
  *
+ * If tiles deduplication is enabled in the json file, each sprite tile set is stored as a list of tile indexes
+ * which reference unique tiles (flipped or not), instead of storing the tiles themselves.
+ *
  * @ingroup sprite
  * @ingroup tile
  * @ingroup tool
@@ -40,6 +44,10 @@ class sprite_tiles_item
 {
 
 public:
+    static constexpr const uint16_t tile_index_mask = 0x3FFF; //!< Tile index bits which reference a unique tile.
+    static constexpr const uint16_t horizontal_flip_flag = 0x4000; //!< Tile index flag of horizontally flipped tiles.
+    static constexpr const uint16_t vertical_flip_flag = 0x8000; //!< Tile index flag of vertically flipped tiles.
+
     /**
      * @brief Constructor.
      * @param tiles_ref Reference to one or more sprite tile sets.
@@ -50,11 +58,34 @@ public:
      * @param graphics_count Number of sprite tile sets contained in tiles_ref.
      */
     constexpr sprite_tiles_item(const span<const tile>& tiles_ref, int graphics_count) :
+        sprite_tiles_item(tiles_ref, graphics_count, compression_type::NONE)
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param tiles_ref Reference to one or more sprite tile sets.
+     *
+     * If the tiles are compressed, tiles_ref data must point to the compressed data
+     * and tiles_ref size must be the number of tiles once decompressed.
+     *
+     * The tiles are not copied but referenced, so they should outlive the sprite_tiles_item
+     * to avoid dangling references.
+     *
+     * @param graphics_count Number of sprite tile sets contained in tiles_ref.
+     * Compressed tiles must contain only one sprite tile set.
+     * @param compression Compression type of the referenced tiles.
+     */
+    constexpr sprite_tiles_item(const span<const tile>& tiles_ref, int graphics_count,
+                                compression_type compression) :
         _tiles_ref(tiles_ref),
         _graphics_count(graphics_count),
-        _tiles_count_per_graphic(0)
+        _tiles_count_per_graphic(0),
+        _compression(compression)
     {
         BTN_ASSERT(! tiles_ref.empty(), "Tiles ref is empty");
+        BTN_ASSERT(compression == compression_type::NONE || graphics_count == 1,
+                   "Compressed tiles must contain only one sprite tile set: ", graphics_count);
         BTN_ASSERT(graphics_count > 0, "Invalid graphics count: ", graphics_count);
         BTN_ASSERT(graphics_count <= tiles_ref.size(), "Invalid tiles or graphics count: ",
                    tiles_ref.size(), " - ", graphics_count);
@@ -64,6 +95,41 @@ public:
         _tiles_count_per_graphic = tiles_ref.size() / graphics_count;
     }
 
+    /**
+     * @brief Constructor for deduplicated tiles.
+     * @param tiles_ref Reference to the unique tiles referenced by tile_indexes_ref.
+     *
+     * The tiles are not copied but referenced, so they should outlive the sprite_tiles_item
+     * to avoid dangling references.
+     *
+     * @param tile_indexes_ref Reference to the tile indexes of one or more sprite tile sets.
+     * Each tile index can have the horizontal_flip_flag and vertical_flip_flag flags set.
+     *
+     * The tile indexes are not copied but referenced, so they should outlive the sprite_tiles_item
+     * to avoid dangling references.
+     *
+     * @param graphics_count Number of sprite tile sets contained in tile_indexes_ref.
+     */
+    constexpr sprite_tiles_item(const span<const tile>& tiles_ref, const span<const uint16_t>& tile_indexes_ref,
+                                int graphics_count) :
+        _tiles_ref(tiles_ref),
+        _tile_indexes_ref(tile_indexes_ref),
+        _graphics_count(graphics_count),
+        _tiles_count_per_graphic(0),
+        _compression(compression_type::NONE)
+    {
+        BTN_ASSERT(! tiles_ref.empty(), "Tiles ref is empty");
+        BTN_ASSERT(tiles_ref.size() <= tile_index_mask + 1, "Too many tiles: ", tiles_ref.size());
+        BTN_ASSERT(! tile_indexes_ref.empty(), "Tile indexes ref is empty");
+        BTN_ASSERT(graphics_count > 0, "Invalid graphics count: ", graphics_count);
+        BTN_ASSERT(graphics_count <= tile_indexes_ref.size(), "Invalid tile indexes or graphics count: ",
+                   tile_indexes_ref.size(), " - ", graphics_count);
+        BTN_ASSERT(tile_indexes_ref.size() % graphics_count == 0, "Invalid tile indexes or graphics count: ",
+                   tile_indexes_ref.size(), " - ", graphics_count);
+
+        _tiles_count_per_graphic = tile_indexes_ref.size() / graphics_count;
+    }
+
     /**
      * @brief Returns the number of sprite tile sets contained in tiles_ref.
      */
@@ -81,7 +147,8 @@ public:
     }
 
     /**
-     * @brief Returns the reference to one or more sprite tile sets.
+     * @brief Returns the reference to one or more sprite tile sets,
+     * or to the unique tiles referenced by tile_indexes_ref() if the tiles are deduplicated.
      *
      * The tiles are not copied but referenced, so they should outlive the sprite_tiles_item
      * to avoid dangling references.
@@ -91,19 +158,54 @@ public:
         return _tiles_ref;
     }
 
+    /**
+     * @brief Returns the reference to the tile indexes of one or more sprite tile sets
+     * if the tiles are deduplicated; otherwise it returns an empty span.
+     *
+     * The tile indexes are not copied but referenced, so they should outlive the sprite_tiles_item
+     * to avoid dangling references.
+     */
+    [[nodiscard]] constexpr const span<const uint16_t>& tile_indexes_ref() const
+    {
+        return _tile_indexes_ref;
+    }
+
+    /**
+     * @brief Returns the compression type of the referenced tiles.
+     */
+    [[nodiscard]] constexpr compression_type compression() const
+    {
+        return _compression;
+    }
+
+    /**
+     * @brief Indicates if the tiles are deduplicated (they are referenced by tile_indexes_ref()) or not.
+     */
+    [[nodiscard]] constexpr bool deduplicated() const
+    {
+        return ! _tile_indexes_ref.empty();
+    }
+
     /**
      * @brief Returns the reference to the first sprite tile set.
+     *
+     * Deduplicated tiles are not stored in sprite tile sets, so this method can't be called for them.
      */
     [[nodiscard]] constexpr span<const tile> graphics_tiles_ref() const
     {
+        BTN_ASSERT(! deduplicated(), "Tiles are deduplicated");
+
         return span<const tile>(_tiles_ref.data(), _tiles_count_per_graphic);
     }
 
     /**
      * @brief Returns the reference to the sprite tile set indicated by graphics_index.
+     *
+     * Deduplicated tiles are not stored in sprite tile sets, so this method can't be called for them.
      */
     [[nodiscard]] constexpr span<const tile> graphics_tiles_ref(int graphics_index) const
     {
+        BTN_ASSERT(! deduplicated(), "Tiles are deduplicated");
         BTN_ASSERT(graphics_index >= 0, "Invalid graphics index: ", graphics_index);
         BTN_ASSERT(graphics_index < _graphics_count, "Invalid graphics index: ",
                    graphics_index, " - ", _graphics_count);
@@ -112,6 +214,22 @@ public:
         return span<const tile>(_tiles_ref.data() + (graphics_index * tiles_count), tiles_count);
     }
 
+    /**
+     * @brief Returns the reference to the tile indexes of the sprite tile set indicated by graphics_index.
+     *
+     * Tiles must be deduplicated to call this method.
+     */
+    [[nodiscard]] constexpr span<const uint16_t> graphics_tile_indexes_ref(int graphics_index) const
+    {
+        BTN_ASSERT(deduplicated(), "Tiles are not deduplicated");
+        BTN_ASSERT(graphics_index >= 0, "Invalid graphics index: ", graphics_index);
+        BTN_ASSERT(graphics_index < _graphics_count, "Invalid graphics index: ",
+                   graphics_index, " - ", _graphics_count);
+
+        int tiles_count = _tiles_count_per_graphic;
+        return span<const uint16_t>(_tile_indexes_ref.data() + (graphics_index * tiles_count), tiles_count);
+    }
+
     /**
      * @brief Searches for a sprite_tiles_ptr which references the first sprite tile set.
      * @return sprite_tiles_ptr which references the first sprite tile set if it has been found;
@@ -244,7 +362,9 @@ public:
     [[nodiscard]] constexpr friend bool operator==(const sprite_tiles_item& a, const sprite_tiles_item& b)
     {
         return a._tiles_ref.data() == b._tiles_ref.data() && a._tiles_ref.size() == b._tiles_ref.size() &&
-                a._graphics_count == b._graphics_count;
+                a._tile_indexes_ref.data() == b._tile_indexes_ref.data() &&
+                a._tile_indexes_ref.size() == b._tile_indexes_ref.size() && a._graphics_count == b._graphics_count &&
+                a._compression == b._compression;
     }
 
     /**
@@ -260,8 +380,10 @@ public:
 
 private:
     span<const tile> _tiles_ref;
+    span<const uint16_t> _tile_indexes_ref;
     int _graphics_count;
     int _tiles_count_per_graphic;
+    compression_type _compression;
 };
 
 }
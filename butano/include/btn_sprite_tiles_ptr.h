@@ -312,7 +312,8 @@ public:
     [[nodiscard]] int tiles_count() const;
 
     /**
-     * @brief Returns the referenced tiles unless it was created with allocate or allocate_optional.
+     * @brief Returns the referenced tiles unless it was created with allocate or allocate_optional,
+     * or the referenced tiles are deduplicated or compressed.
      * In that case, it returns `nullopt`.
      */
     [[nodiscard]] optional<span<const tile>> tiles_ref() const;
@@ -339,6 +340,10 @@ public:
      * Remember also that the tiles are not copied but referenced,
      * so they should outlive the sprite_tiles_ptr to avoid dangling references.
      *
+     * If the tiles are compressed and they don't fit in the VRAM commits budget,
+     * they are decompressed over multiple frames in an EWRAM buffer,
+     * and the previous tiles are displayed until the new ones are copied to VRAM at once.
+     *
      * @param tiles_item sprite_tiles_item which references the tiles to handle.
      */
     void set_tiles_ref(const sprite_tiles_item& tiles_item);
@@ -13,7 +13,9 @@
  * @ingroup sprite
  */
 
+#include "btn_config_sprites.h"
 #include "../hw/include/btn_hw_sprites_constants.h"
+#include "../hw/include/btn_hw_display_constants.h"
 
 /**
  * @brief Sprites related functions.
@@ -38,6 +40,97 @@ namespace btn::sprites
      */
     [[nodiscard]] int available_items_count();
 
+    /**
+     * @brief Returns the number of times that all hardware sprites have been sorted again from scratch.
+     *
+     * Most of the time only the hardware sprites affected by a change are updated.
+     */
+    [[nodiscard]] int hw_rebuilds_count();
+
+    /**
+     * @brief Returns the number of hardware sprites updated when all of them have been sorted again from scratch.
+     */
+    [[nodiscard]] int hw_rebuilt_count();
+
+    /**
+     * @brief Returns the number of times that a sprite has been inserted in the sorted hardware sprites
+     * without sorting all of them again.
+     */
+    [[nodiscard]] int hw_patches_count();
+
+    /**
+     * @brief Returns the number of hardware sprites updated when a sprite has been inserted in the
+     * sorted hardware sprites without sorting all of them again.
+     */
+    [[nodiscard]] int hw_patched_count();
+
+    /**
+     * @brief Returns the number of hardware sprites committed to the GBA in the last frame.
+     */
+    [[nodiscard]] int hw_committed_count();
+
+    /**
+     * @brief Indicates if the sprites multiplexer is enabled or not.
+     */
+    [[nodiscard]] bool multiplexer_enabled();
+
+    /**
+     * @brief Sets if the sprites multiplexer must be enabled or not.
+     *
+     * When the multiplexer is enabled and there are more than 128 sprites on screen,
+     * the screen is divided in horizontal bands of BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT pixels
+     * and hardware sprites are rewritten between them, so each band can show up to 128 sprites.
+     *
+     * A hardware sprite can be rewritten in a band only if its previous sprite ends at least two scanlines before it,
+     * and up to BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES hardware sprites can be rewritten before each band,
+     * so sprites which don't fit in a band are not displayed (see multiplexer_dropped_count).
+     *
+     * Keep in mind that while sprites are being multiplexed:
+     * * H-Blank interval is reserved to update hardware sprites (`DCNT_OAM_HBL` is set in the display control
+     * register), so the hardware can render less sprite pixels per scanline.
+     * * A VCOUNT interrupt is triggered in each band with rewritten hardware sprites,
+     * which waits for the H-Blank before rewriting them.
+     * * Sprites don't have a fixed hardware sprite, so H-Blank effects can't be applied to them.
+     * * Sprites which share hardware sprites are not sorted between them.
+     *
+     * @param enabled `true` if the sprites multiplexer must be enabled; `false` otherwise.
+     */
+    void set_multiplexer_enabled(bool enabled);
+
+    /**
+     * @brief Indicates if sprites have been multiplexed in the last frame or not.
+     */
+    [[nodiscard]] bool multiplexing();
+
+    /**
+     * @brief Returns the number of horizontal screen bands used by the sprites multiplexer.
+     */
+    [[nodiscard]] constexpr int multiplexer_bands_count()
+    {
+        return (hw::display::height() + BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT - 1) /
+                BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT;
+    }
+
+    /**
+     * @brief Returns the number of hardware sprites used in the given screen band in the last multiplexed frame.
+     * @param band Screen band index in the range [0..multiplexer_bands_count()).
+     */
+    [[nodiscard]] int multiplexer_band_used_count(int band);
+
+    /**
+     * @brief Returns the number of hardware sprites rewritten before the given screen band
+     * in the last multiplexed frame.
+     * @param band Screen band index in the range [0..multiplexer_bands_count()).
+     */
+    [[nodiscard]] int multiplexer_band_rewrites_count(int band);
+
+    /**
+     * @brief Returns the number of sprites on screen which have not been displayed in the last multiplexed frame
+     * because there were no hardware sprites available for them,
+     * or because BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES was reached in their band.
+     */
+    [[nodiscard]] int multiplexer_dropped_count();
+
     /**
      * @return Returns the minimum priority of a sprite relative to backgrounds.
      */
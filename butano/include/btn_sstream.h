@@ -222,9 +222,9 @@ public:
     void append(long value);
 
     /**
-     * @brief Appends the character representation of the given int64_t value to the managed string.
+     * @brief Appends the character representation of the given long long value to the managed string.
      */
-    void append(int64_t value);
+    void append(long long value);
 
     /**
      * @brief Appends the character representation of the given unsigned value to the managed string.
@@ -237,9 +237,9 @@ public:
     void append(unsigned long value);
 
     /**
-     * @brief Appends the character representation of the given uint64_t value to the managed string.
+     * @brief Appends the character representation of the given unsigned long long value to the managed string.
      */
-    void append(uint64_t value);
+    void append(unsigned long long value);
 
     /**
      * @brief Appends the character representation of the given pointer to the managed string.
@@ -465,14 +465,14 @@ inline ostringstream& operator<<(ostringstream& stream, long value)
 }
 
 /**
- * @brief Appends the character representation of the given int64_t value to the given ostringstream.
+ * @brief Appends the character representation of the given long long value to the given ostringstream.
  * @param stream ostringstream in which to append to.
- * @param value int64_t value to append.
+ * @param value long long value to append.
  * @return Reference to the ostringstream.
  *
  * @ingroup string
  */
-inline ostringstream& operator<<(ostringstream& stream, int64_t value)
+inline ostringstream& operator<<(ostringstream& stream, long long value)
 {
     stream.append(value);
     return stream;
@@ -507,14 +507,14 @@ inline ostringstream& operator<<(ostringstream& stream, unsigned long value)
 }
 
 /**
- * @brief Appends the character representation of the given uint64_t value to the given ostringstream.
+ * @brief Appends the character representation of the given unsigned long long value to the given ostringstream.
  * @param stream ostringstream in which to append to.
- * @param value uint64_t value to append.
+ * @param value unsigned long long value to append.
  * @return Reference to the ostringstream.
  *
  * @ingroup string
  */
-inline ostringstream& operator<<(ostringstream& stream, uint64_t value)
+inline ostringstream& operator<<(ostringstream& stream, unsigned long long value)
 {
     stream.append(value);
     return stream;
@@ -68,6 +68,9 @@ protected:
     }
 
 private:
+    template<typename Action, int MaxSize>
+    friend class scheduled_actions;
+
     Property _delta_property;
     Property _initial_property;
 };
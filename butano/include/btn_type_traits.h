@@ -24,6 +24,12 @@ namespace btn
     using std::is_same;
     using std::is_same_v;
 
+    using std::is_integral;
+    using std::is_integral_v;
+
+    using std::is_signed;
+    using std::is_signed_v;
+
     using std::is_trivial;
     using std::is_trivial_v;
 
@@ -72,10 +72,10 @@ public:
         {
             size_type index = _index;
             size_type last_valid_index = _map->_last_valid_index;
-            const bool* allocated = _map->_allocated;
+            const uint16_t* metadata = _map->_metadata;
             ++index;
 
-            while(index <= last_valid_index && ! allocated[index])
+            while(index <= last_valid_index && ! metadata[index])
             {
                 ++index;
             }
@@ -97,10 +97,10 @@ public:
         {
             int index = _index;
             int first_valid_index = _map->_first_valid_index;
-            const bool* allocated = _map->_allocated;
+            const uint16_t* metadata = _map->_metadata;
             --index;
 
-            while(index >= first_valid_index && ! allocated[index])
+            while(index >= first_valid_index && ! metadata[index])
             {
                 --index;
             }
@@ -114,7 +114,7 @@ public:
          */
         [[nodiscard]] const_reference operator*() const
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage[_index];
         }
@@ -124,7 +124,7 @@ public:
          */
         [[nodiscard]] reference operator*()
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage[_index];
         }
@@ -134,7 +134,7 @@ public:
          */
         const_pointer operator->() const
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage + _index;
         }
@@ -144,7 +144,7 @@ public:
          */
         pointer operator->()
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage + _index;
         }
@@ -225,10 +225,10 @@ public:
         {
             size_type index = _index;
             size_type last_valid_index = _map->_last_valid_index;
-            const bool* allocated = _map->_allocated;
+            const uint16_t* metadata = _map->_metadata;
             ++index;
 
-            while(index <= last_valid_index && ! allocated[index])
+            while(index <= last_valid_index && ! metadata[index])
             {
                 ++index;
             }
@@ -250,10 +250,10 @@ public:
         {
             int index = _index;
             int first_valid_index = _map->_first_valid_index;
-            const bool* allocated = _map->_allocated;
+            const uint16_t* metadata = _map->_metadata;
             --index;
 
-            while(index >= first_valid_index && ! allocated[index])
+            while(index >= first_valid_index && ! metadata[index])
             {
                 --index;
             }
@@ -267,7 +267,7 @@ public:
          */
         [[nodiscard]] const_reference operator*() const
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage[_index];
         }
@@ -277,7 +277,7 @@ public:
          */
         const_pointer operator->() const
         {
-            BTN_ASSERT(_map->_allocated[_index], "Index is not allocated: ", _index);
+            BTN_ASSERT(_map->_metadata[_index], "Index is not allocated: ", _index);
 
             return _map->_storage + _index;
         }
@@ -592,21 +592,28 @@ public:
         }
 
         const_pointer storage = _storage;
-        const bool* allocated = _allocated;
+        const uint16_t* metadata = _metadata;
         key_equal key_equal_functor;
-        size_type index = _index(key_hash);
-        size_type max_size = _max_size_minus_one + 1;
-        size_type its = 0;
+        hash_type mixed_hash = _mixed_hash(key_hash);
+        unsigned fragment = _fragment(mixed_hash);
+        size_type index = _home_index(mixed_hash);
+        size_type distance = 0;
 
-        while(its < max_size && allocated[index])
+        while(unsigned current_metadata = metadata[index])
         {
-            if(key_equal_functor(key, storage[index].first))
+            // Elements are sorted by home index, so the search ends when an element closer to its home is found:
+            if(_distance(index, current_metadata) < distance)
+            {
+                return end();
+            }
+
+            if((current_metadata & _fragment_mask) == fragment && key_equal_functor(key, storage[index].first))
             {
                 return iterator(index, *this);
             }
 
             index = _index(index + 1);
-            ++its;
+            ++distance;
         }
 
         return end();
@@ -718,29 +725,64 @@ public:
      */
     iterator insert_hash(hash_type key_hash, value_type&& value)
     {
-        size_type index = _index(key_hash);
         pointer storage = _storage;
-        bool* allocated = _allocated;
+        uint16_t* metadata = _metadata;
         key_equal key_equal_functor;
-        size_type current_index = index;
+        hash_type mixed_hash = _mixed_hash(key_hash);
+        unsigned fragment = _fragment(mixed_hash);
+        size_type index = _home_index(mixed_hash);
+        size_type distance = 0;
 
-        while(allocated[current_index])
+        while(unsigned current_metadata = metadata[index])
         {
-            if(key_equal_functor(value.first, storage[current_index].first))
+            // Robin Hood: the new element takes the place of the first one which is closer to its home:
+            if(_distance(index, current_metadata) < distance)
+            {
+                break;
+            }
+
+            if((current_metadata & _fragment_mask) == fragment && key_equal_functor(value.first, storage[index].first))
             {
                 return end();
             }
 
-            current_index = _index(current_index + 1);
-            BTN_ASSERT(current_index != index, "All indices are allocated");
+            index = _index(index + 1);
+            ++distance;
         }
 
-        ::new(storage + current_index) value_type(move(value));
-        allocated[current_index] = true;
-        _first_valid_index = min(_first_valid_index, current_index);
-        _last_valid_index = max(_last_valid_index, current_index);
+        BTN_ASSERT(_size <= _max_size_minus_one, "All indices are allocated");
+
+        size_type last_index = index;
+
+        if(metadata[index])
+        {
+            // The rest of the cluster is moved forward one position, which keeps it sorted by home index:
+            do
+            {
+                last_index = _index(last_index + 1);
+            }
+            while(metadata[last_index]);
+
+            size_type current_index = last_index;
+
+            while(current_index != index)
+            {
+                size_type previous_index = _index(current_index - 1);
+                unsigned previous_metadata = metadata[previous_index];
+                metadata[current_index] = uint16_t(previous_metadata >> _distance_shift == unsigned(_max_distance) + 1 ?
+                                                       previous_metadata : previous_metadata + _distance_one);
+                ::new(storage + current_index) value_type(move(storage[previous_index]));
+                storage[previous_index].~value_type();
+                current_index = previous_index;
+            }
+        }
+
+        ::new(storage + index) value_type(move(value));
+        metadata[index] = _metadata_value(distance, fragment);
+        _first_valid_index = min(_first_valid_index, min(index, last_index));
+        _last_valid_index = max(_last_valid_index, max(index, last_index));
         ++_size;
-        return iterator(current_index, *this);
+        return iterator(index, *this);
     }
 
     /**
@@ -927,13 +969,13 @@ public:
      */
     iterator erase(const const_iterator& position)
     {
-        bool* allocated = _allocated;
+        uint16_t* metadata = _metadata;
         size_type index = position._index;
-        BTN_ASSERT(allocated[index], "Index is not allocated: ", index);
+        BTN_ASSERT(metadata[index], "Index is not allocated: ", index);
 
         pointer storage = _storage;
         storage[index].~value_type();
-        allocated[index] = false;
+        metadata[index] = 0;
         --_size;
 
         if(_size == 0)
@@ -943,39 +985,38 @@ public:
             return end();
         }
 
-        hasher hasher_functor;
         size_type current_index = index;
         size_type next_index = _index(index + 1);
 
-        while(allocated[next_index] && _index(hasher_functor(storage[next_index].first)) != next_index)
+        // Next elements of the same cluster which are not in their home index are moved back one position
+        // (backward shift deletion), so stored distances are enough to keep them reachable:
+        while(unsigned next_metadata = metadata[next_index])
         {
-            ::new(storage + current_index) value_type(move(storage[next_index]));
-            storage[next_index].~value_type();
-            allocated[current_index] = true;
-            allocated[next_index] = false;
-            current_index = next_index;
-            next_index = _index(next_index + 1);
-        }
+            size_type next_distance = _distance(next_index, next_metadata);
 
-        if(_size == 1)
-        {
-            if(index == _first_valid_index)
+            if(! next_distance)
             {
-                index = _last_valid_index;
-                _first_valid_index = _last_valid_index;
+                break;
             }
-            else
+
+            if(! next_index)
             {
-                index = _first_valid_index;
-                _last_valid_index = _first_valid_index;
+                // The first element is moved to the last index:
+                _last_valid_index = current_index;
             }
 
-            return iterator(index, *this);
+            metadata[current_index] = _metadata_value(next_distance - 1, next_metadata & _fragment_mask);
+            ::new(storage + current_index) value_type(move(storage[next_index]));
+            storage[next_index].~value_type();
+            current_index = next_index;
+            next_index = _index(next_index + 1);
         }
 
+        metadata[current_index] = 0;
+
         size_type first_valid_index = _first_valid_index;
 
-        while(! allocated[first_valid_index])
+        while(! metadata[first_valid_index])
         {
             ++first_valid_index;
         }
@@ -984,18 +1025,23 @@ public:
 
         size_type last_valid_index = _last_valid_index;
 
-        while(! allocated[last_valid_index])
+        while(! metadata[last_valid_index])
         {
             --last_valid_index;
         }
 
         _last_valid_index = last_valid_index;
 
-        while(index <= last_valid_index && ! allocated[index])
+        while(index <= last_valid_index && ! metadata[index])
         {
             ++index;
         }
 
+        if(index > last_valid_index)
+        {
+            index = max_size();
+        }
+
         return iterator(index, *this);
     }
 
@@ -1038,32 +1084,23 @@ public:
     friend size_type erase_if(iunordered_map& map, const Pred& pred)
     {
         size_type erased_count = 0;
-        pointer storage = map._storage;
-        bool* allocated = map._allocated;
-        size_type first_valid_index = map.max_size();
-        size_type last_valid_index = 0;
+        iterator it = map.begin();
+        iterator end = map.end();
 
-        for(size_type index = map._first_valid_index, last = map._last_valid_index; index <= last; ++index)
+        // Erased elements can't just be marked as free, since the next elements of their clusters must be moved back:
+        while(it != end)
         {
-            if(allocated[index])
+            if(pred(*it))
             {
-                if(allocated[index] && pred(storage[index]))
-                {
-                    storage[index].~value_type();
-                    allocated[index] = false;
-                    ++erased_count;
-                }
-                else
-                {
-                    first_valid_index = min(index, first_valid_index);
-                    last_valid_index = max(index, last_valid_index);
-                }
+                it = map.erase(it);
+                ++erased_count;
+            }
+            else
+            {
+                ++it;
             }
         }
 
-        map._size -= erased_count;
-        map._first_valid_index = first_valid_index;
-        map._last_valid_index = last_valid_index;
         return erased_count;
     }
 
@@ -1074,46 +1111,21 @@ public:
     {
         if(this != &other)
         {
-            BTN_ASSERT(_max_size_minus_one == other._max_size_minus_one,
-                       "Invalid max size: ", max_size(), " - ", other.max_size());
-
-            pointer storage = _storage;
             pointer other_storage = other._storage;
-            bool* allocated = _allocated;
-            bool* other_allocated = other._allocated;
-            size_type size = _size;
-            size_type first_valid_index = min(_first_valid_index, other._first_valid_index);
-            size_type last_valid_index = max(_last_valid_index, other._last_valid_index);
+            const uint16_t* other_metadata = other._metadata;
+            hasher hasher_functor;
 
-            for(size_type index = first_valid_index; index <= last_valid_index; ++index)
+            // Elements are inserted again, since their positions depend on the elements already stored in this map:
+            for(size_type index = other._first_valid_index, last = other._last_valid_index; index <= last; ++index)
             {
-                if(other_allocated[index])
+                if(other_metadata[index])
                 {
-                    value_type&& other_value = other_storage[index];
-
-                    if(allocated[index])
-                    {
-                        storage[index] = move(other_value);
-                    }
-                    else
-                    {
-                        ::new(storage + index) value_type(move(other_value));
-                        ++size;
-                    }
-
-                    other_value.~value_type();
+                    value_type& other_value = other_storage[index];
+                    insert_or_assign_hash(hasher_functor(other_value.first), move(other_value));
                 }
             }
 
-            _size = size;
-            _first_valid_index = first_valid_index;
-            _last_valid_index = last_valid_index;
-
-            int other_max_size = other.max_size();
-            memory::clear(other_max_size, *other.allocated);
-            other._first_valid_index = other_max_size;
-            other._last_valid_index = 0;
-            other._size = 0;
+            other.clear();
         }
     }
 
@@ -1125,20 +1137,20 @@ public:
         if(_size)
         {
             pointer storage = _storage;
-            bool* allocated = _allocated;
+            uint16_t* metadata = _metadata;
             size_type first_valid_index = _first_valid_index;
             size_type last_valid_index = _last_valid_index;
 
             for(size_type index = first_valid_index; index <= last_valid_index; ++index)
             {
-                if(allocated[index])
+                if(metadata[index])
                 {
                     storage[index].~value_type();
                 }
             }
 
             size_type max_size = _max_size_minus_one + 1;
-            memory::clear(max_size, *allocated);
+            memory::clear(max_size, *metadata);
             _first_valid_index = max_size;
             _last_valid_index = 0;
             _size = 0;
@@ -1200,16 +1212,16 @@ public:
 
             pointer storage = _storage;
             pointer other_storage = other._storage;
-            bool* allocated = _allocated;
-            bool* other_allocated = other._allocated;
+            uint16_t* metadata = _metadata;
+            uint16_t* other_metadata = other._metadata;
             size_type first_valid_index = min(_first_valid_index, other._first_valid_index);
             size_type last_valid_index = max(_last_valid_index, other._last_valid_index);
 
             for(size_type index = first_valid_index; index <= last_valid_index; ++index)
             {
-                if(other_allocated[index])
+                if(other_metadata[index])
                 {
-                    if(allocated[index])
+                    if(metadata[index])
                     {
                         btn::swap(storage[index], other_storage[index]);
                     }
@@ -1217,20 +1229,18 @@ public:
                     {
                         ::new(storage + index) value_type(move(other_storage[index]));
                         other_storage[index].~value_type();
-                        other_allocated[index] = false;
-                        allocated[index] = true;
                     }
                 }
                 else
                 {
-                    if(allocated[index])
+                    if(metadata[index])
                     {
                         ::new(other_storage + index) value_type(move(storage[index]));
                         storage[index].~value_type();
-                        allocated[index] = false;
-                        other_allocated[index] = true;
                     }
                 }
+
+                btn::swap(metadata[index], other_metadata[index]);
             }
 
             btn::swap(_size, other._size);
@@ -1267,17 +1277,17 @@ public:
 
         const_pointer a_storage = a._storage;
         const_pointer b_storage = b._storage;
-        const bool* a_allocated = a._allocated;
-        const bool* b_allocated = b._allocated;
+        const uint16_t* a_metadata = a._metadata;
+        const uint16_t* b_metadata = b._metadata;
 
         for(size_type index = first_valid_index; index <= last_valid_index; ++index)
         {
-            if(a_allocated[index] != b_allocated[index])
+            if(a_metadata[index] != b_metadata[index])
             {
                 return false;
             }
 
-            if(a_allocated[index] && a_storage[index] != b_storage[index])
+            if(a_metadata[index] && a_storage[index] != b_storage[index])
             {
                 return false;
             }
@@ -1348,10 +1358,11 @@ public:
 protected:
     /// @cond DO_NOT_DOCUMENT
 
-    iunordered_map(reference storage, bool& allocated, size_type max_size) :
+    iunordered_map(reference storage, uint16_t& metadata, size_type max_size) :
         _storage(&storage),
-        _allocated(&allocated),
+        _metadata(&metadata),
         _max_size_minus_one(max_size - 1),
+        _home_index_shift(__builtin_clz(unsigned(max_size))),
         _first_valid_index(max_size)
     {
         BTN_ASSERT(power_of_two(max_size), "Max size is not power of two: ", max_size);
@@ -1360,9 +1371,17 @@ protected:
     /// @endcond
 
 private:
+    // Each metadata entry stores the distance to the element home index plus one (zero for free indices)
+    // in its high byte and a fragment of the element hash in its low byte:
+    static constexpr unsigned _fragment_mask = 0xFF;
+    static constexpr unsigned _distance_shift = 8;
+    static constexpr unsigned _distance_one = 1 << _distance_shift;
+    static constexpr size_type _max_distance = 254;
+
     pointer _storage;
-    bool* _allocated;
+    uint16_t* _metadata;
     size_type _max_size_minus_one;
+    size_type _home_index_shift;
     size_type _first_valid_index;
     size_type _last_valid_index = 0;
     size_type _size = 0;
@@ -1371,14 +1390,14 @@ private:
     {
         const_pointer other_storage = other._storage;
         pointer storage = _storage;
-        bool* allocated = _allocated;
+        uint16_t* metadata = _metadata;
         size_type first_valid_index = other._first_valid_index;
         size_type last_valid_index = other._last_valid_index;
-        memory::copy(*other._allocated, other.max_size(), *allocated);
+        memory::copy(*other._metadata, other.max_size(), *metadata);
 
         for(size_type index = first_valid_index; index <= last_valid_index; ++index)
         {
-            if(allocated[index])
+            if(metadata[index])
             {
                 ::new(storage + index) value_type(other_storage[index]);
             }
@@ -1393,15 +1412,15 @@ private:
     {
         pointer other_storage = other._storage;
         pointer storage = _storage;
-        bool* allocated = _allocated;
+        uint16_t* metadata = _metadata;
         size_type first_valid_index = other._first_valid_index;
         size_type last_valid_index = other._last_valid_index;
         int other_max_size = other.max_size();
-        memory::copy(*other._allocated, other_max_size, *allocated);
+        memory::copy(*other._metadata, other_max_size, *metadata);
 
         for(size_type index = first_valid_index; index <= last_valid_index; ++index)
         {
-            if(allocated[index])
+            if(metadata[index])
             {
                 value_type& other_value = other_storage[index];
                 ::new(storage + index) value_type(move(other_value));
@@ -1413,7 +1432,7 @@ private:
         _last_valid_index = other._last_valid_index;
         _size = other._size;
 
-        memory::clear(other_max_size, *other.allocated);
+        memory::clear(other_max_size, *other._metadata);
         other._first_valid_index = other_max_size;
         other._last_valid_index = 0;
         other._size = 0;
@@ -1423,6 +1442,41 @@ private:
     {
         return key_hash & _max_size_minus_one;
     }
+
+    // Fibonacci hashing: home indices are taken from the high bits of the product,
+    // so hashes with constant low bits (like the ones of aligned pointers) are spread too:
+    [[nodiscard]] static hash_type _mixed_hash(hash_type key_hash)
+    {
+        return key_hash * 2654435769u;
+    }
+
+    [[nodiscard]] size_type _home_index(hash_type mixed_hash) const
+    {
+        return size_type(mixed_hash >> _home_index_shift) & _max_size_minus_one;
+    }
+
+    [[nodiscard]] static unsigned _fragment(hash_type mixed_hash)
+    {
+        return (mixed_hash >> 8) & _fragment_mask;
+    }
+
+    [[nodiscard]] static uint16_t _metadata_value(size_type distance, unsigned fragment)
+    {
+        return uint16_t(((min(distance, _max_distance) + 1) << _distance_shift) | fragment);
+    }
+
+    [[nodiscard]] size_type _distance(size_type index, unsigned metadata_value) const
+    {
+        size_type distance = size_type(metadata_value >> _distance_shift) - 1;
+
+        // Saturated distances are rare, so in that case the hash of the key is calculated again:
+        if(distance == _max_distance) [[unlikely]]
+        {
+            distance = _index(hash_type(index - _home_index(_mixed_hash(hasher()(_storage[index].first)))));
+        }
+
+        return distance;
+    }
 };
 
 
@@ -1450,7 +1504,7 @@ public:
      */
     unordered_map() :
         iunordered_map<Key, Value, KeyHash, KeyEqual>(
-            *reinterpret_cast<pointer>(_storage_buffer), *_allocated_buffer, MaxSize)
+            *reinterpret_cast<pointer>(_storage_buffer), *_metadata_buffer, MaxSize)
     {
     }
 
@@ -1576,7 +1630,7 @@ public:
 
 private:
     alignas(value_type) char _storage_buffer[sizeof(value_type) * MaxSize];
-    bool _allocated_buffer[MaxSize] = {};
+    uint16_t _metadata_buffer[MaxSize] = {};
 };
 
 }
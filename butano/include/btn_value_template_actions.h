@@ -92,6 +92,9 @@ protected:
     }
 
 private:
+    template<typename Action, int MaxSize>
+    friend class scheduled_actions;
+
     Value _value;
     Property _delta_property;
     Property _initial_property;
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_VRAM_COMMITS_H
+#define BTN_VRAM_COMMITS_H
+
+/**
+ * @file
+ * btn::vram_commits header file.
+ *
+ * @ingroup core
+ */
+
+#include "btn_common.h"
+
+/**
+ * @brief VRAM commits related functions.
+ *
+ * Tiles, maps and palettes uploads are done in the V-Blank period.
+ * To avoid overrunning it, they are limited by a bytes budget:
+ * uploads that don't fit in it are delayed to the next frames.
+ *
+ * Each upload is never split, so sprites and backgrounds never show half uploaded graphics.
+ *
+ * @ingroup core
+ */
+namespace btn::vram_commits
+{
+    /**
+     * @brief Returns the maximum number of bytes that can be uploaded to VRAM in a V-Blank period.
+     */
+    [[nodiscard]] int max_bytes_per_frame();
+
+    /**
+     * @brief Sets the maximum number of bytes that can be uploaded to VRAM in a V-Blank period.
+     *
+     * Uploads of new graphics (which VRAM contents are not valid yet)
+     * and uploads delayed too many frames are done even if they don't fit in this budget.
+     *
+     * @param max_bytes Maximum number of bytes; it must be greater than 0.
+     */
+    void set_max_bytes_per_frame(int max_bytes);
+
+    /**
+     * @brief Returns the number of bytes uploaded to VRAM in the last V-Blank period.
+     */
+    [[nodiscard]] int uploaded_bytes();
+
+    /**
+     * @brief Returns the number of bytes which upload was delayed in the last V-Blank period.
+     */
+    [[nodiscard]] int deferred_bytes();
+}
+
+#endif
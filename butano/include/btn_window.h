@@ -18,6 +18,7 @@
 namespace btn
 {
 
+class affine_bg_ptr;
 class regular_bg_ptr;
 
 /**
@@ -83,6 +84,20 @@ public:
      */
     void set_show_bg(const regular_bg_ptr& regular_bg, bool show);
 
+    /**
+     * @brief Indicates if the specified background is shown in this window.
+     * @param affine_bg Affine BG to ask for.
+     * @return `true` if the specified background is shown in this window, otherwise `false`.
+     */
+    [[nodiscard]] bool show_bg(const affine_bg_ptr& affine_bg) const;
+
+    /**
+     * @brief Sets if the specified background must be shown in this window.
+     * @param affine_bg Affine BG to show or hide.
+     * @param show `true` if the specified background must be shown in this window, otherwise `false`.
+     */
+    void set_show_bg(const affine_bg_ptr& affine_bg, bool show);
+
     /**
      * @brief Indicates if sprites are shown in this window.
      */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_adpcm_decoder.h"
+
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+namespace
+{
+    constexpr const int16_t _step_table[] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88,
+        97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+        724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660,
+        4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+        18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    constexpr const int8_t _index_table[] = {
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    constexpr const int _max_step_index = int(sizeof(_step_table) / sizeof(*_step_table)) - 1;
+}
+
+int adpcm_decoder::decode(int max_samples, int16_t* output)
+{
+    BTN_ASSERT(max_samples >= 0, "Invalid max samples: ", max_samples);
+    BTN_ASSERT(started(), "Decoder is not started");
+
+    const uint8_t* codes_ptr = _codes_ptr;
+    int block_sample = _block_sample;
+    int predictor = _predictor;
+    int step_index = _step_index;
+    int result = 0;
+
+    while(result < max_samples)
+    {
+        if(block_sample == 0)
+        {
+            if(_block_index == _blocks_count)
+            {
+                if(! _loop)
+                {
+                    break;
+                }
+
+                _block_index = 0;
+            }
+
+            const uint8_t* block_ptr = _blocks_ptr + (_block_index * block_bytes());
+            predictor = int16_t(block_ptr[0] | (block_ptr[1] << 8));
+            step_index = block_ptr[2];
+            BTN_ASSERT(step_index <= _max_step_index, "Invalid step index: ", step_index);
+
+            codes_ptr = block_ptr + 4;
+            output[result] = int16_t(predictor);
+            ++result;
+            block_sample = 1;
+            continue;
+        }
+
+        int block_end = min(samples_per_block(), block_sample + max_samples - result);
+
+        while(block_sample < block_end)
+        {
+            int code;
+
+            if(block_sample & 1)
+            {
+                code = *codes_ptr & 0xF;
+            }
+            else
+            {
+                code = *codes_ptr >> 4;
+                ++codes_ptr;
+            }
+
+            int step = _step_table[step_index];
+            int difference = step >> 3;
+
+            if(code & 4)
+            {
+                difference += step;
+            }
+
+            if(code & 2)
+            {
+                difference += step >> 1;
+            }
+
+            if(code & 1)
+            {
+                difference += step >> 2;
+            }
+
+            if(code & 8)
+            {
+                predictor = max(predictor - difference, -32768);
+            }
+            else
+            {
+                predictor = min(predictor + difference, 32767);
+            }
+
+            step_index = clamp(step_index + _index_table[code & 7], 0, _max_step_index);
+            output[result] = int16_t(predictor);
+            ++result;
+            ++block_sample;
+        }
+
+        if(block_sample == samples_per_block())
+        {
+            block_sample = 0;
+            ++_block_index;
+        }
+    }
+
+    _codes_ptr = codes_ptr;
+    _block_sample = block_sample;
+    _predictor = predictor;
+    _step_index = step_index;
+    return result;
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_ADPCM_DECODER_H
+#define BTN_ADPCM_DECODER_H
+
+#include "btn_assert.h"
+
+namespace btn
+{
+
+// Resumable decoder of mono IMA-ADPCM data.
+//
+// Data is stored in blocks of block_bytes() bytes. Each block begins with a header (16-bit first sample,
+// 8-bit step index and one padding byte) followed by 4-bit codes (low nibble first).
+class adpcm_decoder
+{
+
+public:
+    [[nodiscard]] static constexpr int block_bytes()
+    {
+        return 256;
+    }
+
+    [[nodiscard]] static constexpr int samples_per_block()
+    {
+        return ((block_bytes() - 4) * 2) + 1;
+    }
+
+    adpcm_decoder() = default;
+
+    void start(const uint8_t* blocks_ptr, int blocks_count, bool loop)
+    {
+        BTN_ASSERT(blocks_ptr, "Blocks is null");
+        BTN_ASSERT(blocks_count > 0, "Invalid blocks count: ", blocks_count);
+
+        _blocks_ptr = blocks_ptr;
+        _codes_ptr = nullptr;
+        _blocks_count = blocks_count;
+        _block_index = 0;
+        _block_sample = 0;
+        _predictor = 0;
+        _step_index = 0;
+        _loop = loop;
+    }
+
+    [[nodiscard]] bool started() const
+    {
+        return _blocks_ptr;
+    }
+
+    [[nodiscard]] bool done() const
+    {
+        return ! _loop && _block_index == _blocks_count;
+    }
+
+    void stop()
+    {
+        _blocks_ptr = nullptr;
+    }
+
+    // Decodes up to max_samples 16-bit samples, returning the number of decoded samples:
+    BTN_CODE_IWRAM int decode(int max_samples, int16_t* output);
+
+private:
+    const uint8_t* _blocks_ptr = nullptr;
+    const uint8_t* _codes_ptr = nullptr;
+    int _blocks_count = 0;
+    int _block_index = 0;
+    int _block_sample = 0;
+    int _predictor = 0;
+    int _step_index = 0;
+    bool _loop = false;
+};
+
+}
+
+#endif
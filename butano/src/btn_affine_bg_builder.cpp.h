@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_affine_bg_builder.h"
+
+#include "btn_bgs.h"
+#include "btn_affine_bg_ptr.h"
+
+namespace btn
+{
+
+affine_bg_builder& affine_bg_builder::set_rotation_angle(fixed rotation_angle)
+{
+    BTN_ASSERT(rotation_angle >= 0 && rotation_angle <= 360, "Invalid rotation angle: ", rotation_angle);
+
+    _rotation_angle = rotation_angle;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_horizontal_scale(fixed horizontal_scale)
+{
+    BTN_ASSERT(horizontal_scale > 0, "Invalid horizontal scale: ", horizontal_scale);
+
+    _horizontal_scale = horizontal_scale;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_vertical_scale(fixed vertical_scale)
+{
+    BTN_ASSERT(vertical_scale > 0, "Invalid vertical scale: ", vertical_scale);
+
+    _vertical_scale = vertical_scale;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_scale(fixed scale)
+{
+    BTN_ASSERT(scale > 0, "Invalid scale: ", scale);
+
+    _horizontal_scale = scale;
+    _vertical_scale = scale;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_scale(fixed horizontal_scale, fixed vertical_scale)
+{
+    BTN_ASSERT(horizontal_scale > 0, "Invalid horizontal scale: ", horizontal_scale);
+    BTN_ASSERT(vertical_scale > 0, "Invalid vertical scale: ", vertical_scale);
+
+    _horizontal_scale = horizontal_scale;
+    _vertical_scale = vertical_scale;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_priority(int priority)
+{
+    BTN_ASSERT(priority >= 0 && priority <= bgs::max_priority(), "Invalid priority: ", priority);
+
+    _priority = priority;
+    return *this;
+}
+
+affine_bg_builder& affine_bg_builder::set_z_order(int z_order)
+{
+    BTN_ASSERT(z_order >= bgs::min_z_order() && z_order <= bgs::max_z_order(), "Invalid z order: ", z_order);
+
+    _z_order = z_order;
+    return *this;
+}
+
+affine_bg_ptr affine_bg_builder::build() const
+{
+    return affine_bg_ptr::create(*this);
+}
+
+affine_bg_ptr affine_bg_builder::release_build()
+{
+    return affine_bg_ptr::create(move(*this));
+}
+
+optional<affine_bg_ptr> affine_bg_builder::build_optional() const
+{
+    return affine_bg_ptr::create_optional(*this);
+}
+
+optional<affine_bg_ptr> affine_bg_builder::release_build_optional()
+{
+    return affine_bg_ptr::create_optional(move(*this));
+}
+
+affine_bg_map_ptr affine_bg_builder::map() const
+{
+    if(_item)
+    {
+        return _item->create_map();
+    }
+
+    BTN_ASSERT(_map, "Map has been already released");
+
+    return *_map;
+}
+
+optional<affine_bg_map_ptr> affine_bg_builder::map_optional() const
+{
+    optional<affine_bg_map_ptr> result;
+
+    if(_item)
+    {
+        result = _item->create_map_optional();
+    }
+    else
+    {
+        result = _map;
+    }
+
+    return result;
+}
+
+affine_bg_map_ptr affine_bg_builder::release_map()
+{
+    if(_item)
+    {
+        return _item->create_map();
+    }
+
+    BTN_ASSERT(_map, "Map has been already released");
+
+    affine_bg_map_ptr result = move(*_map);
+    _map.reset();
+    return result;
+}
+
+optional<affine_bg_map_ptr> affine_bg_builder::release_map_optional()
+{
+    optional<affine_bg_map_ptr> result;
+
+    if(_item)
+    {
+        result = _item->create_map_optional();
+    }
+    else
+    {
+        if(_map)
+        {
+            result = move(*_map);
+            _map.reset();
+        }
+    }
+
+    return result;
+}
+
+}
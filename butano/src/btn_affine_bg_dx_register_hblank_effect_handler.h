@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AFFINE_BG_DX_REGISTER_HBLANK_EFFECT_HANDLER_H
+#define BTN_AFFINE_BG_DX_REGISTER_HBLANK_EFFECT_HANDLER_H
+
+#include "btn_display.h"
+#include "btn_any_fwd.h"
+#include "btn_optional.h"
+#include "btn_bgs_manager.h"
+#include "../hw/include/btn_hw_bgs.h"
+
+namespace btn
+{
+
+class affine_bg_dx_register_hblank_effect_handler
+{
+
+public:
+    static void setup_target(int, iany&)
+    {
+    }
+
+    [[nodiscard]] static bool target_visible(int target_id)
+    {
+        auto handle = reinterpret_cast<void*>(target_id);
+        return bgs_manager::hw_id(handle).has_value();
+    }
+
+    [[nodiscard]] static bool target_updated(int, iany&)
+    {
+        return false;
+    }
+
+    [[nodiscard]] static uint16_t* output_register(int target_id)
+    {
+        auto handle = reinterpret_cast<void*>(target_id);
+        return hw::bgs::affine_dx_register(*bgs_manager::hw_id(handle));
+    }
+
+    static void write_output_values(int, const iany&, const void* input_values_ptr, uint16_t* output_values_ptr)
+    {
+        // The register is 32 bits wide, so it is written with two 16 bits entries:
+        auto int_source = static_cast<const unsigned*>(input_values_ptr);
+        uint16_t* high_output_values_ptr = output_values_ptr + display::height();
+
+        for(int index = 0; index < display::height(); ++index)
+        {
+            unsigned value = int_source[index];
+            output_values_ptr[index] = uint16_t(value);
+            high_output_values_ptr[index] = uint16_t(value >> 16);
+        }
+    }
+
+    static void show(int)
+    {
+    }
+
+    static void cleanup(int)
+    {
+        bgs_manager::reload();
+    }
+};
+
+}
+
+#endif
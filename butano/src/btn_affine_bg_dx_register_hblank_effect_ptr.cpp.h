@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_affine_bg_dx_register_hblank_effect_ptr.h"
+
+#include "btn_span.h"
+#include "btn_display.h"
+#include "btn_optional.h"
+#include "btn_hblank_effects_manager.h"
+
+namespace btn
+{
+
+affine_bg_dx_register_hblank_effect_ptr affine_bg_dx_register_hblank_effect_ptr::create(
+        affine_bg_ptr bg, const span<const int>& values_ref)
+{
+    int id = hblank_effects_manager::create(values_ref.data(), values_ref.size(), int(bg.handle()),
+                                            hblank_effects_manager::handler_type::AFFINE_BG_DX_REGISTER);
+    return affine_bg_dx_register_hblank_effect_ptr(id, move(bg));
+}
+
+optional<affine_bg_dx_register_hblank_effect_ptr> affine_bg_dx_register_hblank_effect_ptr::create_optional(
+        affine_bg_ptr bg, const span<const int>& values_ref)
+{
+    int id = hblank_effects_manager::create_optional(values_ref.data(), values_ref.size(), int(bg.handle()),
+                                                     hblank_effects_manager::handler_type::AFFINE_BG_DX_REGISTER);
+    optional<affine_bg_dx_register_hblank_effect_ptr> result;
+
+    if(id >= 0)
+    {
+        result = affine_bg_dx_register_hblank_effect_ptr(id, move(bg));
+    }
+
+    return result;
+}
+
+span<const int> affine_bg_dx_register_hblank_effect_ptr::values_ref() const
+{
+    auto values_ptr = reinterpret_cast<const int*>(hblank_effects_manager::values_ref(id()));
+    return span<const int>(values_ptr, display::height());
+}
+
+void affine_bg_dx_register_hblank_effect_ptr::set_values_ref(const span<const int>& values_ref)
+{
+    hblank_effects_manager::set_values_ref(id(), values_ref.data(), values_ref.size());
+}
+
+void affine_bg_dx_register_hblank_effect_ptr::reload_values_ref()
+{
+    hblank_effects_manager::reload_values_ref(id());
+}
+
+void affine_bg_dx_register_hblank_effect_ptr::swap(affine_bg_dx_register_hblank_effect_ptr& other)
+{
+    hblank_effect_ptr::swap(other);
+    _bg.swap(other._bg);
+}
+
+affine_bg_dx_register_hblank_effect_ptr::affine_bg_dx_register_hblank_effect_ptr(int id, affine_bg_ptr&& bg) :
+    hblank_effect_ptr(id),
+    _bg(move(bg))
+{
+}
+
+}
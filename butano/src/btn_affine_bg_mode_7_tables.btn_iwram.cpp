@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_affine_bg_mode_7_tables.h"
+
+#include "btn_math.h"
+#include "btn_array.h"
+
+namespace btn
+{
+
+namespace
+{
+    [[nodiscard]] constexpr array<int, display::height() + 1> _create_reciprocal_lut()
+    {
+        array<int, display::height() + 1> result = {};
+
+        for(int index = 1; index <= display::height(); ++index)
+        {
+            result[index] = (1 << 16) / index;
+        }
+
+        return result;
+    }
+
+    // Divisions are avoided with the reciprocal of the distance to the horizon of each screen horizontal line:
+    constexpr const array<int, display::height() + 1> reciprocal_lut = _create_reciprocal_lut();
+}
+
+void affine_bg_mode_7_tables::update(fixed camera_x, fixed camera_z, fixed camera_height, fixed camera_angle,
+                                     int horizon_y, int focal_distance)
+{
+    BTN_ASSERT(camera_height > 0, "Invalid camera height: ", camera_height);
+    BTN_ASSERT(horizon_y >= 0 && horizon_y < display::height(), "Invalid horizon y: ", horizon_y);
+    BTN_ASSERT(focal_distance > 0, "Invalid focal distance: ", focal_distance);
+
+    for(int index = 0; index <= horizon_y; ++index)
+    {
+        _pa_values[index] = 0;
+        _pc_values[index] = 0;
+        _dx_values[index] = 0;
+        _dy_values[index] = 0;
+    }
+
+    // Sines, cosines, scales and factors have 12 bits of fractional precision, registers have 8:
+    int cos = degrees_cos(camera_angle).data();
+    int sin = degrees_sin(camera_angle).data();
+    int64_t height = camera_height.data();
+    int x = camera_x.data() >> 4;
+    int z = camera_z.data() >> 4;
+    int half_width = display::width() / 2;
+    int64_t dx_factor = (-half_width * cos) + (focal_distance * sin);
+    int64_t dz_factor = (-half_width * sin) - (focal_distance * cos);
+
+    for(int index = horizon_y + 1; index < display::height(); ++index)
+    {
+        // Map pixels per screen pixel in this screen horizontal line:
+        int64_t scale = (height * reciprocal_lut[index - horizon_y]) >> 16;
+
+        _pa_values[index] = int16_t((scale * cos) >> 16);
+        _pc_values[index] = int16_t((scale * sin) >> 16);
+        _dx_values[index] = x + int((scale * dx_factor) >> 16);
+        _dy_values[index] = z + int((scale * dz_factor) >> 16);
+    }
+}
+
+}
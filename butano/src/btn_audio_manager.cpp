@@ -6,13 +6,17 @@
 #include "btn_audio_manager.h"
 
 #include "btn_vector.h"
+#include "btn_optional.h"
 #include "btn_config_audio.h"
+#include "btn_audio_stream_mixer.h"
 #include "../hw/include/btn_hw_audio.h"
 
 #include "btn_music.cpp.h"
 #include "btn_sound.cpp.h"
 #include "btn_music_item.cpp.h"
 #include "btn_sound_item.cpp.h"
+#include "btn_audio_stream.cpp.h"
+#include "btn_audio_stream_item.cpp.h"
 
 namespace btn::audio_manager
 {
@@ -163,6 +167,13 @@ namespace
         int music_position = 0;
         bool music_playing = false;
         bool music_paused = false;
+        audio_stream_mixer stream_mixer;
+        optional<audio_stream_item> stream_to_play;
+        fixed stream_volume;
+        bool stream_playing = false;
+        bool stream_paused = false;
+        bool stream_loop = false;
+        bool stream_commit = false;
     };
 
     BTN_DATA_EWRAM static_data data;
@@ -173,6 +184,50 @@ namespace
         return fixed_t<10>(volume).data();
     }
 
+    int _hw_audio_stream_volume(fixed volume)
+    {
+        return fixed_t<8>(volume).data();
+    }
+
+    void _mix_audio_stream(int samples_count, int8_t* left_samples, int8_t* right_samples)
+    {
+        // Called by hw::audio after maxmod mixes a frame, from commit() or from the V-Blank handler,
+        // so the stream mixer is only modified in commit() while the V-Blank handler is disabled:
+        data.stream_mixer.mix(samples_count, left_samples, right_samples);
+    }
+
+    void _commit_audio_stream()
+    {
+        audio_stream_mixer& stream_mixer = data.stream_mixer;
+
+        if(data.stream_commit)
+        {
+            if(data.stream_to_play)
+            {
+                stream_mixer.play(*data.stream_to_play, hw::audio::mixing_rate(),
+                                  _hw_audio_stream_volume(data.stream_volume), data.stream_loop);
+                data.stream_to_play.reset();
+            }
+            else if(data.stream_playing)
+            {
+                stream_mixer.set_volume(_hw_audio_stream_volume(data.stream_volume));
+            }
+            else
+            {
+                stream_mixer.stop();
+            }
+
+            stream_mixer.set_paused(data.stream_paused);
+            data.stream_commit = false;
+        }
+
+        if(! stream_mixer.playing())
+        {
+            data.stream_playing = false;
+            data.stream_paused = false;
+        }
+    }
+
     int _hw_sound_volume(fixed volume)
     {
         return min(fixed_t<8>(volume).data(), 255);
@@ -191,7 +246,7 @@ namespace
 
 void init()
 {
-    hw::audio::init();
+    hw::audio::init(_mix_audio_stream);
 }
 
 void enable()
@@ -288,6 +343,73 @@ void set_music_volume(fixed volume)
     data.music_volume = volume;
 }
 
+bool audio_stream_playing()
+{
+    return data.stream_playing;
+}
+
+void play_audio_stream(const audio_stream_item& item, fixed volume, bool loop)
+{
+    BTN_ASSERT(volume >= 0 && volume <= 1, "Volume range is [0..1]: ", volume);
+    BTN_ASSERT(item.sample_rate() <= audio_stream_mixer::max_sample_rate(),
+               "Sample rate is too high: ", item.sample_rate(), " - ", audio_stream_mixer::max_sample_rate());
+
+    data.stream_to_play = item;
+    data.stream_volume = volume;
+    data.stream_playing = true;
+    data.stream_paused = false;
+    data.stream_loop = loop;
+    data.stream_commit = true;
+}
+
+void stop_audio_stream()
+{
+    BTN_ASSERT(data.stream_playing, "There's no audio stream playing");
+
+    data.stream_to_play.reset();
+    data.stream_playing = false;
+    data.stream_paused = false;
+    data.stream_commit = true;
+}
+
+bool audio_stream_paused()
+{
+    return data.stream_paused;
+}
+
+void pause_audio_stream()
+{
+    BTN_ASSERT(data.stream_playing, "There's no audio stream playing");
+    BTN_ASSERT(! data.stream_paused, "Audio stream was already paused");
+
+    data.stream_paused = true;
+    data.stream_commit = true;
+}
+
+void resume_audio_stream()
+{
+    BTN_ASSERT(data.stream_paused, "Audio stream was not paused");
+
+    data.stream_paused = false;
+    data.stream_commit = true;
+}
+
+fixed audio_stream_volume()
+{
+    BTN_ASSERT(data.stream_playing, "There's no audio stream playing");
+
+    return data.stream_volume;
+}
+
+void set_audio_stream_volume(fixed volume)
+{
+    BTN_ASSERT(volume >= 0 && volume <= 1, "Volume range is [0..1]: ", volume);
+    BTN_ASSERT(data.stream_playing, "There's no audio stream playing");
+
+    data.stream_volume = volume;
+    data.stream_commit = true;
+}
+
 void play_sound(int priority, sound_item item)
 {
     BTN_ASSERT(priority >= -32767 && priority <= 32767, "Priority range is [-32767..32767]: ", priority);
@@ -335,6 +457,8 @@ void commit()
     {
         data.music_position = hw::audio::music_position();
     }
+
+    _commit_audio_stream();
 }
 
 void enable_vblank_handler()
@@ -351,6 +475,11 @@ void stop()
         stop_music();
     }
 
+    if(data.stream_playing)
+    {
+        stop_audio_stream();
+    }
+
     stop_all_sounds();
 }
 
@@ -12,6 +12,7 @@ namespace btn
 {
     class music_item;
     class sound_item;
+    class audio_stream_item;
 }
 
 namespace btn::audio_manager
@@ -42,6 +43,22 @@ namespace btn::audio_manager
 
     void set_music_volume(fixed volume);
 
+    [[nodiscard]] bool audio_stream_playing();
+
+    void play_audio_stream(const audio_stream_item& item, fixed volume, bool loop);
+
+    void stop_audio_stream();
+
+    [[nodiscard]] bool audio_stream_paused();
+
+    void pause_audio_stream();
+
+    void resume_audio_stream();
+
+    [[nodiscard]] fixed audio_stream_volume();
+
+    void set_audio_stream_volume(fixed volume);
+
     void play_sound(int priority, sound_item item);
 
     void play_sound(int priority, sound_item item, fixed volume, fixed speed, fixed panning);
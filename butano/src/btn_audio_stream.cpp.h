@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_audio_stream.h"
+
+#include "btn_fixed.h"
+#include "btn_audio_manager.h"
+
+namespace btn::audio_stream
+{
+
+bool playing()
+{
+    return audio_manager::audio_stream_playing();
+}
+
+void play(const audio_stream_item& item)
+{
+    audio_manager::play_audio_stream(item, 1, false);
+}
+
+void play(const audio_stream_item& item, fixed volume)
+{
+    audio_manager::play_audio_stream(item, volume, false);
+}
+
+void play(const audio_stream_item& item, fixed volume, bool loop)
+{
+    audio_manager::play_audio_stream(item, volume, loop);
+}
+
+void stop()
+{
+    audio_manager::stop_audio_stream();
+}
+
+bool paused()
+{
+    return audio_manager::audio_stream_paused();
+}
+
+void pause()
+{
+    audio_manager::pause_audio_stream();
+}
+
+void resume()
+{
+    audio_manager::resume_audio_stream();
+}
+
+fixed volume()
+{
+    return audio_manager::audio_stream_volume();
+}
+
+void set_volume(fixed volume)
+{
+    audio_manager::set_audio_stream_volume(volume);
+}
+
+}
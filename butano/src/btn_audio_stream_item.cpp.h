@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_audio_stream_item.h"
+
+#include "btn_fixed.h"
+#include "btn_audio_manager.h"
+
+namespace btn
+{
+
+void audio_stream_item::play() const
+{
+    audio_manager::play_audio_stream(*this, 1, false);
+}
+
+void audio_stream_item::play(fixed volume) const
+{
+    audio_manager::play_audio_stream(*this, volume, false);
+}
+
+void audio_stream_item::play(fixed volume, bool loop) const
+{
+    audio_manager::play_audio_stream(*this, volume, loop);
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_audio_stream_mixer.h"
+
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+void audio_stream_mixer::mix(int samples_count, int8_t* left_samples, int8_t* right_samples)
+{
+    if(! _decoder.started() || _paused || ! _volume)
+    {
+        return;
+    }
+
+    unsigned step = _step;
+    unsigned fraction = _fraction;
+    int sample = _sample;
+    int volume = _volume;
+    int buffer_index = _buffer_index;
+    int buffer_size = _buffer_size;
+
+    for(int index = 0; index < samples_count; ++index)
+    {
+        fraction += step;
+
+        while(fraction >= 0x10000)
+        {
+            fraction -= 0x10000;
+
+            if(buffer_index == buffer_size)
+            {
+                buffer_index = 0;
+                buffer_size = _decoder.decode(int(sizeof(_buffer) / sizeof(*_buffer)), _buffer);
+
+                if(! buffer_size)
+                {
+                    _decoder.stop();
+                    return;
+                }
+            }
+
+            sample = _buffer[buffer_index];
+            ++buffer_index;
+        }
+
+        int value = (sample * volume) >> 16;
+        left_samples[index] = int8_t(clamp(left_samples[index] + value, -128, 127));
+        right_samples[index] = int8_t(clamp(right_samples[index] + value, -128, 127));
+    }
+
+    _fraction = fraction;
+    _sample = sample;
+    _buffer_index = buffer_index;
+    _buffer_size = buffer_size;
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_AUDIO_STREAM_MIXER_H
+#define BTN_AUDIO_STREAM_MIXER_H
+
+#include "btn_adpcm_decoder.h"
+#include "btn_audio_stream_item.h"
+
+namespace btn
+{
+
+// Decodes an audio stream in small chunks and adds it to already mixed 8-bit stereo samples.
+//
+// The stream is converted to the mixing rate with nearest neighbour resampling, so each mixed sample costs
+// one addition and the number of decoded samples per call is bounded by the stream sample rate.
+class audio_stream_mixer
+{
+
+public:
+    [[nodiscard]] static constexpr int max_sample_rate()
+    {
+        return 32768;
+    }
+
+    [[nodiscard]] bool playing() const
+    {
+        return _decoder.started();
+    }
+
+    void play(const audio_stream_item& item, int mixing_rate, int volume, bool loop)
+    {
+        BTN_ASSERT(item.sample_rate() > 0 && item.sample_rate() <= max_sample_rate(),
+                   "Invalid sample rate: ", item.sample_rate());
+        BTN_ASSERT(mixing_rate > 0, "Invalid mixing rate: ", mixing_rate);
+
+        _decoder.start(item.data_ptr(), item.blocks_count(), loop);
+        _step = unsigned((item.sample_rate() << 16) / mixing_rate);
+        _fraction = 0;
+        _sample = 0;
+        _buffer_index = 0;
+        _buffer_size = 0;
+        _paused = false;
+        set_volume(volume);
+    }
+
+    void stop()
+    {
+        _decoder.stop();
+    }
+
+    [[nodiscard]] bool paused() const
+    {
+        return _paused;
+    }
+
+    void set_paused(bool paused)
+    {
+        _paused = paused;
+    }
+
+    // Volume range is [0..256]:
+    void set_volume(int volume)
+    {
+        BTN_ASSERT(volume >= 0 && volume <= 256, "Invalid volume: ", volume);
+
+        _volume = volume;
+    }
+
+    // Adds the next samples of the stream to the given samples, stopping it at its end if it doesn't loop:
+    BTN_CODE_IWRAM void mix(int samples_count, int8_t* left_samples, int8_t* right_samples);
+
+private:
+    adpcm_decoder _decoder;
+    unsigned _step = 0;
+    unsigned _fraction = 0;
+    int _sample = 0;
+    int _volume = 0;
+    int _buffer_index = 0;
+    int _buffer_size = 0;
+    bool _paused = false;
+    int16_t _buffer[64];
+};
+
+}
+
+#endif
@@ -5,16 +5,23 @@
 
 #include "btn_bg_blocks_manager.h"
 
+#include "btn_math.h"
+#include "btn_fixed.h"
 #include "btn_vector.h"
 #include "btn_bgs_manager.h"
+#include "btn_decompressor.h"
 #include "btn_unordered_map.h"
 #include "btn_config_bg_blocks.h"
+#include "btn_vram_commit_queue.h"
+#include "btn_vram_commit_stream.h"
 #include "../hw/include/btn_hw_bg_blocks.h"
 
 #include "btn_bg_maps.cpp.h"
 #include "btn_bg_tiles.cpp.h"
 #include "btn_bg_tiles_ptr.cpp.h"
 #include "btn_bg_tiles_item.cpp.h"
+#include "btn_affine_bg_map_ptr.cpp.h"
+#include "btn_affine_bg_map_item.cpp.h"
 #include "btn_regular_bg_map_ptr.cpp.h"
 #include "btn_regular_bg_map_item.cpp.h"
 
@@ -69,6 +76,9 @@ namespace
     constexpr const int max_items = BTN_CFG_BG_BLOCKS_MAX_ITEMS;
     constexpr const int max_list_items = max_items + 1;
     constexpr const int max_tiles_half_words = _blocks_to_half_words(hw::bg_blocks::max_blocks());
+    constexpr const int compaction_max_bytes = BTN_CFG_BG_BLOCKS_COMPACTION_MAX_BYTES_PER_FRAME;
+
+    static_assert(compaction_max_bytes >= 0);
 
 
     enum class status_type
@@ -87,18 +97,26 @@ namespace
         unsigned usages = 0;
         optional<bg_tiles_ptr> tiles;
         optional<bg_palette_ptr> palette;
+        int big_map_x = 0;
+        int big_map_y = 0;
+        int committed_big_map_x = 0;
+        int committed_big_map_y = 0;
         uint16_t width = 0;
-        uint8_t height = 0;
+        uint16_t height = 0;
         uint8_t start_block = 0;
         uint8_t blocks_count = 0;
         uint8_t next_index = max_list_items;
+        compression_type compression = compression_type::NONE;
 
     private:
         uint8_t _status = uint8_t(status_type::FREE);
 
     public:
         bool is_tiles: 1 = false;
+        bool affine_map: 1 = false;
+        bool big_map: 1 = false;
         bool commit: 1 = false;
+        bool commit_big_map_window: 1 = false;
 
         [[nodiscard]] status_type status() const
         {
@@ -112,6 +130,16 @@ namespace
 
         [[nodiscard]] int half_words() const
         {
+            if(big_map)
+            {
+                return hw::bg_blocks::big_map_hw_size() * hw::bg_blocks::big_map_hw_size();
+            }
+
+            if(affine_map)
+            {
+                return (width * height) / 2;
+            }
+
             return width * height;
         }
 
@@ -209,6 +237,11 @@ namespace
             return _free_indices.available();
         }
 
+        [[nodiscard]] int available() const
+        {
+            return _free_indices.size();
+        }
+
         [[nodiscard]] bool full() const
         {
             return _free_indices.empty();
@@ -254,6 +287,14 @@ namespace
             return iterator(_items[index].next_index, *this);
         }
 
+        // Moves the item after index after the item at position_index, keeping its index:
+        void move_after(int index, int position_index)
+        {
+            auto moved_index = int(_items[index].next_index);
+            _join(index, _items[moved_index].next_index);
+            _insert_node_after(position_index, moved_index);
+        }
+
     private:
         item_type _items[max_list_items];
         vector<int8_t, max_items> _free_indices;
@@ -289,30 +330,62 @@ namespace
         int height;
         optional<bg_tiles_ptr> tiles;
         optional<bg_palette_ptr> palette;
+        compression_type compression;
+        bool affine_map;
 
-        static create_data from_tiles(const uint16_t* data_ptr, int half_words)
+        static create_data from_tiles(const uint16_t* data_ptr, int half_words, compression_type compression)
         {
-            return create_data{ data_ptr, _ceil_half_words_to_blocks(half_words), half_words, 1, nullopt, nullopt };
+            return create_data{ data_ptr, _ceil_half_words_to_blocks(half_words), half_words, 1, nullopt, nullopt,
+                        compression, false };
         }
 
-        static create_data from_map(const uint16_t* data_ptr, const size& dimensions, bg_tiles_ptr&& tiles,
-                                    bg_palette_ptr&& palette)
+        static create_data from_map(const uint16_t* data_ptr, const size& dimensions, compression_type compression,
+                                    bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
         {
-            return create_data{ data_ptr, _ceil_half_words_to_blocks(dimensions.width() * dimensions.height()),
-                        dimensions.width(), dimensions.height(), move(tiles), move(palette) };
+            int half_words = dimensions.width() * dimensions.height();
+
+            if(regular_bg_map_item::big(dimensions))
+            {
+                half_words = hw::bg_blocks::big_map_hw_size() * hw::bg_blocks::big_map_hw_size();
+            }
+
+            return create_data{ data_ptr, _ceil_half_words_to_blocks(half_words),
+                        dimensions.width(), dimensions.height(), move(tiles), move(palette), compression, false };
+        }
+
+        static create_data from_affine_map(const uint16_t* data_ptr, const size& dimensions,
+                                           compression_type compression, bg_tiles_ptr&& tiles,
+                                           bg_palette_ptr&& palette)
+        {
+            int half_words = (dimensions.width() * dimensions.height()) / 2;
+            return create_data{ data_ptr, _ceil_half_words_to_blocks(half_words),
+                        dimensions.width(), dimensions.height(), move(tiles), move(palette), compression, true };
         }
     };
 
 
+    class relocation_type
+    {
+
+    public:
+        uint8_t source_block;
+        uint8_t destination_block;
+        uint8_t blocks_count;
+    };
+
+
     class static_data
     {
 
     public:
         items_list items;
         unordered_map<const uint16_t*, int, max_items * 2> items_map;
+        vector<relocation_type, max_items> relocations;
+        vram_commit_queue<max_items> commit_queue;
+        vram_commit_stream streaming;
         int free_blocks_count = 0;
         int to_remove_blocks_count = 0;
-        bool check_commit = false;
+        int compaction_available_bytes = compaction_max_bytes;
         bool delay_commit = false;
     };
 
@@ -342,6 +415,7 @@ namespace
                             " - start_block: ", item.start_block,
                             " - blocks_count: ", item.blocks_count,
                             " - data: ", item.data,
+                            " - compression: ", int(item.compression),
                             " - usages: ", item.usages,
                             " - tiles: ", item.tiles_count(),
                             (item.commit ? " - commit" : " - no_commit"));
@@ -354,6 +428,7 @@ namespace
                             " - start_block: ", item.start_block,
                             " - blocks_count: ", item.blocks_count,
                             " - data: ", item.data,
+                            " - compression: ", int(item.compression),
                             " - usages: ", item.usages,
                             " - width: ", item.width ,
                             " - height: ", item.height,
@@ -380,7 +455,7 @@ namespace
 
             BTN_LOG("free_blocks_count: ", data.free_blocks_count);
             BTN_LOG("to_remove_blocks_count: ", data.to_remove_blocks_count);
-            BTN_LOG("check_commit: ", (data.check_commit ? "true" : "false"));
+            BTN_LOG("commit_queue_empty: ", (data.commit_queue.empty() ? "true" : "false"));
             BTN_LOG("delay_commit: ", (data.delay_commit ? "true" : "false"));
         }
 
@@ -400,7 +475,8 @@ namespace
             } while(false)
     #endif
 
-    [[nodiscard]] int _find_tiles_impl(const uint16_t* tiles_data, [[maybe_unused]] int half_words)
+    [[nodiscard]] int _find_tiles_impl(const uint16_t* tiles_data, [[maybe_unused]] compression_type compression,
+                                       [[maybe_unused]] int half_words)
     {
         BTN_ASSERT(tiles_data, "Tiles ref is null");
 
@@ -414,6 +490,8 @@ namespace
                        tiles_data, " - ", item.data);
             BTN_ASSERT(half_words == item.half_words(), "Tiles count does not match item tiles count: ",
                        half_words, " - ", item.half_words());
+            BTN_ASSERT(compression == item.compression, "Compression does not match item compression: ",
+                       int(compression), " - ", int(item.compression));
 
             switch(item.status())
             {
@@ -447,11 +525,23 @@ namespace
         return -1;
     }
 
-    [[nodiscard]] int _find_regular_map_impl(
-            const regular_bg_map_cell& map_cells_ref, [[maybe_unused]] const size& map_dimensions,
-            const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
+    [[nodiscard]] const uint16_t* _affine_map_data_ptr(const affine_bg_map_cell& map_cells_ref)
+    {
+        BTN_ASSERT(aligned<alignof(int)>(&map_cells_ref), "Map cells are not aligned");
+
+        return reinterpret_cast<const uint16_t*>(&map_cells_ref);
+    }
+
+    [[nodiscard]] bool _valid_affine_map_tiles(const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
+    {
+        return palette.bpp_mode() == palette_bpp_mode::BPP_8 && tiles.valid_tiles_count(palette_bpp_mode::BPP_8) &&
+                tiles.tiles_count() <= affine_bg_item::max_tiles_count();
+    }
+
+    [[nodiscard]] int _find_map_impl(
+            const uint16_t* data_ptr, [[maybe_unused]] const size& map_dimensions,
+            [[maybe_unused]] compression_type compression, const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
     {
-        const uint16_t* data_ptr = &map_cells_ref;
         auto items_map_iterator = data.items_map.find(data_ptr);
 
         if(items_map_iterator != data.items_map.end())
@@ -462,6 +552,8 @@ namespace
                        map_dimensions.width(), " - ", item.width);
             BTN_ASSERT(map_dimensions.height() == item.height, "Height does not match item height: ",
                        map_dimensions.height(), " - ", item.height);
+            BTN_ASSERT(compression == item.compression, "Compression does not match item compression: ",
+                       int(compression), " - ", int(item.compression));
             BTN_ASSERT(! item.tiles || tiles == *item.tiles,
                        "Tiles does not match item tiles: ", tiles.id(), " - ", item.tiles->id());
             BTN_ASSERT(! item.palette || palette == *item.palette,
@@ -502,12 +594,125 @@ namespace
         return -1;
     }
 
-    void _commit_item(const item_type& item)
+    [[nodiscard]] bool _commit_big_map_window(const item_type& item)
     {
-        if(item.is_tiles)
+        constexpr const int hw_size = hw::bg_blocks::big_map_hw_size();
+
+        return item.commit_big_map_window ||
+                abs(item.big_map_x - item.committed_big_map_x) >= hw_size ||
+                abs(item.big_map_y - item.committed_big_map_y) >= hw_size;
+    }
+
+    [[nodiscard]] int _commit_bytes(int id, const item_type& item)
+    {
+        if(id == data.commit_queue.streaming_id() && data.streaming.started())
+        {
+            return data.streaming.bytes();
+        }
+
+        if(item.big_map && ! _commit_big_map_window(item))
+        {
+            // Only the newly exposed columns and rows are uploaded:
+            int lines = abs(item.big_map_x - item.committed_big_map_x) +
+                    abs(item.big_map_y - item.committed_big_map_y);
+            return lines * hw::bg_blocks::big_map_hw_size() * 2;
+        }
+
+        return item.half_words() * 2;
+    }
+
+    void _commit_big_map(item_type& item)
+    {
+        constexpr const int hw_size = hw::bg_blocks::big_map_hw_size();
+
+        const uint16_t* data_ptr = item.data;
+        int width = item.width;
+        int height = item.height;
+        int x = item.big_map_x;
+        int y = item.big_map_y;
+        int tiles_offset = item.tiles_offset();
+        int palette_offset = item.palette_offset();
+        int block_index = item.start_block;
+
+        if(_commit_big_map_window(item))
+        {
+            for(int row = y, last_row = y + hw_size; row < last_row; ++row)
+            {
+                hw::bg_blocks::commit_big_map_row(data_ptr, width, height, x, row, tiles_offset, palette_offset,
+                                                  block_index);
+            }
+        }
+        else
+        {
+            int committed_x = item.committed_big_map_x;
+            int committed_y = item.committed_big_map_y;
+            int first_column = x < committed_x ? x : committed_x + hw_size;
+            int last_column = x < committed_x ? committed_x : x + hw_size;
+            int first_row = y < committed_y ? y : committed_y + hw_size;
+            int last_row = y < committed_y ? committed_y : y + hw_size;
+
+            for(int column = first_column; column < last_column; ++column)
+            {
+                hw::bg_blocks::commit_big_map_column(data_ptr, width, height, column, y, tiles_offset,
+                                                     palette_offset, block_index);
+            }
+
+            for(int row = first_row; row < last_row; ++row)
+            {
+                hw::bg_blocks::commit_big_map_row(data_ptr, width, height, x, row, tiles_offset, palette_offset,
+                                                  block_index);
+            }
+        }
+
+        item.committed_big_map_x = x;
+        item.committed_big_map_y = y;
+        item.commit_big_map_window = false;
+    }
+
+    void _check_affine_map_tiles([[maybe_unused]] const item_type& item)
+    {
+        BTN_ASSERT(item.tiles_offset() + (item.tiles->tiles_count() / 2) <= 256,
+                   "Affine map cells can't reference the tiles: ",
+                   item.tiles_offset(), " - ", item.tiles->tiles_count());
+    }
+
+    // LZ77 back-references point to the decompressed map cells, so the offsets of compressed maps are added
+    // once all of them are in VRAM:
+    void _offset_decompressed_map(const item_type& item)
+    {
+        if(item.affine_map)
+        {
+            _check_affine_map_tiles(item);
+            hw::bg_blocks::offset_affine_map(item.start_block, item.half_words(), item.tiles_offset());
+        }
+        else if(! item.is_tiles)
+        {
+            hw::bg_blocks::offset_map(item.start_block, item.half_words(), item.tiles_offset(), item.palette_offset());
+        }
+    }
+
+    void _commit_item(item_type& item)
+    {
+        if(item.compression != compression_type::NONE)
+        {
+            decompressor item_decompressor;
+            item_decompressor.start(item.data, item.compression, hw::bg_blocks::vram(item.start_block));
+            item_decompressor.decompress_all();
+            _offset_decompressed_map(item);
+        }
+        else if(item.is_tiles)
         {
             hw::bg_blocks::commit_tiles(item.data, item.start_block, item.half_words());
         }
+        else if(item.big_map)
+        {
+            _commit_big_map(item);
+        }
+        else if(item.affine_map)
+        {
+            _check_affine_map_tiles(item);
+            hw::bg_blocks::commit_affine_map(item.data, item.start_block, item.half_words(), item.tiles_offset());
+        }
         else
         {
             hw::bg_blocks::commit_map(item.data, item.start_block, item.half_words(), item.tiles_offset(),
@@ -515,16 +720,78 @@ namespace
         }
     }
 
-    void _check_commit_item(int id, const uint16_t* data_ptr, bool delay_commit)
+    // Compressed items which don't fit in the VRAM commits budget are decompressed over multiple frames:
+    [[nodiscard]] bool _stream_item(int id, item_type& item, int max_bytes)
+    {
+        if(id != data.commit_queue.streaming_id())
+        {
+            _commit_item(item);
+            return true;
+        }
+
+        vram_commit_stream& streaming = data.streaming;
+
+        if(! streaming.started() && ! streaming.start(item.data, item.compression))
+        {
+            // Without memory for the staging buffer, the item is committed at once:
+            _commit_item(item);
+            return true;
+        }
+
+        if(streaming.commit(max_bytes, hw::bg_blocks::vram(item.start_block)))
+        {
+            _offset_decompressed_map(item);
+            return true;
+        }
+
+        return false;
+    }
+
+    void _stop_streaming(int id)
+    {
+        if(id == data.commit_queue.streaming_id())
+        {
+            data.streaming.stop();
+        }
+    }
+
+    void _set_commit(int id, item_type& item, vram_commit_priority priority)
+    {
+        // All map cells must be uploaded again, not only the exposed ones:
+        item.commit = true;
+        item.commit_big_map_window = true;
+        data.commit_queue.push(id, priority, item.compression != compression_type::NONE);
+    }
+
+    void _reset_commit(int id, item_type& item)
+    {
+        if(item.commit)
+        {
+            item.commit = false;
+            _stop_streaming(id);
+            data.commit_queue.erase(id);
+        }
+    }
+
+    void _check_commit_item(int id, const uint16_t* data_ptr, compression_type compression, bool delay_commit,
+                            vram_commit_priority priority)
     {
         item_type& item = data.items.item(id);
+        BTN_ASSERT(compression == compression_type::NONE || ! item.big_map, "Big maps can't be compressed");
+        BTN_ASSERT(compression == compression_type::NONE ||
+                   decompressor::decompressed_bytes(data_ptr) == item.half_words() * 2,
+                   "Decompressed size does not match item size: ",
+                   decompressor::decompressed_bytes(data_ptr), " - ", item.half_words() * 2);
+
+        _stop_streaming(id);
         item.data = data_ptr;
+        item.compression = compression;
+        item.commit_big_map_window = true;
         data.items_map.insert(data_ptr, id);
 
         if(delay_commit)
         {
-            item.commit = true;
-            data.check_commit = true;
+            _set_commit(id, item, priority);
         }
         else
         {
@@ -612,15 +879,22 @@ namespace
         item->tiles = move(create_data.tiles);
         item->palette = move(create_data.palette);
         item->width = uint16_t(create_data.width);
-        item->height = uint8_t(create_data.height);
+        item->height = uint16_t(create_data.height);
         item->usages = 1;
         item->set_status(status_type::USED);
         item->is_tiles = is_tiles;
-        item->commit = false;
+        item->affine_map = create_data.affine_map;
+        item->big_map = ! is_tiles && ! create_data.affine_map &&
+                regular_bg_map_item::big(size(create_data.width, create_data.height));
+        item->big_map_x = 0;
+        item->big_map_y = 0;
+        item->compression = compression_type::NONE;
+        _reset_commit(id, *item);
 
         if(data_ptr)
         {
-            _check_commit_item(id, data_ptr, delay_commit);
+            // Item VRAM contents are not valid yet, so they must be committed as soon as possible:
+            _check_commit_item(id, data_ptr, create_data.compression, delay_commit, vram_commit_priority::FORCED);
         }
 
         return id;
@@ -772,7 +1046,7 @@ namespace
 
     [[nodiscard]] bool _remove_adjacent_item(int adjacent_id, item_type& current_item)
     {
-        const item_type& adjacent_item = data.items.item(adjacent_id);
+        item_type& adjacent_item = data.items.item(adjacent_id);
         status_type adjacent_item_status = adjacent_item.status();
         bool remove = adjacent_item_status != status_type::USED;
 
@@ -787,12 +1061,276 @@ namespace
                     data.items_map.erase(adjacent_item.data);
                 }
 
+                _reset_commit(adjacent_id, adjacent_item);
                 data.free_blocks_count += adjacent_item.blocks_count;
             }
         }
 
         return remove;
     }
+
+    // Items VRAM contents can be moved only if they can be reloaded and they are not being uploaded:
+    [[nodiscard]] bool _movable_item(const item_type& item)
+    {
+        return item.status() == status_type::USED && item.data && ! item.commit &&
+                _blocks_to_half_words(item.blocks_count) * 2 <= data.compaction_available_bytes;
+    }
+
+    // Tile sets keep their offset in their character base block, so the map cells which reference them
+    // don't need to be updated:
+    [[nodiscard]] int _tiles_destination_block(const item_type& item, const item_type& free_item)
+    {
+        int alignment_blocks_count = hw::bg_blocks::tiles_alignment_blocks_count();
+        int free_start_block = free_item.start_block;
+        int offset_blocks_count = item.start_block % alignment_blocks_count;
+        int result = free_start_block + ((offset_blocks_count - (free_start_block % alignment_blocks_count) +
+                                          alignment_blocks_count) % alignment_blocks_count);
+
+        if(result + item.blocks_count > free_start_block + free_item.blocks_count)
+        {
+            return -1;
+        }
+
+        return result;
+    }
+
+    void _relocate_item(item_type& item, int destination_block)
+    {
+        int old_start_block = item.start_block;
+        int blocks_count = item.blocks_count;
+        item.start_block = uint8_t(destination_block);
+        data.relocations.push_back(relocation_type{ uint8_t(old_start_block), uint8_t(destination_block),
+                                                    uint8_t(blocks_count) });
+        data.compaction_available_bytes -= _blocks_to_half_words(blocks_count) * 2;
+        data.to_remove_blocks_count += blocks_count;
+        data.free_blocks_count -= blocks_count;
+
+        // BG registers are updated in the same V-Blank period in which the blocks are copied:
+        if(item.is_tiles)
+        {
+            int alignment_blocks_count = hw::bg_blocks::tiles_alignment_blocks_count();
+            int new_tiles_cbb = destination_block / alignment_blocks_count;
+
+            if(new_tiles_cbb != old_start_block / alignment_blocks_count)
+            {
+                for(const item_type& map_item : data.items)
+                {
+                    if(map_item.status() != status_type::FREE && ! map_item.is_tiles && map_item.tiles &&
+                            map_item.tiles->id() == destination_block)
+                    {
+                        bgs_manager::update_map_tiles_cbb(map_item.start_block, new_tiles_cbb);
+                    }
+                }
+            }
+        }
+        else
+        {
+            bgs_manager::update_map_sbb(destination_block);
+        }
+    }
+
+    // BGs keep using the old blocks until the next commit, so they are not released until the next update:
+    int _insert_old_item(int id)
+    {
+        const item_type& item = data.items.item(id);
+        item_type old_item;
+        old_item.start_block = item.start_block;
+        old_item.blocks_count = item.blocks_count;
+        old_item.set_status(status_type::TO_REMOVE);
+        return data.items.insert_after(id, old_item).id();
+    }
+
+    // Tile sets are moved to the front of the first free item before them in which they fit:
+    void _move_tiles_item(int previous_id, int free_previous_id, int destination_block)
+    {
+        int id = data.items.item(previous_id).next_index;
+        int free_id = data.items.item(free_previous_id).next_index;
+        item_type& item = data.items.item(id);
+        item_type& free_item = data.items.item(free_id);
+        int blocks_count = item.blocks_count;
+        int free_start_block = free_item.start_block;
+        int padding_blocks_count = destination_block - free_start_block;
+        int new_free_blocks_count = free_start_block + free_item.blocks_count - destination_block - blocks_count;
+        _insert_old_item(id);
+        data.items.move_after(previous_id, padding_blocks_count ? free_id : free_previous_id);
+
+        if(padding_blocks_count)
+        {
+            free_item.blocks_count = uint8_t(padding_blocks_count);
+
+            if(new_free_blocks_count)
+            {
+                item_type new_free_item;
+                new_free_item.start_block = uint8_t(destination_block + blocks_count);
+                new_free_item.blocks_count = uint8_t(new_free_blocks_count);
+                data.items.insert_after(id, new_free_item);
+            }
+        }
+        else if(new_free_blocks_count)
+        {
+            free_item.start_block = uint8_t(destination_block + blocks_count);
+            free_item.blocks_count = uint8_t(new_free_blocks_count);
+        }
+        else
+        {
+            data.items.erase_after(id);
+        }
+
+        _relocate_item(item, destination_block);
+    }
+
+    // Maps are moved to the back of the last free item after them in which they fit:
+    void _move_map_item(int previous_id, int free_previous_id)
+    {
+        int id = data.items.item(previous_id).next_index;
+        int free_id = data.items.item(free_previous_id).next_index;
+        item_type& item = data.items.item(id);
+        item_type& free_item = data.items.item(free_id);
+        int blocks_count = item.blocks_count;
+        int new_free_blocks_count = free_item.blocks_count - blocks_count;
+        int destination_block = free_item.start_block + new_free_blocks_count;
+        int old_id = _insert_old_item(id);
+        data.items.move_after(previous_id, free_id);
+
+        if(new_free_blocks_count)
+        {
+            free_item.blocks_count = uint8_t(new_free_blocks_count);
+        }
+        else
+        {
+            data.items.erase_after(free_previous_id == id ? old_id : free_previous_id);
+        }
+
+        _relocate_item(item, destination_block);
+    }
+
+    // Maps are moved from the front and tile sets from the back, so each item is moved only once:
+    [[nodiscard]] bool _compact_item()
+    {
+        auto end = data.items.end();
+        auto previous_iterator = data.items.before_begin();
+        auto iterator = data.items.begin();
+        int tiles_previous_id = -1;
+        int tiles_free_previous_id = -1;
+        int tiles_destination_block = -1;
+
+        while(iterator != end)
+        {
+            item_type& item = *iterator;
+
+            if(_movable_item(item))
+            {
+                if(item.is_tiles)
+                {
+                    auto free_previous_iterator = data.items.before_begin();
+                    auto free_iterator = data.items.begin();
+
+                    while(free_iterator != iterator)
+                    {
+                        const item_type& free_item = *free_iterator;
+
+                        if(free_item.status() == status_type::FREE)
+                        {
+                            int destination_block = _tiles_destination_block(item, free_item);
+
+                            if(destination_block >= 0)
+                            {
+                                tiles_previous_id = previous_iterator.id();
+                                tiles_free_previous_id = free_previous_iterator.id();
+                                tiles_destination_block = destination_block;
+                                break;
+                            }
+                        }
+
+                        free_previous_iterator = free_iterator;
+                        ++free_iterator;
+                    }
+                }
+                else
+                {
+                    auto free_previous_iterator = iterator;
+                    auto free_iterator = iterator;
+                    ++free_iterator;
+
+                    auto last_free_previous_iterator = end;
+
+                    while(free_iterator != end)
+                    {
+                        const item_type& free_item = *free_iterator;
+
+                        if(free_item.status() == status_type::FREE && free_item.blocks_count >= item.blocks_count)
+                        {
+                            last_free_previous_iterator = free_previous_iterator;
+                        }
+
+                        free_previous_iterator = free_iterator;
+                        ++free_iterator;
+                    }
+
+                    if(last_free_previous_iterator != end)
+                    {
+                        _move_map_item(previous_iterator.id(), last_free_previous_iterator.id());
+                        return true;
+                    }
+                }
+            }
+
+            previous_iterator = iterator;
+            ++iterator;
+        }
+
+        if(tiles_destination_block >= 0)
+        {
+            _move_tiles_item(tiles_previous_id, tiles_free_previous_id, tiles_destination_block);
+            return true;
+        }
+
+        return false;
+    }
+
+    void _compact()
+    {
+        int free_items_count = 0;
+
+        for(const item_type& item : data.items)
+        {
+            if(item.status() == status_type::FREE)
+            {
+                ++free_items_count;
+            }
+        }
+
+        if(free_items_count < 2)
+        {
+            return;
+        }
+
+        BTN_BG_BLOCKS_LOG("bg_blocks_manager - COMPACT");
+
+        // Each move can add two items (the old blocks and a free item after the moved one):
+        while(data.items.available() >= 2 && ! data.relocations.full() && _compact_item())
+        {
+        }
+
+        if(! data.relocations.empty())
+        {
+            BTN_BG_BLOCKS_LOG_STATUS();
+        }
+    }
+
+    void _commit_relocations()
+    {
+        // Relocations are committed before the other uploads, since old VRAM contents can be replaced by them:
+        for(const relocation_type& relocation : data.relocations)
+        {
+            int blocks_count = relocation.blocks_count;
+            hw::bg_blocks::copy_blocks(relocation.source_block, blocks_count, relocation.destination_block);
+            vram_commits_manager::force(_blocks_to_half_words(blocks_count) * 2);
+        }
+
+        data.relocations.clear();
+        data.compaction_available_bytes = compaction_max_bytes;
+    }
 }
 
 void init()
@@ -868,36 +1406,69 @@ int available_map_blocks_count()
     return data.free_blocks_count;
 }
 
-int find_tiles(const span<const tile>& tiles_ref)
+fixed fragmentation()
+{
+    int free_blocks_count = data.free_blocks_count;
+
+    if(! free_blocks_count)
+    {
+        return 0;
+    }
+
+    int biggest_free_blocks_count = 0;
+
+    for(const item_type& item : data.items)
+    {
+        if(item.status() == status_type::FREE)
+        {
+            biggest_free_blocks_count = max(biggest_free_blocks_count, int(item.blocks_count));
+        }
+    }
+
+    return 1 - (fixed(biggest_free_blocks_count) / free_blocks_count);
+}
+
+int find_tiles(const span<const tile>& tiles_ref, compression_type compression)
 {
     auto tiles_data = reinterpret_cast<const uint16_t*>(tiles_ref.data());
     int tiles_count = tiles_ref.size();
 
-    BTN_BG_BLOCKS_LOG("bg_blocks_manager - FIND TILES: ", tiles_data, " - ", tiles_count);
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - FIND TILES: ", tiles_data, " - ", tiles_count, " - ", int(compression));
 
     int half_words = _tiles_to_half_words(tiles_count);
-    return _find_tiles_impl(tiles_data, half_words);
+    return _find_tiles_impl(tiles_data, compression, half_words);
 }
 
 int find_regular_map(const regular_bg_map_cell& map_cells_ref, [[maybe_unused]] const size& map_dimensions,
-                     const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
+                     compression_type compression, const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
 {
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - FIND REGULAR MAP: ", &map_cells_ref, " - ",
-                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", palette.id());
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      palette.id());
 
-    return _find_regular_map_impl(map_cells_ref, map_dimensions, tiles, palette);
+    return _find_map_impl(&map_cells_ref, map_dimensions, compression, tiles, palette);
 }
 
-int create_tiles(const span<const tile>& tiles_ref)
+int find_affine_map(const affine_bg_map_cell& map_cells_ref, [[maybe_unused]] const size& map_dimensions,
+                    compression_type compression, const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
+{
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - FIND AFFINE MAP: ", &map_cells_ref, " - ",
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      palette.id());
+
+    return _find_map_impl(_affine_map_data_ptr(map_cells_ref), map_dimensions, compression, tiles, palette);
+}
+
+int create_tiles(const span<const tile>& tiles_ref, compression_type compression)
 {
     auto tiles_data = reinterpret_cast<const uint16_t*>(tiles_ref.data());
     int tiles_count = tiles_ref.size();
     int half_words = _tiles_to_half_words(tiles_count);
 
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE TILES: ", tiles_data, " - ", tiles_count, " - ",
-                      _ceil_half_words_to_blocks(half_words));
+                      _ceil_half_words_to_blocks(half_words), " - ", int(compression));
 
-    int result = _find_tiles_impl(tiles_data, half_words);
+    int result = _find_tiles_impl(tiles_data, compression, half_words);
 
     if(result != -1)
     {
@@ -907,7 +1478,7 @@ int create_tiles(const span<const tile>& tiles_ref)
     BTN_ASSERT(half_words > 0 && half_words <= max_tiles_half_words,
                "Invalid tiles count: ", tiles_count, " - ", half_words);
 
-    result = _create_impl<true>(create_data::from_tiles(tiles_data, half_words));
+    result = _create_impl<true>(create_data::from_tiles(tiles_data, half_words, compression));
 
     if(result != -1)
     {
@@ -922,24 +1493,28 @@ int create_tiles(const span<const tile>& tiles_ref)
     return result;
 }
 
-int create_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions, bg_tiles_ptr&& tiles,
-                       bg_palette_ptr&& palette)
+int create_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                       compression_type compression, bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
 {
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE REGULAR MAP: ", &map_cells_ref, " - ",
-                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", tiles.id(), " - ", palette.id());
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      tiles.id(), " - ", palette.id());
 
-    int result = _find_regular_map_impl(map_cells_ref, map_dimensions, tiles, palette);
+    int result = _find_map_impl(&map_cells_ref, map_dimensions, compression, tiles, palette);
 
     if(result != -1)
     {
         return result;
     }
 
-    BTN_ASSERT(map_dimensions.width() == 32 || map_dimensions.width() == 64, "Invalid width: ", map_dimensions.width());
-    BTN_ASSERT(map_dimensions.height() == 32 || map_dimensions.height() == 64, "Invalid height: ", map_dimensions.height());
+    BTN_ASSERT(map_dimensions.width() >= 32 && map_dimensions.width() <= regular_bg_map_item::max_big_dimension(),
+               "Invalid width: ", map_dimensions.width());
+    BTN_ASSERT(map_dimensions.height() >= 32 && map_dimensions.height() <= regular_bg_map_item::max_big_dimension(),
+               "Invalid height: ", map_dimensions.height());
     BTN_ASSERT(tiles.valid_tiles_count(palette.bpp_mode()), "Invalid tiles count: ", tiles.tiles_count());
 
-    result = _create_impl<false>(create_data::from_map(&map_cells_ref, map_dimensions, move(tiles), move(palette)));
+    result = _create_impl<false>(create_data::from_map(&map_cells_ref, map_dimensions, compression, move(tiles),
+                                                       move(palette)));
 
     if(result != -1)
     {
@@ -954,12 +1529,47 @@ int create_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map
     return result;
 }
 
-int create_new_tiles(const span<const tile>& tiles_ref)
+int create_affine_map(const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                      compression_type compression, bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
+{
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE AFFINE MAP: ", &map_cells_ref, " - ",
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      tiles.id(), " - ", palette.id());
+
+    const uint16_t* data_ptr = _affine_map_data_ptr(map_cells_ref);
+    int result = _find_map_impl(data_ptr, map_dimensions, compression, tiles, palette);
+
+    if(result != -1)
+    {
+        return result;
+    }
+
+    BTN_ASSERT(affine_bg_map_item::valid_dimensions(map_dimensions),
+               "Invalid dimensions: ", map_dimensions.width(), " - ", map_dimensions.height());
+    BTN_ASSERT(_valid_affine_map_tiles(tiles, palette), "Invalid tiles or palette: ", tiles.tiles_count());
+
+    result = _create_impl<false>(create_data::from_affine_map(data_ptr, map_dimensions, compression, move(tiles),
+                                                              move(palette)));
+
+    if(result != -1)
+    {
+        BTN_BG_BLOCKS_LOG("CREATED. start_block: ", data.items.item(result).start_block);
+        BTN_BG_BLOCKS_LOG_STATUS();
+    }
+    else
+    {
+        BTN_BG_BLOCKS_LOG("NOT CREATED");
+    }
+
+    return result;
+}
+
+int create_new_tiles(const span<const tile>& tiles_ref, compression_type compression)
 {
     int half_words = _tiles_to_half_words(tiles_ref.size());
 
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE NEW TILES: ", tiles_ref.data(), " - ", tiles_ref.size(), " - ",
-                      _ceil_half_words_to_blocks(half_words));
+                      _ceil_half_words_to_blocks(half_words), " - ", int(compression));
 
     BTN_ASSERT(half_words > 0 && half_words <= max_tiles_half_words,
                "Invalid tiles count: ", tiles_ref.size(), " - ", half_words);
@@ -967,7 +1577,7 @@ int create_new_tiles(const span<const tile>& tiles_ref)
     auto data_ptr = reinterpret_cast<const uint16_t*>(tiles_ref.data());
     BTN_ASSERT(data.items_map.find(data_ptr) == data.items_map.end(), "Multiple copies of the same data not supported");
 
-    int result = _create_impl<true>(create_data::from_tiles(data_ptr, half_words));
+    int result = _create_impl<true>(create_data::from_tiles(data_ptr, half_words, compression));
 
     if(result != -1)
     {
@@ -982,20 +1592,54 @@ int create_new_tiles(const span<const tile>& tiles_ref)
     return result;
 }
 
-int create_new_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions, bg_tiles_ptr&& tiles,
-                           bg_palette_ptr&& palette)
+int create_new_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                           compression_type compression, bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
 {
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE NEW REGULAR MAP: ", &map_cells_ref, " - ",
-                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", tiles.id(), " - ", palette.id());
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      tiles.id(), " - ", palette.id());
 
-    BTN_ASSERT(map_dimensions.width() == 32 || map_dimensions.width() == 64, "Invalid width: ", map_dimensions.width());
-    BTN_ASSERT(map_dimensions.height() == 32 || map_dimensions.height() == 64, "Invalid height: ", map_dimensions.height());
+    BTN_ASSERT(map_dimensions.width() >= 32 && map_dimensions.width() <= regular_bg_map_item::max_big_dimension(),
+               "Invalid width: ", map_dimensions.width());
+    BTN_ASSERT(map_dimensions.height() >= 32 && map_dimensions.height() <= regular_bg_map_item::max_big_dimension(),
+               "Invalid height: ", map_dimensions.height());
     BTN_ASSERT(tiles.valid_tiles_count(palette.bpp_mode()), "Invalid tiles count: ", tiles.tiles_count());
 
     const uint16_t* data_ptr = &map_cells_ref;
     BTN_ASSERT(data.items_map.find(data_ptr) == data.items_map.end(), "Multiple copies of the same data not supported");
 
-    int result = _create_impl<false>(create_data::from_map(data_ptr, map_dimensions, move(tiles), move(palette)));
+    int result = _create_impl<false>(create_data::from_map(data_ptr, map_dimensions, compression, move(tiles),
+                                                           move(palette)));
+
+    if(result != -1)
+    {
+        BTN_BG_BLOCKS_LOG("CREATED. start_block: ", data.items.item(result).start_block);
+        BTN_BG_BLOCKS_LOG_STATUS();
+    }
+    else
+    {
+        BTN_BG_BLOCKS_LOG("NOT CREATED");
+    }
+
+    return result;
+}
+
+int create_new_affine_map(const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                          compression_type compression, bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
+{
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE NEW AFFINE MAP: ", &map_cells_ref, " - ",
+                      map_dimensions.width(), " - ", map_dimensions.height(), " - ", int(compression), " - ",
+                      tiles.id(), " - ", palette.id());
+
+    BTN_ASSERT(affine_bg_map_item::valid_dimensions(map_dimensions),
+               "Invalid dimensions: ", map_dimensions.width(), " - ", map_dimensions.height());
+    BTN_ASSERT(_valid_affine_map_tiles(tiles, palette), "Invalid tiles or palette: ", tiles.tiles_count());
+
+    const uint16_t* data_ptr = _affine_map_data_ptr(map_cells_ref);
+    BTN_ASSERT(data.items_map.find(data_ptr) == data.items_map.end(), "Multiple copies of the same data not supported");
+
+    int result = _create_impl<false>(create_data::from_affine_map(data_ptr, map_dimensions, compression,
+                                                                  move(tiles), move(palette)));
 
     if(result != -1)
     {
@@ -1019,7 +1663,7 @@ int allocate_tiles(int tiles_count)
     BTN_ASSERT(half_words > 0 && half_words <= max_tiles_half_words,
                "Invalid tiles count: ", tiles_count, " - ", half_words);
 
-    int result = _allocate_impl<true>(create_data::from_tiles(nullptr, half_words));
+    int result = _allocate_impl<true>(create_data::from_tiles(nullptr, half_words, compression_type::NONE));
 
     if(result != -1)
     {
@@ -1043,7 +1687,33 @@ int allocate_regular_map(const size& map_dimensions, bg_tiles_ptr&& tiles, bg_pa
     BTN_ASSERT(map_dimensions.height() == 32 || map_dimensions.height() == 64, "Invalid height: ", map_dimensions.height());
     BTN_ASSERT(tiles.valid_tiles_count(palette.bpp_mode()), "Invalid tiles count: ", tiles.tiles_count());
 
-    int result = _allocate_impl<false>(create_data::from_map(nullptr, map_dimensions, move(tiles), move(palette)));
+    int result = _allocate_impl<false>(create_data::from_map(nullptr, map_dimensions, compression_type::NONE,
+                                                             move(tiles), move(palette)));
+
+    if(result != -1)
+    {
+        BTN_BG_BLOCKS_LOG("ALLOCATED. start_block: ", data.items.item(result).start_block);
+        BTN_BG_BLOCKS_LOG_STATUS();
+    }
+    else
+    {
+        BTN_BG_BLOCKS_LOG("NOT ALLOCATED");
+    }
+
+    return result;
+}
+
+int allocate_affine_map(const size& map_dimensions, bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
+{
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - ALLOCATE AFFINE MAP: ", map_dimensions.width(), " - ",
+                      map_dimensions.height(), " - ", tiles.id(), " - ", palette.id());
+
+    BTN_ASSERT(affine_bg_map_item::valid_dimensions(map_dimensions),
+               "Invalid dimensions: ", map_dimensions.width(), " - ", map_dimensions.height());
+    BTN_ASSERT(_valid_affine_map_tiles(tiles, palette), "Invalid tiles or palette: ", tiles.tiles_count());
+
+    int result = _allocate_impl<false>(create_data::from_affine_map(nullptr, map_dimensions, compression_type::NONE,
+                                                                    move(tiles), move(palette)));
 
     if(result != -1)
     {
@@ -1115,7 +1785,7 @@ size map_dimensions(int id)
     const item_type& item = data.items.item(id);
     optional<span<const tile>> result;
 
-    if(const uint16_t* data_ptr = item.data)
+    if(const uint16_t* data_ptr = item.data; data_ptr && item.compression == compression_type::NONE)
     {
         auto tiles = reinterpret_cast<const tile*>(data_ptr);
         result.emplace(tiles, item.tiles_count());
@@ -1129,7 +1799,7 @@ optional<span<const regular_bg_map_cell>> regular_map_cells_ref(int id)
     const item_type& item = data.items.item(id);
     optional<span<const regular_bg_map_cell>> result;
 
-    if(item.data)
+    if(item.data && item.compression == compression_type::NONE)
     {
         result.emplace(item.data, item.width * item.height);
     }
@@ -1137,10 +1807,46 @@ optional<span<const regular_bg_map_cell>> regular_map_cells_ref(int id)
     return result;
 }
 
-void set_tiles_ref(int id, const span<const tile>& tiles_ref)
+optional<span<const affine_bg_map_cell>> affine_map_cells_ref(int id)
+{
+    const item_type& item = data.items.item(id);
+    optional<span<const affine_bg_map_cell>> result;
+
+    if(item.data && item.compression == compression_type::NONE)
+    {
+        result.emplace(reinterpret_cast<const affine_bg_map_cell*>(item.data), item.width * item.height);
+    }
+
+    return result;
+}
+
+void update_regular_map_position(int map_id, int x, int y)
+{
+    for(auto iterator = data.items.begin(), end = data.items.end(); iterator != end; ++iterator)
+    {
+        item_type& item = *iterator;
+
+        if(item.start_block == map_id && item.big_map && item.status() == status_type::USED)
+        {
+            if(item.big_map_x != x || item.big_map_y != y)
+            {
+                item.big_map_x = x;
+                item.big_map_y = y;
+
+                // Exposed map cells must be visible in the same frame in which the background is moved:
+                item.commit = true;
+                data.commit_queue.push(iterator.id(), vram_commit_priority::FORCED);
+            }
+
+            return;
+        }
+    }
+}
+
+void set_tiles_ref(int id, const span<const tile>& tiles_ref, compression_type compression)
 {
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - SET TILES REF: ", id, " - ", data.items.item(id).start_block, " - ",
-                      tiles_ref.data(), " - ", tiles_ref.size());
+                      tiles_ref.data(), " - ", tiles_ref.size(), " - ", int(compression));
 
     item_type& item = data.items.item(id);
     BTN_ASSERT(item.data, "Item has no data");
@@ -1156,17 +1862,18 @@ void set_tiles_ref(int id, const span<const tile>& tiles_ref)
                    "Multiple copies of the same data not supported");
 
         data.items_map.erase(item.data);
-        _check_commit_item(id, data_ptr, true);
+        _check_commit_item(id, data_ptr, compression, true, vram_commit_priority::NORMAL);
 
         BTN_BG_BLOCKS_LOG_STATUS();
     }
 }
 
 void set_regular_map_cells_ref(int id, const regular_bg_map_cell& map_cells_ref,
-                               [[maybe_unused]] const size& map_dimensions)
+                               [[maybe_unused]] const size& map_dimensions, compression_type compression)
 {
     BTN_BG_BLOCKS_LOG("bg_blocks_manager - SET REGULAR MAP CELLS REF: ", id, " - ", data.items.item(id).start_block,
-                      " - ", &map_cells_ref, " - ", map_dimensions.width(), " - ", map_dimensions.height());
+                      " - ", &map_cells_ref, " - ", map_dimensions.width(), " - ", map_dimensions.height(), " - ",
+                      int(compression));
 
     item_type& item = data.items.item(id);
     BTN_ASSERT(item.data, "Item has no data");
@@ -1183,7 +1890,36 @@ void set_regular_map_cells_ref(int id, const regular_bg_map_cell& map_cells_ref,
                    "Multiple copies of the same data not supported");
 
         data.items_map.erase(item.data);
-        _check_commit_item(id, data_ptr, true);
+        _check_commit_item(id, data_ptr, compression, true, vram_commit_priority::NORMAL);
+
+        BTN_BG_BLOCKS_LOG_STATUS();
+    }
+}
+
+void set_affine_map_cells_ref(int id, const affine_bg_map_cell& map_cells_ref,
+                              [[maybe_unused]] const size& map_dimensions, compression_type compression)
+{
+    BTN_BG_BLOCKS_LOG("bg_blocks_manager - SET AFFINE MAP CELLS REF: ", id, " - ", data.items.item(id).start_block,
+                      " - ", &map_cells_ref, " - ", map_dimensions.width(), " - ", map_dimensions.height(), " - ",
+                      int(compression));
+
+    item_type& item = data.items.item(id);
+    BTN_ASSERT(item.data, "Item has no data");
+    BTN_ASSERT(item.affine_map, "Item is not an affine map");
+    BTN_ASSERT(map_dimensions.width() == item.width, "Width does not match item width: ",
+               map_dimensions.width(), " - ", item.width);
+    BTN_ASSERT(map_dimensions.height() == item.height, "Height does not match item height: ",
+               map_dimensions.height(), " - ", item.height);
+
+    const uint16_t* data_ptr = _affine_map_data_ptr(map_cells_ref);
+
+    if(item.data != data_ptr)
+    {
+        BTN_ASSERT(data.items_map.find(data_ptr) == data.items_map.end(),
+                   "Multiple copies of the same data not supported");
+
+        data.items_map.erase(item.data);
+        _check_commit_item(id, data_ptr, compression, true, vram_commit_priority::NORMAL);
 
         BTN_BG_BLOCKS_LOG_STATUS();
     }
@@ -1196,8 +1932,7 @@ void reload(int id)
     item_type& item = data.items.item(id);
     BTN_ASSERT(item.data, "Item has no data");
 
-    item.commit = true;
-    data.check_commit = true;
+    _set_commit(id, item, vram_commit_priority::NORMAL);
 
     BTN_BG_BLOCKS_LOG_STATUS();
 }
@@ -1241,8 +1976,8 @@ void set_map_tiles(int id, bg_tiles_ptr&& tiles)
 
         if(item.tiles_offset() != old_tiles_offset)
         {
-            item.commit = true;
-            data.check_commit = true;
+            // Map VRAM contents are not valid for the new tiles:
+            _set_commit(id, item, vram_commit_priority::FORCED);
         }
     }
 }
@@ -1266,6 +2001,8 @@ void set_map_palette(int id, bg_palette_ptr&& palette)
     if(palette != item.palette)
     {
         palette_bpp_mode new_palette_bpp_mode = palette.bpp_mode();
+        BTN_ASSERT(! item.affine_map || new_palette_bpp_mode == palette_bpp_mode::BPP_8,
+                   "Affine maps only support 8 bits per pixel palettes");
         BTN_ASSERT(item.tiles->valid_tiles_count(new_palette_bpp_mode),
                    "Invalid tiles count: ", item.tiles->tiles_count());
 
@@ -1295,8 +2032,8 @@ void set_map_palette(int id, bg_palette_ptr&& palette)
 
         if(item.tiles_offset() != old_tiles_offset || item.palette_offset() != old_palette_offset)
         {
-            item.commit = true;
-            data.check_commit = true;
+            // Map VRAM contents are not valid for the new tiles or palette:
+            _set_commit(id, item, vram_commit_priority::FORCED);
         }
     }
 }
@@ -1311,6 +2048,8 @@ void set_map_tiles_and_palette(int id, bg_tiles_ptr&& tiles, bg_palette_ptr&& pa
 {
     item_type& item = data.items.item(id);
     palette_bpp_mode new_palette_bpp_mode = palette.bpp_mode();
+    BTN_ASSERT(! item.affine_map || new_palette_bpp_mode == palette_bpp_mode::BPP_8,
+               "Affine maps only support 8 bits per pixel palettes");
     BTN_ASSERT(tiles.valid_tiles_count(new_palette_bpp_mode), "Invalid tiles count: ", tiles.tiles_count());
 
     int old_tiles_offset;
@@ -1354,8 +2093,8 @@ void set_map_tiles_and_palette(int id, bg_tiles_ptr&& tiles, bg_palette_ptr&& pa
 
     if(item.tiles_offset() != old_tiles_offset || item.palette_offset() != old_palette_offset)
     {
-        item.commit = true;
-        data.check_commit = true;
+        // Map VRAM contents are not valid for the new tiles or palette:
+        _set_commit(id, item, vram_commit_priority::FORCED);
     }
 }
 
@@ -1387,6 +2126,20 @@ optional<span<regular_bg_map_cell>> regular_map_vram(int id)
     return result;
 }
 
+optional<span<affine_bg_map_cell>> affine_map_vram(int id)
+{
+    const item_type& item = data.items.item(id);
+    optional<span<affine_bg_map_cell>> result;
+
+    if(! item.data)
+    {
+        auto vram_ptr = reinterpret_cast<affine_bg_map_cell*>(hw::bg_blocks::vram(item.start_block));
+        result.emplace(vram_ptr, item.width * item.height);
+    }
+
+    return result;
+}
+
 void update()
 {
     if(data.to_remove_blocks_count)
@@ -1414,8 +2167,9 @@ void update()
                 item.data = nullptr;
                 item.width = 0;
                 item.height = 0;
+                item.compression = compression_type::NONE;
                 item.set_status(status_type::FREE);
-                item.commit = false;
+                _reset_commit(iterator.id(), item);
                 data.free_blocks_count += item.blocks_count;
 
                 auto next_iterator = iterator;
@@ -1451,30 +2205,54 @@ void update()
 
         BTN_BG_BLOCKS_LOG_STATUS();
     }
+
+    if(compaction_max_bytes)
+    {
+        _compact();
+    }
 }
 
 void commit()
 {
-    bool do_commit = data.check_commit;
+    if(! data.relocations.empty())
+    {
+        _commit_relocations();
+    }
+
+    bool do_commit = ! data.commit_queue.empty();
 
     if(do_commit)
     {
         BTN_BG_BLOCKS_LOG("bg_blocks_manager - COMMIT");
 
-        data.check_commit = false;
+        data.commit_queue.commit(
+                    [](int id)
+                    {
+                        const item_type& item = data.items.item(id);
+                        return item.status() == status_type::USED ? _commit_bytes(id, item) : 0;
+                    },
+                    [](int id)
+                    {
+                        item_type& item = data.items.item(id);
+                        item.commit = false;
+
+                        if(item.status() == status_type::USED)
+                        {
+                            _commit_item(item);
+                        }
+                    },
+                    [](int id, int max_bytes)
+                    {
+                        item_type& item = data.items.item(id);
 
-        for(item_type& item : data.items)
-        {
-            if(item.commit)
-            {
-                item.commit = false;
+                        if(item.status() != status_type::USED || _stream_item(id, item, max_bytes))
+                        {
+                            item.commit = false;
+                            return true;
+                        }
 
-                if(item.status() == status_type::USED)
-                {
-                    _commit_item(item);
-                }
-            }
-        }
+                        return false;
+                    });
     }
 
     data.delay_commit = false;
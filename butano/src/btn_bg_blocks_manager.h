@@ -7,7 +7,10 @@
 #define BTN_BG_BLOCKS_MANAGER_H
 
 #include "btn_span_fwd.h"
+#include "btn_fixed_fwd.h"
 #include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
+#include "btn_affine_bg_map_cell.h"
 #include "btn_regular_bg_map_cell.h"
 
 namespace btn
@@ -38,26 +41,46 @@ namespace btn::bg_blocks_manager
 
     [[nodiscard]] int available_map_blocks_count();
 
-    [[nodiscard]] int find_tiles(const span<const tile>& tiles_ref);
+    [[nodiscard]] fixed fragmentation();
+
+    [[nodiscard]] int find_tiles(const span<const tile>& tiles_ref, compression_type compression);
 
     [[nodiscard]] int find_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
-                                       const bg_tiles_ptr& tiles, const bg_palette_ptr& palette);
+                                       compression_type compression, const bg_tiles_ptr& tiles,
+                                       const bg_palette_ptr& palette);
+
+    [[nodiscard]] int find_affine_map(const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                                      compression_type compression, const bg_tiles_ptr& tiles,
+                                      const bg_palette_ptr& palette);
 
-    [[nodiscard]] int create_tiles(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create_tiles(const span<const tile>& tiles_ref, compression_type compression);
 
     [[nodiscard]] int create_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
-                                         bg_tiles_ptr&& tiles, bg_palette_ptr&& palette);
+                                         compression_type compression, bg_tiles_ptr&& tiles,
+                                         bg_palette_ptr&& palette);
+
+    [[nodiscard]] int create_affine_map(const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                                        compression_type compression, bg_tiles_ptr&& tiles,
+                                        bg_palette_ptr&& palette);
 
-    [[nodiscard]] int create_new_tiles(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create_new_tiles(const span<const tile>& tiles_ref, compression_type compression);
 
     [[nodiscard]] int create_new_regular_map(const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
-                                             bg_tiles_ptr&& tiles, bg_palette_ptr&& palette);
+                                             compression_type compression, bg_tiles_ptr&& tiles,
+                                             bg_palette_ptr&& palette);
+
+    [[nodiscard]] int create_new_affine_map(const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                                            compression_type compression, bg_tiles_ptr&& tiles,
+                                            bg_palette_ptr&& palette);
 
     [[nodiscard]] int allocate_tiles(int tiles_count);
 
     [[nodiscard]] int allocate_regular_map(const size& map_dimensions, bg_tiles_ptr&& tiles,
                                            bg_palette_ptr&& palette);
 
+    [[nodiscard]] int allocate_affine_map(const size& map_dimensions, bg_tiles_ptr&& tiles,
+                                          bg_palette_ptr&& palette);
+
     void increase_usages(int id);
 
     void decrease_usages(int id);
@@ -74,9 +97,17 @@ namespace btn::bg_blocks_manager
 
     [[nodiscard]] optional<span<const regular_bg_map_cell>> regular_map_cells_ref(int id);
 
-    void set_tiles_ref(int id, const span<const tile>& tiles_ref);
+    [[nodiscard]] optional<span<const affine_bg_map_cell>> affine_map_cells_ref(int id);
 
-    void set_regular_map_cells_ref(int id, const regular_bg_map_cell& map_cells_ref, const size& map_dimensions);
+    void update_regular_map_position(int map_id, int x, int y);
+
+    void set_tiles_ref(int id, const span<const tile>& tiles_ref, compression_type compression);
+
+    void set_regular_map_cells_ref(int id, const regular_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                                   compression_type compression);
+
+    void set_affine_map_cells_ref(int id, const affine_bg_map_cell& map_cells_ref, const size& map_dimensions,
+                                  compression_type compression);
 
     void reload(int id);
 
@@ -98,6 +129,8 @@ namespace btn::bg_blocks_manager
 
     [[nodiscard]] optional<span<regular_bg_map_cell>> regular_map_vram(int id);
 
+    [[nodiscard]] optional<span<affine_bg_map_cell>> affine_map_vram(int id);
+
     void update();
 
     void commit();
@@ -30,17 +30,9 @@ public:
 
     [[nodiscard]] static bool target_updated(int target_id, iany&)
     {
-        if(optional<palettes_bank::commit_data> commit_data =
-                palettes_manager::bg_palettes_bank().retrieve_commit_data())
-        {
-            palette_target_id palette_target_id(target_id);
-            int target_color = palette_target_id.params.final_color_index;
-            int first_color = commit_data->offset;
-            int last_color = first_color + commit_data->count - 1;
-            return target_color >= first_color && target_color <= last_color;
-        }
-
-        return false;
+        palette_target_id palette_target_id(target_id);
+        int target_color = palette_target_id.params.final_color_index;
+        return palettes_manager::bg_palettes_bank().color_committed(target_color);
     }
 
     [[nodiscard]] static uint16_t* output_register(int target_id)
@@ -29,13 +29,7 @@ public:
 
     [[nodiscard]] static bool target_updated(int, iany&)
     {
-        if(optional<palettes_bank::commit_data> commit_data =
-                palettes_manager::bg_palettes_bank().retrieve_commit_data())
-        {
-            return commit_data->offset == 0;
-        }
-
-        return false;
+        return palettes_manager::bg_palettes_bank().color_committed(0);
     }
 
     [[nodiscard]] static uint16_t* output_register(int)
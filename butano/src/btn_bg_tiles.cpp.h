@@ -30,4 +30,9 @@ int available_blocks_count()
     return bg_blocks_manager::available_tile_blocks_count();
 }
 
+fixed fragmentation()
+{
+    return bg_blocks_manager::fragmentation();
+}
+
 }
@@ -14,7 +14,7 @@ namespace btn
 
 optional<bg_tiles_ptr> bg_tiles_ptr::find(const span<const tile>& tiles_ref)
 {
-    int handle = bg_blocks_manager::find_tiles(tiles_ref);
+    int handle = bg_blocks_manager::find_tiles(tiles_ref, compression_type::NONE);
     optional<bg_tiles_ptr> result;
 
     if(handle >= 0)
@@ -27,12 +27,20 @@ optional<bg_tiles_ptr> bg_tiles_ptr::find(const span<const tile>& tiles_ref)
 
 optional<bg_tiles_ptr> bg_tiles_ptr::find(const bg_tiles_item& tiles_item)
 {
-    return find(tiles_item.tiles_ref());
+    int handle = bg_blocks_manager::find_tiles(tiles_item.tiles_ref(), tiles_item.compression());
+    optional<bg_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = bg_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 bg_tiles_ptr bg_tiles_ptr::create(const span<const tile>& tiles_ref)
 {
-    int handle = bg_blocks_manager::create_tiles(tiles_ref);
+    int handle = bg_blocks_manager::create_tiles(tiles_ref, compression_type::NONE);
     BTN_ASSERT(handle >= 0, "Tiles create failed");
 
     return bg_tiles_ptr(handle);
@@ -40,12 +48,15 @@ bg_tiles_ptr bg_tiles_ptr::create(const span<const tile>& tiles_ref)
 
 bg_tiles_ptr bg_tiles_ptr::create(const bg_tiles_item& tiles_item)
 {
-    return create(tiles_item.tiles_ref());
+    int handle = bg_blocks_manager::create_tiles(tiles_item.tiles_ref(), tiles_item.compression());
+    BTN_ASSERT(handle >= 0, "Tiles create failed");
+
+    return bg_tiles_ptr(handle);
 }
 
 bg_tiles_ptr bg_tiles_ptr::create_new(const span<const tile>& tiles_ref)
 {
-    int handle = bg_blocks_manager::create_new_tiles(tiles_ref);
+    int handle = bg_blocks_manager::create_new_tiles(tiles_ref, compression_type::NONE);
     BTN_ASSERT(handle >= 0, "Tiles create new failed");
 
     return bg_tiles_ptr(handle);
@@ -53,7 +64,10 @@ bg_tiles_ptr bg_tiles_ptr::create_new(const span<const tile>& tiles_ref)
 
 bg_tiles_ptr bg_tiles_ptr::create_new(const bg_tiles_item& tiles_item)
 {
-    return create_new(tiles_item.tiles_ref());
+    int handle = bg_blocks_manager::create_new_tiles(tiles_item.tiles_ref(), tiles_item.compression());
+    BTN_ASSERT(handle >= 0, "Tiles create new failed");
+
+    return bg_tiles_ptr(handle);
 }
 
 bg_tiles_ptr bg_tiles_ptr::allocate(int tiles_count)
@@ -66,7 +80,7 @@ bg_tiles_ptr bg_tiles_ptr::allocate(int tiles_count)
 
 optional<bg_tiles_ptr> bg_tiles_ptr::create_optional(const span<const tile>& tiles_ref)
 {
-    int handle = bg_blocks_manager::create_tiles(tiles_ref);
+    int handle = bg_blocks_manager::create_tiles(tiles_ref, compression_type::NONE);
     optional<bg_tiles_ptr> result;
 
     if(handle >= 0)
@@ -79,12 +93,20 @@ optional<bg_tiles_ptr> bg_tiles_ptr::create_optional(const span<const tile>& til
 
 optional<bg_tiles_ptr> bg_tiles_ptr::create_optional(const bg_tiles_item& tiles_item)
 {
-    return create_optional(tiles_item.tiles_ref());
+    int handle = bg_blocks_manager::create_tiles(tiles_item.tiles_ref(), tiles_item.compression());
+    optional<bg_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = bg_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 optional<bg_tiles_ptr> bg_tiles_ptr::create_new_optional(const span<const tile>& tiles_ref)
 {
-    int handle = bg_blocks_manager::create_new_tiles(tiles_ref);
+    int handle = bg_blocks_manager::create_new_tiles(tiles_ref, compression_type::NONE);
     optional<bg_tiles_ptr> result;
 
     if(handle >= 0)
@@ -97,7 +119,15 @@ optional<bg_tiles_ptr> bg_tiles_ptr::create_new_optional(const span<const tile>&
 
 optional<bg_tiles_ptr> bg_tiles_ptr::create_new_optional(const bg_tiles_item& tiles_item)
 {
-    return create_new_optional(tiles_item.tiles_ref());
+    int handle = bg_blocks_manager::create_new_tiles(tiles_item.tiles_ref(), tiles_item.compression());
+    optional<bg_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = bg_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 optional<bg_tiles_ptr> bg_tiles_ptr::allocate_optional(int tiles_count)
@@ -169,12 +199,12 @@ optional<span<const tile>> bg_tiles_ptr::tiles_ref() const
 
 void bg_tiles_ptr::set_tiles_ref(const span<const tile>& tiles_ref)
 {
-    bg_blocks_manager::set_tiles_ref(_handle, tiles_ref);
+    bg_blocks_manager::set_tiles_ref(_handle, tiles_ref, compression_type::NONE);
 }
 
 void bg_tiles_ptr::set_tiles_ref(const bg_tiles_item& tiles_item)
 {
-    bg_blocks_manager::set_tiles_ref(_handle, tiles_item.tiles_ref());
+    bg_blocks_manager::set_tiles_ref(_handle, tiles_item.tiles_ref(), tiles_item.compression());
 }
 
 void bg_tiles_ptr::reload_tiles_ref()
@@ -10,10 +10,16 @@
 #include "btn_display.h"
 #include "btn_sort_key.h"
 #include "btn_config_bgs.h"
+#include "btn_bg_blocks_manager.h"
 #include "btn_display_manager.h"
+#include "btn_sprite_affine_mat_attributes.h"
 #include "../hw/include/btn_hw_bgs.h"
+#include "../hw/include/btn_hw_bg_blocks.h"
 
 #include "btn_bgs.cpp.h"
+#include "btn_affine_bg_ptr.cpp.h"
+#include "btn_affine_bg_item.cpp.h"
+#include "btn_affine_bg_builder.cpp.h"
 #include "btn_regular_bg_ptr.cpp.h"
 #include "btn_regular_bg_item.cpp.h"
 #include "btn_regular_bg_builder.cpp.h"
@@ -32,16 +38,22 @@ namespace
     public:
         fixed_point position;
         point hw_position;
+        point big_map_position;
         size half_dimensions;
         unsigned usages = 1;
         sort_key bg_sort_key;
         hw::bgs::handle handle;
         optional<regular_bg_map_ptr> map;
+        optional<affine_bg_map_ptr> affine_map;
+        sprite_affine_mat_attributes affine_mat_attributes;
         optional<camera_ptr> camera;
         int8_t handles_index = -1;
         bool blending_enabled: 1;
         bool visible: 1;
         bool update: 1;
+        bool big_map: 1;
+        bool update_big_map: 1;
+        bool affine: 1;
 
         item_type(regular_bg_builder&& builder, regular_bg_map_ptr&& _map) :
             position(builder.position()),
@@ -50,12 +62,36 @@ namespace
             camera(builder.release_camera()),
             blending_enabled(builder.blending_enabled()),
             visible(builder.visible()),
-            update(true)
+            update(true),
+            affine(false)
         {
             hw::bgs::setup_regular(builder, handle);
             update_map();
         }
 
+        item_type(affine_bg_builder&& builder, affine_bg_map_ptr&& _map) :
+            position(builder.position()),
+            bg_sort_key(builder.priority(), builder.z_order()),
+            affine_map(move(_map)),
+            affine_mat_attributes(builder.rotation_angle(), builder.horizontal_scale(), builder.vertical_scale(),
+                                  false, false),
+            camera(builder.release_camera()),
+            blending_enabled(builder.blending_enabled()),
+            visible(builder.visible()),
+            update(true),
+            big_map(false),
+            update_big_map(false),
+            affine(true)
+        {
+            hw::bgs::setup_affine(builder, handle);
+            update_affine_map();
+        }
+
+        [[nodiscard]] int map_id() const
+        {
+            return affine ? affine_map->id() : map->id();
+        }
+
         void update_map()
         {
             const regular_bg_map_ptr& map_ref = *map;
@@ -64,12 +100,61 @@ namespace
             hw::bgs::set_tiles_cbb(map_ref.tiles().cbb(), new_handle);
             hw::bgs::set_map_sbb(map_ref.id(), new_handle);
             hw::bgs::set_bpp_mode(map_ref.bpp_mode(), new_handle);
-            hw::bgs::set_map_dimensions(map_dimensions, new_handle);
+            big_map = map_ref.big();
+            update_big_map = big_map;
+
+            if(big_map)
+            {
+                // Big maps are streamed to a smaller hardware map:
+                int big_map_hw_size = hw::bg_blocks::big_map_hw_size();
+                hw::bgs::set_map_dimensions(size(big_map_hw_size, big_map_hw_size), new_handle);
+            }
+            else
+            {
+                hw::bgs::set_map_dimensions(map_dimensions, new_handle);
+            }
+
+            handle = new_handle;
+            half_dimensions = map_dimensions * 4;
+            update_hw_position();
+        }
+
+        void update_affine_map()
+        {
+            const affine_bg_map_ptr& map_ref = *affine_map;
+            size map_dimensions = map_ref.dimensions();
+            hw::bgs::handle new_handle = handle;
+            hw::bgs::set_tiles_cbb(map_ref.tiles().cbb(), new_handle);
+            hw::bgs::set_map_sbb(map_ref.id(), new_handle);
+            hw::bgs::set_affine_map_dimensions(map_dimensions, new_handle);
             handle = new_handle;
             half_dimensions = map_dimensions * 4;
+            update_affine_mat();
+        }
+
+        void update_affine_mat()
+        {
+            // Sprite affine matrices have the same registers layout than affine backgrounds:
+            const sprite_affine_mat_attributes& attributes = affine_mat_attributes;
+            hw::bgs::set_affine_mat(attributes.pa_register_value(), attributes.pb_register_value(),
+                                    attributes.pc_register_value(), attributes.pd_register_value(), handle);
             update_hw_position();
         }
 
+        void update_big_map_position()
+        {
+            // Position in map cells of the top-left visible map cell:
+            point new_big_map_position(hw_position.x() >> 3, hw_position.y() >> 3);
+
+            if(update_big_map || big_map_position != new_big_map_position)
+            {
+                big_map_position = new_big_map_position;
+                update_big_map = false;
+                bg_blocks_manager::update_regular_map_position(map->id(), new_big_map_position.x(),
+                                                               new_big_map_position.y());
+            }
+        }
+
         void update_hw_position()
         {
             int real_x = position.x().right_shift_integer();
@@ -88,16 +173,67 @@ namespace
 
         void update_hw_x(int real_x)
         {
-            int hw_x = -real_x - (display::width() / 2) + half_dimensions.width();
-            hw_position.set_x(hw_x);
-            hw::bgs::set_x(hw_x, handle);
+            set_hw_x(-real_x - (display::width() / 2) + half_dimensions.width());
         }
 
         void update_hw_y(int real_y)
         {
-            int hw_y = -real_y - (display::height() / 2) + half_dimensions.height();
+            set_hw_y(-real_y - (display::height() / 2) + half_dimensions.height());
+        }
+
+        void set_hw_x(int hw_x)
+        {
+            hw_position.set_x(hw_x);
+
+            if(affine)
+            {
+                update_affine_reference_point();
+            }
+            else
+            {
+                hw::bgs::set_x(hw_x, handle);
+            }
+        }
+
+        void set_hw_y(int hw_y)
+        {
             hw_position.set_y(hw_y);
-            hw::bgs::set_y(hw_y, handle);
+
+            if(affine)
+            {
+                update_affine_reference_point();
+            }
+            else
+            {
+                hw::bgs::set_y(hw_y, handle);
+            }
+        }
+
+        void set_hw_position(const point& new_hw_position)
+        {
+            hw_position = new_hw_position;
+
+            if(affine)
+            {
+                update_affine_reference_point();
+            }
+            else
+            {
+                hw::bgs::set_x(new_hw_position.x(), handle);
+                hw::bgs::set_y(new_hw_position.y(), handle);
+            }
+        }
+
+        void update_affine_reference_point()
+        {
+            // The center of the map is transformed around the center of the background in the screen:
+            int half_width = half_dimensions.width();
+            int half_height = half_dimensions.height();
+            int center_x = half_width - hw_position.x();
+            int center_y = half_height - hw_position.y();
+            int dx = (half_width << 8) - (handle.pa * center_x) - (handle.pb * center_y);
+            int dy = (half_height << 8) - (handle.pc * center_x) - (handle.pd * center_y);
+            hw::bgs::set_affine_reference_point(dx, dy, handle);
         }
     };
 
@@ -147,6 +283,39 @@ namespace
             data.commit = true;
         }
     }
+
+    template<class Builder>
+    [[nodiscard]] id_type _create(Builder&& builder)
+    {
+        BTN_ASSERT(! data.items_vector.full(), "No more available bgs");
+
+        auto map = builder.release_map();
+        item_type& item = data.items_pool.create(move(builder), move(map));
+        _insert_item(item);
+        display_manager::set_show_bg_in_all_windows(&item, true);
+        return &item;
+    }
+
+    template<class Builder>
+    [[nodiscard]] id_type _create_optional(Builder&& builder)
+    {
+        if(data.items_vector.full())
+        {
+            return nullptr;
+        }
+
+        auto map = builder.release_map_optional();
+
+        if(! map)
+        {
+            return nullptr;
+        }
+
+        item_type& item = data.items_pool.create(move(builder), move(*map));
+        _insert_item(item);
+        display_manager::set_show_bg_in_all_windows(&item, true);
+        return &item;
+    }
 }
 
 int used_count()
@@ -161,33 +330,22 @@ int available_count()
 
 id_type create(regular_bg_builder&& builder)
 {
-    BTN_ASSERT(! data.items_vector.full(), "No more available bgs");
-
-    regular_bg_map_ptr map = builder.release_map();
-    item_type& item = data.items_pool.create(move(builder), move(map));
-    _insert_item(item);
-    display_manager::set_show_bg_in_all_windows(&item, true);
-    return &item;
+    return _create(move(builder));
 }
 
 id_type create_optional(regular_bg_builder&& builder)
 {
-    if(data.items_vector.full())
-    {
-        return nullptr;
-    }
-
-    optional<regular_bg_map_ptr> map = builder.release_map_optional();
+    return _create_optional(move(builder));
+}
 
-    if(! map)
-    {
-        return nullptr;
-    }
+id_type create(affine_bg_builder&& builder)
+{
+    return _create(move(builder));
+}
 
-    item_type& item = data.items_pool.create(move(builder), move(*map));
-    _insert_item(item);
-    display_manager::set_show_bg_in_all_windows(&item, true);
-    return &item;
+id_type create_optional(affine_bg_builder&& builder)
+{
+    return _create_optional(move(builder));
 }
 
 void increase_usages(id_type id)
@@ -205,7 +363,8 @@ void decrease_usages(id_type id)
     {
         if(! data.rebuild_handles && item->visible)
         {
-            if(! data.items_vector.empty() && item != data.items_vector.back())
+            // Affine backgrounds change the display mode, so the handles must be rebuilt:
+            if(item->affine || (! data.items_vector.empty() && item != data.items_vector.back()))
             {
                 data.rebuild_handles = true;
             }
@@ -277,6 +436,42 @@ void remove_map(id_type id)
     item->map.reset();
 }
 
+const affine_bg_map_ptr& affine_map(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return *item->affine_map;
+}
+
+void set_affine_map(id_type id, const affine_bg_map_ptr& map)
+{
+    auto item = static_cast<item_type*>(id);
+
+    if(map != item->affine_map)
+    {
+        item->affine_map = map;
+        item->update_affine_map();
+        _update_item(*item);
+    }
+}
+
+void set_affine_map(id_type id, affine_bg_map_ptr&& map)
+{
+    auto item = static_cast<item_type*>(id);
+
+    if(map != item->affine_map)
+    {
+        item->affine_map = move(map);
+        item->update_affine_map();
+        _update_item(*item);
+    }
+}
+
+void remove_affine_map(id_type id)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_map.reset();
+}
+
 const fixed_point& position(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
@@ -301,9 +496,7 @@ void set_x(id_type id, fixed x)
 
     if(diff)
     {
-        int hw_x = item->hw_position.x() - diff;
-        item->hw_position.set_x(hw_x);
-        hw::bgs::set_x(hw_x, item->handle);
+        item->set_hw_x(item->hw_position.x() - diff);
         _update_item(*item);
     }
 }
@@ -320,9 +513,7 @@ void set_y(id_type id, fixed y)
 
     if(diff)
     {
-        int hw_y = item->hw_position.y() - diff;
-        item->hw_position.set_y(hw_y);
-        hw::bgs::set_y(hw_y, item->handle);
+        item->set_hw_y(item->hw_position.y() - diff);
         _update_item(*item);
     }
 }
@@ -339,16 +530,69 @@ void set_position(id_type id, const fixed_point& position)
 
     if(diff != point())
     {
-        point hw_position = item->hw_position - diff;
-        item->hw_position = hw_position;
-
-        hw::bgs::handle& handle = item->handle;
-        hw::bgs::set_x(hw_position.x(), handle);
-        hw::bgs::set_y(hw_position.y(), handle);
+        item->set_hw_position(item->hw_position - diff);
         _update_item(*item);
     }
 }
 
+fixed rotation_angle(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return item->affine_mat_attributes.rotation_angle();
+}
+
+void set_rotation_angle(id_type id, fixed rotation_angle)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_mat_attributes.set_rotation_angle(rotation_angle);
+    item->update_affine_mat();
+    _update_item(*item);
+}
+
+fixed horizontal_scale(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return item->affine_mat_attributes.horizontal_scale();
+}
+
+void set_horizontal_scale(id_type id, fixed horizontal_scale)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_mat_attributes.set_horizontal_scale(horizontal_scale);
+    item->update_affine_mat();
+    _update_item(*item);
+}
+
+fixed vertical_scale(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return item->affine_mat_attributes.vertical_scale();
+}
+
+void set_vertical_scale(id_type id, fixed vertical_scale)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_mat_attributes.set_vertical_scale(vertical_scale);
+    item->update_affine_mat();
+    _update_item(*item);
+}
+
+void set_scale(id_type id, fixed scale)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_mat_attributes.set_scale(scale);
+    item->update_affine_mat();
+    _update_item(*item);
+}
+
+void set_scale(id_type id, fixed horizontal_scale, fixed vertical_scale)
+{
+    auto item = static_cast<item_type*>(id);
+    item->affine_mat_attributes.set_scale(horizontal_scale, vertical_scale);
+    item->update_affine_mat();
+    _update_item(*item);
+}
+
 int priority(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
@@ -433,6 +677,19 @@ void set_mosaic_enabled(id_type id, bool mosaic_enabled)
     _update_item(*item);
 }
 
+bool wrapping_enabled(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return hw::bgs::wrapping_enabled(item->handle);
+}
+
+void set_wrapping_enabled(id_type id, bool wrapping_enabled)
+{
+    auto item = static_cast<item_type*>(id);
+    hw::bgs::set_wrapping_enabled(wrapping_enabled, item->handle);
+    _update_item(*item);
+}
+
 regular_bg_attributes regular_attributes(id_type id)
 {
     return regular_bg_attributes(map(id), priority(id), mosaic_enabled(id));
@@ -521,11 +778,23 @@ void update_cameras()
     }
 }
 
+void update_map_sbb(int map_id)
+{
+    for(item_type* item : data.items_vector)
+    {
+        if(item->map_id() == map_id)
+        {
+            hw::bgs::set_map_sbb(map_id, item->handle);
+            _update_item(*item);
+        }
+    }
+}
+
 void update_map_tiles_cbb(int map_id, int tiles_cbb)
 {
     for(item_type* item : data.items_vector)
     {
-        if(item->map->id() == map_id)
+        if(item->map_id() == map_id)
         {
             hw::bgs::set_tiles_cbb(tiles_cbb, item->handle);
             _update_item(*item);
@@ -537,7 +806,7 @@ void update_map_palette_bpp_mode(int map_id, palette_bpp_mode new_bpp_mode)
 {
     for(item_type* item : data.items_vector)
     {
-        if(item->map->id() == map_id)
+        if(item->map_id() == map_id)
         {
             hw::bgs::set_bpp_mode(new_bpp_mode, item->handle);
             _update_item(*item);
@@ -610,23 +879,60 @@ void fill_hblank_effect_regular_attributes(id_type id, const regular_bg_attribut
 
 void update()
 {
+    for(item_type* item : data.items_vector)
+    {
+        if(item->big_map && item->visible)
+        {
+            item->update_big_map_position();
+        }
+    }
+
     if(data.rebuild_handles)
     {
-        int id = hw::bgs::count() - 1;
+        int affine_count = 0;
         data.rebuild_handles = false;
         data.commit = true;
 
+        for(const item_type* item : data.items_vector)
+        {
+            if(item->visible && item->affine)
+            {
+                ++affine_count;
+            }
+        }
+
+        BTN_ASSERT(affine_count <= 2, "Too much affine bgs on screen: ", affine_count);
+
+        // Mode 0: four regular bgs. Mode 1: BG0 and BG1 are regular, BG2 is affine. Mode 2: BG2 and BG3 are affine:
+        int mode = affine_count;
+        int regular_id = mode == 0 ? 3 : mode == 1 ? 1 : -1;
+        int affine_id = mode == 1 ? 2 : 3;
+        bool enabled_ids[hw::bgs::count()] = {};
+
         for(item_type* item : data.items_vector)
         {
             if(item->visible)
             {
-                BTN_ASSERT(BTN_CFG_BGS_MAX_ITEMS <= hw::bgs::count() || id >= 0, "Too much bgs on screen");
+                int id;
+
+                if(item->affine)
+                {
+                    id = affine_id;
+                    --affine_id;
+                }
+                else
+                {
+                    BTN_ASSERT(regular_id >= 0, "Too much bgs on screen");
+
+                    id = regular_id;
+                    --regular_id;
+                }
 
                 item->handles_index = int8_t(id);
                 data.handles[id] = item->handle;
+                enabled_ids[id] = true;
                 display_manager::set_bg_enabled(id, true);
                 display_manager::set_blending_bg_enabled(id, item->blending_enabled);
-                --id;
             }
             else
             {
@@ -634,11 +940,15 @@ void update()
             }
         }
 
-        for(int index = 0; index <= id; ++index)
+        for(int index = 0; index < hw::bgs::count(); ++index)
         {
-            display_manager::set_bg_enabled(index, false);
+            if(! enabled_ids[index])
+            {
+                display_manager::set_bg_enabled(index, false);
+            }
         }
 
+        display_manager::set_bgs_mode(mode);
         display_manager::update_windows_visible_bgs();
     }
 }
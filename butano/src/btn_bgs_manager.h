@@ -17,6 +17,8 @@ class size;
 class point;
 class camera_ptr;
 class fixed_point;
+class affine_bg_builder;
+class affine_bg_map_ptr;
 class regular_bg_builder;
 class regular_bg_map_ptr;
 class regular_bg_attributes;
@@ -34,6 +36,10 @@ namespace bgs_manager
 
     [[nodiscard]] id_type create_optional(regular_bg_builder&& builder);
 
+    [[nodiscard]] id_type create(affine_bg_builder&& builder);
+
+    [[nodiscard]] id_type create_optional(affine_bg_builder&& builder);
+
     void increase_usages(id_type id);
 
     void decrease_usages(id_type id);
@@ -50,6 +56,14 @@ namespace bgs_manager
 
     void remove_map(id_type id);
 
+    [[nodiscard]] const affine_bg_map_ptr& affine_map(id_type id);
+
+    void set_affine_map(id_type id, const affine_bg_map_ptr& map);
+
+    void set_affine_map(id_type id, affine_bg_map_ptr&& map);
+
+    void remove_affine_map(id_type id);
+
     [[nodiscard]] const fixed_point& position(id_type id);
 
     [[nodiscard]] const point& hw_position(id_type id);
@@ -60,6 +74,22 @@ namespace bgs_manager
 
     void set_position(id_type id, const fixed_point& position);
 
+    [[nodiscard]] fixed rotation_angle(id_type id);
+
+    void set_rotation_angle(id_type id, fixed rotation_angle);
+
+    [[nodiscard]] fixed horizontal_scale(id_type id);
+
+    void set_horizontal_scale(id_type id, fixed horizontal_scale);
+
+    [[nodiscard]] fixed vertical_scale(id_type id);
+
+    void set_vertical_scale(id_type id, fixed vertical_scale);
+
+    void set_scale(id_type id, fixed scale);
+
+    void set_scale(id_type id, fixed horizontal_scale, fixed vertical_scale);
+
     [[nodiscard]] int priority(id_type id);
 
     void set_priority(id_type id, int priority);
@@ -76,6 +106,10 @@ namespace bgs_manager
 
     void set_mosaic_enabled(id_type id, bool mosaic_enabled);
 
+    [[nodiscard]] bool wrapping_enabled(id_type id);
+
+    void set_wrapping_enabled(id_type id, bool wrapping_enabled);
+
     [[nodiscard]] regular_bg_attributes regular_attributes(id_type id);
 
     void set_regular_attributes(id_type id, const regular_bg_attributes& attributes);
@@ -96,6 +130,8 @@ namespace bgs_manager
 
     void update_cameras();
 
+    void update_map_sbb(int map_id);
+
     void update_map_tiles_cbb(int map_id, int tiles_cbb);
 
     void update_map_palette_bpp_mode(int map_id, palette_bpp_mode new_bpp_mode);
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_collision_grid.h"
+
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+namespace
+{
+    [[nodiscard]] inline int _cell_coordinate(int data, int shift, int cells)
+    {
+        return clamp((data >> shift) + (cells / 2), 0, cells - 1);
+    }
+
+    [[nodiscard]] inline bool _intersects(int left, int top, int right, int bottom, int other_left, int other_top,
+                                          int other_right, int other_bottom)
+    {
+        // Same result as fixed_rect::intersects:
+        return left < other_right && right > other_left && top < other_bottom && bottom > other_top;
+    }
+}
+
+template<typename Function>
+bool icollision_grid::_for_each_intersecting(int left, int top, int right, int bottom,
+                                             const Function& function) const
+{
+    // Stored rects can't be bigger than a cell, so only one more cell around the given rect must be checked:
+    int shift = fixed::precision() + _cell_size_shift;
+    int columns = _columns;
+    int first_column = max(_cell_coordinate(left, shift, columns) - 1, 0);
+    int last_column = min(_cell_coordinate(right, shift, columns) + 1, columns - 1);
+    int first_row = max(_cell_coordinate(top, shift, _rows) - 1, 0);
+    int last_row = min(_cell_coordinate(bottom, shift, _rows) + 1, _rows - 1);
+    const item_type* items = _items;
+
+    for(int row = first_row; row <= last_row; ++row)
+    {
+        const int16_t* row_cells = _cells + (row * columns);
+
+        for(int column = first_column; column <= last_column; ++column)
+        {
+            int id = row_cells[column];
+
+            while(id >= 0)
+            {
+                const item_type& item = items[id];
+
+                if(_intersects(item.left, item.top, item.right, item.bottom, left, top, right, bottom))
+                {
+                    if(! function(id))
+                    {
+                        return false;
+                    }
+                }
+
+                id = item.next;
+            }
+        }
+    }
+
+    return true;
+}
+
+void icollision_grid::set_rect(int id, const fixed_rect& rect)
+{
+    BTN_ASSERT(contains(id), "Invalid id: ", id);
+
+    _place(id, rect);
+}
+
+int icollision_grid::intersecting(const fixed_rect& rect) const
+{
+    int left = rect.left().data();
+    int top = rect.top().data();
+    int result = -1;
+    _for_each_intersecting(left, top, left + rect.width().data(), top + rect.height().data(),
+                           [&result](int id)
+    {
+        result = id;
+        return false;
+    });
+
+    return result;
+}
+
+bool icollision_grid::intersecting(const fixed_rect& rect, ivector<int>& ids) const
+{
+    int left = rect.left().data();
+    int top = rect.top().data();
+    return _for_each_intersecting(left, top, left + rect.width().data(), top + rect.height().data(),
+                                  [&ids](int id)
+    {
+        if(ids.full())
+        {
+            return false;
+        }
+
+        ids.push_back(id);
+        return true;
+    });
+}
+
+bool icollision_grid::intersecting_pairs(ivector<pair<int, int>>& pairs) const
+{
+    for(int id = 0; id < _max_size; ++id)
+    {
+        const item_type& item = _items[id];
+
+        if(item.cell >= 0)
+        {
+            bool fit = _for_each_intersecting(item.left, item.top, item.right, item.bottom,
+                                              [id, &pairs](int other_id)
+            {
+                // Each pair is found twice, so only one of them is stored:
+                if(other_id > id)
+                {
+                    if(pairs.full())
+                    {
+                        return false;
+                    }
+
+                    pairs.push_back(make_pair(id, other_id));
+                }
+
+                return true;
+            });
+
+            if(! fit)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool icollision_grid::intersecting_pairs(const icollision_grid& other, ivector<pair<int, int>>& pairs) const
+{
+    const item_type* other_items = other._items;
+
+    for(int other_id = 0, other_max_size = other._max_size; other_id < other_max_size; ++other_id)
+    {
+        const item_type& other_item = other_items[other_id];
+
+        if(other_item.cell >= 0)
+        {
+            bool fit = _for_each_intersecting(other_item.left, other_item.top, other_item.right, other_item.bottom,
+                                              [other_id, &pairs](int id)
+            {
+                if(pairs.full())
+                {
+                    return false;
+                }
+
+                pairs.push_back(make_pair(id, other_id));
+                return true;
+            });
+
+            if(! fit)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void icollision_grid::_place(int id, const fixed_rect& rect)
+{
+    int shift = fixed::precision() + _cell_size_shift;
+    [[maybe_unused]] int max_dimension = 1 << shift;
+    BTN_ASSERT(rect.width().data() >= 0 && rect.width().data() <= max_dimension &&
+               rect.height().data() >= 0 && rect.height().data() <= max_dimension,
+               "Rect is bigger than a cell: ", rect.width(), " - ", rect.height(), " - ", cell_size());
+
+    item_type& item = _items[id];
+    int left = rect.left().data();
+    int top = rect.top().data();
+    item.left = left;
+    item.top = top;
+    item.right = left + rect.width().data();
+    item.bottom = top + rect.height().data();
+
+    int column = _cell_coordinate(rect.x().data(), shift, _columns);
+    int row = _cell_coordinate(rect.y().data(), shift, _rows);
+    int cell = (row * _columns) + column;
+
+    if(cell != item.cell)
+    {
+        if(item.cell >= 0)
+        {
+            _unlink(id);
+        }
+
+        int16_t& cell_first_id = _cells[cell];
+        item.cell = int16_t(cell);
+        item.prev = -1;
+        item.next = cell_first_id;
+
+        if(cell_first_id >= 0)
+        {
+            _items[cell_first_id].prev = int16_t(id);
+        }
+
+        cell_first_id = int16_t(id);
+    }
+}
+
+void icollision_grid::_unlink(int id)
+{
+    item_type& item = _items[id];
+    int prev = item.prev;
+    int next = item.next;
+
+    if(prev >= 0)
+    {
+        _items[prev].next = int16_t(next);
+    }
+    else
+    {
+        _cells[item.cell] = int16_t(next);
+    }
+
+    if(next >= 0)
+    {
+        _items[next].prev = int16_t(prev);
+    }
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_collision_grid.h"
+
+namespace btn
+{
+
+fixed_rect icollision_grid::rect(int id) const
+{
+    BTN_ASSERT(contains(id), "Invalid id: ", id);
+
+    const item_type& item = _items[id];
+    fixed left = fixed::from_data(item.left);
+    fixed top = fixed::from_data(item.top);
+    fixed width = fixed::from_data(item.right - item.left);
+    fixed height = fixed::from_data(item.bottom - item.top);
+    return fixed_rect(left + (width / 2), top + (height / 2), width, height);
+}
+
+int icollision_grid::add(const fixed_rect& rect)
+{
+    BTN_ASSERT(! full(), "Collision grid is full");
+
+    int id = _free_id;
+    _free_id = _items[id].next;
+    ++_size;
+    _place(id, rect);
+    return id;
+}
+
+void icollision_grid::remove(int id)
+{
+    BTN_ASSERT(contains(id), "Invalid id: ", id);
+
+    _unlink(id);
+
+    item_type& item = _items[id];
+    item.cell = -1;
+    item.next = int16_t(_free_id);
+    _free_id = id;
+    --_size;
+}
+
+void icollision_grid::clear()
+{
+    for(int index = 0, limit = _columns * _rows; index < limit; ++index)
+    {
+        _cells[index] = -1;
+    }
+
+    for(int id = 0; id < _max_size; ++id)
+    {
+        item_type& item = _items[id];
+        item.cell = -1;
+        item.next = int16_t(id + 1 < _max_size ? id + 1 : -1);
+    }
+
+    _size = 0;
+    _free_id = 0;
+}
+
+}
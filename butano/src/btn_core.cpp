@@ -13,6 +13,7 @@
 #include "btn_timers.h"
 #include "btn_profiler.h"
 #include "btn_string_view.h"
+#include "btn_config_core.h"
 #include "btn_bgs_manager.h"
 #include "btn_audio_manager.h"
 #include "btn_keypad_manager.h"
@@ -22,8 +23,10 @@
 #include "btn_cameras_manager.h"
 #include "btn_palettes_manager.h"
 #include "btn_bg_blocks_manager.h"
+#include "btn_vram_commits_manager.h"
 #include "btn_sprite_tiles_manager.h"
 #include "btn_hblank_effects_manager.h"
+#include "btn_scheduled_actions_manager.h"
 #include "../hw/include/btn_hw_irq.h"
 #include "../hw/include/btn_hw_core.h"
 #include "../hw/include/btn_hw_sram.h"
@@ -38,6 +41,18 @@
     #include "../hw/include/btn_hw_show.h"
 #endif
 
+#if BTN_CFG_LOG_ENABLED && BTN_CFG_LOG_DEFERRED
+    #include "btn_deferred_log.h"
+#endif
+
+#if BTN_CFG_CORE_BENCHMARK_FRAMES
+    #include "btn_algorithm.h"
+    #include "btn_log_dump_writer.h"
+
+    static_assert(BTN_CFG_CORE_BENCHMARK_FRAMES > 0 && BTN_CFG_CORE_BENCHMARK_FRAMES <= UINT16_MAX);
+    static_assert(BTN_CFG_LOG_ENABLED, "Benchmark results are logged, so log must be enabled");
+#endif
+
 #if BTN_CFG_PROFILER_ENABLED && BTN_CFG_PROFILER_LOG_ENGINE
     #define BTN_PROFILER_ENGINE_START(id) \
         BTN_PROFILER_START(id)
@@ -68,10 +83,58 @@ namespace
         timer cpu_usage_timer;
         int cpu_usage_ticks = 0;
         int vblank_usage_ticks = 0;
+
+        #if BTN_CFG_CORE_BENCHMARK_FRAMES
+            uint16_t benchmark_cpu_usage_ticks[BTN_CFG_CORE_BENCHMARK_FRAMES];
+            uint16_t benchmark_vblank_usage_ticks[BTN_CFG_CORE_BENCHMARK_FRAMES];
+            int benchmark_frames = 0;
+        #endif
     };
 
     BTN_DATA_EWRAM static_data data;
 
+    #if BTN_CFG_CORE_BENCHMARK_FRAMES
+        void update_benchmark()
+        {
+            int frame = data.benchmark_frames;
+
+            if(frame < BTN_CFG_CORE_BENCHMARK_FRAMES)
+            {
+                // Results are stored and logged at the end, since logging them in each frame would change them:
+                data.benchmark_cpu_usage_ticks[frame] = uint16_t(min(data.cpu_usage_ticks, int(UINT16_MAX)));
+                data.benchmark_vblank_usage_ticks[frame] = uint16_t(min(data.vblank_usage_ticks, int(UINT16_MAX)));
+                ++frame;
+                data.benchmark_frames = frame;
+
+                if(frame == BTN_CFG_CORE_BENCHMARK_FRAMES)
+                {
+                    #if BTN_CFG_PROFILER_ENABLED
+                        profiler::dump();
+                    #endif
+
+                    // Format (little endian):
+                    // u8 version, u32 ticks per frame, u32 ticks per V-Blank, u16 frames count,
+                    // u16 CPU usage ticks of each frame, u16 V-Blank usage ticks of each frame.
+                    log_dump_writer writer("btn_benchmark");
+                    writer.write(1, 1);
+                    writer.write(unsigned(timers::ticks_per_frame()), 4);
+                    writer.write(unsigned(timers::ticks_per_vblank()), 4);
+                    writer.write(unsigned(frame), 2);
+
+                    for(uint16_t ticks : data.benchmark_cpu_usage_ticks)
+                    {
+                        writer.write(ticks, 2);
+                    }
+
+                    for(uint16_t ticks : data.benchmark_vblank_usage_ticks)
+                    {
+                        writer.write(ticks, 2);
+                    }
+                }
+            }
+        }
+    #endif
+
     void enable()
     {
         hblank_effects_manager::enable();
@@ -106,7 +169,11 @@ namespace
 
 void init()
 {
-    init(string_view());
+    #ifdef BTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS
+        init(BTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS);
+    #else
+        init(string_view());
+    #endif
 }
 
 void init(const string_view& keypad_commands)
@@ -156,6 +223,12 @@ void init(const string_view& keypad_commands)
 
 void update()
 {
+    BTN_PROFILER_ENGINE_START("eng_update");
+
+    BTN_PROFILER_ENGINE_START("eng_actions_update");
+    scheduled_actions_manager::update();
+    BTN_PROFILER_ENGINE_STOP();
+
     BTN_PROFILER_ENGINE_START("eng_cameras_update");
     cameras_manager::update();
     BTN_PROFILER_ENGINE_STOP();
@@ -188,10 +261,17 @@ void update()
     hblank_effects_manager::update();
     BTN_PROFILER_ENGINE_STOP();
 
+    BTN_PROFILER_ENGINE_STOP();
+
     BTN_PROFILER_ENGINE_START("eng_cpu_usage");
     data.cpu_usage_ticks = data.cpu_usage_timer.elapsed_ticks();
     BTN_PROFILER_ENGINE_STOP();
 
+    #if BTN_CFG_LOG_ENABLED && BTN_CFG_LOG_DEFERRED
+        // Deferred log messages are written after measuring CPU usage, so they don't change it:
+        _btn::deferred_log::idle_flush();
+    #endif
+
     audio_manager::disable_vblank_handler();
     hw::core::wait_for_vblank();
 
@@ -199,6 +279,14 @@ void update()
     data.cpu_usage_timer.restart();
     BTN_PROFILER_ENGINE_STOP();
 
+    #if BTN_CFG_PROFILER_ENABLED
+        _btn::profiler::next_frame();
+    #endif
+
+    vram_commits_manager::start();
+
+    BTN_PROFILER_ENGINE_START("eng_commit");
+
     BTN_PROFILER_ENGINE_START("eng_hblank_fx_commit");
     hblank_effects_manager::commit();
     BTN_PROFILER_ENGINE_STOP();
@@ -227,6 +315,8 @@ void update()
     bg_blocks_manager::commit();
     BTN_PROFILER_ENGINE_STOP();
 
+    BTN_PROFILER_ENGINE_STOP();
+
     BTN_PROFILER_ENGINE_START("eng_cpu_usage");
     data.vblank_usage_ticks = data.cpu_usage_timer.elapsed_ticks();
     BTN_PROFILER_ENGINE_STOP();
@@ -240,6 +330,10 @@ void update()
     BTN_PROFILER_ENGINE_START("eng_keypad");
     keypad_manager::update();
     BTN_PROFILER_ENGINE_STOP();
+
+    #if BTN_CFG_CORE_BENCHMARK_FRAMES
+        update_benchmark();
+    #endif
 }
 
 void sleep(keypad::key_type wake_up_key)
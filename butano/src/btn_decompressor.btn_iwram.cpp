@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_decompressor.h"
+
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+void decompressor::start(const void* source_ptr, compression_type compression, void* destination_ptr)
+{
+    BTN_ASSERT(source_ptr, "Source is null");
+    BTN_ASSERT(valid_header(source_ptr, compression), "Invalid header: ",
+               *static_cast<const uint8_t*>(source_ptr), " - ", int(compression));
+    BTN_ASSERT(! (reinterpret_cast<uintptr_t>(destination_ptr) & 1), "Destination is not aligned");
+
+    auto source_bytes_ptr = static_cast<const uint8_t*>(source_ptr);
+    _source_ptr = source_bytes_ptr + 4;
+    _destination_ptr = static_cast<uint16_t*>(destination_ptr);
+    _position = 0;
+    _size = decompressed_bytes(source_ptr);
+    _compression = compression;
+    _bits_count = 0;
+    _run_length = 0;
+
+    if(compression == compression_type::HUFFMAN)
+    {
+        // Tree size byte is followed by the tree nodes, and then by the bit stream:
+        _tree_ptr = _source_ptr;
+        _source_ptr += (_tree_ptr[0] + 1) * 2;
+        _data_bits = uint8_t(source_bytes_ptr[0] & 0xF);
+    }
+}
+
+bool decompressor::decompress(int max_bytes)
+{
+    int end_position = max_bytes < _size - _position ? _position + max_bytes : _size;
+
+    switch(_compression)
+    {
+
+    case compression_type::LZ77:
+        _decompress_lz77(end_position);
+        break;
+
+    case compression_type::RUN_LENGTH:
+        _decompress_run_length(end_position);
+        break;
+
+    case compression_type::HUFFMAN:
+        _decompress_huffman(end_position);
+        break;
+
+    default:
+        BTN_ERROR("Invalid compression: ", int(_compression));
+        break;
+    }
+
+    if(done())
+    {
+        _flush();
+        return true;
+    }
+
+    return false;
+}
+
+void decompressor::_flush()
+{
+    if(_position & 1)
+    {
+        _destination_ptr[_position >> 1] = uint16_t(_pending_byte);
+    }
+}
+
+void decompressor::_decompress_lz77(int end_position)
+{
+    // Flags byte (most significant bit first) followed by 8 blocks:
+    // 0: raw byte.
+    // 1: 2 bytes with length (bits 4-7, plus 3) and displacement (bits 0-3 and 8-15, plus 1) of a copy.
+    const uint8_t* source_ptr = _source_ptr;
+    unsigned flags = _flags;
+    int flags_count = _bits_count;
+    int run_length = _run_length;
+    int displacement = _run_value;
+
+    while(_position < end_position)
+    {
+        if(run_length)
+        {
+            _write(_read(_position - displacement));
+            --run_length;
+        }
+        else
+        {
+            if(! flags_count)
+            {
+                flags = *source_ptr++;
+                flags_count = 8;
+            }
+
+            --flags_count;
+
+            if(flags & (1 << flags_count))
+            {
+                unsigned first_byte = source_ptr[0];
+                unsigned second_byte = source_ptr[1];
+                source_ptr += 2;
+                run_length = int(first_byte >> 4) + 3;
+                displacement = int(((first_byte & 0xF) << 8) | second_byte) + 1;
+            }
+            else
+            {
+                _write(*source_ptr++);
+            }
+        }
+    }
+
+    _source_ptr = source_ptr;
+    _flags = flags;
+    _bits_count = flags_count;
+    _run_length = run_length;
+    _run_value = displacement;
+}
+
+void decompressor::_decompress_run_length(int end_position)
+{
+    // Flag byte followed by data:
+    // Bit 7 clear: bits 0-6 plus 1 raw bytes.
+    // Bit 7 set: the next byte repeated bits 0-6 plus 3 times.
+    const uint8_t* source_ptr = _source_ptr;
+    int run_length = _run_length;
+    unsigned value = unsigned(_run_value);
+    bool run_copy = _run_copy;
+
+    while(_position < end_position)
+    {
+        if(! run_length)
+        {
+            unsigned flag = *source_ptr++;
+
+            if(flag & 0x80)
+            {
+                run_length = int(flag & 0x7F) + 3;
+                value = *source_ptr++;
+                run_copy = false;
+            }
+            else
+            {
+                run_length = int(flag) + 1;
+                run_copy = true;
+            }
+        }
+
+        int length = min(run_length, end_position - _position);
+        run_length -= length;
+
+        if(run_copy)
+        {
+            for(int index = 0; index < length; ++index)
+            {
+                _write(*source_ptr++);
+            }
+        }
+        else
+        {
+            for(int index = 0; index < length; ++index)
+            {
+                _write(value);
+            }
+        }
+    }
+
+    _source_ptr = source_ptr;
+    _run_length = run_length;
+    _run_value = int(value);
+    _run_copy = run_copy;
+}
+
+void decompressor::_decompress_huffman(int end_position)
+{
+    // Tree nodes:
+    // Bits 0-5: offset to the children nodes, which are at (node_address & ~1) + (offset * 2) + 2 (+ 1 for node 1).
+    // Bit 6: node 1 is a data node.
+    // Bit 7: node 0 is a data node.
+    // The bit stream is stored in 32-bit words, most significant bit first.
+    const uint8_t* tree_ptr = _tree_ptr;
+    const uint8_t* source_ptr = _source_ptr;
+    unsigned bits = _bits;
+    int bits_count = _bits_count;
+    int data_bits = _data_bits;
+    int symbols_per_byte = 8 / data_bits;
+
+    while(_position < end_position)
+    {
+        unsigned byte = 0;
+
+        for(int symbol_index = 0; symbol_index < symbols_per_byte; ++symbol_index)
+        {
+            int node_offset = 1;
+            unsigned node = tree_ptr[node_offset];
+
+            while(true)
+            {
+                if(! bits_count)
+                {
+                    bits = unsigned(source_ptr[0]) | (unsigned(source_ptr[1]) << 8) |
+                            (unsigned(source_ptr[2]) << 16) | (unsigned(source_ptr[3]) << 24);
+                    source_ptr += 4;
+                    bits_count = 32;
+                }
+
+                --bits_count;
+
+                unsigned bit = (bits >> bits_count) & 1;
+                int child_offset = (node_offset & ~1) + int((node & 0x3F) * 2) + 2 + int(bit);
+                unsigned data_node_flag = bit ? node & 0x40 : node & 0x80;
+                node_offset = child_offset;
+                node = tree_ptr[node_offset];
+
+                if(data_node_flag)
+                {
+                    byte |= node << (symbol_index * data_bits);
+                    break;
+                }
+            }
+        }
+
+        _write(byte);
+    }
+
+    _source_ptr = source_ptr;
+    _bits = bits;
+    _bits_count = bits_count;
+}
+
+}
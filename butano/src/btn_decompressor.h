@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_DECOMPRESSOR_H
+#define BTN_DECOMPRESSOR_H
+
+#include "btn_assert.h"
+#include "btn_compression_type.h"
+
+namespace btn
+{
+
+// Resumable decompressor of GBA BIOS compatible LZ77, run-length and Huffman data.
+//
+// The destination is written with 16-bit stores only, so it can be VRAM.
+// Decompression can be split in multiple calls, so big assets can be decompressed over multiple frames.
+class decompressor
+{
+
+public:
+    [[nodiscard]] static int decompressed_bytes(const void* source_ptr)
+    {
+        auto source_bytes_ptr = static_cast<const uint8_t*>(source_ptr);
+        return source_bytes_ptr[1] | (source_bytes_ptr[2] << 8) | (source_bytes_ptr[3] << 16);
+    }
+
+    [[nodiscard]] static bool valid_header(const void* source_ptr, compression_type compression)
+    {
+        int header = *static_cast<const uint8_t*>(source_ptr);
+
+        switch(compression)
+        {
+
+        case compression_type::LZ77:
+            return header == 0x10;
+
+        case compression_type::RUN_LENGTH:
+            return header == 0x30;
+
+        case compression_type::HUFFMAN:
+            return header == 0x24 || header == 0x28;
+
+        default:
+            return false;
+        }
+    }
+
+    decompressor() = default;
+
+    void start(const void* source_ptr, compression_type compression, void* destination_ptr);
+
+    [[nodiscard]] bool started() const
+    {
+        return _source_ptr;
+    }
+
+    [[nodiscard]] bool done() const
+    {
+        return _position == _size;
+    }
+
+    [[nodiscard]] int position() const
+    {
+        return _position;
+    }
+
+    [[nodiscard]] int size() const
+    {
+        return _size;
+    }
+
+    void stop()
+    {
+        _source_ptr = nullptr;
+    }
+
+    // Decompresses up to max_bytes bytes, returning true if all data has been decompressed:
+    BTN_CODE_IWRAM bool decompress(int max_bytes);
+
+    void decompress_all()
+    {
+        decompress(_size - _position);
+    }
+
+private:
+    const uint8_t* _source_ptr = nullptr;
+    const uint8_t* _tree_ptr = nullptr;
+    uint16_t* _destination_ptr = nullptr;
+    int _position = 0;
+    int _size = 0;
+    unsigned _pending_byte = 0;
+    unsigned _flags = 0;
+    unsigned _bits = 0;
+    int _bits_count = 0;
+    int _run_length = 0;
+    int _run_value = 0;
+    compression_type _compression = compression_type::NONE;
+    uint8_t _data_bits = 0;
+    bool _run_copy = false;
+
+    void _write(unsigned byte)
+    {
+        if(_position & 1)
+        {
+            _destination_ptr[_position >> 1] = uint16_t(_pending_byte | (byte << 8));
+        }
+        else
+        {
+            _pending_byte = byte;
+        }
+
+        ++_position;
+    }
+
+    [[nodiscard]] unsigned _read(int position) const
+    {
+        if(position == _position - 1 && (position & 1) == 0)
+        {
+            return _pending_byte;
+        }
+
+        unsigned half_word = _destination_ptr[position >> 1];
+        return (position & 1) ? half_word >> 8 : half_word & 0xFF;
+    }
+
+    void _flush();
+
+    BTN_CODE_IWRAM void _decompress_lz77(int end_position);
+
+    BTN_CODE_IWRAM void _decompress_run_length(int end_position);
+
+    BTN_CODE_IWRAM void _decompress_huffman(int end_position);
+};
+
+}
+
+#endif
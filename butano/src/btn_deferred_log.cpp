@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_deferred_log.h"
+
+#if BTN_CFG_LOG_ENABLED && BTN_CFG_LOG_DEFERRED
+    #include "btn_display.h"
+    #include "btn_algorithm.h"
+    #include "btn_log_dump_writer.h"
+    #include "../hw/include/btn_hw_display.h"
+
+    namespace _btn::deferred_log
+    {
+        namespace
+        {
+            static_assert(BTN_CFG_LOG_DEFERRED_BUFFER_SIZE >= 64);
+            static_assert(BTN_CFG_LOG_DEFERRED_BUFFER_SIZE % 4 == 0);
+
+            constexpr const int words_count = BTN_CFG_LOG_DEFERRED_BUFFER_SIZE / 4;
+
+            // Pending words are stored in [tail, head) if head >= tail,
+            // or in [tail, end) and [0, head) if the ring buffer has wrapped:
+            class static_data
+            {
+
+            public:
+                unsigned words[words_count];
+                int head = 0;
+                int tail = 0;
+                int end = words_count;
+                int dropped_messages_count = 0;
+                int flushed_dropped_messages_count = 0;
+            };
+
+            BTN_DATA_EWRAM static_data data;
+
+            // A message can be split between two dumps, so the butano-log-tool.py script concatenates them
+            // to rebuild the messages.
+            //
+            // Format (little endian):
+            // u8 version, u32 dropped messages count, u32 pending words.
+            template<typename Function>
+            void _flush(const Function& continue_function)
+            {
+                if(data.head == data.tail && data.dropped_messages_count == data.flushed_dropped_messages_count)
+                {
+                    return;
+                }
+
+                constexpr const int words_per_line = 16;
+
+                btn::log_dump_writer writer("btn_log");
+                writer.write(1, 1);
+                writer.write(unsigned(data.dropped_messages_count), 4);
+                data.flushed_dropped_messages_count = data.dropped_messages_count;
+
+                while(data.head != data.tail && continue_function())
+                {
+                    int tail = data.tail;
+                    int last = data.head >= tail ? data.head : data.end;
+                    int words = btn::min(last - tail, words_per_line);
+
+                    for(int index = 0; index < words; ++index)
+                    {
+                        writer.write(data.words[tail + index], 4);
+                    }
+
+                    tail += words;
+
+                    if(tail == data.end)
+                    {
+                        tail = 0;
+                        data.end = words_count;
+                    }
+
+                    data.tail = tail;
+                }
+            }
+        }
+
+        unsigned* reserve(int words)
+        {
+            int head = data.head;
+            int tail = data.tail;
+            unsigned* result = nullptr;
+
+            if(head == tail)
+            {
+                head = 0;
+                tail = 0;
+                data.tail = 0;
+                data.end = words_count;
+            }
+
+            if(head >= tail)
+            {
+                if(words_count - head >= words)
+                {
+                    result = data.words + head;
+                    data.head = head + words;
+                }
+                else if(tail > words)
+                {
+                    // Messages are contiguous, so the end of the ring buffer is skipped:
+                    data.end = head;
+                    result = data.words;
+                    data.head = words;
+                }
+            }
+            else if(tail - head > words)
+            {
+                result = data.words + head;
+                data.head = head + words;
+            }
+
+            if(! result)
+            {
+                ++data.dropped_messages_count;
+            }
+
+            return result;
+        }
+
+        void idle_flush()
+        {
+            // Pending words are written only while the screen is being drawn, so V-Blank is not delayed:
+            _flush([]{ return btn::hw::display::vcount() < btn::display::height() - 4; });
+        }
+    }
+
+    namespace btn::deferred_log
+    {
+        void flush()
+        {
+            _btn::deferred_log::_flush([]{ return true; });
+        }
+
+        int dropped_messages_count()
+        {
+            return _btn::deferred_log::data.dropped_messages_count;
+        }
+    }
+#endif
@@ -31,6 +31,7 @@ namespace
 
     public:
         bool enabled_bgs[hw::bgs::count()] = {};
+        int bgs_mode = 0;
         fixed sprites_mosaic_horizontal_stretch;
         fixed sprites_mosaic_vertical_stretch;
         fixed bgs_mosaic_horizontal_stretch;
@@ -129,6 +130,23 @@ void set_bg_enabled(int bg, bool enabled)
     data.commit = true;
 }
 
+int bgs_mode()
+{
+    return data.bgs_mode;
+}
+
+void set_bgs_mode(int mode)
+{
+    BTN_ASSERT(mode >= 0 && mode <= 2, "Invalid mode: ", mode);
+
+    if(data.bgs_mode != mode)
+    {
+        data.bgs_mode = mode;
+        data.commit_enabled_bgs = true;
+        data.commit = true;
+    }
+}
+
 fixed sprites_mosaic_horizontal_stretch()
 {
     return data.sprites_mosaic_horizontal_stretch;
@@ -793,6 +811,8 @@ void commit()
 
         if(data.commit_enabled_bgs)
         {
+            hw::display::set_mode(data.bgs_mode);
+
             for(int index = 0; index < hw::bgs::count(); ++index)
             {
                 hw::display::set_bg_enabled(index, data.enabled_bgs[index]);
@@ -29,6 +29,10 @@ namespace btn::display_manager
 
     void set_bg_enabled(int bg, bool enabled);
 
+    [[nodiscard]] int bgs_mode();
+
+    void set_bgs_mode(int mode);
+
     [[nodiscard]] fixed sprites_mosaic_horizontal_stretch();
 
     void set_sprites_mosaic_horizontal_stretch(fixed stretch);
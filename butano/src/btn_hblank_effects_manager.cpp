@@ -8,6 +8,12 @@
 #include "btn_vector.h"
 #include "../hw/include/btn_hw_hblank_effects.h"
 
+#include "btn_affine_bg_pa_register_hblank_effect_handler.h"
+#include "btn_affine_bg_pb_register_hblank_effect_handler.h"
+#include "btn_affine_bg_pc_register_hblank_effect_handler.h"
+#include "btn_affine_bg_pd_register_hblank_effect_handler.h"
+#include "btn_affine_bg_dx_register_hblank_effect_handler.h"
+#include "btn_affine_bg_dy_register_hblank_effect_handler.h"
 #include "btn_bg_palette_color_hblank_effect_handler.h"
 #include "btn_bg_palettes_transparent_color_hblank_effect_handler.h"
 #include "btn_blending_fade_alpha_hblank_effect_handler.h"
@@ -33,6 +39,12 @@
 
 #include "btn_hblank_effects.cpp.h"
 #include "btn_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_pa_register_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_pb_register_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_pc_register_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_pd_register_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_dx_register_hblank_effect_ptr.cpp.h"
+#include "btn_affine_bg_dy_register_hblank_effect_ptr.cpp.h"
 #include "btn_bg_palette_color_hblank_effect_ptr.cpp.h"
 #include "btn_bg_palettes_transparent_color_hblank_effect_ptr.cpp.h"
 #include "btn_blending_fade_alpha_hblank_effect_ptr.cpp.h"
@@ -63,6 +75,14 @@ namespace
 
     static_assert(max_items > 0 && max_items <= 8);
 
+    #if BTN_CFG_HBLANK_EFFECTS_BACKEND == BTN_HBLANK_EFFECTS_BACKEND_HDMA
+        constexpr const int max_hdma_entries = min(max_items, hw::hdma::max_channels);
+    #elif BTN_CFG_HBLANK_EFFECTS_BACKEND == BTN_HBLANK_EFFECTS_BACKEND_IRQ
+        constexpr const int max_hdma_entries = 0;
+    #else
+        static_assert(false, "Unknown H-Blank effects backend");
+    #endif
+
     using last_value_type = any<4 * sizeof(int)>;
     using hw_entry = hw::hblank_effects::entry;
 
@@ -75,9 +95,11 @@ namespace
         int target_id = 0;
         unsigned usages = 0;
         uint16_t* output_register = nullptr;
-        alignas(int) uint16_t output_values_a[display::height()] = {};
-        alignas(int) uint16_t output_values_b[display::height()] = {};
+        // 32 bits registers are written with two 16 bits entries, so their output values are twice as many:
+        alignas(int) uint16_t output_values_a[display::height() * 2] = {};
+        alignas(int) uint16_t output_values_b[display::height() * 2] = {};
         handler_type handler;
+        bool words: 1 = false;
         bool visible: 1 = false;
         bool update: 1 = false;
         bool on_screen: 1 = false;
@@ -89,6 +111,30 @@ namespace
             switch(handler)
             {
 
+            case handler_type::AFFINE_BG_PA_REGISTER:
+                affine_bg_pa_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
+            case handler_type::AFFINE_BG_PB_REGISTER:
+                affine_bg_pb_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
+            case handler_type::AFFINE_BG_PC_REGISTER:
+                affine_bg_pc_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
+            case handler_type::AFFINE_BG_PD_REGISTER:
+                affine_bg_pd_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
+            case handler_type::AFFINE_BG_DX_REGISTER:
+                affine_bg_dx_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
+            case handler_type::AFFINE_BG_DY_REGISTER:
+                affine_bg_dy_register_hblank_effect_handler::setup_target(target_id, target_last_value);
+                break;
+
             case handler_type::BG_PALETTE_COLOR:
                 bg_palette_color_hblank_effect_handler::setup_target(target_id, target_last_value);
                 break;
@@ -204,6 +250,24 @@ namespace
             switch(handler)
             {
 
+            case handler_type::AFFINE_BG_PA_REGISTER:
+                return _check_update_impl<affine_bg_pa_register_hblank_effect_handler>();
+
+            case handler_type::AFFINE_BG_PB_REGISTER:
+                return _check_update_impl<affine_bg_pb_register_hblank_effect_handler>();
+
+            case handler_type::AFFINE_BG_PC_REGISTER:
+                return _check_update_impl<affine_bg_pc_register_hblank_effect_handler>();
+
+            case handler_type::AFFINE_BG_PD_REGISTER:
+                return _check_update_impl<affine_bg_pd_register_hblank_effect_handler>();
+
+            case handler_type::AFFINE_BG_DX_REGISTER:
+                return _check_update_impl<affine_bg_dx_register_hblank_effect_handler>();
+
+            case handler_type::AFFINE_BG_DY_REGISTER:
+                return _check_update_impl<affine_bg_dy_register_hblank_effect_handler>();
+
             case handler_type::BG_PALETTE_COLOR:
                 return _check_update_impl<bg_palette_color_hblank_effect_handler>();
 
@@ -288,10 +352,22 @@ namespace
             }
         }
 
-        void setup_entry(hw_entry& entry) const
+        [[nodiscard]] int entries_count() const
         {
-            entry.src = output_values_a_active ? output_values_a : output_values_b;
-            entry.dest = output_register;
+            return words ? 2 : 1;
+        }
+
+        void setup_entries(hw_entry* entries) const
+        {
+            const uint16_t* output_values = output_values_a_active ? output_values_a : output_values_b;
+            entries[0].src = output_values;
+            entries[0].dest = output_register;
+
+            if(words)
+            {
+                entries[1].src = output_values + display::height();
+                entries[1].dest = output_register + 1;
+            }
         }
 
         void show()
@@ -299,6 +375,30 @@ namespace
             switch(handler)
             {
 
+            case handler_type::AFFINE_BG_PA_REGISTER:
+                affine_bg_pa_register_hblank_effect_handler::show(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PB_REGISTER:
+                affine_bg_pb_register_hblank_effect_handler::show(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PC_REGISTER:
+                affine_bg_pc_register_hblank_effect_handler::show(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PD_REGISTER:
+                affine_bg_pd_register_hblank_effect_handler::show(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_DX_REGISTER:
+                affine_bg_dx_register_hblank_effect_handler::show(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_DY_REGISTER:
+                affine_bg_dy_register_hblank_effect_handler::show(target_id);
+                break;
+
             case handler_type::BG_PALETTE_COLOR:
                 bg_palette_color_hblank_effect_handler::show(target_id);
                 break;
@@ -414,6 +514,30 @@ namespace
             switch(handler)
             {
 
+            case handler_type::AFFINE_BG_PA_REGISTER:
+                affine_bg_pa_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PB_REGISTER:
+                affine_bg_pb_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PC_REGISTER:
+                affine_bg_pc_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_PD_REGISTER:
+                affine_bg_pd_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_DX_REGISTER:
+                affine_bg_dx_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
+            case handler_type::AFFINE_BG_DY_REGISTER:
+                affine_bg_dy_register_hblank_effect_handler::cleanup(target_id);
+                break;
+
             case handler_type::BG_PALETTE_COLOR:
                 bg_palette_color_hblank_effect_handler::cleanup(target_id);
                 break;
@@ -587,6 +711,7 @@ namespace
         bool update = false;
         bool commit = false;
         bool enabled = false;
+        bool hdma_enabled = false;
     };
 
     class static_internal_data
@@ -635,6 +760,8 @@ namespace
         new_item.usages = 1;
         new_item.output_register = nullptr;
         new_item.handler = handler;
+        new_item.words = handler == handler_type::AFFINE_BG_DX_REGISTER ||
+                handler == handler_type::AFFINE_BG_DY_REGISTER;
         new_item.visible = true;
         new_item.update = true;
         new_item.on_screen = false;
@@ -674,6 +801,11 @@ void enable()
     {
         hw::hblank_effects::enable();
     }
+
+    if(external_data.hdma_enabled)
+    {
+        hw::hblank_effects::enable_hdma();
+    }
 }
 
 void disable()
@@ -682,6 +814,11 @@ void disable()
     {
         hw::hblank_effects::disable();
     }
+
+    if(external_data.hdma_enabled)
+    {
+        hw::hblank_effects::disable_hdma();
+    }
 }
 
 int create(const void* values_ptr, [[maybe_unused]] int values_count, int target_id, handler_type handler)
@@ -862,9 +999,11 @@ void update()
 
             if(item.visible && item.on_screen)
             {
-                hw_entry& entry = entries[entries_count];
-                item.setup_entry(entry);
-                ++entries_count;
+                int item_entries_count = item.entries_count();
+                BTN_ASSERT(entries_count + item_entries_count <= max_items, "Too many H-Blank effect entries");
+
+                item.setup_entries(entries + entries_count);
+                entries_count += item_entries_count;
             }
         }
 
@@ -877,15 +1016,41 @@ void commit()
 {
     if(external_data.commit)
     {
+        // The first entries are committed with HDMA and the remaining ones with the H-Blank interrupt handler:
+        int total_entries_count = external_data.new_entries_count;
+        int hdma_entries_count = min(total_entries_count, max_hdma_entries);
         int old_entries_count = external_data.old_entries_count;
-        int new_entries_count = external_data.new_entries_count;
-        external_data.old_entries_count = external_data.new_entries_count;
+        int new_entries_count = total_entries_count - hdma_entries_count;
+        external_data.old_entries_count = int8_t(new_entries_count);
         external_data.commit = false;
 
+        hw_entry* entries_ptr = external_data.entries_a_active ? internal_data.entries_a : internal_data.entries_b;
+
+        if constexpr(max_hdma_entries > 0)
+        {
+            hw::hblank_effects::commit_hdma_entries(entries_ptr, hdma_entries_count);
+
+            if(hdma_entries_count)
+            {
+                if(! external_data.hdma_enabled)
+                {
+                    external_data.hdma_enabled = true;
+                    hw::hblank_effects::enable_hdma();
+                }
+            }
+            else
+            {
+                if(external_data.hdma_enabled)
+                {
+                    external_data.hdma_enabled = false;
+                    hw::hblank_effects::disable_hdma();
+                }
+            }
+        }
+
         if(new_entries_count)
         {
-            hw_entry* entries_ptr = external_data.entries_a_active ? internal_data.entries_a : internal_data.entries_b;
-            hw::hblank_effects::commit_entries_ptr(entries_ptr);
+            hw::hblank_effects::commit_entries_ptr(entries_ptr + hdma_entries_count);
 
             if(old_entries_count != new_entries_count)
             {
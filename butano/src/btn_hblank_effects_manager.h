@@ -12,6 +12,12 @@ namespace btn::hblank_effects_manager
 {
     enum class handler_type : uint8_t
     {
+        AFFINE_BG_PA_REGISTER,
+        AFFINE_BG_PB_REGISTER,
+        AFFINE_BG_PC_REGISTER,
+        AFFINE_BG_PD_REGISTER,
+        AFFINE_BG_DX_REGISTER,
+        AFFINE_BG_DY_REGISTER,
         BG_PALETTE_COLOR,
         BG_PALETTES_TRANSPARENT_COLOR,
         BLENDING_FADE_ALPHA,
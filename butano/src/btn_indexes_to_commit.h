@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_INDEXES_TO_COMMIT_H
+#define BTN_INDEXES_TO_COMMIT_H
+
+#include "btn_assert.h"
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+// Indexes of hardware items which must be committed, stored as a bitmask.
+//
+// They are committed with the minimum number of transfers: contiguous indexes are committed together,
+// and ranges separated by up to MaxMergedGap indexes are merged, since committing a few unmodified items
+// is cheaper than the setup cost of another transfer.
+template<int MaxIndexes, int MaxMergedGap>
+class indexes_to_commit
+{
+    static_assert(MaxIndexes > 0);
+    static_assert(MaxMergedGap >= 0);
+
+public:
+    [[nodiscard]] bool empty() const
+    {
+        for(unsigned word : _words)
+        {
+            if(word)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Indicates if the given index is committed by for_each_range, merged gaps included:
+    [[nodiscard]] bool committed(int index) const
+    {
+        bool result = false;
+
+        for_each_range([index, &result](int first_index, int count)
+        {
+            result |= index >= first_index && index < first_index + count;
+        });
+
+        return result;
+    }
+
+    void add(int index)
+    {
+        BTN_ASSERT(index >= 0 && index < MaxIndexes, "Invalid index: ", index);
+
+        _words[index / 32] |= 1U << (index % 32);
+    }
+
+    void add(int first_index, int count)
+    {
+        BTN_ASSERT(first_index >= 0 && count >= 0 && first_index + count <= MaxIndexes,
+                   "Invalid range: ", first_index, " - ", count);
+
+        while(count > 0)
+        {
+            int first_bit = first_index % 32;
+            int bits_count = min(count, 32 - first_bit);
+            unsigned bits = bits_count == 32 ? ~0U : ((1U << bits_count) - 1) << first_bit;
+            _words[first_index / 32] |= bits;
+            first_index += bits_count;
+            count -= bits_count;
+        }
+    }
+
+    void clear()
+    {
+        for(unsigned& word : _words)
+        {
+            word = 0;
+        }
+    }
+
+    // Number of indexes committed by for_each_range, merged gaps included:
+    [[nodiscard]] int committed_count() const
+    {
+        int result = 0;
+
+        for_each_range([&result](int, int count)
+        {
+            result += count;
+        });
+
+        return result;
+    }
+
+    // Calls function(first_index, count) for each range to commit:
+    template<typename Function>
+    void for_each_range(const Function& function) const
+    {
+        int range_first_index = -1;
+        int range_end_index = 0;
+
+        for(int word_index = 0; word_index < words_count; ++word_index)
+        {
+            unsigned word = _words[word_index];
+
+            while(word)
+            {
+                int first_bit = __builtin_ctz(word);
+                unsigned clear_bits = ~word & (~0U << first_bit);
+                int end_bit = clear_bits ? __builtin_ctz(clear_bits) : 32;
+                int first_index = (word_index * 32) + first_bit;
+                int end_index = (word_index * 32) + end_bit;
+                word = end_bit == 32 ? 0 : word & (~0U << end_bit);
+
+                if(range_first_index >= 0 && first_index - range_end_index <= MaxMergedGap)
+                {
+                    range_end_index = end_index;
+                }
+                else
+                {
+                    if(range_first_index >= 0)
+                    {
+                        function(range_first_index, range_end_index - range_first_index);
+                    }
+
+                    range_first_index = first_index;
+                    range_end_index = end_index;
+                }
+            }
+        }
+
+        if(range_first_index >= 0)
+        {
+            function(range_first_index, range_end_index - range_first_index);
+        }
+    }
+
+private:
+    static constexpr const int words_count = (MaxIndexes + 31) / 32;
+
+    unsigned _words[words_count] = {};
+};
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_LOG_DUMP_WRITER_H
+#define BTN_LOG_DUMP_WRITER_H
+
+#include "btn_log.h"
+#include "btn_string.h"
+
+#if BTN_CFG_LOG_ENABLED
+
+namespace btn
+{
+
+// Logs binary data as hex encoded lines, which are decoded by the butano tools:
+// <tag>_begin
+// <tag>:<hex bytes>
+// ...
+// <tag>_end
+class log_dump_writer
+{
+
+public:
+    explicit log_dump_writer(const char* tag) :
+        _tag(tag)
+    {
+        _log("_begin");
+    }
+
+    ~log_dump_writer()
+    {
+        if(_bytes)
+        {
+            btn::log(_line);
+        }
+
+        _log("_end");
+    }
+
+    log_dump_writer(const log_dump_writer& other) = delete;
+
+    log_dump_writer& operator=(const log_dump_writer& other) = delete;
+
+    void write(unsigned value, int bytes)
+    {
+        for(int index = 0; index < bytes; ++index)
+        {
+            _write_byte(value & 0xFF);
+            value >>= 8;
+        }
+    }
+
+    void write(const char* text)
+    {
+        int size = 0;
+
+        while(text[size] && size < 255)
+        {
+            ++size;
+        }
+
+        write(unsigned(size), 1);
+
+        for(int index = 0; index < size; ++index)
+        {
+            _write_byte(uint8_t(text[index]));
+        }
+    }
+
+private:
+    static constexpr const int _max_bytes_per_line = 64;
+
+    const char* _tag;
+    string<32 + (_max_bytes_per_line * 2)> _line;
+    int _bytes = 0;
+
+    void _log(const char* suffix)
+    {
+        _line.clear();
+        _line.append(_tag);
+        _line.append(suffix);
+        btn::log(_line);
+        _line.clear();
+    }
+
+    void _write_byte(unsigned byte)
+    {
+        constexpr const char hex_chars[] = "0123456789abcdef";
+
+        if(! _bytes)
+        {
+            _line.clear();
+            _line.append(_tag);
+            _line.push_back(':');
+        }
+
+        _line.push_back(hex_chars[byte >> 4]);
+        _line.push_back(hex_chars[byte & 0xF]);
+        ++_bytes;
+
+        if(_bytes == _max_bytes_per_line)
+        {
+            btn::log(_line);
+            _bytes = 0;
+        }
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -8,9 +8,9 @@
 #include "btn_memory_manager.h"
 #include "../hw/include/btn_hw_memory.h"
 
-void* operator new(unsigned bytes)
+void* operator new(std::size_t bytes)
 {
-    void* ptr = btn::memory_manager::ewram_alloc(bytes);
+    void* ptr = btn::memory_manager::ewram_alloc(int(bytes));
     BTN_ASSERT(ptr, "Allocation failed. Size in bytes: ", bytes);
     return ptr;
 }
@@ -20,14 +20,14 @@ void operator delete(void* ptr) noexcept
     btn::memory_manager::ewram_free(ptr);
 }
 
-void operator delete(void* ptr, [[maybe_unused]] unsigned bytes) noexcept
+void operator delete(void* ptr, [[maybe_unused]] std::size_t bytes) noexcept
 {
     btn::memory_manager::ewram_free(ptr);
 }
 
-void* operator new[](unsigned bytes)
+void* operator new[](std::size_t bytes)
 {
-    void* ptr = btn::memory_manager::ewram_alloc(bytes);
+    void* ptr = btn::memory_manager::ewram_alloc(int(bytes));
     BTN_ASSERT(ptr, "Allocation failed. Size in bytes: ", bytes);
     return ptr;
 }
@@ -37,7 +37,7 @@ void operator delete[](void* ptr) noexcept
     btn::memory_manager::ewram_free(ptr);
 }
 
-void operator delete[](void* ptr, [[maybe_unused]] unsigned bytes) noexcept
+void operator delete[](void* ptr, [[maybe_unused]] std::size_t bytes) noexcept
 {
     btn::memory_manager::ewram_free(ptr);
 }
@@ -111,6 +111,34 @@ int available_items_ewram()
     return memory_manager::available_items_ewram();
 }
 
+int largest_available_alloc_ewram()
+{
+    return memory_manager::largest_available_alloc_ewram();
+}
+
+int free_blocks_ewram()
+{
+    return memory_manager::free_blocks_ewram();
+}
+
+int used_pools_ewram()
+{
+    return memory_manager::used_pools_ewram();
+}
+
+fixed fragmentation_ewram()
+{
+    int available_bytes = memory_manager::available_alloc_ewram();
+
+    if(available_bytes <= 0)
+    {
+        return 0;
+    }
+
+    int largest_available_bytes = memory_manager::largest_available_alloc_ewram();
+    return fixed(1) - (fixed(largest_available_bytes) / available_bytes);
+}
+
 int used_static_iwram()
 {
     return hw::memory::used_static_iwram();
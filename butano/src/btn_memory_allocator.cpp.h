@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_memory_allocator.h"
+
+#include "btn_assert.h"
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+namespace
+{
+    [[nodiscard]] inline int _fls(unsigned value)
+    {
+        return 31 - __builtin_clz(value);
+    }
+
+    [[nodiscard]] inline int _ffs(unsigned value)
+    {
+        return __builtin_ctz(value);
+    }
+}
+
+void memory_allocator::init(void* start, int bytes)
+{
+    BTN_ASSERT(start, "Start is null");
+    BTN_ASSERT(bytes >= 0, "Invalid bytes: ", bytes);
+
+    // Align the start of the memory area and leave room for the first block header and the sentinel block:
+    auto start_address = reinterpret_cast<uintptr_t>(start);
+    auto aligned_start_address = (start_address + alignment - 1) & ~uintptr_t(alignment - 1);
+    int block_size = (bytes - int(aligned_start_address - start_address) - (_block_overhead * 2)) &
+            ~(alignment - 1);
+
+    if(block_size < _block_min_size)
+    {
+        return;
+    }
+
+    BTN_ASSERT(block_size < _block_max_size, "Too many bytes: ", bytes);
+
+    // The previous physical field of the first block is outside the memory area, but it is never accessed:
+    auto block = reinterpret_cast<block_header*>(aligned_start_address - sizeof(block_header*));
+    block->size_and_flags = uintptr_t(block_size);
+    block->set_free(true);
+    _insert_free_block(block);
+
+    // The sentinel block is a zero sized used block which avoids merging past the end of the memory area:
+    block_header* sentinel = block->link_next();
+    sentinel->size_and_flags = 0;
+    sentinel->set_previous_free(true);
+
+    _total_bytes = block_size + _block_overhead;
+}
+
+void* memory_allocator::alloc(int bytes)
+{
+    BTN_ASSERT(bytes >= 0, "Invalid bytes: ", bytes);
+
+    int aligned_bytes = (bytes + alignment - 1) & ~(alignment - 1);
+
+    if(aligned_bytes < bytes)
+    {
+        return nullptr;
+    }
+
+    void* result = nullptr;
+    int used_bytes;
+
+    if(int chunk_size = aligned_bytes + _block_overhead; chunk_size <= max_pool_chunk_size)
+    {
+        result = _pool_alloc((chunk_size / alignment) - 1);
+        used_bytes = chunk_size;
+    }
+
+    if(! result)
+    {
+        result = _block_alloc(aligned_bytes);
+
+        if(! result)
+        {
+            return nullptr;
+        }
+
+        used_bytes = block_header::from_data(result)->size() + _block_overhead;
+    }
+
+    _used_bytes += used_bytes;
+    ++_used_items;
+    return result;
+}
+
+void memory_allocator::free(void* ptr)
+{
+    if(ptr)
+    {
+        // Pool chunks have the lowest bit of their header set, used blocks have it cleared:
+        uintptr_t* header = static_cast<uintptr_t*>(ptr) - 1;
+
+        if(*header & 1)
+        {
+            _pool_free(header);
+        }
+        else
+        {
+            block_header* block = block_header::from_data(ptr);
+            BTN_ASSERT(! block->free(), "Block is not used: ", ptr);
+
+            _used_bytes -= block->size() + _block_overhead;
+            _block_free(ptr);
+        }
+
+        --_used_items;
+    }
+}
+
+int memory_allocator::largest_available_bytes() const
+{
+    if(! _fl_bitmap)
+    {
+        return 0;
+    }
+
+    int fl = _fls(_fl_bitmap);
+    int sl = _fls(_sl_bitmaps[fl]);
+    int result = 0;
+
+    // Blocks of the same list are not sorted by size:
+    for(block_header* block = _blocks[fl][sl]; block; block = block->next_free_block)
+    {
+        result = max(result, block->size());
+    }
+
+    return result;
+}
+
+void memory_allocator::_mapping(int size, int& fl, int& sl)
+{
+    if(size < _small_block_size)
+    {
+        fl = 0;
+        sl = size / (_small_block_size / _sl_index_count);
+    }
+    else
+    {
+        int msb = _fls(unsigned(size));
+        sl = (size >> (msb - _sl_index_count_log2)) ^ _sl_index_count;
+        fl = msb - (_fl_index_shift - 1);
+    }
+}
+
+void memory_allocator::_insert_free_block(block_header* block)
+{
+    int fl;
+    int sl;
+    _mapping(block->size(), fl, sl);
+
+    block_header* current = _blocks[fl][sl];
+    block->next_free_block = current;
+    block->previous_free_block = nullptr;
+
+    if(current)
+    {
+        current->previous_free_block = block;
+    }
+
+    _blocks[fl][sl] = block;
+    _fl_bitmap |= 1U << fl;
+    _sl_bitmaps[fl] |= 1U << sl;
+    ++_free_blocks;
+}
+
+void memory_allocator::_remove_free_block(block_header* block)
+{
+    int fl;
+    int sl;
+    _mapping(block->size(), fl, sl);
+    _remove_free_block(block, fl, sl);
+}
+
+void memory_allocator::_remove_free_block(block_header* block, int fl, int sl)
+{
+    block_header* next = block->next_free_block;
+    block_header* previous = block->previous_free_block;
+
+    if(next)
+    {
+        next->previous_free_block = previous;
+    }
+
+    if(previous)
+    {
+        previous->next_free_block = next;
+    }
+    else
+    {
+        _blocks[fl][sl] = next;
+
+        if(! next)
+        {
+            _sl_bitmaps[fl] &= ~(1U << sl);
+
+            if(! _sl_bitmaps[fl])
+            {
+                _fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+
+    --_free_blocks;
+}
+
+memory_allocator::block_header* memory_allocator::_merge_previous(block_header* block)
+{
+    if(block->previous_free())
+    {
+        block_header* previous = block->previous_physical;
+        _remove_free_block(previous);
+        previous->set_size(previous->size() + block->size() + _block_overhead);
+        previous->link_next();
+        block = previous;
+    }
+
+    return block;
+}
+
+memory_allocator::block_header* memory_allocator::_merge_next(block_header* block)
+{
+    block_header* next = block->next_physical();
+
+    if(next->free())
+    {
+        _remove_free_block(next);
+        block->set_size(block->size() + next->size() + _block_overhead);
+        block->link_next();
+    }
+
+    return block;
+}
+
+void* memory_allocator::_block_alloc(int bytes)
+{
+    int size = max(bytes, _block_min_size);
+
+    if(size >= _block_max_size)
+    {
+        return nullptr;
+    }
+
+    // Round up the size to the next list, so any block of it is big enough:
+    int search_size = size;
+
+    if(search_size >= _small_block_size)
+    {
+        search_size += (1 << (_fls(unsigned(search_size)) - _sl_index_count_log2)) - 1;
+    }
+
+    int fl;
+    int sl;
+    _mapping(search_size, fl, sl);
+
+    if(fl >= _fl_index_count)
+    {
+        return nullptr;
+    }
+
+    unsigned sl_bitmap = _sl_bitmaps[fl] & (~0U << sl);
+
+    if(! sl_bitmap)
+    {
+        unsigned fl_bitmap = fl + 1 < _fl_index_count ? _fl_bitmap & (~0U << (fl + 1)) : 0;
+
+        if(! fl_bitmap)
+        {
+            return nullptr;
+        }
+
+        fl = _ffs(fl_bitmap);
+        sl_bitmap = _sl_bitmaps[fl];
+    }
+
+    sl = _ffs(sl_bitmap);
+
+    block_header* block = _blocks[fl][sl];
+    _remove_free_block(block, fl, sl);
+
+    // Split the block if the remaining space is big enough to store another one:
+    if(block->size() >= int(sizeof(block_header)) + size)
+    {
+        auto remaining = reinterpret_cast<block_header*>(block->data() + size - sizeof(uintptr_t));
+        remaining->size_and_flags = uintptr_t(block->size() - size - _block_overhead);
+        block->set_size(size);
+        remaining->set_free(true);
+        remaining->link_next()->set_previous_free(true);
+        block->link_next();
+        _insert_free_block(remaining);
+    }
+
+    block->next_physical()->set_previous_free(false);
+    block->set_free(false);
+    return block->data();
+}
+
+void memory_allocator::_block_free(void* ptr)
+{
+    block_header* block = block_header::from_data(ptr);
+    block->set_free(true);
+    block->link_next()->set_previous_free(true);
+    block = _merge_previous(block);
+    block = _merge_next(block);
+    _insert_free_block(block);
+}
+
+void* memory_allocator::_pool_alloc(int pool_index)
+{
+    int chunk_size = (pool_index + 1) * alignment;
+    pool_page* page = _pools[pool_index];
+
+    if(! page)
+    {
+        int page_size = _pool_page_header_size + (chunk_size * _pool_page_chunks);
+        page = static_cast<pool_page*>(_block_alloc(page_size));
+
+        if(! page)
+        {
+            return nullptr;
+        }
+
+        page->next = nullptr;
+        page->previous = nullptr;
+        page->free_chunks = nullptr;
+        page->used_chunks = 0;
+        page->carved_chunks = 0;
+        page->pool_index = uint16_t(pool_index);
+        _pools[pool_index] = page;
+        _pools_bytes += block_header::from_data(page)->size() + _block_overhead;
+    }
+
+    uintptr_t* chunk = page->free_chunks;
+
+    if(chunk)
+    {
+        page->free_chunks = reinterpret_cast<uintptr_t*>(*chunk);
+    }
+    else
+    {
+        // Chunks are carved lazily, so pages are created in constant time:
+        chunk = reinterpret_cast<uintptr_t*>(reinterpret_cast<char*>(page) + _pool_page_header_size +
+                                             (page->carved_chunks * chunk_size));
+        ++page->carved_chunks;
+    }
+
+    ++page->used_chunks;
+
+    // Full pages are removed from the pool:
+    if(page->used_chunks == _pool_page_chunks)
+    {
+        _pools[pool_index] = page->next;
+
+        if(page->next)
+        {
+            page->next->previous = nullptr;
+        }
+    }
+
+    *chunk = uintptr_t(reinterpret_cast<char*>(chunk) - reinterpret_cast<char*>(page)) | 1;
+    return chunk + 1;
+}
+
+void memory_allocator::_pool_free(uintptr_t* chunk)
+{
+    auto page = reinterpret_cast<pool_page*>(reinterpret_cast<char*>(chunk) - (*chunk & ~uintptr_t(1)));
+    int pool_index = page->pool_index;
+    BTN_ASSERT(pool_index < pools_count && page->used_chunks, "Chunk is not used: ", chunk + 1);
+
+    *chunk = reinterpret_cast<uintptr_t>(page->free_chunks);
+    page->free_chunks = chunk;
+    _used_bytes -= (pool_index + 1) * alignment;
+
+    // Full pages are inserted again in the pool:
+    if(page->used_chunks == _pool_page_chunks)
+    {
+        pool_page* first_page = _pools[pool_index];
+        page->next = first_page;
+        page->previous = nullptr;
+
+        if(first_page)
+        {
+            first_page->previous = page;
+        }
+
+        _pools[pool_index] = page;
+    }
+
+    --page->used_chunks;
+
+    // Empty pages are released, unless they are the only page of the pool:
+    if(! page->used_chunks && (page->next || page->previous))
+    {
+        pool_page* next = page->next;
+        pool_page* previous = page->previous;
+
+        if(next)
+        {
+            next->previous = previous;
+        }
+
+        if(previous)
+        {
+            previous->next = next;
+        }
+        else
+        {
+            _pools[pool_index] = next;
+        }
+
+        _pools_bytes -= block_header::from_data(page)->size() + _block_overhead;
+        _block_free(page);
+    }
+}
+
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_MEMORY_ALLOCATOR_H
+#define BTN_MEMORY_ALLOCATOR_H
+
+#include "btn_common.h"
+#include "btn_config_memory.h"
+
+namespace btn
+{
+
+// Segregated-fit allocator with two levels:
+// * Small items are stored in fixed size chunks taken from pool pages, one pool per chunk size.
+// * Big items and pool pages are stored in blocks indexed by a TLSF (two-level segregated fit) structure.
+// All operations are O(1) except for the stats functions.
+class memory_allocator
+{
+
+public:
+    static constexpr const int alignment = sizeof(uintptr_t);
+    static constexpr const int pools_count = BTN_CFG_MEMORY_EWRAM_POOLS_COUNT;
+    static constexpr const int max_pool_chunk_size = pools_count * alignment;
+
+    // It must be called only once:
+    void init(void* start, int bytes);
+
+    [[nodiscard]] void* alloc(int bytes);
+
+    void free(void* ptr);
+
+    [[nodiscard]] int total_bytes() const
+    {
+        return _total_bytes;
+    }
+
+    [[nodiscard]] int used_bytes() const
+    {
+        return _used_bytes;
+    }
+
+    [[nodiscard]] int available_bytes() const
+    {
+        return _total_bytes - _used_bytes;
+    }
+
+    [[nodiscard]] int used_items() const
+    {
+        return _used_items;
+    }
+
+    [[nodiscard]] int free_blocks() const
+    {
+        return _free_blocks;
+    }
+
+    [[nodiscard]] int largest_available_bytes() const;
+
+    [[nodiscard]] int pools_bytes() const
+    {
+        return _pools_bytes;
+    }
+
+private:
+    static constexpr const int _align_log2 = alignment == 8 ? 3 : 2;
+    static constexpr const int _sl_index_count_log2 = 4;
+    static constexpr const int _sl_index_count = 1 << _sl_index_count_log2;
+    static constexpr const int _fl_index_shift = _sl_index_count_log2 + _align_log2;
+    static constexpr const int _fl_index_max = 18;
+    static constexpr const int _fl_index_count = _fl_index_max - _fl_index_shift + 1;
+    static constexpr const int _small_block_size = 1 << _fl_index_shift;
+
+    static_assert(alignment == 4 || alignment == 8);
+    static_assert(pools_count >= 0 && pools_count <= _small_block_size / alignment);
+
+    class block_header
+    {
+
+    public:
+        static constexpr const uintptr_t free_flag = 1;
+        static constexpr const uintptr_t previous_free_flag = 2;
+
+        // Only valid if the previous physical block is free (it is stored in its last word):
+        block_header* previous_physical;
+
+        // Size of the block data, and free and previous free flags in the lowest bits:
+        uintptr_t size_and_flags;
+
+        // Only valid if the block is free:
+        block_header* next_free_block;
+        block_header* previous_free_block;
+
+        [[nodiscard]] static block_header* from_data(void* data)
+        {
+            return reinterpret_cast<block_header*>(static_cast<char*>(data) - sizeof(block_header*) -
+                                                   sizeof(uintptr_t));
+        }
+
+        [[nodiscard]] char* data()
+        {
+            return reinterpret_cast<char*>(&size_and_flags + 1);
+        }
+
+        [[nodiscard]] int size() const
+        {
+            return int(size_and_flags & ~(free_flag | previous_free_flag));
+        }
+
+        void set_size(int size)
+        {
+            size_and_flags = uintptr_t(size) | (size_and_flags & (free_flag | previous_free_flag));
+        }
+
+        [[nodiscard]] bool free() const
+        {
+            return size_and_flags & free_flag;
+        }
+
+        void set_free(bool free)
+        {
+            size_and_flags = free ? size_and_flags | free_flag : size_and_flags & ~free_flag;
+        }
+
+        [[nodiscard]] bool previous_free() const
+        {
+            return size_and_flags & previous_free_flag;
+        }
+
+        void set_previous_free(bool previous_free)
+        {
+            size_and_flags = previous_free ?
+                        size_and_flags | previous_free_flag : size_and_flags & ~previous_free_flag;
+        }
+
+        // The previous physical field of the next block overlaps the last word of the data of this one:
+        [[nodiscard]] block_header* next_physical()
+        {
+            return reinterpret_cast<block_header*>(data() + size() - sizeof(uintptr_t));
+        }
+
+        block_header* link_next()
+        {
+            block_header* next = next_physical();
+            next->previous_physical = this;
+            return next;
+        }
+    };
+
+    class pool_page
+    {
+
+    public:
+        pool_page* next;
+        pool_page* previous;
+        uintptr_t* free_chunks;
+        uint16_t used_chunks;
+        uint16_t carved_chunks;
+        uint16_t pool_index;
+    };
+
+    static constexpr const int _block_overhead = sizeof(uintptr_t);
+    static constexpr const int _block_min_size = sizeof(block_header) - sizeof(block_header*);
+    static constexpr const int _block_max_size = 1 << _fl_index_max;
+    static constexpr const int _pool_page_header_size = (sizeof(pool_page) + alignment - 1) & ~(alignment - 1);
+    static constexpr const int _pool_page_chunks = BTN_CFG_MEMORY_EWRAM_POOL_PAGE_CHUNKS;
+
+    static_assert(_pool_page_chunks > 0 && _pool_page_chunks <= UINT16_MAX);
+
+    block_header* _blocks[_fl_index_count][_sl_index_count] = {};
+    unsigned _sl_bitmaps[_fl_index_count] = {};
+    unsigned _fl_bitmap = 0;
+    pool_page* _pools[pools_count > 0 ? pools_count : 1] = {};
+    int _total_bytes = 0;
+    int _used_bytes = 0;
+    int _used_items = 0;
+    int _free_blocks = 0;
+    int _pools_bytes = 0;
+
+    static void _mapping(int size, int& fl, int& sl);
+
+    void _insert_free_block(block_header* block);
+
+    void _remove_free_block(block_header* block);
+
+    void _remove_free_block(block_header* block, int fl, int sl);
+
+    [[nodiscard]] block_header* _merge_previous(block_header* block);
+
+    [[nodiscard]] block_header* _merge_next(block_header* block);
+
+    [[nodiscard]] void* _block_alloc(int bytes);
+
+    void _block_free(void* ptr);
+
+    [[nodiscard]] void* _pool_alloc(int pool_index);
+
+    void _pool_free(uintptr_t* chunk);
+};
+
+}
+
+#endif
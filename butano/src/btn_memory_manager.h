@@ -23,6 +23,12 @@ namespace btn::memory_manager
     [[nodiscard]] int used_items_ewram();
 
     [[nodiscard]] int available_items_ewram();
+
+    [[nodiscard]] int largest_available_alloc_ewram();
+
+    [[nodiscard]] int free_blocks_ewram();
+
+    [[nodiscard]] int used_pools_ewram();
 }
 
 #endif
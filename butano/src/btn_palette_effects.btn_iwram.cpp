@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_palette_effects.h"
+
+namespace btn
+{
+
+namespace
+{
+    [[nodiscard]] unsigned _apply_lut(unsigned color_data, const uint8_t* red_lut, const uint8_t* green_lut,
+                                      const uint8_t* blue_lut)
+    {
+        return red_lut[color_data & 31] | (unsigned(green_lut[(color_data >> 5) & 31]) << 5) |
+                (unsigned(blue_lut[(color_data >> 10) & 31]) << 10);
+    }
+
+    [[nodiscard]] unsigned _apply_grayscale(unsigned color_data, unsigned intensity)
+    {
+        // Same weights and rounding as tonc clr_grayscale and clr_blend_fast:
+        unsigned red = color_data & 31;
+        unsigned green = (color_data >> 5) & 31;
+        unsigned blue = (color_data >> 10) & 31;
+        unsigned gray = ((red * 0x4C) + (green * 0x96) + (blue * 0x1E) + 0x80) >> 8;
+        unsigned gray_weight = gray * intensity;
+        unsigned color_intensity = 32 - intensity;
+        red = ((red * color_intensity) + gray_weight + 16) >> 5;
+        green = ((green * color_intensity) + gray_weight + 16) >> 5;
+        blue = ((blue * color_intensity) + gray_weight + 16) >> 5;
+        return red | (green << 5) | (blue << 10);
+    }
+}
+
+void palette_effects::apply(const color* source_colors_ptr, int count, color* destination_colors_ptr) const
+{
+    BTN_ASSERT(_luts_count, "There's no effects to apply");
+
+    auto source_ptr = reinterpret_cast<const uint16_t*>(source_colors_ptr);
+    auto destination_ptr = reinterpret_cast<uint16_t*>(destination_colors_ptr);
+    const uint8_t* red_lut = _luts[0].channels[0];
+    const uint8_t* green_lut = _luts[0].channels[1];
+    const uint8_t* blue_lut = _luts[0].channels[2];
+
+    if(_luts_count == 1)
+    {
+        // Without grayscale, each color is only three table lookups:
+        int index = 0;
+
+        for(int limit = count - 3; index < limit; index += 4)
+        {
+            unsigned color_0 = source_ptr[index];
+            unsigned color_1 = source_ptr[index + 1];
+            unsigned color_2 = source_ptr[index + 2];
+            unsigned color_3 = source_ptr[index + 3];
+            destination_ptr[index] = uint16_t(_apply_lut(color_0, red_lut, green_lut, blue_lut));
+            destination_ptr[index + 1] = uint16_t(_apply_lut(color_1, red_lut, green_lut, blue_lut));
+            destination_ptr[index + 2] = uint16_t(_apply_lut(color_2, red_lut, green_lut, blue_lut));
+            destination_ptr[index + 3] = uint16_t(_apply_lut(color_3, red_lut, green_lut, blue_lut));
+        }
+
+        for(; index < count; ++index)
+        {
+            destination_ptr[index] = uint16_t(_apply_lut(source_ptr[index], red_lut, green_lut, blue_lut));
+        }
+    }
+    else
+    {
+        // Identity lookup tables are skipped, so grayscale alone doesn't need table lookups:
+        int luts_count = _luts_count;
+        bool first_identity_lut = _identity_luts[0];
+
+        for(int index = 0; index < count; ++index)
+        {
+            unsigned color_data = source_ptr[index];
+
+            if(! first_identity_lut)
+            {
+                color_data = _apply_lut(color_data, red_lut, green_lut, blue_lut);
+            }
+
+            for(int lut_index = 1; lut_index < luts_count; ++lut_index)
+            {
+                color_data = _apply_grayscale(color_data, _grayscale_intensities[lut_index - 1]);
+
+                if(! _identity_luts[lut_index])
+                {
+                    const lut& current_lut = _luts[lut_index];
+                    color_data = _apply_lut(color_data, current_lut.channels[0], current_lut.channels[1],
+                                            current_lut.channels[2]);
+                }
+            }
+
+            destination_ptr[index] = uint16_t(color_data);
+        }
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_palette_effects.h"
+
+#include "btn_memory.h"
+#include "btn_algorithm.h"
+
+namespace btn
+{
+
+namespace
+{
+    [[nodiscard]] constexpr int _clamp_channel(int value)
+    {
+        return clamp(value, 0, 31);
+    }
+
+    [[nodiscard]] constexpr int _blend_channel(int value, int target_value, int intensity)
+    {
+        // Same rounding as tonc clr_blend_fast and clr_fade_fast:
+        return ((value * (32 - intensity)) + (target_value * intensity) + 16) >> 5;
+    }
+}
+
+void palette_effects::add_brightness(int brightness)
+{
+    int value = brightness >> 3;
+    _add_transform([value](int channel){ return _clamp_channel(channel + value); });
+}
+
+void palette_effects::add_contrast(int contrast)
+{
+    int a = contrast + 256;
+    int b = (-contrast >> 1) * 32;
+    _add_transform([a, b](int channel){ return _clamp_channel(((a * channel) + b) >> 8); });
+}
+
+void palette_effects::add_intensity(int intensity)
+{
+    int a = intensity + 256;
+    _add_transform([a](int channel){ return _clamp_channel((a * channel) >> 8); });
+}
+
+void palette_effects::add_inversion()
+{
+    _add_transform([](int channel){ return 31 - channel; });
+}
+
+void palette_effects::add_grayscale(int intensity)
+{
+    BTN_ASSERT(_luts_count < max_luts, "Too many grayscale effects");
+
+    _last_lut();
+    _grayscale_intensities[_luts_count - 1] = uint8_t(intensity);
+    _push_identity_lut();
+}
+
+void palette_effects::add_fade(color fade_color, int intensity)
+{
+    int fade_channels[3] = { fade_color.red(), fade_color.green(), fade_color.blue() };
+    lut& last_lut = _last_lut();
+    _identity_luts[_luts_count - 1] = false;
+
+    for(int channel_index = 0; channel_index < 3; ++channel_index)
+    {
+        int fade_channel = fade_channels[channel_index];
+
+        for(uint8_t& value : last_lut.channels[channel_index])
+        {
+            value = uint8_t(_blend_channel(value, fade_channel, intensity));
+        }
+    }
+}
+
+void palette_effects::append(const palette_effects& other)
+{
+    int other_luts_count = other._luts_count;
+
+    if(! other_luts_count)
+    {
+        return;
+    }
+
+    if(! _luts_count)
+    {
+        *this = other;
+        return;
+    }
+
+    BTN_ASSERT(_luts_count + other_luts_count - 1 <= max_luts, "Too many grayscale effects");
+
+    lut& last_lut = _luts[_luts_count - 1];
+    const lut& other_first_lut = other._luts[0];
+    _identity_luts[_luts_count - 1] = _identity_luts[_luts_count - 1] && other._identity_luts[0];
+
+    for(int channel_index = 0; channel_index < 3; ++channel_index)
+    {
+        const uint8_t* other_channel = other_first_lut.channels[channel_index];
+
+        for(uint8_t& value : last_lut.channels[channel_index])
+        {
+            value = other_channel[value];
+        }
+    }
+
+    for(int lut_index = 1; lut_index < other_luts_count; ++lut_index)
+    {
+        _grayscale_intensities[_luts_count - 1] = other._grayscale_intensities[lut_index - 1];
+        _luts[_luts_count] = other._luts[lut_index];
+        _identity_luts[_luts_count] = other._identity_luts[lut_index];
+        ++_luts_count;
+    }
+}
+
+palette_effects::lut& palette_effects::_last_lut()
+{
+    if(! _luts_count)
+    {
+        _push_identity_lut();
+    }
+
+    return _luts[_luts_count - 1];
+}
+
+void palette_effects::_push_identity_lut()
+{
+    lut& new_lut = _luts[_luts_count];
+    _identity_luts[_luts_count] = true;
+    ++_luts_count;
+
+    for(int index = 0; index < 32; ++index)
+    {
+        new_lut.channels[0][index] = uint8_t(index);
+    }
+
+    memory::copy(new_lut.channels[0][0], 32, new_lut.channels[1][0]);
+    memory::copy(new_lut.channels[0][0], 32, new_lut.channels[2][0]);
+}
+
+}
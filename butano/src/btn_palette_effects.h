@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_PALETTE_EFFECTS_H
+#define BTN_PALETTE_EFFECTS_H
+
+#include "btn_color.h"
+#include "btn_assert.h"
+
+namespace btn
+{
+
+// Palette effects applied to colors in only one pass.
+//
+// Brightness, contrast, intensity, inversion and fade modify each color channel separately,
+// so they are composed in 32 entries lookup tables (one per channel).
+// Grayscale mixes the channels, so each grayscale effect starts a new set of lookup tables.
+class palette_effects
+{
+
+public:
+    [[nodiscard]] bool empty() const
+    {
+        return ! _luts_count;
+    }
+
+    // Brightness, contrast and intensity are 8 bits fixed point values in the range [-256, 256]:
+    void add_brightness(int brightness);
+
+    void add_contrast(int contrast);
+
+    void add_intensity(int intensity);
+
+    void add_inversion();
+
+    // Grayscale and fade intensities are in the range [0, 32]:
+    void add_grayscale(int intensity);
+
+    void add_fade(color fade_color, int intensity);
+
+    void append(const palette_effects& other);
+
+    BTN_CODE_IWRAM void apply(const color* source_colors_ptr, int count, color* destination_colors_ptr) const;
+
+private:
+    static constexpr const int max_luts = 3;
+
+    class lut
+    {
+
+    public:
+        uint8_t channels[3][32];
+    };
+
+    lut _luts[max_luts];
+    uint8_t _grayscale_intensities[max_luts - 1];
+    int _luts_count = 0;
+    bool _identity_luts[max_luts];
+
+    lut& _last_lut();
+
+    void _push_identity_lut();
+
+    template<typename Function>
+    void _add_transform(const Function& function)
+    {
+        lut& last_lut = _last_lut();
+        _identity_luts[_luts_count - 1] = false;
+
+        for(auto& channel : last_lut.channels)
+        {
+            for(uint8_t& value : channel)
+            {
+                value = uint8_t(function(int(value)));
+            }
+        }
+    }
+};
+
+}
+
+#endif
@@ -7,10 +7,10 @@
 
 #include "btn_math.h"
 #include "btn_span.h"
-#include "btn_limits.h"
 #include "btn_memory.h"
 #include "btn_display.h"
 #include "btn_algorithm.h"
+#include "btn_palette_effects.h"
 #include "btn_palette_bpp_mode.h"
 
 namespace btn
@@ -356,16 +356,7 @@ void palettes_bank::set_rotate_count(int id, int count)
 
 void palettes_bank::reload(int id)
 {
-    if(_first_index_to_commit != numeric_limits<int>::max())
-    {
-        _first_index_to_commit = min(_first_index_to_commit, id);
-        _last_index_to_commit = max(_last_index_to_commit, id);
-    }
-    else
-    {
-        _first_index_to_commit = id;
-        _last_index_to_commit = id;
-    }
+    _palettes_to_commit.add(id, max(int(_palettes[id].slots_count), 1));
 }
 
 void palettes_bank::set_transparent_color(const optional<color>& transparent_color)
@@ -555,8 +546,7 @@ void palettes_bank::set_fade(color color, fixed intensity)
 
 void palettes_bank::update()
 {
-    int first_index = numeric_limits<int>::max();
-    int last_index = 0;
+    _palettes_to_commit.clear();
 
     if(_update)
     {
@@ -564,6 +554,13 @@ void palettes_bank::update()
         _update = false;
         _update_global_effects = false;
 
+        palette_effects global_effects;
+
+        if(_global_effects_enabled)
+        {
+            _add_global_effects(global_effects);
+        }
+
         if(update_global_effects)
         {
             for(int index = 0, limit = hw::palettes::count(); index < limit; ++index)
@@ -572,9 +569,8 @@ void palettes_bank::update()
 
                 if(pal.usages)
                 {
-                    _update_palette(index);
-                    first_index = min(first_index, index);
-                    last_index = index;
+                    _update_palette(index, global_effects);
+                    _palettes_to_commit.add(index, max(int(pal.slots_count), 1));
                 }
             }
         }
@@ -586,9 +582,8 @@ void palettes_bank::update()
 
                 if(pal.update)
                 {
-                    _update_palette(index);
-                    first_index = min(first_index, index);
-                    last_index = index;
+                    _update_palette(index, global_effects);
+                    _palettes_to_commit.add(index, max(int(pal.slots_count), 1));
                 }
             }
         }
@@ -596,43 +591,14 @@ void palettes_bank::update()
         if(_transparent_color)
         {
             _final_colors[0] = *_transparent_color;
-            first_index = 0;
-        }
+            _palettes_to_commit.add(0);
 
-        if(_global_effects_enabled && first_index != numeric_limits<int>::max())
-        {
-            color* all_colors_ptr = _final_colors + (first_index * hw::palettes::colors_per_palette());
-            int all_colors_count = (last_index - first_index + max(int(_palettes[last_index].slots_count), 1)) *
-                    hw::palettes::colors_per_palette();
-            _apply_global_effects(all_colors_count, all_colors_ptr);
+            if(! global_effects.empty())
+            {
+                global_effects.apply(_final_colors, 1, _final_colors);
+            }
         }
     }
-
-    _first_index_to_commit = first_index;
-    _last_index_to_commit = last_index;
-}
-
-optional<palettes_bank::commit_data> palettes_bank::retrieve_commit_data() const
-{
-    optional<commit_data> result;
-
-    if(_first_index_to_commit != numeric_limits<int>::max())
-    {
-        int first_index = _first_index_to_commit;
-        int last_index = _last_index_to_commit;
-        int colors_offset = first_index * hw::palettes::colors_per_palette();
-        int colors_count = (last_index - first_index + max(int(_palettes[last_index].slots_count), 1)) *
-                hw::palettes::colors_per_palette();
-        result = commit_data{ _final_colors, colors_offset, colors_count };
-    }
-
-    return result;
-}
-
-void palettes_bank::reset_commit_data()
-{
-    _first_index_to_commit = numeric_limits<int>::max();
-    _last_index_to_commit = 0;
 }
 
 void palettes_bank::fill_hblank_effect_colors(int id, const color* source_colors_ptr, uint16_t* dest_ptr) const
@@ -640,16 +606,15 @@ void palettes_bank::fill_hblank_effect_colors(int id, const color* source_colors
     BTN_ASSERT(aligned<alignof(int)>(source_colors_ptr), "Source colors are not aligned");
     BTN_ASSERT(aligned<alignof(int)>(dest_ptr), "Destination colors are not aligned");
 
-    const palette& pal = _palettes[id];
-    int dest_colors_count = display::height();
-    auto dest_colors_ptr = reinterpret_cast<color*>(dest_ptr);
-    copy_colors(source_colors_ptr, dest_colors_count, dest_colors_ptr);
-    pal.apply_effects(dest_colors_count, dest_colors_ptr);
+    palette_effects global_effects;
 
     if(_global_effects_enabled)
     {
-        _apply_global_effects(dest_colors_count, dest_colors_ptr);
+        _add_global_effects(global_effects);
     }
+
+    _apply_effects(&_palettes[id], global_effects, source_colors_ptr, display::height(),
+                   reinterpret_cast<color*>(dest_ptr));
 }
 
 void palettes_bank::fill_hblank_effect_colors(const color* source_colors_ptr, uint16_t* dest_ptr) const
@@ -657,14 +622,14 @@ void palettes_bank::fill_hblank_effect_colors(const color* source_colors_ptr, ui
     BTN_ASSERT(aligned<alignof(int)>(source_colors_ptr), "Source colors are not aligned");
     BTN_ASSERT(aligned<alignof(int)>(dest_ptr), "Destination colors are not aligned");
 
-    int dest_colors_count = display::height();
-    auto dest_colors_ptr = reinterpret_cast<color*>(dest_ptr);
-    copy_colors(source_colors_ptr, dest_colors_count, dest_colors_ptr);
+    palette_effects global_effects;
 
     if(_global_effects_enabled)
     {
-        _apply_global_effects(dest_colors_count, dest_colors_ptr);
+        _add_global_effects(global_effects);
     }
+
+    _apply_effects(nullptr, global_effects, source_colors_ptr, display::height(), reinterpret_cast<color*>(dest_ptr));
 }
 
 [[nodiscard]] bool palettes_bank::_same_colors(const span<const color>& colors, int id) const
@@ -733,70 +698,93 @@ void palettes_bank::_set_colors_bpp_impl(int id, const span<const color>& colors
     _update = true;
 }
 
-void palettes_bank::_update_palette(int id)
+void palettes_bank::_update_palette(int id, const palette_effects& global_effects)
 {
     palette& pal = _palettes[id];
     const color* initial_pal_colors_ptr = _initial_colors + (id * hw::palettes::colors_per_palette());
     color* final_pal_colors_ptr = _final_colors + (id * hw::palettes::colors_per_palette());
     int pal_colors_count = pal.slots_count * hw::palettes::colors_per_palette();
-    copy_colors(initial_pal_colors_ptr, pal_colors_count, final_pal_colors_ptr);
-    pal.apply_effects(pal_colors_count, final_pal_colors_ptr);
+    _apply_effects(&pal, global_effects, initial_pal_colors_ptr, pal_colors_count, final_pal_colors_ptr);
 
+    // Rotation only moves colors, so it can be done after applying the effects:
     if(pal.rotate_count)
     {
         hw::palettes::rotate(pal.rotate_count, pal_colors_count - 1, final_pal_colors_ptr + 1);
     }
 }
 
-void palettes_bank::_apply_global_effects(int dest_colors_count, color* dest_colors_ptr) const
+void palettes_bank::_add_global_effects(palette_effects& effects) const
 {
     if(int brightness = fixed_t<8>(_brightness).data())
     {
-        hw::palettes::brightness(brightness, dest_colors_count, dest_colors_ptr);
+        effects.add_brightness(brightness);
     }
 
     if(int contrast = fixed_t<8>(_contrast).data())
     {
-        hw::palettes::contrast(contrast, dest_colors_count, dest_colors_ptr);
+        effects.add_contrast(contrast);
     }
 
     if(int intensity = fixed_t<8>(_intensity).data())
     {
-        hw::palettes::intensity(intensity, dest_colors_count, dest_colors_ptr);
+        effects.add_intensity(intensity);
     }
 
     if(_inverted)
     {
-        hw::palettes::invert(dest_colors_count, dest_colors_ptr);
+        effects.add_inversion();
     }
 
     if(int grayscale_intensity = fixed_t<5>(_grayscale_intensity).data())
     {
-        hw::palettes::grayscale(grayscale_intensity, dest_colors_count, dest_colors_ptr);
+        effects.add_grayscale(grayscale_intensity);
     }
 
     if(int fade_intensity = fixed_t<5>(_fade_intensity).data())
     {
-        hw::palettes::fade(_fade_color, fade_intensity, dest_colors_count, dest_colors_ptr);
+        effects.add_fade(_fade_color, fade_intensity);
+    }
+}
+
+void palettes_bank::_apply_effects(const palette* pal, const palette_effects& global_effects,
+                                   const color* source_colors_ptr, int colors_count, color* dest_colors_ptr) const
+{
+    palette_effects pal_effects;
+
+    if(pal && pal->add_effects(pal_effects))
+    {
+        // Palette effects are applied before global effects:
+        pal_effects.append(global_effects);
+        pal_effects.apply(source_colors_ptr, colors_count, dest_colors_ptr);
+    }
+    else if(! global_effects.empty())
+    {
+        global_effects.apply(source_colors_ptr, colors_count, dest_colors_ptr);
+    }
+    else
+    {
+        copy_colors(source_colors_ptr, colors_count, dest_colors_ptr);
     }
 }
 
-void palettes_bank::palette::apply_effects(int dest_colors_count, color* dest_colors_ptr) const
+bool palettes_bank::palette::add_effects(palette_effects& effects) const
 {
-     if(inverted)
-     {
-         hw::palettes::invert(dest_colors_count, dest_colors_ptr);
-     }
+    if(inverted)
+    {
+        effects.add_inversion();
+    }
 
-     if(int pal_grayscale_intensity = fixed_t<5>(grayscale_intensity).data())
-     {
-         hw::palettes::grayscale(pal_grayscale_intensity, dest_colors_count, dest_colors_ptr);
-     }
+    if(int pal_grayscale_intensity = fixed_t<5>(grayscale_intensity).data())
+    {
+        effects.add_grayscale(pal_grayscale_intensity);
+    }
+
+    if(int pal_fade_intensity = fixed_t<5>(fade_intensity).data())
+    {
+        effects.add_fade(fade_color, pal_fade_intensity);
+    }
 
-     if(int pal_fade_intensity = fixed_t<5>(fade_intensity).data())
-     {
-         hw::palettes::fade(fade_color, pal_fade_intensity, dest_colors_count, dest_colors_ptr);
-     }
+    return ! effects.empty();
 }
 
 }
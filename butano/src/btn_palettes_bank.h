@@ -11,26 +11,19 @@
 #include "btn_color.h"
 #include "btn_optional.h"
 #include "btn_unordered_map.h"
+#include "btn_indexes_to_commit.h"
 #include "../hw/include/btn_hw_palettes.h"
 
 namespace btn
 {
 
 enum class palette_bpp_mode;
+class palette_effects;
 
 class palettes_bank
 {
 
 public:
-    class commit_data
-    {
-
-    public:
-        const color* colors_ptr;
-        int offset;
-        int count;
-    };
-
     [[nodiscard]] static unsigned colors_hash(const span<const color>& colors);
 
     [[nodiscard]] int used_colors_count() const;
@@ -162,9 +155,36 @@ public:
 
     void update();
 
-    [[nodiscard]] optional<commit_data> retrieve_commit_data() const;
+    [[nodiscard]] bool commit_pending() const
+    {
+        return ! _palettes_to_commit.empty();
+    }
 
-    void reset_commit_data();
+    [[nodiscard]] int commit_colors_count() const
+    {
+        return _palettes_to_commit.committed_count() * hw::palettes::colors_per_palette();
+    }
+
+    [[nodiscard]] bool color_committed(int color_index) const
+    {
+        return _palettes_to_commit.committed(color_index / hw::palettes::colors_per_palette());
+    }
+
+    // Calls function(colors_ptr, offset, count) for each range of colors to commit:
+    template<typename Function>
+    void for_each_commit_range(const Function& function) const
+    {
+        _palettes_to_commit.for_each_range([this, &function](int first_index, int count)
+        {
+            int colors_per_palette = hw::palettes::colors_per_palette();
+            function(_final_colors, first_index * colors_per_palette, count * colors_per_palette);
+        });
+    }
+
+    void reset_commit_data()
+    {
+        _palettes_to_commit.clear();
+    }
 
     void fill_hblank_effect_colors(int id, const color* source_colors_ptr, uint16_t* dest_ptr) const;
 
@@ -187,7 +207,7 @@ private:
         bool update: 1 = false;
         bool locked: 1 = false;
 
-        void apply_effects(int dest_colors_count, color* dest_colors_ptr) const;
+        [[nodiscard]] bool add_effects(palette_effects& effects) const;
     };
 
     class identity_hasher
@@ -210,8 +230,9 @@ private:
     fixed _grayscale_intensity;
     fixed _fade_intensity;
     unordered_map<uint16_t, int16_t, hw::palettes::count() * 2, identity_hasher> _bpp_4_indexes_map;
-    int _first_index_to_commit = numeric_limits<int>::max();
-    int _last_index_to_commit = 0;
+
+    // Committing a 16 colors gap costs less than the setup of another transfer:
+    indexes_to_commit<hw::palettes::count(), 1> _palettes_to_commit;
     color _fade_color;
     bool _inverted = false;
     bool _update = false;
@@ -228,9 +249,12 @@ private:
 
     void _set_colors_bpp_impl(int id, const span<const color>& colors);
 
-    void _update_palette(int id);
+    void _update_palette(int id, const palette_effects& global_effects);
+
+    void _add_global_effects(palette_effects& effects) const;
 
-    void _apply_global_effects(int dest_colors_count, color* dest_colors_ptr) const;
+    void _apply_effects(const palette* pal, const palette_effects& global_effects, const color* source_colors_ptr,
+                        int colors_count, color* dest_colors_ptr) const;
 };
 
 }
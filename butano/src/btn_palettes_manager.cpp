@@ -5,6 +5,8 @@
 
 #include "btn_palettes_manager.h"
 
+#include "btn_vram_commit_queue.h"
+
 #include "btn_bg_palettes.cpp.h"
 #include "btn_bg_palette_ptr.cpp.h"
 #include "btn_bg_palette_item.cpp.h"
@@ -12,21 +14,33 @@
 #include "btn_sprite_palette_ptr.cpp.h"
 #include "btn_sprite_palette_item.cpp.h"
 #include "btn_palettes_bank.cpp.h"
+#include "btn_palette_effects.cpp.h"
 
 namespace btn::palettes_manager
 {
 
 namespace
 {
+    constexpr const int sprite_palettes_commit_id = 0;
+    constexpr const int bg_palettes_commit_id = 1;
+
+
     class static_data
     {
 
     public:
         palettes_bank sprite_palettes_bank;
         palettes_bank bg_palettes_bank;
+        vram_commit_queue<2> commit_queue;
     };
 
     BTN_DATA_EWRAM static_data data;
+
+
+    [[nodiscard]] palettes_bank& _palettes_bank(int commit_id)
+    {
+        return commit_id == sprite_palettes_commit_id ? data.sprite_palettes_bank : data.bg_palettes_bank;
+    }
 }
 
 palettes_bank& sprite_palettes_bank()
@@ -47,16 +61,39 @@ void update()
 
 void commit()
 {
-    if(optional<palettes_bank::commit_data> commit_data = data.sprite_palettes_bank.retrieve_commit_data())
+    // Palettes commit data is recalculated each frame, so palettes commits can't be delayed:
+    if(data.sprite_palettes_bank.commit_pending())
+    {
+        data.commit_queue.push(sprite_palettes_commit_id, vram_commit_priority::FORCED);
+    }
+
+    if(data.bg_palettes_bank.commit_pending())
     {
-        hw::palettes::commit_sprites(commit_data->colors_ptr, commit_data->offset, commit_data->count);
-        data.sprite_palettes_bank.reset_commit_data();
+        data.commit_queue.push(bg_palettes_commit_id, vram_commit_priority::FORCED);
     }
 
-    if(optional<palettes_bank::commit_data> commit_data = data.bg_palettes_bank.retrieve_commit_data())
+    if(! data.commit_queue.empty())
     {
-        hw::palettes::commit_bgs(commit_data->colors_ptr, commit_data->offset, commit_data->count);
-        data.bg_palettes_bank.reset_commit_data();
+        data.commit_queue.commit(
+                    [](int id)
+                    {
+                        return _palettes_bank(id).commit_colors_count() * int(sizeof(color));
+                    },
+                    [](int id)
+                    {
+                        palettes_bank& bank = _palettes_bank(id);
+
+                        if(id == sprite_palettes_commit_id)
+                        {
+                            bank.for_each_commit_range(hw::palettes::commit_sprites);
+                        }
+                        else
+                        {
+                            bank.for_each_commit_range(hw::palettes::commit_bgs);
+                        }
+
+                        bank.reset_commit_data();
+                    });
     }
 }
 
@@ -7,63 +7,252 @@
 
 #if BTN_CFG_PROFILER_ENABLED
     #include "btn_timer.h"
-    #include "btn_optional.h"
+    #include "btn_vector.h"
+    #include "btn_algorithm.h"
     #include "btn_unordered_map.h"
 
+    #if BTN_CFG_LOG_ENABLED
+        #include "btn_timers.h"
+        #include "btn_log_dump_writer.h"
+    #endif
+
     namespace _btn::profiler
     {
         namespace
         {
             static_assert(BTN_CFG_PROFILER_MAX_ENTRIES > 0);
             static_assert(btn::power_of_two(BTN_CFG_PROFILER_MAX_ENTRIES));
+            static_assert(BTN_CFG_PROFILER_MAX_DEPTH > 0);
+            static_assert(BTN_CFG_PROFILER_MAX_FRAMES > 0);
+            static_assert(btn::power_of_two(BTN_CFG_PROFILER_MAX_FRAMES));
+
+            constexpr const int max_frames = BTN_CFG_PROFILER_MAX_FRAMES;
+
+            class active_entry
+            {
+
+            public:
+                const char* id;
+                unsigned id_hash;
+                btn::timer timer;
+            };
 
             class static_data
             {
 
             public:
                 ticks_map ticks_per_entry;
-                btn::optional<btn::timer> current_timer;
-                const char* current_id = nullptr;
-                unsigned current_id_hash;
+                btn::vector<active_entry, BTN_CFG_PROFILER_MAX_DEPTH> active_entries;
+                int frames[BTN_CFG_PROFILER_MAX_ENTRIES][max_frames];
+                int frames_count = 0;
             };
 
             BTN_DATA_EWRAM static_data data;
+
+            [[nodiscard]] ticks& _ticks(const char* id, unsigned id_hash)
+            {
+                ticks_map& ticks_per_entry = data.ticks_per_entry;
+                auto it = ticks_per_entry.find_hash(id_hash, id);
+
+                if(it != ticks_per_entry.end())
+                {
+                    return it->second;
+                }
+
+                int frames_index = ticks_per_entry.size();
+                BTN_ASSERT(frames_index < BTN_CFG_PROFILER_MAX_ENTRIES, "Too many entries: ", frames_index);
+
+                // The first parent of the entry is the one shown in flame charts:
+                ticks new_ticks;
+                new_ticks.frames_index = frames_index;
+
+                if(! data.active_entries.empty())
+                {
+                    new_ticks.parent_id = data.active_entries.back().id;
+                }
+
+                int* frames = data.frames[frames_index];
+                btn::fill(frames, frames + max_frames, 0);
+                return ticks_per_entry.insert_hash(id_hash, id, new_ticks)->second;
+            }
         }
 
         void start(const char* id, unsigned id_hash)
         {
             BTN_ASSERT(id, "Id is null");
-            BTN_ASSERT(! data.current_id, "There's already an active id: ", data.current_id);
+            BTN_ASSERT(! data.active_entries.full(), "Too many active ids: ", data.active_entries.size());
 
-            data.current_id = id;
-            data.current_id_hash = id_hash;
-            data.current_timer = btn::timer();
+            data.active_entries.push_back(active_entry{ id, id_hash, btn::timer() });
         }
 
         void stop()
         {
-            BTN_ASSERT(data.current_id, "There's no active id");
+            BTN_ASSERT(! data.active_entries.empty(), "There's no active id");
 
-            int timer_ticks = data.current_timer->elapsed_ticks();
-            auto timer_ticks_64 = int64_t(timer_ticks);
-            ticks& ticks = data.ticks_per_entry(data.current_id_hash, data.current_id);
-            ticks.total += timer_ticks_64;
+            const active_entry& last_active_entry = data.active_entries.back();
+            int timer_ticks = last_active_entry.timer.elapsed_ticks();
+            const char* id = last_active_entry.id;
+            unsigned id_hash = last_active_entry.id_hash;
+            data.active_entries.pop_back();
+
+            ticks& ticks = _ticks(id, id_hash);
+            ticks.total += int64_t(timer_ticks);
             ticks.max = btn::max(ticks.max, timer_ticks);
-            data.current_id = nullptr;
+            ticks.current_frame += timer_ticks;
+        }
+
+        void next_frame()
+        {
+            int frames_count = data.frames_count;
+            int frame_index = frames_count & (max_frames - 1);
+
+            for(auto& ticks_per_entry_pair : data.ticks_per_entry)
+            {
+                ticks& ticks = ticks_per_entry_pair.second;
+                int current_frame = ticks.current_frame;
+                data.frames[ticks.frames_index][frame_index] = current_frame;
+                ticks.current_frame = 0;
+
+                if(current_frame > ticks.max_frame)
+                {
+                    ticks.max_frame = current_frame;
+                    ticks.max_frame_index = frames_count;
+                }
+            }
+
+            data.frames_count = frames_count + 1;
         }
 
         const ticks_map& ticks_per_entry()
         {
-            BTN_ASSERT(! data.current_id, "There's an active id: ", data.current_id);
+            BTN_ASSERT(data.active_entries.empty(), "There's an active id: ", data.active_entries.back().id);
 
             return data.ticks_per_entry;
         }
 
+        int stored_frames()
+        {
+            return btn::min(data.frames_count, max_frames);
+        }
+
+        int frames_count()
+        {
+            return data.frames_count;
+        }
+
+        int frame_ticks(const ticks& ticks, int frame)
+        {
+            BTN_ASSERT(frame >= 0 && frame < stored_frames(), "Invalid frame: ", frame, " - ", stored_frames());
+
+            int frame_index = (data.frames_count - stored_frames() + frame) & (max_frames - 1);
+            return data.frames[ticks.frames_index][frame_index];
+        }
+
+        frame_stats stats(const ticks& ticks)
+        {
+            frame_stats result;
+            int frames = stored_frames();
+
+            if(frames)
+            {
+                int sorted_frames[max_frames];
+
+                for(int frame = 0; frame < frames; ++frame)
+                {
+                    sorted_frames[frame] = frame_ticks(ticks, frame);
+                }
+
+                btn::sort(sorted_frames, sorted_frames + frames);
+
+                // Nearest-rank percentiles:
+                result.p50 = sorted_frames[((frames * 50) + 99) / 100 - 1];
+                result.p95 = sorted_frames[((frames * 95) + 99) / 100 - 1];
+                result.p99 = sorted_frames[((frames * 99) + 99) / 100 - 1];
+
+                // A frame is a spike if it takes more than twice the median.
+                // If the median is zero, there's no reference to compare with, so no spikes are counted:
+                if(result.p50 > 0)
+                {
+                    for(int frame = 0; frame < frames; ++frame)
+                    {
+                        if(sorted_frames[frame] > result.p50 * 2)
+                        {
+                            ++result.spikes;
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
         void reset()
         {
-            BTN_ASSERT(! data.current_id, "There's an active id: ", data.current_id);
+            BTN_ASSERT(data.active_entries.empty(), "There's an active id: ", data.active_entries.back().id);
 
             data.ticks_per_entry.clear();
+            data.frames_count = 0;
+        }
+    }
+
+    namespace btn::profiler
+    {
+        void dump()
+        {
+            #if BTN_CFG_LOG_ENABLED
+                using _btn::profiler::ticks_map;
+
+                // Format (little endian):
+                // u8 version, u32 ticks per frame, u32 frames count, u16 stored frames, u16 entries count.
+                // For each entry:
+                // u8 id size, id characters, u16 parent entry index (0xFFFF if there's no parent), u64 total ticks,
+                // u32 max ticks, u32 max frame ticks, u32 max frame index, u32 ticks of each stored frame.
+                const ticks_map& ticks_per_entry = _btn::profiler::ticks_per_entry();
+                vector<const ticks_map::value_type*, BTN_CFG_PROFILER_MAX_ENTRIES> entries;
+
+                for(const ticks_map::value_type& ticks_pair : ticks_per_entry)
+                {
+                    entries.push_back(&ticks_pair);
+                }
+
+                int frames = _btn::profiler::stored_frames();
+                int entries_count = entries.size();
+                log_dump_writer writer("btn_profiler");
+                writer.write(1, 1);
+                writer.write(unsigned(timers::ticks_per_frame()), 4);
+                writer.write(unsigned(_btn::profiler::frames_count()), 4);
+                writer.write(unsigned(frames), 2);
+                writer.write(unsigned(entries_count), 2);
+
+                for(const ticks_map::value_type* entry : entries)
+                {
+                    const _btn::profiler::ticks& entry_ticks = entry->second;
+                    unsigned parent_index = 0xFFFF;
+
+                    for(int index = 0; index < entries_count; ++index)
+                    {
+                        if(entry_ticks.parent_id && entries[index]->first == entry_ticks.parent_id)
+                        {
+                            parent_index = unsigned(index);
+                            break;
+                        }
+                    }
+
+                    auto total = uint64_t(entry_ticks.total);
+                    writer.write(entry->first);
+                    writer.write(parent_index, 2);
+                    writer.write(unsigned(total), 4);
+                    writer.write(unsigned(total >> 32), 4);
+                    writer.write(unsigned(entry_ticks.max), 4);
+                    writer.write(unsigned(entry_ticks.max_frame), 4);
+                    writer.write(unsigned(entry_ticks.max_frame_index), 4);
+
+                    for(int frame = 0; frame < frames; ++frame)
+                    {
+                        writer.write(unsigned(_btn::profiler::frame_ticks(entry_ticks, frame)), 4);
+                    }
+                }
+            #endif
         }
     }
 #endif
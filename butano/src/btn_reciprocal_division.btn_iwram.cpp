@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_reciprocal_division.h"
+
+#include "btn_reciprocal_lut.h"
+
+namespace _btn
+{
+
+unsigned reciprocal_impl(unsigned normalized_divisor)
+{
+    // Initial estimation with 8 bits of precision:
+    unsigned result = unsigned(btn::reciprocal_lut[(normalized_divisor >> 23) & 0xFF]) << 16;
+
+    // Each Newton-Raphson iteration doubles the precision (x = x * (2 - d * x)):
+    for(int iteration = 0; iteration < 2; ++iteration)
+    {
+        unsigned error = 0u - unsigned((uint64_t(normalized_divisor) * result) >> 32);
+        uint64_t next_result = (uint64_t(result) * error) >> 31;
+        result = next_result > 0xFFFFFFFF ? 0xFFFFFFFF : unsigned(next_result);
+    }
+
+    // The estimation can be up to two units bigger than the real reciprocal:
+    return result - 2;
+}
+
+}
+
+namespace btn
+{
+
+void reciprocal_division::_divide(const int* values, int* results, int count, int value_shift) const
+{
+    for(int index = 0; index < count; ++index)
+    {
+        results[index] = _divide(values[index], value_shift);
+    }
+}
+
+}
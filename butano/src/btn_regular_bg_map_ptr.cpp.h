@@ -18,7 +18,7 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::find(
         const regular_bg_map_cell& cells_ref, const size& dimensions, const bg_tiles_ptr& tiles,
         const bg_palette_ptr& palette)
 {
-    int handle = bg_blocks_manager::find_regular_map(cells_ref, dimensions, tiles, palette);
+    int handle = bg_blocks_manager::find_regular_map(cells_ref, dimensions, compression_type::NONE, tiles, palette);
     optional<regular_bg_map_ptr> result;
 
     if(handle >= 0)
@@ -32,7 +32,16 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::find(
 optional<regular_bg_map_ptr> regular_bg_map_ptr::find(
         const regular_bg_map_item& map_item, const bg_tiles_ptr& tiles, const bg_palette_ptr& palette)
 {
-    return find(map_item.cells_ref(), map_item.dimensions(), tiles, palette);
+    int handle = bg_blocks_manager::find_regular_map(map_item.cells_ref(), map_item.dimensions(),
+                                                     map_item.compression(), tiles, palette);
+    optional<regular_bg_map_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = regular_bg_map_ptr(handle);
+    }
+
+    return result;
 }
 
 optional<regular_bg_map_ptr> regular_bg_map_ptr::find(const regular_bg_item& item)
@@ -53,7 +62,8 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::find(const regular_bg_item& ite
 regular_bg_map_ptr regular_bg_map_ptr::create(
         const regular_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
-    int handle = bg_blocks_manager::create_regular_map(cells_ref, dimensions, move(tiles), move(palette));
+    int handle = bg_blocks_manager::create_regular_map(cells_ref, dimensions, compression_type::NONE,
+                                                       move(tiles), move(palette));
     BTN_ASSERT(handle >= 0, "Regular map create failed");
 
     return regular_bg_map_ptr(handle);
@@ -63,7 +73,7 @@ regular_bg_map_ptr regular_bg_map_ptr::create(
         const regular_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
     int handle = bg_blocks_manager::create_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), move(tiles), move(palette));
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(tiles), move(palette));
     BTN_ASSERT(handle >= 0, "Regular map create failed");
 
     return regular_bg_map_ptr(handle);
@@ -73,7 +83,7 @@ regular_bg_map_ptr regular_bg_map_ptr::create(const regular_bg_item& item)
 {
     const regular_bg_map_item& map_item = item.map_item();
     int handle = bg_blocks_manager::create_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), item.tiles_item().create_tiles(),
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), item.tiles_item().create_tiles(),
                 item.palette_item().create_palette());
     BTN_ASSERT(handle >= 0, "Regular map create failed");
 
@@ -83,7 +93,8 @@ regular_bg_map_ptr regular_bg_map_ptr::create(const regular_bg_item& item)
 regular_bg_map_ptr regular_bg_map_ptr::create_new(
         const regular_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
-    int handle = bg_blocks_manager::create_new_regular_map(cells_ref, dimensions, move(tiles), move(palette));
+    int handle = bg_blocks_manager::create_new_regular_map(cells_ref, dimensions, compression_type::NONE,
+                                                           move(tiles), move(palette));
     BTN_ASSERT(handle >= 0, "Regular map create new failed");
 
     return regular_bg_map_ptr(handle);
@@ -93,7 +104,7 @@ regular_bg_map_ptr regular_bg_map_ptr::create_new(
         const regular_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
     int handle = bg_blocks_manager::create_new_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), move(tiles), move(palette));
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(tiles), move(palette));
     BTN_ASSERT(handle >= 0, "Regular map create new failed");
 
     return regular_bg_map_ptr(handle);
@@ -103,7 +114,7 @@ regular_bg_map_ptr regular_bg_map_ptr::create_new(const regular_bg_item& item)
 {
     const regular_bg_map_item& map_item = item.map_item();
     int handle = bg_blocks_manager::create_new_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), item.tiles_item().create_tiles(),
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), item.tiles_item().create_tiles(),
                 item.palette_item().create_palette());
     BTN_ASSERT(handle >= 0, "Regular map create new failed");
 
@@ -122,7 +133,8 @@ regular_bg_map_ptr regular_bg_map_ptr::allocate(
 optional<regular_bg_map_ptr> regular_bg_map_ptr::create_optional(
         const regular_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
-    int handle = bg_blocks_manager::create_regular_map(cells_ref, dimensions, move(tiles), move(palette));
+    int handle = bg_blocks_manager::create_regular_map(cells_ref, dimensions, compression_type::NONE,
+                                                       move(tiles), move(palette));
     optional<regular_bg_map_ptr> result;
 
     if(handle >= 0)
@@ -137,7 +149,7 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::create_optional(
         const regular_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
     int handle = bg_blocks_manager::create_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), move(tiles), move(palette));
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(tiles), move(palette));
     optional<regular_bg_map_ptr> result;
 
     if(handle >= 0)
@@ -158,7 +170,8 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::create_optional(const regular_b
         {
             const regular_bg_map_item& map_item = item.map_item();
             int handle = bg_blocks_manager::create_regular_map(
-                        map_item.cells_ref(), map_item.dimensions(), move(*tiles), move(*palette));
+                        map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(*tiles),
+                        move(*palette));
 
             if(handle >= 0)
             {
@@ -173,7 +186,8 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::create_optional(const regular_b
 optional<regular_bg_map_ptr> regular_bg_map_ptr::create_new_optional(
         const regular_bg_map_cell& cells_ref, const size& dimensions, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
-    int handle = bg_blocks_manager::create_new_regular_map(cells_ref, dimensions, move(tiles), move(palette));
+    int handle = bg_blocks_manager::create_new_regular_map(cells_ref, dimensions, compression_type::NONE,
+                                                           move(tiles), move(palette));
     optional<regular_bg_map_ptr> result;
 
     if(handle >= 0)
@@ -188,7 +202,7 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::create_new_optional(
         const regular_bg_map_item& map_item, bg_tiles_ptr tiles, bg_palette_ptr palette)
 {
     int handle = bg_blocks_manager::create_new_regular_map(
-                map_item.cells_ref(), map_item.dimensions(), move(tiles), move(palette));
+                map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(tiles), move(palette));
     optional<regular_bg_map_ptr> result;
 
     if(handle >= 0)
@@ -209,7 +223,8 @@ optional<regular_bg_map_ptr> regular_bg_map_ptr::create_new_optional(const regul
         {
             const regular_bg_map_item& map_item = item.map_item();
             int handle = bg_blocks_manager::create_new_regular_map(
-                        map_item.cells_ref(), map_item.dimensions(), move(*tiles), move(*palette));
+                        map_item.cells_ref(), map_item.dimensions(), map_item.compression(), move(*tiles),
+                        move(*palette));
 
             if(handle >= 0)
             {
@@ -267,6 +282,11 @@ size regular_bg_map_ptr::dimensions() const
     return bg_blocks_manager::map_dimensions(_handle);
 }
 
+bool regular_bg_map_ptr::big() const
+{
+    return regular_bg_map_item::big(dimensions());
+}
+
 palette_bpp_mode regular_bg_map_ptr::bpp_mode() const
 {
     return palette().bpp_mode();
@@ -279,7 +299,13 @@ optional<span<const regular_bg_map_cell>> regular_bg_map_ptr::cells_ref() const
 
 void regular_bg_map_ptr::set_cells_ref(const regular_bg_map_cell& cells_ref, const size& dimensions)
 {
-    bg_blocks_manager::set_regular_map_cells_ref(_handle, cells_ref, dimensions);
+    bg_blocks_manager::set_regular_map_cells_ref(_handle, cells_ref, dimensions, compression_type::NONE);
+}
+
+void regular_bg_map_ptr::set_cells_ref(const regular_bg_map_item& map_item)
+{
+    bg_blocks_manager::set_regular_map_cells_ref(_handle, map_item.cells_ref(), map_item.dimensions(),
+                                                 map_item.compression());
 }
 
 void regular_bg_map_ptr::reload_cells_ref()
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_scheduled_actions.h"
+
+#include "btn_scheduled_actions_manager.h"
+
+namespace btn
+{
+
+scheduled_actions_base::~scheduled_actions_base()
+{
+    scheduled_actions_manager::remove(*this);
+}
+
+scheduled_actions_base::scheduled_actions_base()
+{
+    scheduled_actions_manager::add(*this);
+}
+
+}
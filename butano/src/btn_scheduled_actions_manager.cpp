@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_scheduled_actions_manager.h"
+
+#include "btn_scheduled_actions.h"
+
+#include "btn_scheduled_actions.cpp.h"
+
+namespace btn::scheduled_actions_manager
+{
+
+namespace
+{
+    class static_data
+    {
+
+    public:
+        intrusive_list<scheduled_actions_base> pools;
+    };
+
+    BTN_DATA_EWRAM static_data data;
+}
+
+void add(scheduled_actions_base& actions)
+{
+    data.pools.push_back(actions);
+}
+
+void remove(scheduled_actions_base& actions)
+{
+    data.pools.erase(actions);
+}
+
+void update()
+{
+    for(scheduled_actions_base& actions : data.pools)
+    {
+        actions.update();
+    }
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_SCHEDULED_ACTIONS_MANAGER_H
+#define BTN_SCHEDULED_ACTIONS_MANAGER_H
+
+#include "btn_common.h"
+
+namespace btn
+{
+    class scheduled_actions_base;
+}
+
+namespace btn::scheduled_actions_manager
+{
+    void add(scheduled_actions_base& actions);
+
+    void remove(scheduled_actions_base& actions);
+
+    void update();
+}
+
+#endif
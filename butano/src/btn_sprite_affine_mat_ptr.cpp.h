@@ -48,6 +48,11 @@ optional<sprite_affine_mat_ptr> sprite_affine_mat_ptr::create_optional(const spr
     return result;
 }
 
+sprite_affine_mat_ptr sprite_affine_mat_ptr::create_shared(const sprite_affine_mat_attributes& attributes)
+{
+    return sprite_affine_mat_ptr(sprite_affine_mats_manager::create_shared(attributes));
+}
+
 sprite_affine_mat_ptr::sprite_affine_mat_ptr(const sprite_affine_mat_ptr& other) :
     sprite_affine_mat_ptr(other._id)
 {
@@ -70,6 +75,11 @@ sprite_affine_mat_ptr& sprite_affine_mat_ptr::operator=(const sprite_affine_mat_
     return *this;
 }
 
+bool sprite_affine_mat_ptr::shared() const
+{
+    return sprite_affine_mats_manager::shared(_id);
+}
+
 fixed sprite_affine_mat_ptr::rotation_angle() const
 {
     return sprite_affine_mats_manager::rotation_angle(_id);
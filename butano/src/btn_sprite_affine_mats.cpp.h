@@ -20,4 +20,14 @@ int available_count()
     return sprite_affine_mats_manager::available_count();
 }
 
+bool sharing_enabled()
+{
+    return sprite_affine_mats_manager::sharing_enabled();
+}
+
+void set_sharing_enabled(bool sharing_enabled)
+{
+    sprite_affine_mats_manager::set_sharing_enabled(sharing_enabled);
+}
+
 }
@@ -6,9 +6,9 @@
 #include "btn_sprite_affine_mats_manager.h"
 
 #include "btn_vector.h"
+#include "btn_unordered_map.h"
 #include "btn_sprites_manager_item.h"
 #include "../hw/include/btn_hw_sprite_affine_mats.h"
-#include "../hw/include/btn_hw_sprite_affine_mats_constants.h"
 
 #include "btn_sprite_affine_mats.cpp.h"
 #include "btn_sprite_affine_mat_ptr.cpp.h"
@@ -29,9 +29,11 @@ namespace
         sprite_affine_mat_attributes attributes;
         intrusive_list<sprite_affine_mat_attach_node_type> attached_nodes;
         unsigned usages;
+        unsigned hash;
         bool flipped_identity;
         bool double_size;
         bool remove_if_not_needed;
+        bool shared;
 
         void init()
         {
@@ -40,6 +42,7 @@ namespace
             flipped_identity = true;
             double_size = false;
             remove_if_not_needed = false;
+            shared = false;
         }
 
         void init(const sprite_affine_mat_attributes& new_attributes)
@@ -47,6 +50,7 @@ namespace
             attributes = new_attributes;
             usages = 1;
             remove_if_not_needed = false;
+            shared = false;
 
             if(attributes.flipped_identity())
             {
@@ -74,6 +78,15 @@ namespace
         {
         }
 
+        [[nodiscard]] unsigned hash() const
+        {
+            unsigned result = make_hash(_pa);
+            hash_combine(_pb, result);
+            hash_combine(_pc, result);
+            hash_combine(_pd, result);
+            return result;
+        }
+
         [[nodiscard]] friend bool operator==(const registers& a, const registers& b) = default;
 
     private:
@@ -90,11 +103,12 @@ namespace
     public:
         item_type items[max_items];
         vector<int8_t, max_items> free_item_indexes;
+        unordered_map<unsigned, int8_t, max_items * 2> shared_indexes_map;
         hw::sprite_affine_mats::handle* handles_ptr = nullptr;
-        int first_index_to_commit = max_items;
-        int last_index_to_commit = 0;
+        indexes_to_commit_type indexes_to_commit;
         int first_index_to_remove_if_not_needed = max_items;
         int last_index_to_remove_if_not_needed = 0;
+        bool sharing_enabled = false;
     };
 
     BTN_DATA_EWRAM static_data data;
@@ -102,8 +116,7 @@ namespace
 
     void _update_indexes_to_commit(int index)
     {
-        data.first_index_to_commit = min(data.first_index_to_commit, index);
-        data.last_index_to_commit = max(data.last_index_to_commit, index);
+        data.indexes_to_commit.add(index);
     }
 
     void _update(int index)
@@ -232,6 +245,99 @@ int create_optional(const sprite_affine_mat_attributes& attributes)
     return _create(attributes);
 }
 
+int create_shared(const sprite_affine_mat_attributes& attributes)
+{
+    registers attributes_registers(attributes);
+    unsigned hash = attributes_registers.hash();
+    auto shared_indexes_map_it = data.shared_indexes_map.find(hash);
+
+    if(shared_indexes_map_it != data.shared_indexes_map.end())
+    {
+        int item_index = shared_indexes_map_it->second;
+        item_type& item = data.items[item_index];
+
+        if(registers(item.attributes) == attributes_registers)
+        {
+            ++item.usages;
+            return item_index;
+        }
+    }
+
+    BTN_ASSERT(! data.free_item_indexes.empty(), "No more sprite affine mats available");
+
+    // Hash collisions are solved creating a new item without adding it to the shared indexes map:
+    int item_index = _create(attributes);
+    item_type& item = data.items[item_index];
+    item.hash = hash;
+    item.shared = true;
+
+    if(shared_indexes_map_it == data.shared_indexes_map.end())
+    {
+        data.shared_indexes_map.insert(hash, int8_t(item_index));
+    }
+
+    return item_index;
+}
+
+bool shared(int id)
+{
+    const item_type& item = data.items[id];
+    return item.shared;
+}
+
+bool update_shared(int id, const sprite_affine_mat_attributes& attributes)
+{
+    item_type& item = data.items[id];
+    BTN_ASSERT(item.shared, "Sprite affine mat is not shared");
+
+    registers old_registers(item.attributes);
+    registers new_registers(attributes);
+
+    if(new_registers == old_registers)
+    {
+        item.attributes = attributes;
+        return true;
+    }
+
+    // Only items which are not referenced by other sprite_affine_mat_ptr objects can be updated in place:
+    if(item.usages > 1)
+    {
+        return false;
+    }
+
+    unsigned new_hash = new_registers.hash();
+    auto new_shared_indexes_map_it = data.shared_indexes_map.find(new_hash);
+
+    if(new_shared_indexes_map_it != data.shared_indexes_map.end())
+    {
+        return false;
+    }
+
+    auto old_shared_indexes_map_it = data.shared_indexes_map.find(item.hash);
+
+    if(old_shared_indexes_map_it != data.shared_indexes_map.end() && old_shared_indexes_map_it->second == id)
+    {
+        data.shared_indexes_map.erase(old_shared_indexes_map_it);
+    }
+
+    item.attributes = attributes;
+    item.hash = new_hash;
+    data.shared_indexes_map.insert(new_hash, int8_t(id));
+    hw::sprite_affine_mats::setup(attributes, data.handles_ptr[id]);
+    _update(id);
+    return true;
+}
+
+bool sharing_enabled()
+{
+    return data.sharing_enabled;
+}
+
+void set_sharing_enabled(bool sharing_enabled)
+{
+    data.sharing_enabled = sharing_enabled;
+}
+
 void increase_usages(int id)
 {
     item_type& item = data.items[id];
@@ -249,6 +355,18 @@ void decrease_usages(int id)
 
         item.remove_if_not_needed = false;
         data.free_item_indexes.push_back(int8_t(id));
+
+        if(item.shared)
+        {
+            auto shared_indexes_map_it = data.shared_indexes_map.find(item.hash);
+
+            if(shared_indexes_map_it != data.shared_indexes_map.end() && shared_indexes_map_it->second == id)
+            {
+                data.shared_indexes_map.erase(shared_indexes_map_it);
+            }
+
+            item.shared = false;
+        }
     }
 }
 
@@ -272,6 +390,7 @@ fixed rotation_angle(int id)
 void set_rotation_angle(int id, fixed rotation_angle)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(rotation_angle != item.attributes.rotation_angle())
     {
@@ -294,6 +413,7 @@ fixed horizontal_scale(int id)
 void set_horizontal_scale(int id, fixed horizontal_scale)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(horizontal_scale != item.attributes.horizontal_scale())
     {
@@ -317,6 +437,7 @@ fixed vertical_scale(int id)
 void set_vertical_scale(int id, fixed vertical_scale)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(vertical_scale != item.attributes.vertical_scale())
     {
@@ -335,6 +456,7 @@ void set_vertical_scale(int id, fixed vertical_scale)
 void set_scale(int id, fixed scale)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(scale != item.attributes.horizontal_scale() || scale != item.attributes.vertical_scale())
     {
@@ -352,6 +474,7 @@ void set_scale(int id, fixed scale)
 void set_scale(int id, fixed horizontal_scale, fixed vertical_scale)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(horizontal_scale != item.attributes.horizontal_scale() || vertical_scale != item.attributes.vertical_scale())
     {
@@ -374,6 +497,7 @@ bool horizontal_flip(int id)
 void set_horizontal_flip(int id, bool horizontal_flip)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(horizontal_flip != item.attributes.horizontal_flip())
     {
@@ -391,6 +515,7 @@ bool vertical_flip(int id)
 void set_vertical_flip(int id, bool vertical_flip)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
 
     if(vertical_flip != item.attributes.vertical_flip())
     {
@@ -408,6 +533,8 @@ const sprite_affine_mat_attributes& attributes(int id)
 void set_attributes(int id, const sprite_affine_mat_attributes& attributes)
 {
     item_type& item = data.items[id];
+    BTN_ASSERT(! item.shared, "Shared sprite affine mats can't be modified");
+
     registers old_registers(item.attributes);
     item.attributes = attributes;
 
@@ -475,19 +602,10 @@ void update()
     }
 }
 
-optional<commit_data> retrieve_commit_data()
+indexes_to_commit_type retrieve_indexes_to_commit()
 {
-    optional<commit_data> result;
-
-    if(data.first_index_to_commit < max_items)
-    {
-        int offset = data.first_index_to_commit;
-        int count = data.last_index_to_commit - data.first_index_to_commit + 1;
-        result = commit_data{ offset, count };
-        data.first_index_to_commit = max_items;
-        data.last_index_to_commit = 0;
-    }
-
+    indexes_to_commit_type result = data.indexes_to_commit;
+    data.indexes_to_commit.clear();
     return result;
 }
 
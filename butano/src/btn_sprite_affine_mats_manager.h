@@ -9,6 +9,8 @@
 #include "btn_fixed_fwd.h"
 #include "btn_optional_fwd.h"
 #include "btn_intrusive_list.h"
+#include "btn_indexes_to_commit.h"
+#include "../hw/include/btn_hw_sprite_affine_mats_constants.h"
 
 namespace btn
 {
@@ -19,13 +21,7 @@ namespace btn
 
 namespace btn::sprite_affine_mats_manager
 {
-    class commit_data
-    {
-
-    public:
-        int offset;
-        int count;
-    };
+    using indexes_to_commit_type = indexes_to_commit<hw::sprite_affine_mats::count(), 0>;
 
 
     void init(int handles_size, void* handles);
@@ -42,6 +38,16 @@ namespace btn::sprite_affine_mats_manager
 
     [[nodiscard]] int create_optional(const sprite_affine_mat_attributes& attributes);
 
+    [[nodiscard]] int create_shared(const sprite_affine_mat_attributes& attributes);
+
+    [[nodiscard]] bool shared(int id);
+
+    [[nodiscard]] bool update_shared(int id, const sprite_affine_mat_attributes& attributes);
+
+    [[nodiscard]] bool sharing_enabled();
+
+    void set_sharing_enabled(bool sharing_enabled);
+
     void increase_usages(int id);
 
     void decrease_usages(int id);
@@ -88,7 +94,7 @@ namespace btn::sprite_affine_mats_manager
 
     void update();
 
-    [[nodiscard]] optional<commit_data> retrieve_commit_data();
+    [[nodiscard]] indexes_to_commit_type retrieve_indexes_to_commit();
 }
 
 #endif
@@ -7,11 +7,33 @@
 
 #include "btn_sprites.h"
 #include "btn_sprite_ptr.h"
+#include "btn_sprite_affine_mats.h"
 #include "btn_sprite_affine_mat_attributes.h"
 
 namespace btn
 {
 
+namespace
+{
+    [[nodiscard]] sprite_affine_mat_ptr _create_builder_affine_mat(const sprite_affine_mat_attributes& attributes)
+    {
+        if(sprite_affine_mats::sharing_enabled())
+        {
+            return sprite_affine_mat_ptr::create_shared(attributes);
+        }
+
+        return sprite_affine_mat_ptr::create(attributes);
+    }
+
+    void _set_shared_builder_affine_mat(const sprite_affine_mat_attributes& attributes,
+                                        optional<sprite_affine_mat_ptr>& affine_mat)
+    {
+        // Shared matrices can't be modified, so the old one is released before retrieving the new one:
+        affine_mat.reset();
+        affine_mat = sprite_affine_mat_ptr::create_shared(attributes);
+    }
+}
+
 sprite_builder::sprite_builder(const sprite_item& item) :
     _item(item),
     _shape_size(item.shape_size()),
@@ -45,7 +67,16 @@ sprite_builder& sprite_builder::set_rotation_angle(fixed rotation_angle)
 {
     if(_affine_mat)
     {
-        _affine_mat->set_rotation_angle(rotation_angle);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_rotation_angle(rotation_angle);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_rotation_angle(rotation_angle);
+        }
     }
     else if(rotation_angle != 0)
     {
@@ -53,7 +84,7 @@ sprite_builder& sprite_builder::set_rotation_angle(fixed rotation_angle)
         affine_mat_attributes.set_rotation_angle(rotation_angle);
         affine_mat_attributes.set_horizontal_flip(_horizontal_flip);
         affine_mat_attributes.set_vertical_flip(_vertical_flip);
-        _affine_mat = sprite_affine_mat_ptr::create(affine_mat_attributes);
+        _affine_mat = _create_builder_affine_mat(affine_mat_attributes);
     }
 
     return *this;
@@ -63,7 +94,16 @@ sprite_builder& sprite_builder::set_horizontal_scale(fixed horizontal_scale)
 {
     if(_affine_mat)
     {
-        _affine_mat->set_horizontal_scale(horizontal_scale);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_horizontal_scale(horizontal_scale);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_horizontal_scale(horizontal_scale);
+        }
     }
     else if(horizontal_scale != 1)
     {
@@ -71,7 +111,7 @@ sprite_builder& sprite_builder::set_horizontal_scale(fixed horizontal_scale)
         affine_mat_attributes.set_horizontal_scale(horizontal_scale);
         affine_mat_attributes.set_horizontal_flip(_horizontal_flip);
         affine_mat_attributes.set_vertical_flip(_vertical_flip);
-        _affine_mat = sprite_affine_mat_ptr::create(affine_mat_attributes);
+        _affine_mat = _create_builder_affine_mat(affine_mat_attributes);
     }
 
     return *this;
@@ -81,7 +121,16 @@ sprite_builder& sprite_builder::set_vertical_scale(fixed vertical_scale)
 {
     if(_affine_mat)
     {
-        _affine_mat->set_vertical_scale(vertical_scale);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_vertical_scale(vertical_scale);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_vertical_scale(vertical_scale);
+        }
     }
     else if(vertical_scale != 1)
     {
@@ -89,7 +138,7 @@ sprite_builder& sprite_builder::set_vertical_scale(fixed vertical_scale)
         affine_mat_attributes.set_vertical_scale(vertical_scale);
         affine_mat_attributes.set_horizontal_flip(_horizontal_flip);
         affine_mat_attributes.set_vertical_flip(_vertical_flip);
-        _affine_mat = sprite_affine_mat_ptr::create(affine_mat_attributes);
+        _affine_mat = _create_builder_affine_mat(affine_mat_attributes);
     }
 
     return *this;
@@ -99,7 +148,16 @@ sprite_builder& sprite_builder::set_scale(fixed scale)
 {
     if(_affine_mat)
     {
-        _affine_mat->set_scale(scale);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_scale(scale);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_scale(scale);
+        }
     }
     else if(scale != 1)
     {
@@ -107,7 +165,7 @@ sprite_builder& sprite_builder::set_scale(fixed scale)
         affine_mat_attributes.set_scale(scale);
         affine_mat_attributes.set_horizontal_flip(_horizontal_flip);
         affine_mat_attributes.set_vertical_flip(_vertical_flip);
-        _affine_mat = sprite_affine_mat_ptr::create(affine_mat_attributes);
+        _affine_mat = _create_builder_affine_mat(affine_mat_attributes);
     }
 
     return *this;
@@ -117,7 +175,16 @@ sprite_builder& sprite_builder::set_scale(fixed horizontal_scale, fixed vertical
 {
     if(_affine_mat)
     {
-        _affine_mat->set_scale(horizontal_scale, vertical_scale);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_scale(horizontal_scale, vertical_scale);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_scale(horizontal_scale, vertical_scale);
+        }
     }
     else if(horizontal_scale != 1 || vertical_scale != 1)
     {
@@ -125,7 +192,7 @@ sprite_builder& sprite_builder::set_scale(fixed horizontal_scale, fixed vertical
         affine_mat_attributes.set_scale(horizontal_scale, vertical_scale);
         affine_mat_attributes.set_horizontal_flip(_horizontal_flip);
         affine_mat_attributes.set_vertical_flip(_vertical_flip);
-        _affine_mat = sprite_affine_mat_ptr::create(affine_mat_attributes);
+        _affine_mat = _create_builder_affine_mat(affine_mat_attributes);
     }
 
     return *this;
@@ -153,7 +220,16 @@ sprite_builder& sprite_builder::set_horizontal_flip(bool horizontal_flip)
 
     if(_affine_mat)
     {
-        _affine_mat->set_horizontal_flip(horizontal_flip);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_horizontal_flip(horizontal_flip);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_horizontal_flip(horizontal_flip);
+        }
     }
 
     return *this;
@@ -165,7 +241,16 @@ sprite_builder& sprite_builder::set_vertical_flip(bool vertical_flip)
 
     if(_affine_mat)
     {
-        _affine_mat->set_vertical_flip(vertical_flip);
+        if(_affine_mat->shared())
+        {
+            sprite_affine_mat_attributes affine_mat_attributes = _affine_mat->attributes();
+            affine_mat_attributes.set_vertical_flip(vertical_flip);
+            _set_shared_builder_affine_mat(affine_mat_attributes, _affine_mat);
+        }
+        else
+        {
+            _affine_mat->set_vertical_flip(vertical_flip);
+        }
     }
 
     return *this;
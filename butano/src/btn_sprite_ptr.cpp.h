@@ -7,6 +7,7 @@
 
 #include "btn_size.h"
 #include "btn_sprite_builder.h"
+#include "btn_sprite_affine_mats.h"
 #include "btn_sprites_manager.h"
 #include "btn_sprite_first_attributes.h"
 #include "btn_sprite_third_attributes.h"
@@ -424,9 +425,12 @@ fixed sprite_ptr::rotation_angle() const
 
 void sprite_ptr::set_rotation_angle(fixed rotation_angle)
 {
-    if(optional<sprite_affine_mat_ptr>& affine_mat = sprites_manager::affine_mat(_handle))
+    if(sprites_manager::affine_mat(_handle))
     {
-        affine_mat->set_rotation_angle(rotation_angle);
+        sprites_manager::update_affine_mat(_handle, [rotation_angle](auto& affine_mat)
+        {
+            affine_mat.set_rotation_angle(rotation_angle);
+        });
     }
     else if(rotation_angle != 0)
     {
@@ -434,8 +438,7 @@ void sprite_ptr::set_rotation_angle(fixed rotation_angle)
         affine_mat_attributes.set_rotation_angle(rotation_angle);
         affine_mat_attributes.set_horizontal_flip(horizontal_flip());
         affine_mat_attributes.set_vertical_flip(vertical_flip());
-        set_remove_affine_mat_when_not_needed(true);
-        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+        _create_affine_mat(affine_mat_attributes);
     }
 }
 
@@ -451,9 +454,12 @@ fixed sprite_ptr::horizontal_scale() const
 
 void sprite_ptr::set_horizontal_scale(fixed horizontal_scale)
 {
-    if(optional<sprite_affine_mat_ptr>& affine_mat = sprites_manager::affine_mat(_handle))
+    if(sprites_manager::affine_mat(_handle))
     {
-        affine_mat->set_horizontal_scale(horizontal_scale);
+        sprites_manager::update_affine_mat(_handle, [horizontal_scale](auto& affine_mat)
+        {
+            affine_mat.set_horizontal_scale(horizontal_scale);
+        });
     }
     else if(horizontal_scale != 1)
     {
@@ -461,8 +467,7 @@ void sprite_ptr::set_horizontal_scale(fixed horizontal_scale)
         affine_mat_attributes.set_horizontal_scale(horizontal_scale);
         affine_mat_attributes.set_horizontal_flip(horizontal_flip());
         affine_mat_attributes.set_vertical_flip(vertical_flip());
-        set_remove_affine_mat_when_not_needed(true);
-        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+        _create_affine_mat(affine_mat_attributes);
     }
 }
 
@@ -478,9 +483,12 @@ fixed sprite_ptr::vertical_scale() const
 
 void sprite_ptr::set_vertical_scale(fixed vertical_scale)
 {
-    if(optional<sprite_affine_mat_ptr>& affine_mat = sprites_manager::affine_mat(_handle))
+    if(sprites_manager::affine_mat(_handle))
     {
-        affine_mat->set_vertical_scale(vertical_scale);
+        sprites_manager::update_affine_mat(_handle, [vertical_scale](auto& affine_mat)
+        {
+            affine_mat.set_vertical_scale(vertical_scale);
+        });
     }
     else if(vertical_scale != 1)
     {
@@ -488,16 +496,18 @@ void sprite_ptr::set_vertical_scale(fixed vertical_scale)
         affine_mat_attributes.set_vertical_scale(vertical_scale);
         affine_mat_attributes.set_horizontal_flip(horizontal_flip());
         affine_mat_attributes.set_vertical_flip(vertical_flip());
-        set_remove_affine_mat_when_not_needed(true);
-        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+        _create_affine_mat(affine_mat_attributes);
     }
 }
 
 void sprite_ptr::set_scale(fixed scale)
 {
-    if(optional<sprite_affine_mat_ptr>& affine_mat = sprites_manager::affine_mat(_handle))
+    if(sprites_manager::affine_mat(_handle))
     {
-        affine_mat->set_scale(scale);
+        sprites_manager::update_affine_mat(_handle, [scale](auto& affine_mat)
+        {
+            affine_mat.set_scale(scale);
+        });
     }
     else if(scale != 1)
     {
@@ -505,16 +515,18 @@ void sprite_ptr::set_scale(fixed scale)
         affine_mat_attributes.set_scale(scale);
         affine_mat_attributes.set_horizontal_flip(horizontal_flip());
         affine_mat_attributes.set_vertical_flip(vertical_flip());
-        set_remove_affine_mat_when_not_needed(true);
-        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+        _create_affine_mat(affine_mat_attributes);
     }
 }
 
 void sprite_ptr::set_scale(fixed horizontal_scale, fixed vertical_scale)
 {
-    if(optional<sprite_affine_mat_ptr>& affine_mat = sprites_manager::affine_mat(_handle))
+    if(sprites_manager::affine_mat(_handle))
     {
-        affine_mat->set_scale(horizontal_scale, vertical_scale);
+        sprites_manager::update_affine_mat(_handle, [horizontal_scale, vertical_scale](auto& affine_mat)
+        {
+            affine_mat.set_scale(horizontal_scale, vertical_scale);
+        });
     }
     else if(horizontal_scale != 1 || vertical_scale != 1)
     {
@@ -522,8 +534,7 @@ void sprite_ptr::set_scale(fixed horizontal_scale, fixed vertical_scale)
         affine_mat_attributes.set_scale(horizontal_scale, vertical_scale);
         affine_mat_attributes.set_horizontal_flip(horizontal_flip());
         affine_mat_attributes.set_vertical_flip(vertical_flip());
-        set_remove_affine_mat_when_not_needed(true);
-        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+        _create_affine_mat(affine_mat_attributes);
     }
 }
 
@@ -719,6 +730,20 @@ void sprite_ptr::set_third_attributes(const sprite_third_attributes& third_attri
     sprites_manager::set_third_attributes(_handle, third_attributes);
 }
 
+void sprite_ptr::_create_affine_mat(const sprite_affine_mat_attributes& affine_mat_attributes)
+{
+    set_remove_affine_mat_when_not_needed(true);
+
+    if(sprite_affine_mats::sharing_enabled())
+    {
+        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create_shared(affine_mat_attributes));
+    }
+    else
+    {
+        sprites_manager::set_affine_mat(_handle, sprite_affine_mat_ptr::create(affine_mat_attributes));
+    }
+}
+
 void sprite_ptr::_destroy()
 {
     sprites_manager::decrease_usages(_handle);
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_sprite_text.h"
+
+#include "btn_sprite_text_generator.h"
+
+namespace btn
+{
+
+void isprite_text::set_position(const fixed_point& position)
+{
+    fixed_point delta = position - _position;
+    _position = position;
+
+    for(sprite_ptr& sprite : _sprites)
+    {
+        sprite.set_position(sprite.position() + delta);
+    }
+}
+
+void isprite_text::set_text(const string_view& text)
+{
+    _generator->_update_text(text, *this);
+}
+
+}
@@ -7,6 +7,7 @@
 
 #include "btn_sprites.h"
 #include "btn_sprite_ptr.h"
+#include "btn_sprite_text.h"
 #include "btn_sprite_builder.h"
 #include "../hw/include/btn_hw_sprite_tiles.h"
 
@@ -663,6 +664,321 @@ namespace
     };
 
 
+    [[nodiscard]] fixed_point _aligned_position(const sprite_text_generator& generator, const fixed_point& position,
+                                                int text_width)
+    {
+        fixed_point result = position;
+
+        switch(generator.alignment())
+        {
+
+        case sprite_text_generator::alignment_type::LEFT:
+            break;
+
+        case sprite_text_generator::alignment_type::CENTER:
+            result.set_x(result.x() - (text_width / 2));
+            break;
+
+        case sprite_text_generator::alignment_type::RIGHT:
+            result.set_x(result.x() - text_width);
+            break;
+
+        default:
+            BTN_ERROR("Invalid alignment: ", int(generator.alignment()));
+            break;
+        }
+
+        return result;
+    }
+
+
+    class layout_painter
+    {
+
+    public:
+        layout_painter(const sprite_text_generator& generator, ivector<isprite_text::glyph>& glyphs) :
+            _character_widths(generator.font().character_widths_ref().data()),
+            _glyphs(glyphs),
+            _one_sprite_per_character(generator.one_sprite_per_character())
+        {
+            if(generator.font().character_widths_ref().empty())
+            {
+                _character_widths = nullptr;
+            }
+        }
+
+        [[nodiscard]] int width() const
+        {
+            return _x;
+        }
+
+        void paint_space()
+        {
+            _advance(_character_widths ? _character_widths[0] : fixed_character_width);
+        }
+
+        void paint_tab()
+        {
+            _advance((_character_widths ? _character_widths[0] : fixed_character_width) * 4);
+        }
+
+        [[nodiscard]] bool paint_character(int graphics_index)
+        {
+            int width = _character_widths ? _character_widths[graphics_index + 1] : fixed_character_width;
+
+            if(width)
+            {
+                // Same layout rules as the painters:
+                if(_one_sprite_per_character || _sprite_column + width > max_columns_per_sprite)
+                {
+                    ++_sprite_index;
+                    _sprite_column = 0;
+                }
+
+                BTN_ASSERT(! _glyphs.full(), "No more glyphs available");
+
+                _glyphs.push_back(isprite_text::glyph{ int16_t(_x), uint16_t(graphics_index), uint8_t(_sprite_index),
+                                                       uint8_t(_sprite_column), uint8_t(width) });
+                _advance(width);
+            }
+
+            return true;
+        }
+
+    private:
+        const int8_t* _character_widths;
+        ivector<isprite_text::glyph>& _glyphs;
+        int _x = 0;
+        int _sprite_index = -1;
+        int _sprite_column = max_columns_per_sprite;
+        bool _one_sprite_per_character;
+
+        void _advance(int width)
+        {
+            _x += width;
+            _sprite_column += width;
+        }
+    };
+
+
+    void _clear_columns(int first_column, int last_column, tile* tiles_vram)
+    {
+        // Each tile row is a word with 8 pixels of 4 bits:
+        while(first_column < last_column)
+        {
+            int tile_index = first_column / 8;
+            int tile_first_column = first_column % 8;
+            int tile_last_column = min(last_column - (tile_index * 8), 8);
+            tile& tile_vram = tiles_vram[tile_index];
+
+            if(tile_first_column == 0 && tile_last_column == 8)
+            {
+                hw::sprite_tiles::clear_tiles(1, &tile_vram);
+            }
+            else
+            {
+                int columns = tile_last_column - tile_first_column;
+                unsigned mask = ~(((1U << (columns * 4)) - 1) << (tile_first_column * 4));
+
+                for(uint32_t& row : tile_vram.data)
+                {
+                    row &= mask;
+                }
+            }
+
+            first_column = (tile_index * 8) + tile_last_column;
+        }
+    }
+
+    void _clear_columns(int first_column, int last_column, bool big, tile* tiles_vram)
+    {
+        _clear_columns(first_column, last_column, tiles_vram);
+
+        if(big)
+        {
+            _clear_columns(first_column, last_column, tiles_vram + fixed_max_characters_per_sprite);
+        }
+    }
+
+    void _plot_glyph(const sprite_tiles_item& tiles_item, bool big, const isprite_text::glyph& glyph,
+                     tile* tiles_vram)
+    {
+        int character_height = big ? 16 : 8;
+        const tile* source_tiles_data = tiles_item.tiles_ref().data();
+        int source_height = tiles_item.graphics_count() * character_height;
+        int source_y = glyph.graphics_index * character_height;
+        hw::sprite_tiles::plot_tiles(glyph.width, source_tiles_data, source_height, source_y, glyph.column,
+                                     tiles_vram);
+
+        if(big)
+        {
+            hw::sprite_tiles::plot_tiles(glyph.width, source_tiles_data, source_height, source_y + 8,
+                                         glyph.column + max_columns_per_sprite, tiles_vram);
+        }
+    }
+
+    void _update_multiple_characters_per_sprite_text(
+            const sprite_text_generator& generator, const fixed_point& aligned_position,
+            const ivector<isprite_text::glyph>& old_glyphs, const ivector<isprite_text::glyph>& new_glyphs,
+            ivector<sprite_ptr>& sprites)
+    {
+        const sprite_tiles_item& tiles_item = generator.font().item().tiles_item();
+        bool big = generator.font().item().shape_size().height() != 8;
+        int old_glyphs_count = old_glyphs.size();
+        int new_glyphs_count = new_glyphs.size();
+        int old_index = 0;
+        int new_index = 0;
+
+        for(int sprite_index = 0; new_index < new_glyphs_count; ++sprite_index)
+        {
+            int old_end_index = old_index;
+
+            while(old_end_index < old_glyphs_count && old_glyphs[old_end_index].sprite_index == sprite_index)
+            {
+                ++old_end_index;
+            }
+
+            int new_end_index = new_index;
+
+            while(new_end_index < new_glyphs_count && new_glyphs[new_end_index].sprite_index == sprite_index)
+            {
+                ++new_end_index;
+            }
+
+            // The first character of each sprite is painted in its first column:
+            fixed_point sprite_position(aligned_position.x() + new_glyphs[new_index].x + (max_columns_per_sprite / 2),
+                                        aligned_position.y());
+            tile* tiles_vram;
+
+            if(sprite_index < sprites.size())
+            {
+                sprite_ptr& sprite = sprites[sprite_index];
+
+                if(sprite.position() != sprite_position)
+                {
+                    sprite.set_position(sprite_position);
+                }
+
+                sprite_tiles_ptr tiles = sprite.tiles();
+                optional<span<tile>> tiles_vram_span = tiles.vram();
+                BTN_ASSERT(tiles_vram_span, "Tiles VRAM retrieve failed");
+
+                tiles_vram = tiles_vram_span->data();
+
+                // Characters with the same layout are painted again only if they have changed:
+                while(old_index < old_end_index && new_index < new_end_index)
+                {
+                    const isprite_text::glyph& old_glyph = old_glyphs[old_index];
+                    const isprite_text::glyph& new_glyph = new_glyphs[new_index];
+
+                    if(old_glyph.column != new_glyph.column || old_glyph.width != new_glyph.width)
+                    {
+                        break;
+                    }
+
+                    if(old_glyph.graphics_index != new_glyph.graphics_index)
+                    {
+                        _clear_columns(new_glyph.column, new_glyph.column + new_glyph.width, big, tiles_vram);
+                        _plot_glyph(tiles_item, big, new_glyph, tiles_vram);
+                    }
+
+                    ++old_index;
+                    ++new_index;
+                }
+
+                // From the first character with a different layout, the remaining columns are painted again:
+                if(old_index < old_end_index || new_index < new_end_index)
+                {
+                    int first_column = max_columns_per_sprite;
+
+                    if(old_index < old_end_index)
+                    {
+                        first_column = old_glyphs[old_index].column;
+                    }
+
+                    if(new_index < new_end_index)
+                    {
+                        first_column = min(first_column, int(new_glyphs[new_index].column));
+                    }
+
+                    _clear_columns(first_column, max_columns_per_sprite, big, tiles_vram);
+                }
+            }
+            else
+            {
+                sprite_palette_ptr palette = sprites.empty() ?
+                            generator.palette_item().create_palette() : sprites[0].palette();
+
+                if(big)
+                {
+                    tiles_vram = _build_sprite<sprite_size::BIG, fixed_max_characters_per_sprite * 2, false>(
+                                generator, palette, sprite_position, sprites);
+                    hw::sprite_tiles::clear_tiles(fixed_max_characters_per_sprite * 2, tiles_vram);
+                }
+                else
+                {
+                    tiles_vram = _build_sprite<sprite_size::NORMAL, fixed_max_characters_per_sprite, false>(
+                                generator, palette, sprite_position, sprites);
+                    hw::sprite_tiles::clear_tiles(fixed_max_characters_per_sprite, tiles_vram);
+                }
+            }
+
+            for(; new_index < new_end_index; ++new_index)
+            {
+                _plot_glyph(tiles_item, big, new_glyphs[new_index], tiles_vram);
+            }
+
+            old_index = old_end_index;
+        }
+    }
+
+    void _update_one_sprite_per_character_text(
+            const sprite_text_generator& generator, const fixed_point& aligned_position,
+            const ivector<isprite_text::glyph>& old_glyphs, const ivector<isprite_text::glyph>& new_glyphs,
+            ivector<sprite_ptr>& sprites)
+    {
+        const sprite_item& item = generator.font().item();
+        const sprite_tiles_item& tiles_item = item.tiles_item();
+
+        for(int index = 0, limit = new_glyphs.size(); index < limit; ++index)
+        {
+            const isprite_text::glyph& new_glyph = new_glyphs[index];
+            fixed_point sprite_position(aligned_position.x() + new_glyph.x + (fixed_character_width / 2),
+                                        aligned_position.y());
+
+            if(index < sprites.size())
+            {
+                // Character tiles are shared, so they are only loaded if no other sprite is showing them:
+                sprite_ptr& sprite = sprites[index];
+
+                if(old_glyphs[index].graphics_index != new_glyph.graphics_index)
+                {
+                    sprite.set_tiles(tiles_item, new_glyph.graphics_index);
+                }
+
+                if(sprite.position() != sprite_position)
+                {
+                    sprite.set_position(sprite_position);
+                }
+            }
+            else
+            {
+                BTN_ASSERT(! sprites.full(), "No more output sprites available");
+
+                sprite_palette_ptr palette = sprites.empty() ?
+                            generator.palette_item().create_palette() : sprites[0].palette();
+                sprite_shape_size shape_size(item.shape_size().shape(), sprite_size::SMALL);
+                sprite_builder builder(shape_size, sprite_tiles_ptr::create(tiles_item, new_glyph.graphics_index),
+                                       move(palette));
+                builder.set_position(sprite_position);
+                builder.set_bg_priority(generator.bg_priority());
+                builder.set_z_order(generator.z_order());
+                sprites.push_back(sprite_ptr::create(move(builder)));
+            }
+        }
+    }
+
+
     template<bool allow_failure, class Painter>
     [[nodiscard]] bool paint(const string_view& text, const iunordered_map<int, int>& utf8_characters_map,
                              Painter& painter)
@@ -740,27 +1056,9 @@ namespace
             palette = generator.palette_item().create_palette();
         }
 
-        fixed_point aligned_position = position;
-
-        switch(generator.alignment())
-        {
-
-        case sprite_text_generator::alignment_type::LEFT:
-            break;
-
-        case sprite_text_generator::alignment_type::CENTER:
-            aligned_position.set_x(aligned_position.x() - (generator.width(text) / 2));
-            break;
-
-        case sprite_text_generator::alignment_type::RIGHT:
-            aligned_position.set_x(aligned_position.x() - generator.width(text));
-            break;
-
-        default:
-            BTN_ERROR("Invalid alignment: ", int(generator.alignment()));
-            break;
-        }
-
+        bool left_alignment = generator.alignment() == sprite_text_generator::alignment_type::LEFT;
+        int text_width = left_alignment ? 0 : generator.width(text);
+        fixed_point aligned_position = _aligned_position(generator, position, text_width);
         const sprite_font& font = generator.font();
         int output_sprites_count = output_sprites.size();
         bool success;
@@ -827,6 +1125,8 @@ sprite_text_generator::sprite_text_generator(const sprite_font& font) :
     _font(font),
     _palette_item(font.item().palette_item())
 {
+    BTN_ASSERT(! font.item().tiles_item().deduplicated(), "Fonts with deduplicated tiles not supported");
+
     _build_utf8_characters_map();
 }
 
@@ -834,6 +1134,7 @@ sprite_text_generator::sprite_text_generator(const sprite_font& font, const spri
     _font(font),
     _palette_item(palette_item)
 {
+    BTN_ASSERT(! font.item().tiles_item().deduplicated(), "Fonts with deduplicated tiles not supported");
     BTN_ASSERT(palette_item.bpp_mode() == palette_bpp_mode::BPP_4, "8BPP fonts not supported");
 
     _build_utf8_characters_map();
@@ -900,6 +1201,37 @@ bool sprite_text_generator::generate_optional(const fixed_point& position, const
     return _generate<true>(*this, position, text, _utf8_characters_map, output_sprites);
 }
 
+void sprite_text_generator::_update_text(const string_view& text, isprite_text& sprite_text) const
+{
+    ivector<isprite_text::glyph>& old_glyphs = *sprite_text._glyphs;
+    ivector<isprite_text::glyph>& new_glyphs = *sprite_text._new_glyphs;
+    new_glyphs.clear();
+
+    layout_painter painter(*this, new_glyphs);
+    [[maybe_unused]] bool success = paint<false>(text, _utf8_characters_map, painter);
+
+    fixed_point aligned_position = _aligned_position(*this, sprite_text._position, painter.width());
+    ivector<sprite_ptr>& sprites = sprite_text._sprites;
+    int sprites_count = new_glyphs.empty() ? 0 : new_glyphs.back().sprite_index + 1;
+
+    if(sprites.size() > sprites_count)
+    {
+        sprites.shrink(sprites_count);
+    }
+
+    if(_one_sprite_per_character)
+    {
+        _update_one_sprite_per_character_text(*this, aligned_position, old_glyphs, new_glyphs, sprites);
+    }
+    else
+    {
+        _update_multiple_characters_per_sprite_text(*this, aligned_position, old_glyphs, new_glyphs, sprites);
+    }
+
+    sprite_text._glyphs = &new_glyphs;
+    sprite_text._new_glyphs = &old_glyphs;
+}
+
 void sprite_text_generator::_build_utf8_characters_map()
 {
     int utf8_character_index = sprite_font::minimum_graphics;
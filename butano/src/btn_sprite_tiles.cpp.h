@@ -30,6 +30,11 @@ int available_items_count()
     return sprite_tiles_manager::available_items_count();
 }
 
+fixed fragmentation()
+{
+    return sprite_tiles_manager::fragmentation();
+}
+
 #if BTN_CFG_LOG_ENABLED
     void log_status()
     {
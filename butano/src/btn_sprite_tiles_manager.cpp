@@ -5,8 +5,12 @@
 
 #include "btn_sprite_tiles_manager.h"
 
+#include "btn_fixed.h"
 #include "btn_vector.h"
+#include "btn_decompressor.h"
 #include "btn_unordered_map.h"
+#include "btn_vram_commit_queue.h"
+#include "btn_vram_commit_stream.h"
 #include "btn_config_sprite_tiles.h"
 #include "../hw/include/btn_hw_sprite_tiles.h"
 #include "../hw/include/btn_hw_sprite_tiles_constants.h"
@@ -37,6 +41,10 @@ namespace
 
     constexpr const int max_items = BTN_CFG_SPRITE_TILES_MAX_ITEMS;
     constexpr const int max_list_items = max_items + 2;
+    constexpr const int compaction_max_bytes = BTN_CFG_SPRITE_TILES_COMPACTION_MAX_BYTES_PER_FRAME;
+    constexpr const int max_relocations = 16;
+
+    static_assert(compaction_max_bytes >= 0);
 
 
     enum class status_type
@@ -61,7 +69,10 @@ namespace
 
     public:
         const tile* data = nullptr;
+        const uint16_t* tile_indexes = nullptr;
+        const uint16_t* committed_tile_indexes = nullptr;
         unsigned usages = 0;
+        compression_type compression = compression_type::NONE;
         unsigned start_tile: 12 = 0;
         unsigned tiles_count: 12 = 0;
 
@@ -220,6 +231,13 @@ namespace
             return iterator(next_index, *this);
         }
 
+        // Moves the given item before the item at position_index, keeping its index:
+        void move(int index, int position_index)
+        {
+            _remove_node(index);
+            _insert_node(position_index, index);
+        }
+
     private:
         item_type _items[max_list_items];
         vector<int16_t, max_items> _free_indices;
@@ -249,17 +267,31 @@ namespace
     };
 
 
+    class relocation_type
+    {
+
+    public:
+        uint16_t source_tile;
+        uint16_t destination_tile;
+        uint16_t tiles_count;
+    };
+
+
     class static_data
     {
 
     public:
         items_list items;
-        unordered_map<const tile*, int, max_items * 2> items_map;
+        unordered_map<const void*, int, max_items * 2> items_map;
         vector<uint16_t, max_items> free_items;
         vector<uint16_t, max_items> to_remove_items;
+        vector<relocation_type, max_relocations> relocations;
+        vram_commit_queue<max_items> commit_queue;
+        vram_commit_stream streaming;
         int free_tiles_count = 0;
         int to_remove_tiles_count = 0;
-        bool check_commit = false;
+        int compaction_available_bytes = compaction_max_bytes;
+        int relocations_count = 0;
         bool delay_commit = false;
     };
 
@@ -278,6 +310,8 @@ namespace
                         (item.status() == status_type::FREE ? "free" :
                                 item.status() == status_type::USED ? "used" : "to_remove"),
                         " - data: ", item.data,
+                        " - tile_indexes: ", item.tile_indexes,
+                        " - compression: ", int(item.compression),
                         " - start_tile: ", item.start_tile,
                         " - tiles_count: ", item.tiles_count,
                         " - usages: ", item.usages,
@@ -292,7 +326,7 @@ namespace
             for(const auto& items_map_pair : data.items_map)
             {
                 BTN_LOG("    ",
-                        "data: ", items_map_pair.first,
+                        "key: ", items_map_pair.first,
                         " - id: ", items_map_pair.second);
             }
 
@@ -330,7 +364,7 @@ namespace
 
             BTN_LOG("free_tiles_count: ", data.free_tiles_count);
             BTN_LOG("to_remove_tiles_count: ", data.to_remove_tiles_count);
-            BTN_LOG("check_commit: ", (data.check_commit ? "true" : "false"));
+            BTN_LOG("commit_queue_empty: ", (data.commit_queue.empty() ? "true" : "false"));
             BTN_LOG("delay_commit: ", (data.delay_commit ? "true" : "false"));
         }
 
@@ -420,21 +454,101 @@ namespace
                 tiles_count == 32 || tiles_count == 64 || tiles_count == 128;
     }
 
-    [[nodiscard]] int _find_impl(const tile* tiles_data, [[maybe_unused]] int tiles_count)
+    // Deduplicated tiles share their tiles data, so they are identified by their tile indexes:
+    [[nodiscard]] const void* _key(const tile* tiles_data, const uint16_t* tile_indexes)
+    {
+        if(tile_indexes)
+        {
+            return tile_indexes;
+        }
+
+        return tiles_data;
+    }
+
+    [[nodiscard]] const void* _item_key(const item_type& item)
+    {
+        return _key(item.data, item.tile_indexes);
+    }
+
+    void _commit_vram(item_type& item)
+    {
+        if(item.compression != compression_type::NONE)
+        {
+            decompressor item_decompressor;
+            item_decompressor.start(item.data, item.compression, hw::sprite_tiles::vram(item.start_tile));
+            item_decompressor.decompress_all();
+        }
+        else if(const uint16_t* tile_indexes = item.tile_indexes)
+        {
+            // Only the tiles which have changed since the last commit are uploaded:
+            hw::sprite_tiles::commit(item.data, tile_indexes, item.committed_tile_indexes, item.start_tile,
+                                     item.tiles_count);
+            item.committed_tile_indexes = tile_indexes;
+        }
+        else
+        {
+            hw::sprite_tiles::commit(item.data, item.start_tile, item.tiles_count);
+        }
+    }
+
+    [[nodiscard]] int _commit_bytes(int id, const item_type& item)
+    {
+        if(id == data.commit_queue.streaming_id() && data.streaming.started())
+        {
+            return data.streaming.bytes();
+        }
+
+        return int(item.tiles_count * sizeof(tile));
+    }
+
+    // Compressed tiles which don't fit in the VRAM commits budget are decompressed over multiple frames:
+    [[nodiscard]] bool _stream_vram(int id, item_type& item, int max_bytes)
+    {
+        if(id != data.commit_queue.streaming_id())
+        {
+            _commit_vram(item);
+            return true;
+        }
+
+        vram_commit_stream& streaming = data.streaming;
+
+        if(! streaming.started() && ! streaming.start(item.data, item.compression))
+        {
+            // Without memory for the staging buffer, tiles are committed at once:
+            _commit_vram(item);
+            return true;
+        }
+
+        return streaming.commit(max_bytes, reinterpret_cast<uint16_t*>(hw::sprite_tiles::vram(item.start_tile)));
+    }
+
+    void _stop_streaming(int id)
+    {
+        if(id == data.commit_queue.streaming_id())
+        {
+            data.streaming.stop();
+        }
+    }
+
+    [[nodiscard]] int _find_impl(const tile* tiles_data, const uint16_t* tile_indexes,
+                                 [[maybe_unused]] compression_type compression, [[maybe_unused]] int tiles_count)
     {
         BTN_ASSERT(tiles_data, "Tiles ref is null");
 
-        auto items_map_iterator = data.items_map.find(tiles_data);
+        const void* key = _key(tiles_data, tile_indexes);
+        auto items_map_iterator = data.items_map.find(key);
 
         if(items_map_iterator != data.items_map.end())
         {
             int id = items_map_iterator->second;
             item_type& item = data.items.item(id);
 
-            BTN_ASSERT(tiles_data == item.data, "Tiles data does not match item tiles data: ",
-                       tiles_data, " - ", item.data);
+            BTN_ASSERT(key == _item_key(item), "Tiles data does not match item tiles data: ",
+                       key, " - ", _item_key(item));
             BTN_ASSERT(tiles_count == item.tiles_count, "Tiles count does not match item tiles count: ",
                        tiles_count, " - ", item.tiles_count);
+            BTN_ASSERT(compression == item.compression, "Compression does not match item compression: ",
+                       int(compression), " - ", int(item.compression));
 
             switch(item.status())
             {
@@ -470,22 +584,50 @@ namespace
         return -1;
     }
 
-    void _commit_item(const tile* tiles_data, bool delay_commit, item_type& item)
+    void _commit_item(int id, const tile* tiles_data, const uint16_t* tile_indexes, compression_type compression,
+                      bool delay_commit, vram_commit_priority priority)
     {
+        item_type& item = data.items.item(id);
+        BTN_ASSERT(compression == compression_type::NONE ||
+                   decompressor::decompressed_bytes(tiles_data) == int(item.tiles_count * sizeof(tile)),
+                   "Decompressed size does not match item tiles count: ",
+                   decompressor::decompressed_bytes(tiles_data), " - ", item.tiles_count);
+
+        _stop_streaming(id);
+
+        // VRAM contents can be reused only if they come from the same unique tiles:
+        if(item.data != tiles_data || ! tile_indexes)
+        {
+            item.committed_tile_indexes = nullptr;
+        }
+
         item.data = tiles_data;
+        item.tile_indexes = tile_indexes;
+        item.compression = compression;
 
         if(delay_commit)
         {
             item.commit = true;
-            data.check_commit = true;
+            data.commit_queue.push(id, priority, compression != compression_type::NONE);
         }
         else
         {
-            hw::sprite_tiles::commit(tiles_data, item.start_tile, item.tiles_count);
+            _commit_vram(item);
         }
     }
 
-    [[nodiscard]] optional<int> _create_item(int id, const tile* tiles_data, int tiles_count, bool delay_commit)
+    void _reset_commit(int id, item_type& item)
+    {
+        if(item.commit)
+        {
+            item.commit = false;
+            _stop_streaming(id);
+            data.commit_queue.erase(id);
+        }
+    }
+
+    [[nodiscard]] optional<int> _create_item(int id, const tile* tiles_data, const uint16_t* tile_indexes,
+                                             compression_type compression, int tiles_count, bool delay_commit)
     {
         item_type& item = data.items.item(id);
         int new_item_tiles_count = item.tiles_count - tiles_count;
@@ -502,7 +644,7 @@ namespace
             break;
 
         case status_type::TO_REMOVE:
-            data.items_map.erase(item.data);
+            data.items_map.erase(_item_key(item));
             data.to_remove_tiles_count -= tiles_count;
             break;
 
@@ -511,15 +653,22 @@ namespace
             break;
         }
 
-        item.data = tiles_data;
         item.tiles_count = uint16_t(tiles_count);
         item.usages = 1;
-        item.commit = false;
         item.set_status(status_type::USED);
+        _reset_commit(id, item);
 
         if(tiles_data)
         {
-            _commit_item(tiles_data, delay_commit, item);
+            // Item VRAM contents are not valid yet, so they must be committed as soon as possible:
+            _commit_item(id, tiles_data, tile_indexes, compression, delay_commit, vram_commit_priority::FORCED);
+        }
+        else
+        {
+            item.data = nullptr;
+            item.tile_indexes = nullptr;
+            item.committed_tile_indexes = nullptr;
+            item.compression = compression_type::NONE;
         }
 
         optional<int> new_free_item_id;
@@ -539,7 +688,8 @@ namespace
         return new_free_item_id;
     }
 
-    [[nodiscard]] int _create_impl(const tile* tiles_data, int tiles_count)
+    [[nodiscard]] int _create_impl(const tile* tiles_data, const uint16_t* tile_indexes, compression_type compression,
+                                   int tiles_count)
     {
         bool check_to_remove_tiles = tiles_count <= data.to_remove_tiles_count;
 
@@ -558,7 +708,8 @@ namespace
                 {
                     data.to_remove_items.erase(to_remove_items_it);
 
-                    if(optional<int> new_free_item_id = _create_item(id, tiles_data, tiles_count, true))
+                    if(optional<int> new_free_item_id = _create_item(id, tiles_data, tile_indexes, compression,
+                                                                     tiles_count, true))
                     {
                         _insert_free_item(*new_free_item_id);
                     }
@@ -578,7 +729,8 @@ namespace
             {
                 int id = *free_items_it;
 
-                if(optional<int> new_free_item_id = _create_item(id, tiles_data, tiles_count, data.delay_commit))
+                if(optional<int> new_free_item_id = _create_item(id, tiles_data, tile_indexes, compression,
+                                                                 tiles_count, data.delay_commit))
                 {
                     _insert_free_item(*new_free_item_id, free_items_it);
                     ++free_items_it;
@@ -593,7 +745,7 @@ namespace
         {
             update();
             data.delay_commit = true;
-            return _create_impl(tiles_data, tiles_count);
+            return _create_impl(tiles_data, tile_indexes, compression, tiles_count);
         }
 
         return -1;
@@ -616,7 +768,8 @@ namespace
             {
                 int id = *free_items_it;
 
-                if(optional<int> new_free_item_id = _create_item(id, nullptr, tiles_count, false))
+                if(optional<int> new_free_item_id = _create_item(id, nullptr, nullptr, compression_type::NONE,
+                                                                 tiles_count, false))
                 {
                     _insert_free_item(*new_free_item_id, free_items_it);
                     ++free_items_it;
@@ -629,6 +782,303 @@ namespace
 
         return -1;
     }
+
+    [[nodiscard]] int _create(const tile* tiles_data, const uint16_t* tile_indexes, compression_type compression,
+                              int tiles_count)
+    {
+        int result = _find_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            return result;
+        }
+
+        BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+
+        result = _create_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            data.items_map.insert(_key(tiles_data, tile_indexes), result);
+
+            BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+        else
+        {
+            BTN_SPRITE_TILES_LOG("NOT CREATED");
+
+            #if BTN_CFG_LOG_ENABLED
+                log_status();
+
+                BTN_ERROR("Sprite tiles create failed:",
+                          "\n\tTiles data: ", tiles_data,
+                          "\n\tTile indexes: ", tile_indexes,
+                          "\n\tTiles count: ", tiles_count,
+                          "\n\nSprite tiles manager status has been logged.");
+            #else
+                BTN_ERROR("Sprite tiles create failed. Tiles count: ", tiles_count);
+            #endif
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] int _create_new(const tile* tiles_data, const uint16_t* tile_indexes, compression_type compression,
+                                  int tiles_count)
+    {
+        BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+        BTN_ASSERT(data.items_map.find(_key(tiles_data, tile_indexes)) == data.items_map.end(),
+                   "Multiple copies of the same tiles data not supported");
+
+        int result = _create_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            data.items_map.insert(_key(tiles_data, tile_indexes), result);
+
+            BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+        else
+        {
+            BTN_SPRITE_TILES_LOG("NOT CREATED");
+
+            #if BTN_CFG_LOG_ENABLED
+                log_status();
+
+                BTN_ERROR("Sprite tiles create new failed:",
+                          "\n\tTiles data: ", tiles_data,
+                          "\n\tTile indexes: ", tile_indexes,
+                          "\n\tTiles count: ", tiles_count,
+                          "\n\nSprite tiles manager status has been logged.");
+            #else
+                BTN_ERROR("Sprite tiles create new failed. Tiles count: ", tiles_count);
+            #endif
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] int _create_optional(const tile* tiles_data, const uint16_t* tile_indexes,
+                                       compression_type compression, int tiles_count)
+    {
+        int result = _find_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            return result;
+        }
+
+        BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+
+        result = _create_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            data.items_map.insert(_key(tiles_data, tile_indexes), result);
+
+            BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+        else
+        {
+            BTN_SPRITE_TILES_LOG("NOT CREATED");
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] int _create_new_optional(const tile* tiles_data, const uint16_t* tile_indexes,
+                                           compression_type compression, int tiles_count)
+    {
+        BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+        BTN_ASSERT(data.items_map.find(_key(tiles_data, tile_indexes)) == data.items_map.end(),
+                   "Multiple copies of the same tiles data not supported");
+
+        int result = _create_impl(tiles_data, tile_indexes, compression, tiles_count);
+
+        if(result != -1)
+        {
+            data.items_map.insert(_key(tiles_data, tile_indexes), result);
+
+            BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+        else
+        {
+            BTN_SPRITE_TILES_LOG("NOT CREATED");
+        }
+
+        return result;
+    }
+
+    void _set_tiles_ref(int id, const tile* new_tiles_data, const uint16_t* new_tile_indexes,
+                        compression_type new_compression, [[maybe_unused]] int new_tiles_count)
+    {
+        item_type& item = data.items.item(id);
+        const void* old_key = _item_key(item);
+        const void* new_key = _key(new_tiles_data, new_tile_indexes);
+
+        BTN_ASSERT(item.data, "Item has no data");
+
+        if(old_key != new_key)
+        {
+            BTN_ASSERT(data.items_map.find(new_key) == data.items_map.end(),
+                       "Multiple copies of the same tiles data not supported");
+            BTN_ASSERT(item.tiles_count == new_tiles_count, "Tiles count does not match item tiles count: ",
+                       item.tiles_count, " - ", new_tiles_count);
+
+            data.items_map.erase(old_key);
+            _commit_item(id, new_tiles_data, new_tile_indexes, new_compression, true, vram_commit_priority::HIGH);
+            data.items_map.insert(new_key, id);
+
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+    }
+
+    // Items VRAM contents can be moved only if they can be reloaded and they are not being uploaded:
+    [[nodiscard]] bool _movable_item(const item_type& item)
+    {
+        return item.status() == status_type::USED && item.data && ! item.commit;
+    }
+
+    void _move_item(int id, int free_id)
+    {
+        item_type& item = data.items.item(id);
+        item_type& free_item = data.items.item(free_id);
+        int tiles_count = item.tiles_count;
+
+        // Sprites keep using the old tiles until their tile indexes are updated in the next frame,
+        // so they are not released until the next update:
+        item_type old_item;
+        old_item.start_tile = item.start_tile;
+        old_item.tiles_count = item.tiles_count;
+        old_item.set_status(status_type::TO_REMOVE);
+
+        int old_id = data.items.insert(item.next_index, old_item).id();
+        _insert_to_remove_item(old_id);
+        data.to_remove_tiles_count += tiles_count;
+
+        data.relocations.push_back(relocation_type{ uint16_t(item.start_tile), uint16_t(free_item.start_tile),
+                                                    uint16_t(tiles_count) });
+        data.items.move(id, free_id);
+        item.start_tile = free_item.start_tile;
+
+        _erase_free_item(free_id);
+        data.free_tiles_count -= tiles_count;
+        free_item.start_tile += tiles_count;
+        free_item.tiles_count -= tiles_count;
+
+        if(free_item.tiles_count)
+        {
+            _insert_free_item(free_id);
+        }
+        else
+        {
+            data.items.erase(free_id);
+        }
+    }
+
+    // Returns the id of the first free item before the given one in which it fits, or -1 if there's none:
+    [[nodiscard]] int _compaction_free_item_id(const item_type& item)
+    {
+        int start_tile = item.start_tile;
+        int tiles_count = item.tiles_count;
+        int result = -1;
+        int result_start_tile = start_tile;
+
+        for(int free_item_id : data.free_items)
+        {
+            const item_type& free_item = data.items.item(free_item_id);
+            int free_start_tile = free_item.start_tile;
+
+            // 8bpp sprites need even tile indexes:
+            if(free_start_tile < result_start_tile && free_item.tiles_count >= tiles_count &&
+                    (start_tile % 2 || free_start_tile % 2 == 0))
+            {
+                result = free_item_id;
+                result_start_tile = free_start_tile;
+            }
+        }
+
+        return result;
+    }
+
+    // The last used items are moved to the first free items in which they fit,
+    // so each item is moved only once and free space is merged at the end of VRAM:
+    void _compact()
+    {
+        if(data.free_items.size() < 2)
+        {
+            return;
+        }
+
+        BTN_SPRITE_TILES_LOG("sprite_tiles_manager - COMPACT");
+
+        int first_free_start_tile = hw::sprite_tiles::tiles_count();
+
+        for(int free_item_id : data.free_items)
+        {
+            first_free_start_tile = min(first_free_start_tile, int(data.items.item(free_item_id).start_tile));
+        }
+
+        auto iterator = data.items.end();
+
+        while(iterator != data.items.begin() && ! data.relocations.full() && ! data.items.full())
+        {
+            --iterator;
+
+            const item_type& item = *iterator;
+
+            if(int(item.start_tile) < first_free_start_tile)
+            {
+                break;
+            }
+
+            if(_movable_item(item))
+            {
+                int bytes = item.tiles_count * int(sizeof(tile));
+
+                if(bytes <= data.compaction_available_bytes)
+                {
+                    int free_item_id = _compaction_free_item_id(item);
+
+                    if(free_item_id >= 0)
+                    {
+                        auto next_iterator = iterator;
+                        ++next_iterator;
+                        _move_item(iterator.id(), free_item_id);
+                        data.compaction_available_bytes -= bytes;
+                        iterator = next_iterator;
+                        --iterator;
+                    }
+                }
+            }
+        }
+
+        if(! data.relocations.empty())
+        {
+            ++data.relocations_count;
+
+            BTN_SPRITE_TILES_LOG_STATUS();
+        }
+    }
+
+    void _commit_relocations()
+    {
+        // Relocations are committed before the other uploads, since old VRAM contents can be replaced by them:
+        for(const relocation_type& relocation : data.relocations)
+        {
+            int tiles_count = relocation.tiles_count;
+            hw::sprite_tiles::copy_tiles(hw::sprite_tiles::vram(relocation.source_tile), tiles_count,
+                                         hw::sprite_tiles::vram(relocation.destination_tile));
+            vram_commits_manager::force(tiles_count * int(sizeof(tile)));
+        }
+
+        data.relocations.clear();
+        data.compaction_available_bytes = compaction_max_bytes;
+    }
 }
 
 void init()
@@ -665,6 +1115,25 @@ int available_items_count()
     return data.items.available();
 }
 
+fixed fragmentation()
+{
+    int free_tiles_count = data.free_tiles_count;
+
+    if(! free_tiles_count)
+    {
+        return 0;
+    }
+
+    // Free items are sorted by size, so the last one is the biggest one:
+    int biggest_free_tiles_count = data.items.item(data.free_items.back()).tiles_count;
+    return 1 - (fixed(biggest_free_tiles_count) / free_tiles_count);
+}
+
+int relocations_count()
+{
+    return data.relocations_count;
+}
+
 #if BTN_CFG_LOG_ENABLED
     void log_status()
     {
@@ -693,97 +1162,72 @@ int available_items_count()
     }
 #endif
 
-int find(const span<const tile>& tiles_ref)
+int find(const span<const tile>& tiles_ref, compression_type compression)
 {
     const tile* tiles_data = tiles_ref.data();
     int tiles_count = tiles_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - FIND: ", tiles_data, " - ", tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - FIND: ", tiles_data, " - ", tiles_count, " - ",
+                         int(compression));
 
-    return _find_impl(tiles_data, tiles_count);
+    return _find_impl(tiles_data, nullptr, compression, tiles_count);
 }
 
-int create(const span<const tile>& tiles_ref)
+int find(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
 {
-    const tile* tiles_data = tiles_ref.data();
-    int tiles_count = tiles_ref.size();
+    const uint16_t* tile_indexes = tile_indexes_ref.data();
+    int tiles_count = tile_indexes_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE: ", tiles_data, " - ", tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - FIND: ", tiles_data, " - ", tile_indexes, " - ", tiles_count);
 
-    int result = _find_impl(tiles_data, tiles_count);
-
-    if(result != -1)
-    {
-        return result;
-    }
+    return _find_impl(tiles_data, tile_indexes, compression_type::NONE, tiles_count);
+}
 
-    BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+int create(const span<const tile>& tiles_ref, compression_type compression)
+{
+    const tile* tiles_data = tiles_ref.data();
+    int tiles_count = tiles_ref.size();
 
-    result = _create_impl(tiles_data, tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE: ", tiles_data, " - ", tiles_count, " - ",
+                         int(compression));
 
-    if(result != -1)
-    {
-        data.items_map.insert(tiles_data, result);
+    return _create(tiles_data, nullptr, compression, tiles_count);
+}
 
-        BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
-        BTN_SPRITE_TILES_LOG_STATUS();
-    }
-    else
-    {
-        BTN_SPRITE_TILES_LOG("NOT CREATED");
+int create(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
+{
+    const uint16_t* tile_indexes = tile_indexes_ref.data();
+    int tiles_count = tile_indexes_ref.size();
 
-        #if BTN_CFG_LOG_ENABLED
-            log_status();
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE: ", tiles_data, " - ", tile_indexes, " - ", tiles_count);
 
-            BTN_ERROR("Sprite tiles create failed:",
-                      "\n\tTiles data: ", tiles_data,
-                      "\n\tTiles count: ", tiles_count,
-                      "\n\nSprite tiles manager status has been logged.");
-        #else
-            BTN_ERROR("Sprite tiles create failed. Tiles count: ", tiles_count);
-        #endif
-    }
+    BTN_ASSERT(tile_indexes, "Tile indexes ref is null");
 
-    return result;
+    return _create(tiles_data, tile_indexes, compression_type::NONE, tiles_count);
 }
 
-int create_new(const span<const tile>& tiles_ref)
+int create_new(const span<const tile>& tiles_ref, compression_type compression)
 {
     const tile* tiles_data = tiles_ref.data();
     int tiles_count = tiles_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW: ", tiles_data, " - ", tiles_count);
-
-    BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
-    BTN_ASSERT(data.items_map.find(tiles_data) == data.items_map.end(),
-               "Multiple copies of the same tiles data not supported");
-
-    int result = _create_impl(tiles_data, tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW: ", tiles_data, " - ", tiles_count, " - ",
+                         int(compression));
 
-    if(result != -1)
-    {
-        data.items_map.insert(tiles_data, result);
+    return _create_new(tiles_data, nullptr, compression, tiles_count);
+}
 
-        BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
-        BTN_SPRITE_TILES_LOG_STATUS();
-    }
-    else
-    {
-        BTN_SPRITE_TILES_LOG("NOT CREATED");
+int create_new(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
+{
+    const uint16_t* tile_indexes = tile_indexes_ref.data();
+    int tiles_count = tile_indexes_ref.size();
 
-        #if BTN_CFG_LOG_ENABLED
-            log_status();
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW: ", tiles_data, " - ", tile_indexes, " - ",
+                         tiles_count);
 
-            BTN_ERROR("Sprite tiles create new failed:",
-                      "\n\tTiles data: ", tiles_data,
-                      "\n\tTiles count: ", tiles_count,
-                      "\n\nSprite tiles manager status has been logged.");
-        #else
-            BTN_ERROR("Sprite tiles create new failed. Tiles count: ", tiles_count);
-        #endif
-    }
+    BTN_ASSERT(tile_indexes, "Tile indexes ref is null");
 
-    return result;
+    return _create_new(tiles_data, tile_indexes, compression_type::NONE, tiles_count);
 }
 
 int allocate(int tiles_count)
@@ -816,65 +1260,52 @@ int allocate(int tiles_count)
     return result;
 }
 
-int create_optional(const span<const tile>& tiles_ref)
+int create_optional(const span<const tile>& tiles_ref, compression_type compression)
 {
     const tile* tiles_data = tiles_ref.data();
     int tiles_count = tiles_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE OPTIONAL: ", tiles_data, " - ", tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE OPTIONAL: ", tiles_data, " - ", tiles_count, " - ",
+                         int(compression));
 
-    int result = _find_impl(tiles_data, tiles_count);
-
-    if(result != -1)
-    {
-        return result;
-    }
-
-    BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
+    return _create_optional(tiles_data, nullptr, compression, tiles_count);
+}
 
-    result = _create_impl(tiles_data, tiles_count);
+int create_optional(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
+{
+    const uint16_t* tile_indexes = tile_indexes_ref.data();
+    int tiles_count = tile_indexes_ref.size();
 
-    if(result != -1)
-    {
-        data.items_map.insert(tiles_data, result);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE OPTIONAL: ", tiles_data, " - ", tile_indexes, " - ",
+                         tiles_count);
 
-        BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
-        BTN_SPRITE_TILES_LOG_STATUS();
-    }
-    else
-    {
-        BTN_SPRITE_TILES_LOG("NOT CREATED");
-    }
+    BTN_ASSERT(tile_indexes, "Tile indexes ref is null");
 
-    return result;
+    return _create_optional(tiles_data, tile_indexes, compression_type::NONE, tiles_count);
 }
 
-int create_new_optional(const span<const tile>& tiles_ref)
+int create_new_optional(const span<const tile>& tiles_ref, compression_type compression)
 {
     const tile* tiles_data = tiles_ref.data();
     int tiles_count = tiles_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW OPTIONAL: ", tiles_data, " - ", tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW OPTIONAL: ", tiles_data, " - ", tiles_count, " - ",
+                         int(compression));
 
-    BTN_ASSERT(_valid_tiles_count(tiles_count), "Invalid tiles ref count: ", tiles_count);
-    BTN_ASSERT(data.items_map.find(tiles_data) == data.items_map.end(),
-               "Multiple copies of the same tiles data not supported");
+    return _create_new_optional(tiles_data, nullptr, compression, tiles_count);
+}
 
-    int result = _create_impl(tiles_data, tiles_count);
+int create_new_optional(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
+{
+    const uint16_t* tile_indexes = tile_indexes_ref.data();
+    int tiles_count = tile_indexes_ref.size();
 
-    if(result != -1)
-    {
-        data.items_map.insert(tiles_data, result);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - CREATE NEW OPTIONAL: ", tiles_data, " - ", tile_indexes, " - ",
+                         tiles_count);
 
-        BTN_SPRITE_TILES_LOG("CREATED. start_tile: ", data.items.item(result).start_tile);
-        BTN_SPRITE_TILES_LOG_STATUS();
-    }
-    else
-    {
-        BTN_SPRITE_TILES_LOG("NOT CREATED");
-    }
+    BTN_ASSERT(tile_indexes, "Tile indexes ref is null");
 
-    return result;
+    return _create_new_optional(tiles_data, tile_indexes, compression_type::NONE, tiles_count);
 }
 
 int allocate_optional(int tiles_count)
@@ -942,7 +1373,7 @@ optional<span<const tile>> tiles_ref(int id)
     const item_type& item = data.items.item(id);
     optional<span<const tile>> result;
 
-    if(item.data)
+    if(item.data && ! item.tile_indexes && item.compression == compression_type::NONE)
     {
         result.emplace(item.data, item.tiles_count);
     }
@@ -950,32 +1381,28 @@ optional<span<const tile>> tiles_ref(int id)
     return result;
 }
 
-void set_tiles_ref(int id, const span<const tile>& tiles_ref)
+void set_tiles_ref(int id, const span<const tile>& tiles_ref, compression_type compression)
 {
-    item_type& item = data.items.item(id);
-    const tile* old_tiles_data = item.data;
-    [[maybe_unused]] int old_tiles_count = item.tiles_count;
     const tile* new_tiles_data = tiles_ref.data();
-    [[maybe_unused]] int new_tiles_count = tiles_ref.size();
+    int new_tiles_count = tiles_ref.size();
 
-    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - SET_TILES_REF: ", item.start_tile, " - ", new_tiles_data,
-                         " - ", new_tiles_count);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - SET_TILES_REF: ", data.items.item(id).start_tile, " - ",
+                         new_tiles_data, " - ", new_tiles_count, " - ", int(compression));
 
-    BTN_ASSERT(old_tiles_data, "Item has no data");
+    _set_tiles_ref(id, new_tiles_data, nullptr, compression, new_tiles_count);
+}
 
-    if(old_tiles_data != new_tiles_data)
-    {
-        BTN_ASSERT(data.items_map.find(new_tiles_data) == data.items_map.end(),
-                   "Multiple copies of the same tiles data not supported");
-        BTN_ASSERT(old_tiles_count == new_tiles_count, "Tiles count does not match item tiles count: ",
-                   old_tiles_count, " - ", new_tiles_count);
+void set_tiles_ref(int id, const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref)
+{
+    const uint16_t* new_tile_indexes = tile_indexes_ref.data();
+    int new_tiles_count = tile_indexes_ref.size();
 
-        data.items_map.erase(old_tiles_data);
-        _commit_item(new_tiles_data, true, item);
-        data.items_map.insert(new_tiles_data, id);
+    BTN_SPRITE_TILES_LOG("sprite_tiles_manager - SET_TILES_REF: ", data.items.item(id).start_tile, " - ",
+                         tiles_data, " - ", new_tile_indexes, " - ", new_tiles_count);
 
-        BTN_SPRITE_TILES_LOG_STATUS();
-    }
+    BTN_ASSERT(new_tile_indexes, "Tile indexes ref is null");
+
+    _set_tiles_ref(id, tiles_data, new_tile_indexes, compression_type::NONE, new_tiles_count);
 }
 
 void reload_tiles_ref(int id)
@@ -986,8 +1413,10 @@ void reload_tiles_ref(int id)
 
     BTN_ASSERT(item.data, "Item has no data");
 
+    item.committed_tile_indexes = nullptr;
     item.commit = true;
-    data.check_commit = true;
+    _stop_streaming(id);
+    data.commit_queue.push(id, vram_commit_priority::HIGH, item.compression != compression_type::NONE);
 
     BTN_SPRITE_TILES_LOG_STATUS();
 }
@@ -1021,12 +1450,15 @@ void update()
 
             if(item.data)
             {
-                data.items_map.erase(item.data);
+                data.items_map.erase(_item_key(item));
             }
 
             item.data = nullptr;
+            item.tile_indexes = nullptr;
+            item.committed_tile_indexes = nullptr;
+            item.compression = compression_type::NONE;
             item.set_status(status_type::FREE);
-            item.commit = false;
+            _reset_commit(to_remove_item_index, item);
             data.free_tiles_count += item.tiles_count;
 
             auto next_iterator = iterator;
@@ -1070,28 +1502,52 @@ void update()
 
         BTN_SPRITE_TILES_LOG_STATUS();
     }
+
+    if(compaction_max_bytes)
+    {
+        _compact();
+    }
 }
 
 void commit()
 {
-    if(data.check_commit)
+    if(! data.relocations.empty())
+    {
+        _commit_relocations();
+    }
+
+    if(! data.commit_queue.empty())
     {
         BTN_SPRITE_TILES_LOG("sprite_tiles_manager - COMMIT");
 
-        data.check_commit = false;
+        data.commit_queue.commit(
+                    [](int id)
+                    {
+                        const item_type& item = data.items.item(id);
+                        return item.status() == status_type::USED ? _commit_bytes(id, item) : 0;
+                    },
+                    [](int id)
+                    {
+                        item_type& item = data.items.item(id);
+                        item.commit = false;
+
+                        if(item.status() == status_type::USED)
+                        {
+                            _commit_vram(item);
+                        }
+                    },
+                    [](int id, int max_bytes)
+                    {
+                        item_type& item = data.items.item(id);
 
-        for(item_type& item : data.items)
-        {
-            if(item.commit)
-            {
-                item.commit = false;
+                        if(item.status() != status_type::USED || _stream_vram(id, item, max_bytes))
+                        {
+                            item.commit = false;
+                            return true;
+                        }
 
-                if(item.status() == status_type::USED)
-                {
-                    hw::sprite_tiles::commit(item.data, item.start_tile, item.tiles_count);
-                }
-            }
-        }
+                        return false;
+                    });
 
         BTN_SPRITE_TILES_LOG_STATUS();
     }
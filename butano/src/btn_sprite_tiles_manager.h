@@ -7,8 +7,10 @@
 #define BTN_SPRITE_TILES_MANAGER_H
 
 #include "btn_span_fwd.h"
+#include "btn_fixed_fwd.h"
 #include "btn_config_log.h"
 #include "btn_optional_fwd.h"
+#include "btn_compression_type.h"
 
 namespace btn
 {
@@ -27,21 +29,36 @@ namespace btn::sprite_tiles_manager
 
     [[nodiscard]] int available_items_count();
 
+    [[nodiscard]] fixed fragmentation();
+
+    // Incremented when items are moved to another VRAM location:
+    [[nodiscard]] int relocations_count();
+
     #if BTN_CFG_LOG_ENABLED
         void log_status();
     #endif
 
-    [[nodiscard]] int find(const span<const tile>& tiles_ref);
+    [[nodiscard]] int find(const span<const tile>& tiles_ref, compression_type compression);
+
+    [[nodiscard]] int find(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
+
+    [[nodiscard]] int create(const span<const tile>& tiles_ref, compression_type compression);
 
-    [[nodiscard]] int create(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
 
-    [[nodiscard]] int create_new(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create_new(const span<const tile>& tiles_ref, compression_type compression);
+
+    [[nodiscard]] int create_new(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
 
     [[nodiscard]] int allocate(int tiles_count);
 
-    [[nodiscard]] int create_optional(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create_optional(const span<const tile>& tiles_ref, compression_type compression);
+
+    [[nodiscard]] int create_optional(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
 
-    [[nodiscard]] int create_new_optional(const span<const tile>& tiles_ref);
+    [[nodiscard]] int create_new_optional(const span<const tile>& tiles_ref, compression_type compression);
+
+    [[nodiscard]] int create_new_optional(const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
 
     [[nodiscard]] int allocate_optional(int tiles_count);
 
@@ -55,7 +72,9 @@ namespace btn::sprite_tiles_manager
 
     [[nodiscard]] optional<span<const tile>> tiles_ref(int id);
 
-    void set_tiles_ref(int id, const span<const tile>& tiles_ref);
+    void set_tiles_ref(int id, const span<const tile>& tiles_ref, compression_type compression);
+
+    void set_tiles_ref(int id, const tile* tiles_data, const span<const uint16_t>& tile_indexes_ref);
 
     void reload_tiles_ref(int id);
 
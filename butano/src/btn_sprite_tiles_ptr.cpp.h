@@ -14,7 +14,7 @@ namespace btn
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::find(const span<const tile>& tiles_ref)
 {
-    int handle = sprite_tiles_manager::find(tiles_ref);
+    int handle = sprite_tiles_manager::find(tiles_ref, compression_type::NONE);
     optional<sprite_tiles_ptr> result;
 
     if(handle >= 0)
@@ -27,42 +27,75 @@ optional<sprite_tiles_ptr> sprite_tiles_ptr::find(const span<const tile>& tiles_
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::find(const sprite_tiles_item& tiles_item)
 {
-    return find(tiles_item.graphics_tiles_ref());
+    return find(tiles_item, 0);
 }
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::find(const sprite_tiles_item& tiles_item, int graphics_index)
 {
-    return find(tiles_item.graphics_tiles_ref(graphics_index));
+    int handle;
+
+    if(tiles_item.deduplicated())
+    {
+        handle = sprite_tiles_manager::find(tiles_item.tiles_ref().data(),
+                                            tiles_item.graphics_tile_indexes_ref(graphics_index));
+    }
+    else
+    {
+        handle = sprite_tiles_manager::find(tiles_item.graphics_tiles_ref(graphics_index), tiles_item.compression());
+    }
+
+    optional<sprite_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = sprite_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create(const span<const tile>& tiles_ref)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_ref));
+    return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_ref, compression_type::NONE));
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create(const sprite_tiles_item& tiles_item)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_item.graphics_tiles_ref()));
+    return create(tiles_item, 0);
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create(const sprite_tiles_item& tiles_item, int graphics_index)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_item.graphics_tiles_ref(graphics_index)));
+    if(! tiles_item.deduplicated())
+    {
+        return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_item.graphics_tiles_ref(graphics_index),
+                                                             tiles_item.compression()));
+    }
+
+    return sprite_tiles_ptr(sprite_tiles_manager::create(tiles_item.tiles_ref().data(),
+                                                         tiles_item.graphics_tile_indexes_ref(graphics_index)));
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create_new(const span<const tile>& tiles_ref)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_ref));
+    return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_ref, compression_type::NONE));
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create_new(const sprite_tiles_item& tiles_item)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_item.graphics_tiles_ref()));
+    return create_new(tiles_item, 0);
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::create_new(const sprite_tiles_item& tiles_item, int graphics_index)
 {
-    return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_item.graphics_tiles_ref(graphics_index)));
+    if(! tiles_item.deduplicated())
+    {
+        return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_item.graphics_tiles_ref(graphics_index),
+                                                                 tiles_item.compression()));
+    }
+
+    return sprite_tiles_ptr(sprite_tiles_manager::create_new(tiles_item.tiles_ref().data(),
+                                                             tiles_item.graphics_tile_indexes_ref(graphics_index)));
 }
 
 sprite_tiles_ptr sprite_tiles_ptr::allocate(int tiles_count)
@@ -72,7 +105,7 @@ sprite_tiles_ptr sprite_tiles_ptr::allocate(int tiles_count)
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_optional(const span<const tile>& tiles_ref)
 {
-    int handle = sprite_tiles_manager::create_optional(tiles_ref);
+    int handle = sprite_tiles_manager::create_optional(tiles_ref, compression_type::NONE);
     optional<sprite_tiles_ptr> result;
 
     if(handle >= 0)
@@ -85,17 +118,37 @@ optional<sprite_tiles_ptr> sprite_tiles_ptr::create_optional(const span<const ti
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_optional(const sprite_tiles_item& tiles_item)
 {
-    return create_optional(tiles_item.graphics_tiles_ref());
+    return create_optional(tiles_item, 0);
 }
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_optional(const sprite_tiles_item& tiles_item, int graphics_index)
 {
-    return create_optional(tiles_item.graphics_tiles_ref(graphics_index));
+    int handle;
+
+    if(tiles_item.deduplicated())
+    {
+        handle = sprite_tiles_manager::create_optional(tiles_item.tiles_ref().data(),
+                                                       tiles_item.graphics_tile_indexes_ref(graphics_index));
+    }
+    else
+    {
+        handle = sprite_tiles_manager::create_optional(tiles_item.graphics_tiles_ref(graphics_index),
+                                                       tiles_item.compression());
+    }
+
+    optional<sprite_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = sprite_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_new_optional(const span<const tile>& tiles_ref)
 {
-    int handle = sprite_tiles_manager::create_new_optional(tiles_ref);
+    int handle = sprite_tiles_manager::create_new_optional(tiles_ref, compression_type::NONE);
     optional<sprite_tiles_ptr> result;
 
     if(handle >= 0)
@@ -108,13 +161,33 @@ optional<sprite_tiles_ptr> sprite_tiles_ptr::create_new_optional(const span<cons
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_new_optional(const sprite_tiles_item& tiles_item)
 {
-    return create_new_optional(tiles_item.graphics_tiles_ref());
+    return create_new_optional(tiles_item, 0);
 }
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::create_new_optional(const sprite_tiles_item& tiles_item,
                                                                  int graphics_index)
 {
-    return create_new_optional(tiles_item.graphics_tiles_ref(graphics_index));
+    int handle;
+
+    if(tiles_item.deduplicated())
+    {
+        handle = sprite_tiles_manager::create_new_optional(tiles_item.tiles_ref().data(),
+                                                           tiles_item.graphics_tile_indexes_ref(graphics_index));
+    }
+    else
+    {
+        handle = sprite_tiles_manager::create_new_optional(tiles_item.graphics_tiles_ref(graphics_index),
+                                                           tiles_item.compression());
+    }
+
+    optional<sprite_tiles_ptr> result;
+
+    if(handle >= 0)
+    {
+        result = sprite_tiles_ptr(handle);
+    }
+
+    return result;
 }
 
 optional<sprite_tiles_ptr> sprite_tiles_ptr::allocate_optional(int tiles_count)
@@ -169,17 +242,26 @@ optional<span<const tile>> sprite_tiles_ptr::tiles_ref() const
 
 void sprite_tiles_ptr::set_tiles_ref(const span<const tile>& tiles_ref)
 {
-    sprite_tiles_manager::set_tiles_ref(_handle, tiles_ref);
+    sprite_tiles_manager::set_tiles_ref(_handle, tiles_ref, compression_type::NONE);
 }
 
 void sprite_tiles_ptr::set_tiles_ref(const sprite_tiles_item& tiles_item)
 {
-    sprite_tiles_manager::set_tiles_ref(_handle, tiles_item.graphics_tiles_ref());
+    set_tiles_ref(tiles_item, 0);
 }
 
 void sprite_tiles_ptr::set_tiles_ref(const sprite_tiles_item& tiles_item, int graphics_index)
 {
-    sprite_tiles_manager::set_tiles_ref(_handle, tiles_item.graphics_tiles_ref(graphics_index));
+    if(tiles_item.deduplicated())
+    {
+        sprite_tiles_manager::set_tiles_ref(_handle, tiles_item.tiles_ref().data(),
+                                            tiles_item.graphics_tile_indexes_ref(graphics_index));
+    }
+    else
+    {
+        sprite_tiles_manager::set_tiles_ref(_handle, tiles_item.graphics_tiles_ref(graphics_index),
+                                            tiles_item.compression());
+    }
 }
 
 void sprite_tiles_ptr::reload_tiles_ref()
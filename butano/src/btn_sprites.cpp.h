@@ -20,4 +20,59 @@ int available_items_count()
     return sprites_manager::available_items_count();
 }
 
+int hw_rebuilds_count()
+{
+    return sprites_manager::rebuilds_count();
+}
+
+int hw_rebuilt_count()
+{
+    return sprites_manager::rebuilt_count();
+}
+
+int hw_patches_count()
+{
+    return sprites_manager::patches_count();
+}
+
+int hw_patched_count()
+{
+    return sprites_manager::patched_count();
+}
+
+int hw_committed_count()
+{
+    return sprites_manager::committed_count();
+}
+
+bool multiplexer_enabled()
+{
+    return sprites_manager::multiplexer_enabled();
+}
+
+void set_multiplexer_enabled(bool enabled)
+{
+    sprites_manager::set_multiplexer_enabled(enabled);
+}
+
+bool multiplexing()
+{
+    return sprites_manager::multiplexing();
+}
+
+int multiplexer_band_used_count(int band)
+{
+    return sprites_manager::multiplexer_band_used_count(band);
+}
+
+int multiplexer_band_rewrites_count(int band)
+{
+    return sprites_manager::multiplexer_band_rewrites_count(band);
+}
+
+int multiplexer_dropped_count()
+{
+    return sprites_manager::multiplexer_dropped_count();
+}
+
 }
@@ -6,16 +6,132 @@
 #include "btn_sprites_manager.h"
 
 #include "btn_sorted_sprites.h"
+#include "btn_sprites_manager_bands.h"
+#include "btn_sprites_manager_handles.h"
 
 namespace btn::sprites_manager
 {
 
-bool _check_items_on_screen_impl(void* hw_handles, intrusive_list<sorted_sprites::layer>& layers,
-                                 bool rebuild_handles, int& first_index_to_commit, int& last_index_to_commit)
+namespace
 {
-    auto handles = reinterpret_cast<hw::sprites::handle_type*>(hw_handles);
-    int first_index = first_index_to_commit;
-    int last_index = last_index_to_commit;
+    [[nodiscard]] bool _available_handle(const sprites_manager_handles& handles, int index)
+    {
+        const sprites_manager_item* item = handles.items[index];
+        return ! item || ! item->on_screen;
+    }
+
+    void _take_handle(sprites_manager_handles& handles, int index)
+    {
+        if(sprites_manager_item* item = handles.items[index])
+        {
+            item->handles_index = -1;
+        }
+    }
+
+    void _move_handle(sprites_manager_handles& handles, int from_index, int to_index)
+    {
+        sprites_manager_item* item = handles.items[from_index];
+        handles.items[to_index] = item;
+        item->handles_index = int8_t(to_index);
+        hw::sprites::copy_handle(item->handle, handles.hw_handles[to_index]);
+    }
+
+    [[nodiscard]] bool _insert_handle(sprites_manager_item& item, int previous_index, sprites_manager_handles& handles)
+    {
+        constexpr const int count = hw::sprites::count();
+
+        int next_index = previous_index + 1;
+
+        while(next_index < count && ! handles.items[next_index])
+        {
+            ++next_index;
+        }
+
+        int index;
+        int first_index;
+        int last_index;
+
+        if(next_index - previous_index > 1)
+        {
+            // Insert the item in the middle of the unused handles to leave room for the next insertions:
+            index = (previous_index + next_index) / 2;
+            first_index = index;
+            last_index = index;
+        }
+        else
+        {
+            // Move the items between the nearest available handle and the insertion point:
+            int right_index = next_index;
+
+            while(right_index < count && ! _available_handle(handles, right_index))
+            {
+                ++right_index;
+            }
+
+            int left_index = previous_index;
+
+            while(left_index >= 0 && ! _available_handle(handles, left_index))
+            {
+                --left_index;
+            }
+
+            bool right_valid = right_index < count;
+            bool left_valid = left_index >= 0;
+
+            if(right_valid && (! left_valid || right_index - next_index <= previous_index - left_index))
+            {
+                _take_handle(handles, right_index);
+
+                for(int move_index = right_index; move_index > next_index; --move_index)
+                {
+                    _move_handle(handles, move_index - 1, move_index);
+                }
+
+                index = next_index;
+                first_index = next_index;
+                last_index = right_index;
+            }
+            else if(left_valid)
+            {
+                _take_handle(handles, left_index);
+
+                for(int move_index = left_index; move_index < previous_index; ++move_index)
+                {
+                    _move_handle(handles, move_index + 1, move_index);
+                }
+
+                index = previous_index;
+                first_index = left_index;
+                last_index = previous_index;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        handles.items[index] = &item;
+        item.handles_index = int8_t(index);
+        hw::sprites::copy_handle(item.handle, handles.hw_handles[index]);
+        handles.used_count = max(handles.used_count, last_index + 1);
+        handles.update_indexes_to_commit(first_index, last_index);
+        ++handles.patches_count;
+        handles.patched_count += last_index - first_index + 1;
+        return true;
+    }
+
+    [[nodiscard]] int _top_band(const sprites_manager_item& item)
+    {
+        return max(int(item.hw_position.y()), 0) / sprites_manager_bands::band_height;
+    }
+}
+
+bool _check_items_on_screen_impl(sprites_manager_handles& handles, intrusive_list<sorted_sprites::layer>& layers,
+                                 bool rebuild_handles)
+{
+    int first_index = handles.first_index_to_commit;
+    int last_index = handles.last_index_to_commit;
+    int previous_handles_index = -1;
 
     for(sorted_sprites::layer& layer : layers)
     {
@@ -70,7 +186,7 @@ bool _check_items_on_screen_impl(void* hw_handles, intrusive_list<sorted_sprites
 
                     if(handles_index != -1)
                     {
-                        hw::sprites::copy_handle(item.handle, handles[handles_index]);
+                        hw::sprites::copy_handle(item.handle, handles.hw_handles[handles_index]);
 
                         if(handles_index < first_index)
                         {
@@ -82,25 +198,45 @@ bool _check_items_on_screen_impl(void* hw_handles, intrusive_list<sorted_sprites
                             last_index = handles_index;
                         }
                     }
-                    else
+                    else if(on_screen)
                     {
-                        rebuild_handles = true;
+                        handles.first_index_to_commit = first_index;
+                        handles.last_index_to_commit = last_index;
+
+                        if(_insert_handle(item, previous_handles_index, handles))
+                        {
+                            first_index = handles.first_index_to_commit;
+                            last_index = handles.last_index_to_commit;
+                        }
+                        else
+                        {
+                            rebuild_handles = true;
+                        }
                     }
                 }
             }
+
+            if(item.handles_index != -1)
+            {
+                previous_handles_index = item.handles_index;
+            }
         }
     }
 
-    first_index_to_commit = first_index;
-    last_index_to_commit = last_index;
+    handles.first_index_to_commit = first_index;
+    handles.last_index_to_commit = last_index;
     return rebuild_handles;
 }
 
-int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles,
-                          intrusive_list<sorted_sprites::layer>& layers)
+void _rebuild_handles_impl(sprites_manager_handles& handles, intrusive_list<sorted_sprites::layer>& layers)
 {
-    auto handles = reinterpret_cast<hw::sprites::handle_type*>(hw_handles);
-    int visible_items_count = 0;
+    int last_used_count = handles.used_count;
+    int used_count = 0;
+
+    for(sprites_manager_item*& item_ptr : handles.items)
+    {
+        item_ptr = nullptr;
+    }
 
     for(sorted_sprites::layer& layer : layers)
     {
@@ -109,11 +245,12 @@ int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles,
             if(item.on_screen)
             {
                 BTN_ASSERT(BTN_CFG_SPRITES_MAX_ITEMS <= hw::sprites::count() ||
-                           visible_items_count <= hw::sprites::count(), "Too much sprites on screen");
+                           used_count < hw::sprites::count(), "Too much sprites on screen");
 
-                hw::sprites::copy_handle(item.handle, handles[visible_items_count]);
-                item.handles_index = int8_t(visible_items_count);
-                ++visible_items_count;
+                hw::sprites::copy_handle(item.handle, handles.hw_handles[used_count]);
+                handles.items[used_count] = &item;
+                item.handles_index = int8_t(used_count);
+                ++used_count;
             }
             else
             {
@@ -122,12 +259,197 @@ int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles,
         }
     }
 
-    for(int index = visible_items_count; index < last_visible_items_count; ++index)
+    for(int index = used_count; index < last_used_count; ++index)
+    {
+        hw::sprites::hide(handles.hw_handles[index]);
+    }
+
+    int to_commit_count = max(used_count, last_used_count);
+    handles.used_count = used_count;
+    ++handles.rebuilds_count;
+    handles.rebuilt_count += to_commit_count;
+
+    if(to_commit_count)
+    {
+        handles.first_index_to_commit = 0;
+        handles.last_index_to_commit = max(handles.last_index_to_commit, to_commit_count - 1);
+    }
+}
+
+bool _multiplex_handles_impl(sprites_manager_handles& handles, sprites_manager_bands& bands,
+                             intrusive_list<sorted_sprites::layer>& layers)
+{
+    constexpr const int hw_count = hw::sprites::count();
+    constexpr const int bands_count = sprites_manager_bands::count;
+    constexpr const int band_height = sprites_manager_bands::band_height;
+    constexpr const int max_band_rewrites = sprites_manager_bands::max_band_rewrites;
+
+    // Sprites are sorted by the band of their top scanline keeping their priority order (counting sort):
+    int band_indexes[bands_count + 1] = {};
+    int on_screen_count = 0;
+
+    for(sorted_sprites::layer& layer : layers)
+    {
+        for(sprites_manager_item& item : layer.items())
+        {
+            if(item.on_screen)
+            {
+                ++band_indexes[_top_band(item) + 1];
+                ++on_screen_count;
+            }
+        }
+    }
+
+    if(on_screen_count <= hw_count)
+    {
+        bands.hw_bands_count = 0;
+        bands.dropped_count = 0;
+
+        for(int band = 0; band < bands_count; ++band)
+        {
+            bands.used_counts[band] = 0;
+            bands.rewrites_counts[band] = 0;
+        }
+
+        _rebuild_handles_impl(handles, layers);
+        return false;
+    }
+
+    for(int band = 0; band < bands_count; ++band)
+    {
+        band_indexes[band + 1] += band_indexes[band];
+    }
+
+    sprites_manager_item** sorted_items = bands.sorted_items;
+
+    for(sorted_sprites::layer& layer : layers)
+    {
+        for(sprites_manager_item& item : layer.items())
+        {
+            item.handles_index = -1;
+
+            if(item.on_screen)
+            {
+                int& sorted_index = band_indexes[_top_band(item)];
+                sorted_items[sorted_index] = &item;
+                ++sorted_index;
+            }
+        }
+    }
+
+    // Hardware sprites are assigned to the sorted sprites. Unused hardware sprites are assigned first,
+    // since they don't need to be rewritten. Otherwise, a hardware sprite is rewritten in a band
+    // if the previous sprite assigned to it is not displayed anymore.
+    // Rewrites of a band must fit in one H-Blank, so sprites which need more of them are dropped:
+    int8_t released_heads[bands_count];
+    int8_t released_nexts[hw_count];
+    int8_t free_indexes[hw_count];
+    int used_counts[bands_count + 1] = {};
+    int free_indexes_count = 0;
+    int unused_index = 0;
+    int rewrites_count = 0;
+    int hw_bands_count = 0;
+    int dropped_count = 0;
+    hw::sprites::handle_type* rewrites = bands.rewrites();
+    hw::sprites_multiplexer::band* hw_bands = bands.hw_bands();
+
+    for(int8_t& released_head : released_heads)
+    {
+        released_head = -1;
+    }
+
+    for(int band = 0, sorted_index = 0; band < bands_count; ++band)
+    {
+        for(int released_index = released_heads[band]; released_index != -1;
+            released_index = released_nexts[released_index])
+        {
+            free_indexes[free_indexes_count] = int8_t(released_index);
+            ++free_indexes_count;
+        }
+
+        int first_rewrite_index = rewrites_count;
+
+        for(int sorted_last_index = band_indexes[band]; sorted_index < sorted_last_index; ++sorted_index)
+        {
+            sprites_manager_item& item = *sorted_items[sorted_index];
+            int handles_index;
+
+            if(unused_index < hw_count)
+            {
+                handles_index = unused_index;
+                hw::sprites::copy_handle(item.handle, handles.hw_handles[handles_index]);
+                ++unused_index;
+            }
+            else if(free_indexes_count && rewrites_count - first_rewrite_index < max_band_rewrites)
+            {
+                --free_indexes_count;
+                handles_index = free_indexes[free_indexes_count];
+
+                hw::sprites::handle_type& rewrite = rewrites[rewrites_count];
+                hw::sprites::copy_handle(item.handle, rewrite);
+                rewrite.fill = int16_t(handles_index);
+                ++rewrites_count;
+            }
+            else
+            {
+                ++dropped_count;
+                continue;
+            }
+
+            // The hardware sprite can be rewritten when the sprite is not displayed in the rewrite scanline:
+            int bottom = min(item.hw_position.y() + (item.half_height * 2), hw::display::height());
+            int release_band = min((bottom + band_height - 1 + hw::sprites_multiplexer::rewrite_scanlines()) /
+                                   band_height, bands_count);
+            ++used_counts[band];
+            --used_counts[release_band];
+
+            if(release_band < bands_count)
+            {
+                released_nexts[handles_index] = released_heads[release_band];
+                released_heads[release_band] = int8_t(handles_index);
+            }
+        }
+
+        int band_rewrites_count = rewrites_count - first_rewrite_index;
+        bands.rewrites_counts[band] = uint8_t(band_rewrites_count);
+
+        if(band_rewrites_count)
+        {
+            hw::sprites_multiplexer::band& hw_band = hw_bands[hw_bands_count];
+            hw_band.entries_ptr = rewrites + first_rewrite_index;
+            hw_band.entries_count = band_rewrites_count;
+            hw_band.scanline = band * band_height;
+            ++hw_bands_count;
+        }
+    }
+
+    for(int band = 0, used_count = 0; band < bands_count; ++band)
+    {
+        used_count += used_counts[band];
+        bands.used_counts[band] = uint8_t(used_count);
+    }
+
+    for(sprites_manager_item*& item_ptr : handles.items)
+    {
+        item_ptr = nullptr;
+    }
+
+    int to_commit_count = max(unused_index, handles.used_count);
+
+    for(int index = unused_index; index < to_commit_count; ++index)
     {
-        hw::sprites::hide(handles[index]);
+        hw::sprites::hide(handles.hw_handles[index]);
     }
 
-    return visible_items_count;
+    // Rewritten hardware sprites must be restored in every frame:
+    handles.used_count = unused_index;
+    ++handles.rebuilds_count;
+    handles.rebuilt_count += to_commit_count;
+    handles.first_index_to_commit = 0;
+    handles.last_index_to_commit = max(handles.last_index_to_commit, to_commit_count - 1);
+    bands.hw_bands_count = hw_bands_count;
+    bands.dropped_count = dropped_count;
+    return true;
 }
 
 bool _update_cameras_impl(sorted_sprites::layer& layer)
@@ -9,6 +9,9 @@
 #include "btn_sprite_first_attributes.h"
 #include "btn_sprite_regular_second_attributes.h"
 #include "btn_sorted_sprites.h"
+#include "btn_sprites_manager_bands.h"
+#include "btn_sprites_manager_handles.h"
+#include "btn_sprite_tiles_manager.h"
 #include "../hw/include/btn_hw_sprite_affine_mats_constants.h"
 
 #include "btn_sprites.cpp.h"
@@ -33,11 +36,10 @@ namespace
 
     public:
         pool<item_type, BTN_CFG_SPRITES_MAX_ITEMS> items_pool;
-        hw::sprites::handle_type handles[hw::sprites::count()];
+        sprites_manager_handles handles;
+        sprites_manager_bands bands;
         sorted_sprites::sorter sorter;
-        int first_index_to_commit = 0;
-        int last_index_to_commit = hw::sprites::count() - 1;
-        int last_visible_items_count = 0;
+        int tiles_relocations_count = 0;
         bool check_items_on_screen = false;
         bool rebuild_handles = false;
     };
@@ -50,17 +52,33 @@ namespace
 
         if(handles_index != -1)
         {
-            hw::sprites::copy_handle(item.handle, data.handles[handles_index]);
+            hw::sprites::copy_handle(item.handle, data.handles.hw_handles[handles_index]);
+            data.handles.update_indexes_to_commit(handles_index, handles_index);
+        }
+    }
 
-            if(handles_index < data.first_index_to_commit)
-            {
-                data.first_index_to_commit = handles_index;
-            }
+    void _release_handle(item_type& item)
+    {
+        int handles_index = item.handles_index;
 
-            if(handles_index > data.last_index_to_commit)
-            {
-                data.last_index_to_commit = handles_index;
-            }
+        if(handles_index != -1)
+        {
+            hw::sprites::hide(data.handles.hw_handles[handles_index]);
+            data.handles.items[handles_index] = nullptr;
+            data.handles.update_indexes_to_commit(handles_index, handles_index);
+            item.handles_index = -1;
+        }
+    }
+
+    void _update_item_order(item_type& item)
+    {
+        // Items are sorted by their handles index, so they are inserted again in the right position:
+        _release_handle(item);
+
+        if(item.visible)
+        {
+            item.check_on_screen = true;
+            data.check_items_on_screen = true;
         }
     }
 
@@ -121,21 +139,54 @@ namespace
         }
     }
 
+    void _set_shared_affine_mat_attributes(item_type& item, const sprite_affine_mat_attributes& attributes)
+    {
+        if(attributes.flipped_identity() && item.remove_affine_mat_when_not_needed)
+        {
+            _remove_affine_mat(item);
+            hw::sprites::set_horizontal_flip(attributes.horizontal_flip(), item.handle);
+            hw::sprites::set_vertical_flip(attributes.vertical_flip(), item.handle);
+        }
+        else if(! sprite_affine_mats_manager::update_shared(item.affine_mat->id(), attributes))
+        {
+            _assign_affine_mat(item, sprite_affine_mat_ptr::create_shared(attributes));
+        }
+    }
+
+    void _update_tiles_ids()
+    {
+        // Sprite tiles have been moved to another VRAM location:
+        for(sorted_sprites::layer& layer : data.sorter.layers())
+        {
+            for(item_type& item : layer.items())
+            {
+                if(const optional<sprite_tiles_ptr>& tiles = item.tiles)
+                {
+                    int tiles_id = tiles->id();
+
+                    if(hw::sprites::tiles_id(item.handle) != tiles_id)
+                    {
+                        hw::sprites::set_tiles(tiles_id, item.handle);
+                        _update_indexes_to_commit(item);
+                    }
+                }
+            }
+        }
+    }
+
     void _rebuild_handles()
     {
         if(data.rebuild_handles)
         {
-            hw::sprites::handle_type* handles = data.handles;
-            int last_visible_items_count = data.last_visible_items_count;
-            int visible_items_count = _rebuild_handles_impl(last_visible_items_count, handles, data.sorter.layers());
-            int to_commit_items_count = max(visible_items_count, last_visible_items_count);
             data.rebuild_handles = false;
-            data.last_visible_items_count = visible_items_count;
 
-            if(to_commit_items_count)
+            if(data.bands.enabled)
+            {
+                data.bands.multiplexing = _multiplex_handles_impl(data.handles, data.bands, data.sorter.layers());
+            }
+            else
             {
-                data.first_index_to_commit = 0;
-                data.last_index_to_commit = to_commit_items_count - 1;
+                _rebuild_handles_impl(data.handles, data.sorter.layers());
             }
         }
     }
@@ -146,8 +197,7 @@ namespace
         {
             data.check_items_on_screen = false;
 
-            if(_check_items_on_screen_impl(data.handles, data.sorter.layers(), data.rebuild_handles,
-                                           data.first_index_to_commit, data.last_index_to_commit))
+            if(_check_items_on_screen_impl(data.handles, data.sorter.layers(), data.rebuild_handles))
             {
                 data.rebuild_handles = true;
             }
@@ -157,12 +207,12 @@ namespace
 
 void init()
 {
-    for(hw::sprites::handle_type& handle : data.handles)
+    for(hw::sprites::handle_type& handle : data.handles.hw_handles)
     {
         hw::sprites::hide(handle);
     }
 
-    sprite_affine_mats_manager::init(sizeof(data.handles), data.handles);
+    sprite_affine_mats_manager::init(sizeof(data.handles.hw_handles), data.handles.hw_handles);
 }
 
 int used_items_count()
@@ -183,7 +233,6 @@ id_type create(const fixed_point& position, const sprite_shape_size& shape_size,
     item_type& new_item = data.items_pool.create(position, shape_size, move(tiles), move(palette));
     data.sorter.insert(new_item);
     data.check_items_on_screen = true;
-    data.rebuild_handles = true;
     return &new_item;
 }
 
@@ -198,7 +247,6 @@ id_type create_optional(const fixed_point& position, const sprite_shape_size& sh
     item_type& new_item = data.items_pool.create(position, shape_size, move(tiles), move(palette));
     data.sorter.insert(new_item);
     data.check_items_on_screen = true;
-    data.rebuild_handles = true;
     return &new_item;
 }
 
@@ -214,7 +262,6 @@ id_type create(sprite_builder&& builder)
     if(new_item.visible)
     {
         data.check_items_on_screen = true;
-        data.rebuild_handles = true;
     }
 
     return &new_item;
@@ -247,7 +294,6 @@ id_type create_optional(sprite_builder&& builder)
     if(new_item.visible)
     {
         data.check_items_on_screen = true;
-        data.rebuild_handles = true;
     }
 
     return &new_item;
@@ -273,12 +319,7 @@ void decrease_usages(id_type id)
             sprite_affine_mats_manager::dettach_sprite(item->affine_mat->id(), item->affine_mat_attach_node);
         }
 
-        if(item->visible)
-        {
-            hw::sprites::hide(item->handle);
-            _update_indexes_to_commit(*item);
-        }
-
+        _release_handle(*item);
         data.items_pool.destroy(*item);
     }
 }
@@ -602,7 +643,7 @@ void set_bg_priority(id_type id, int bg_priority)
         data.sorter.erase(*item);
         item->set_bg_priority(bg_priority);
         data.sorter.insert(*item);
-        data.rebuild_handles = true;
+        _update_item_order(*item);
     }
 }
 
@@ -621,7 +662,7 @@ void set_z_order(id_type id, int z_order)
         data.sorter.erase(*item);
         item->set_z_order(z_order);
         data.sorter.insert(*item);
-        data.rebuild_handles = true;
+        _update_item_order(*item);
     }
 }
 
@@ -631,7 +672,7 @@ void put_above(id_type id)
 
     if(sorted_sprites::sorter::put_in_front_of_layer(*item))
     {
-        data.rebuild_handles = true;
+        _update_item_order(*item);
     }
 }
 
@@ -653,7 +694,10 @@ void set_horizontal_flip(id_type id, bool horizontal_flip)
 
     if(item->affine_mat)
     {
-        item->affine_mat->set_horizontal_flip(horizontal_flip);
+        update_affine_mat(id, [horizontal_flip](auto& affine_mat)
+        {
+            affine_mat.set_horizontal_flip(horizontal_flip);
+        });
     }
     else
     {
@@ -685,7 +729,10 @@ void set_vertical_flip(id_type id, bool vertical_flip)
 
     if(item->affine_mat)
     {
-        item->affine_mat->set_vertical_flip(vertical_flip);
+        update_affine_mat(id, [vertical_flip](auto& affine_mat)
+        {
+            affine_mat.set_vertical_flip(vertical_flip);
+        });
     }
     else
     {
@@ -901,6 +948,26 @@ void remove_affine_mat(id_type id)
     }
 }
 
+template<typename Setter>
+void update_affine_mat(id_type id, const Setter& setter)
+{
+    auto item = static_cast<item_type*>(id);
+    BTN_ASSERT(item->affine_mat, "Sprite has no affine mat");
+
+    sprite_affine_mat_ptr& affine_mat = *item->affine_mat;
+
+    if(affine_mat.shared())
+    {
+        sprite_affine_mat_attributes attributes = affine_mat.attributes();
+        setter(attributes);
+        _set_shared_affine_mat_attributes(*item, attributes);
+    }
+    else
+    {
+        setter(affine_mat);
+    }
+}
+
 bool remove_affine_mat_when_not_needed(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
@@ -1201,33 +1268,134 @@ void update_affine_mat_double_size(id_type id, bool new_double_size)
     }
 }
 
+bool multiplexer_enabled()
+{
+    return data.bands.enabled;
+}
+
+void set_multiplexer_enabled(bool enabled)
+{
+    if(data.bands.enabled != enabled)
+    {
+        data.bands.enabled = enabled;
+        data.bands.multiplexing = false;
+        data.rebuild_handles = true;
+    }
+}
+
+bool multiplexing()
+{
+    return data.bands.multiplexing;
+}
+
+int multiplexer_band_used_count(int band)
+{
+    BTN_ASSERT(band >= 0 && band < sprites_manager_bands::count, "Invalid band: ", band);
+
+    return data.bands.used_counts[band];
+}
+
+int multiplexer_band_rewrites_count(int band)
+{
+    BTN_ASSERT(band >= 0 && band < sprites_manager_bands::count, "Invalid band: ", band);
+
+    return data.bands.rewrites_counts[band];
+}
+
+int multiplexer_dropped_count()
+{
+    return data.bands.dropped_count;
+}
+
 void update()
 {
     sprite_affine_mats_manager::update();
+
+    if(int tiles_relocations_count = sprite_tiles_manager::relocations_count();
+            tiles_relocations_count != data.tiles_relocations_count)
+    {
+        data.tiles_relocations_count = tiles_relocations_count;
+        _update_tiles_ids();
+    }
+
+    if(data.bands.multiplexing)
+    {
+        // Multiplexed sprites don't have a fixed hardware sprite, so they are assigned again in every frame:
+        data.rebuild_handles = true;
+    }
+
     _check_items_on_screen();
     _rebuild_handles();
 }
 
+int rebuilds_count()
+{
+    return data.handles.rebuilds_count;
+}
+
+int rebuilt_count()
+{
+    return data.handles.rebuilt_count;
+}
+
+int patches_count()
+{
+    return data.handles.patches_count;
+}
+
+int patched_count()
+{
+    return data.handles.patched_count;
+}
+
+int committed_count()
+{
+    return data.handles.committed_count;
+}
+
 void commit()
 {
-    int first_index_to_commit = data.first_index_to_commit;
-    int last_index_to_commit = data.last_index_to_commit;
+    // Committing up to 4 unmodified sprites (32 bytes) costs less than the setup of another transfer:
+    indexes_to_commit<hw::sprites::count(), 4> indexes_to_commit;
+    int first_index_to_commit = data.handles.first_index_to_commit;
 
-    if(auto affine_mats_commit_data = sprite_affine_mats_manager::retrieve_commit_data())
+    if(first_index_to_commit < hw::sprites::count())
     {
-        int multiplier = hw::sprites::count() / hw::sprite_affine_mats::count();
-        int first_mat_index_to_commit = affine_mats_commit_data->offset * multiplier;
-        int last_mat_index_to_commit = first_mat_index_to_commit + (affine_mats_commit_data->count * multiplier) - 1;
-        first_index_to_commit = min(first_index_to_commit, first_mat_index_to_commit);
-        last_index_to_commit = max(last_index_to_commit, last_mat_index_to_commit);
+        indexes_to_commit.add(first_index_to_commit, data.handles.last_index_to_commit - first_index_to_commit + 1);
     }
 
-    if(first_index_to_commit < hw::sprites::count())
+    // Each affine matrix is stored in the fourth attribute of multiple sprites:
+    int multiplier = hw::sprites::count() / hw::sprite_affine_mats::count();
+    sprite_affine_mats_manager::retrieve_indexes_to_commit().for_each_range(
+                [multiplier, &indexes_to_commit](int first_mat_index, int mats_count)
+    {
+        indexes_to_commit.add(first_mat_index * multiplier, mats_count * multiplier);
+    });
+
+    int commit_items_count = 0;
+
+    indexes_to_commit.for_each_range([&commit_items_count](int first_index, int count)
+    {
+        hw::sprites::commit(data.handles.hw_handles[0], first_index, count);
+        commit_items_count += count;
+    });
+
+    data.handles.first_index_to_commit = hw::sprites::count();
+    data.handles.last_index_to_commit = 0;
+    data.handles.committed_count = commit_items_count;
+
+    sprites_manager_bands& bands = data.bands;
+
+    if(bands.multiplexing && bands.hw_bands_count)
+    {
+        hw::sprites_multiplexer::commit(bands.hw_bands(), bands.hw_bands_count);
+        bands.a_active = ! bands.a_active;
+        bands.committed = true;
+    }
+    else if(bands.committed)
     {
-        int commit_items_count = last_index_to_commit - first_index_to_commit + 1;
-        hw::sprites::commit(data.handles[0], first_index_to_commit, commit_items_count);
-        data.first_index_to_commit = hw::sprites::count();
-        data.last_index_to_commit = 0;
+        hw::sprites_multiplexer::stop();
+        bands.committed = false;
     }
 }
 
@@ -24,6 +24,9 @@ class sprite_palette_ptr;
 class sprite_affine_mat_ptr;
 class sprite_first_attributes;
 class sprite_third_attributes;
+class sprites_manager_bands;
+class sprites_manager_handles;
+class sprite_affine_mat_attributes;
 class sprite_regular_second_attributes;
 class sprite_affine_second_attributes;
 enum class sprite_size;
@@ -159,6 +162,11 @@ namespace sprites_manager
 
     void remove_affine_mat(id_type id);
 
+    // Calls setter(affine_mat) if the sprite affine mat is not shared,
+    // otherwise calls setter(attributes) with a copy of its attributes and applies them:
+    template<typename Setter>
+    void update_affine_mat(id_type id, const Setter& setter);
+
     [[nodiscard]] bool remove_affine_mat_when_not_needed(id_type id);
 
     void set_remove_affine_mat_when_not_needed(id_type id, bool remove_when_not_needed);
@@ -207,16 +215,41 @@ namespace sprites_manager
 
     void update_affine_mat_double_size(id_type id, bool new_double_size);
 
+    [[nodiscard]] int rebuilds_count();
+
+    [[nodiscard]] int rebuilt_count();
+
+    [[nodiscard]] int patches_count();
+
+    [[nodiscard]] int patched_count();
+
+    [[nodiscard]] int committed_count();
+
+    [[nodiscard]] bool multiplexer_enabled();
+
+    void set_multiplexer_enabled(bool enabled);
+
+    [[nodiscard]] bool multiplexing();
+
+    [[nodiscard]] int multiplexer_band_used_count(int band);
+
+    [[nodiscard]] int multiplexer_band_rewrites_count(int band);
+
+    [[nodiscard]] int multiplexer_dropped_count();
+
     void update();
 
     void commit();
 
     [[nodiscard]] BTN_CODE_IWRAM bool _check_items_on_screen_impl(
-            void* hw_handles, intrusive_list<sorted_sprites::layer>& layers, bool rebuild_handles,
-            int& first_index_to_commit, int& last_index_to_commit);
+            sprites_manager_handles& handles, intrusive_list<sorted_sprites::layer>& layers, bool rebuild_handles);
+
+    BTN_CODE_IWRAM void _rebuild_handles_impl(
+            sprites_manager_handles& handles, intrusive_list<sorted_sprites::layer>& layers);
 
-    [[nodiscard]] BTN_CODE_IWRAM int _rebuild_handles_impl(
-            int last_visible_items_count, void* hw_handles, intrusive_list<sorted_sprites::layer>& layers);
+    [[nodiscard]] BTN_CODE_IWRAM bool _multiplex_handles_impl(
+            sprites_manager_handles& handles, sprites_manager_bands& bands,
+            intrusive_list<sorted_sprites::layer>& layers);
 
     [[nodiscard]] BTN_CODE_IWRAM bool _update_cameras_impl(sorted_sprites::layer& layer);
 }
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_SPRITES_MANAGER_BANDS_H
+#define BTN_SPRITES_MANAGER_BANDS_H
+
+#include "btn_algorithm.h"
+#include "btn_config_sprites.h"
+#include "../hw/include/btn_hw_display_constants.h"
+#include "../hw/include/btn_hw_sprites_multiplexer.h"
+
+namespace btn
+{
+
+class sprites_manager_item;
+
+// Horizontal screen bands used to show more than 128 sprites.
+// Hardware sprites which are not needed anymore in a band are rewritten with the sprites which appear in it,
+// so each band can show up to 128 sprites.
+class sprites_manager_bands
+{
+
+public:
+    static constexpr int band_height = BTN_CFG_SPRITES_MULTIPLEXER_BAND_HEIGHT;
+    static constexpr int count = (hw::display::height() + band_height - 1) / band_height;
+    static constexpr int max_rewrites = max(BTN_CFG_SPRITES_MAX_ITEMS - hw::sprites::count(), 1);
+    static constexpr int max_band_rewrites = BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES;
+
+    static_assert(band_height > hw::sprites_multiplexer::rewrite_scanlines() * 2);
+    static_assert(band_height <= hw::display::height());
+    static_assert(max_band_rewrites > 0 && max_band_rewrites <= hw::sprites::count());
+
+    sprites_manager_item* sorted_items[BTN_CFG_SPRITES_MAX_ITEMS];
+    hw::sprites::handle_type rewrites_a[max_rewrites];
+    hw::sprites::handle_type rewrites_b[max_rewrites];
+    hw::sprites_multiplexer::band hw_bands_a[count];
+    hw::sprites_multiplexer::band hw_bands_b[count];
+    int hw_bands_count = 0;
+    int dropped_count = 0;
+    uint8_t used_counts[count] = {};
+    uint8_t rewrites_counts[count] = {};
+    bool enabled = false;
+    bool multiplexing = false;
+    bool committed = false;
+    bool a_active = false;
+
+    // Buffers which are not being read by the hardware sprites multiplexer:
+    [[nodiscard]] hw::sprites::handle_type* rewrites()
+    {
+        return a_active ? rewrites_b : rewrites_a;
+    }
+
+    [[nodiscard]] hw::sprites_multiplexer::band* hw_bands()
+    {
+        return a_active ? hw_bands_b : hw_bands_a;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_SPRITES_MANAGER_HANDLES_H
+#define BTN_SPRITES_MANAGER_HANDLES_H
+
+#include "btn_algorithm.h"
+#include "../hw/include/btn_hw_sprites.h"
+#include "../hw/include/btn_hw_sprites_constants.h"
+
+namespace btn
+{
+
+class sprites_manager_item;
+
+// Hardware sprites sorted by priority.
+// Items with a handles index are sorted by it, but there can be unused handles between them,
+// so most items can be inserted without moving other items.
+class sprites_manager_handles
+{
+
+public:
+    hw::sprites::handle_type hw_handles[hw::sprites::count()];
+    sprites_manager_item* items[hw::sprites::count()] = {};
+    int first_index_to_commit = 0;
+    int last_index_to_commit = hw::sprites::count() - 1;
+    int used_count = 0;
+    int rebuilds_count = 0;
+    int rebuilt_count = 0;
+    int patches_count = 0;
+    int patched_count = 0;
+    int committed_count = 0;
+
+    void update_indexes_to_commit(int first_index, int last_index)
+    {
+        first_index_to_commit = min(first_index_to_commit, first_index);
+        last_index_to_commit = max(last_index_to_commit, last_index);
+    }
+};
+
+}
+
+#endif
@@ -120,7 +120,7 @@ void ostringstream::append(long value)
     _string->append(buffer.data(), size);
 }
 
-void ostringstream::append(int64_t value)
+void ostringstream::append(long long value)
 {
     array<char, 32> buffer;
     int size = hw::text::parse(value, buffer);
@@ -141,7 +141,7 @@ void ostringstream::append(unsigned long value)
     _string->append(buffer.data(), size);
 }
 
-void ostringstream::append(uint64_t value)
+void ostringstream::append(unsigned long long value)
 {
     array<char, 32> buffer;
     int size = hw::text::parse(value, buffer);
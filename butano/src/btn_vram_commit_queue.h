@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_VRAM_COMMIT_QUEUE_H
+#define BTN_VRAM_COMMIT_QUEUE_H
+
+#include "btn_vector.h"
+#include "btn_config_vram_commits.h"
+#include "btn_vram_commits_manager.h"
+
+namespace btn
+{
+
+enum class vram_commit_priority : uint8_t
+{
+    FORCED, // Committed in the current frame even if it doesn't fit in the budget.
+    HIGH,
+    NORMAL
+};
+
+
+template<int MaxSize>
+class vram_commit_queue
+{
+    static_assert(MaxSize > 0);
+
+public:
+    [[nodiscard]] bool empty() const
+    {
+        return _entries.empty();
+    }
+
+    [[nodiscard]] bool contains(int id) const
+    {
+        for(const entry& queue_entry : _entries)
+        {
+            if(queue_entry.id == id)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Streamed entries can be committed over multiple frames if they don't fit in the budget.
+    void push(int id, vram_commit_priority priority, bool streamed = false)
+    {
+        auto priority_value = uint8_t(priority);
+        auto end = _entries.end();
+
+        // If the entry is already queued, keep it unless its priority must be raised:
+        for(auto it = _entries.begin(); it != end; ++it)
+        {
+            if(it->id == id)
+            {
+                if(it->priority <= priority_value)
+                {
+                    it->streamed = streamed;
+                    return;
+                }
+
+                _entries.erase(it);
+                end = _entries.end();
+                break;
+            }
+        }
+
+        BTN_ASSERT(! _entries.full(), "Commit queue is full");
+
+        // Entries are sorted by priority, and by age (oldest first) for entries with the same priority:
+        auto it = _entries.begin();
+
+        while(it != end && it->priority <= priority_value)
+        {
+            ++it;
+        }
+
+        _entries.insert(it, entry{ uint16_t(id), priority_value, 0, streamed });
+    }
+
+    void erase(int id)
+    {
+        for(auto it = _entries.begin(), end = _entries.end(); it != end; ++it)
+        {
+            if(it->id == id)
+            {
+                if(_streaming_id == id)
+                {
+                    _streaming_id = -1;
+                }
+
+                _entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        _streaming_id = -1;
+    }
+
+    // Id of the streamed entry which has been partially committed, or -1 if there's none.
+    // Only one entry can be partially committed at the same time.
+    [[nodiscard]] int streaming_id() const
+    {
+        return _streaming_id;
+    }
+
+    // bytes_function returns the number of bytes to upload for the given id.
+    // commit_function uploads the given id.
+    template<typename BytesFunction, typename CommitFunction>
+    void commit(const BytesFunction& bytes_function, const CommitFunction& commit_function)
+    {
+        commit(bytes_function, commit_function, [](int, int) { return true; });
+    }
+
+    // bytes_function returns the number of bytes left to upload for the given id.
+    // commit_function uploads the given id.
+    // stream_function uploads up to the given number of bytes of a streamed id, returning true when it's done.
+    template<typename BytesFunction, typename CommitFunction, typename StreamFunction>
+    void commit(const BytesFunction& bytes_function, const CommitFunction& commit_function,
+                const StreamFunction& stream_function)
+    {
+        int output_index = 0;
+        bool blocked = false;
+
+        for(int index = 0, size = _entries.size(); index < size; ++index)
+        {
+            entry current_entry = _entries[index];
+            int id = current_entry.id;
+            int bytes = bytes_function(id);
+            int streamed_bytes = 0;
+            bool commit;
+
+            if(current_entry.priority == uint8_t(vram_commit_priority::FORCED) ||
+                    current_entry.age >= BTN_CFG_VRAM_COMMITS_MAX_DEFERRED_FRAMES)
+            {
+                vram_commits_manager::force(bytes);
+                commit = true;
+            }
+            else if(blocked)
+            {
+                commit = false;
+            }
+            else
+            {
+                int available_bytes = vram_commits_manager::available_bytes();
+
+                if(current_entry.streamed && bytes > available_bytes && available_bytes > 0 &&
+                        (_streaming_id == -1 || _streaming_id == id))
+                {
+                    // Streamed entries which don't fit are partially committed with the rest of the budget:
+                    _streaming_id = id;
+                    streamed_bytes = available_bytes;
+                    vram_commits_manager::force(streamed_bytes);
+                    stream_function(id, streamed_bytes);
+                    commit = false;
+                }
+                else
+                {
+                    commit = vram_commits_manager::reserve(bytes);
+                }
+
+                // Once an entry doesn't fit, the next ones are delayed too to avoid starving it:
+                blocked = ! commit;
+            }
+
+            if(commit)
+            {
+                if(current_entry.streamed)
+                {
+                    stream_function(id, bytes);
+                }
+                else
+                {
+                    commit_function(id);
+                }
+
+                if(_streaming_id == id)
+                {
+                    _streaming_id = -1;
+                }
+            }
+            else
+            {
+                vram_commits_manager::defer(bytes - streamed_bytes);
+
+                // Entries which have been partially committed are not starved:
+                if(! streamed_bytes)
+                {
+                    ++current_entry.age;
+                }
+
+                _entries[output_index] = current_entry;
+                ++output_index;
+            }
+        }
+
+        _entries.shrink(output_index);
+    }
+
+private:
+    struct entry
+    {
+        uint16_t id;
+        uint8_t priority;
+        uint8_t age;
+        bool streamed;
+    };
+
+    vector<entry, MaxSize> _entries;
+    int _streaming_id = -1;
+};
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_VRAM_COMMIT_STREAM_H
+#define BTN_VRAM_COMMIT_STREAM_H
+
+#include "btn_memory.h"
+#include "btn_decompressor.h"
+#include "btn_vram_commits_manager.h"
+
+namespace btn
+{
+
+// Compressed data committed over multiple frames.
+//
+// Items being streamed can be displayed, so data is decompressed in an EWRAM staging buffer
+// and VRAM is written at once when all of it has been decompressed: partially uploaded data is never displayed.
+class vram_commit_stream
+{
+
+public:
+    vram_commit_stream() = default;
+
+    vram_commit_stream(const vram_commit_stream& other) = delete;
+
+    vram_commit_stream& operator=(const vram_commit_stream& other) = delete;
+
+    ~vram_commit_stream()
+    {
+        stop();
+    }
+
+    [[nodiscard]] bool started() const
+    {
+        return _decompressor.started();
+    }
+
+    // Bytes left to decompress plus the bytes copied to VRAM at the end:
+    [[nodiscard]] int bytes() const
+    {
+        return (_decompressor.size() * 2) - _decompressor.position();
+    }
+
+    // Returns false if there's not enough memory for the staging buffer:
+    [[nodiscard]] bool start(const void* source_ptr, compression_type compression)
+    {
+        int staging_bytes = decompressor::decompressed_bytes(source_ptr);
+        _staging_ptr = static_cast<uint16_t*>(memory::ewram_alloc(staging_bytes));
+
+        if(! _staging_ptr)
+        {
+            return false;
+        }
+
+        _decompressor.start(source_ptr, compression, _staging_ptr);
+        return true;
+    }
+
+    // Decompresses up to max_bytes bytes.
+    // When all data has been decompressed, it is copied to the given VRAM destination and true is returned:
+    [[nodiscard]] bool commit(int max_bytes, uint16_t* vram_ptr)
+    {
+        int position = _decompressor.position();
+
+        if(! _decompressor.decompress(max_bytes))
+        {
+            return false;
+        }
+
+        // The copy is never split, even if it doesn't fit in the rest of the budget:
+        int size = _decompressor.size();
+        int available_bytes = max_bytes - (size - position);
+
+        if(available_bytes < size)
+        {
+            vram_commits_manager::force(size - available_bytes);
+        }
+
+        memory::copy(*_staging_ptr, size / 2, *vram_ptr);
+        stop();
+        return true;
+    }
+
+    void stop()
+    {
+        _decompressor.stop();
+        memory::ewram_free(_staging_ptr);
+        _staging_ptr = nullptr;
+    }
+
+private:
+    decompressor _decompressor;
+    uint16_t* _staging_ptr = nullptr;
+};
+
+}
+
+#endif
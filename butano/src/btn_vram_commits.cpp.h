@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_vram_commits.h"
+
+#include "btn_assert.h"
+#include "btn_vram_commits_manager.h"
+
+namespace btn::vram_commits
+{
+
+int max_bytes_per_frame()
+{
+    return vram_commits_manager::max_bytes_per_frame();
+}
+
+void set_max_bytes_per_frame(int max_bytes)
+{
+    BTN_ASSERT(max_bytes > 0, "Invalid max bytes: ", max_bytes);
+
+    vram_commits_manager::set_max_bytes_per_frame(max_bytes);
+}
+
+int uploaded_bytes()
+{
+    return vram_commits_manager::uploaded_bytes();
+}
+
+int deferred_bytes()
+{
+    return vram_commits_manager::deferred_bytes();
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "btn_vram_commits_manager.h"
+
+#include "btn_algorithm.h"
+#include "btn_config_vram_commits.h"
+
+#include "btn_vram_commits.cpp.h"
+
+namespace btn::vram_commits_manager
+{
+
+namespace
+{
+    static_assert(BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME > 0);
+
+
+    class static_data
+    {
+
+    public:
+        int max_bytes_per_frame = BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME;
+        int available_bytes = BTN_CFG_VRAM_COMMITS_MAX_BYTES_PER_FRAME;
+        int uploaded_bytes = 0;
+        int deferred_bytes = 0;
+    };
+
+    BTN_DATA_EWRAM static_data data;
+}
+
+int max_bytes_per_frame()
+{
+    return data.max_bytes_per_frame;
+}
+
+void set_max_bytes_per_frame(int max_bytes)
+{
+    data.max_bytes_per_frame = max_bytes;
+}
+
+int uploaded_bytes()
+{
+    return data.uploaded_bytes;
+}
+
+int deferred_bytes()
+{
+    return data.deferred_bytes;
+}
+
+int available_bytes()
+{
+    return data.available_bytes;
+}
+
+void start()
+{
+    data.available_bytes = data.max_bytes_per_frame;
+    data.uploaded_bytes = 0;
+    data.deferred_bytes = 0;
+}
+
+bool reserve(int bytes)
+{
+    if(bytes > data.available_bytes)
+    {
+        // Uploads bigger than the budget are allowed only if nothing else has been uploaded in this frame:
+        if(bytes <= data.max_bytes_per_frame || data.uploaded_bytes)
+        {
+            return false;
+        }
+    }
+
+    data.available_bytes = max(data.available_bytes - bytes, 0);
+    data.uploaded_bytes += bytes;
+    return true;
+}
+
+void force(int bytes)
+{
+    data.available_bytes = max(data.available_bytes - bytes, 0);
+    data.uploaded_bytes += bytes;
+}
+
+void defer(int bytes)
+{
+    data.deferred_bytes += bytes;
+}
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BTN_VRAM_COMMITS_MANAGER_H
+#define BTN_VRAM_COMMITS_MANAGER_H
+
+#include "btn_common.h"
+
+namespace btn::vram_commits_manager
+{
+    [[nodiscard]] int max_bytes_per_frame();
+
+    void set_max_bytes_per_frame(int max_bytes);
+
+    [[nodiscard]] int uploaded_bytes();
+
+    [[nodiscard]] int deferred_bytes();
+
+    [[nodiscard]] int available_bytes();
+
+    void start();
+
+    [[nodiscard]] bool reserve(int bytes);
+
+    void force(int bytes);
+
+    void defer(int bytes);
+}
+
+#endif
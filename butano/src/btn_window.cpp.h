@@ -5,6 +5,7 @@
 
 #include "btn_window.h"
 
+#include "btn_affine_bg_ptr.h"
 #include "btn_regular_bg_ptr.h"
 #include "btn_display_manager.h"
 
@@ -23,6 +24,18 @@ void window::set_show_bg(const regular_bg_ptr& regular_bg, bool show)
     display_manager::set_show_bg_in_window(_id, bg_handle, show);
 }
 
+bool window::show_bg(const affine_bg_ptr& affine_bg) const
+{
+    auto bg_handle = const_cast<void*>(affine_bg.handle());
+    return display_manager::show_bg_in_window(_id, bg_handle);
+}
+
+void window::set_show_bg(const affine_bg_ptr& affine_bg, bool show)
+{
+    auto bg_handle = const_cast<void*>(affine_bg.handle());
+    display_manager::set_show_bg_in_window(_id, bg_handle, show);
+}
+
 bool window::show_sprites() const
 {
     return display_manager::show_sprites_in_window(_id);
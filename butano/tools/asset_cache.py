@@ -0,0 +1,99 @@
+"""
+Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+zlib License, see LICENSE file.
+"""
+
+import os
+import json
+import shutil
+import hashlib
+import tempfile
+
+
+class AssetCache:
+    """
+    Output files of processed assets, stored in folders named after the hash of their input files.
+
+    The cache is stored in the build folder by default, but it can be shared between multiple clones with the
+    BUTANO_ASSET_CACHE environment variable.
+    """
+
+    @staticmethod
+    def folder_path(build_folder_path):
+        cache_folder_path = os.environ.get('BUTANO_ASSET_CACHE')
+
+        if not cache_folder_path:
+            cache_folder_path = build_folder_path + '/_btn_asset_cache'
+
+        return cache_folder_path
+
+    @staticmethod
+    def build_key(texts, file_paths):
+        key_hash = hashlib.sha1()
+
+        for text in texts:
+            key_hash.update(text.encode('utf-8'))
+            key_hash.update(b'\0')
+
+        for file_path in file_paths:
+            with open(file_path, 'rb') as file:
+                key_hash.update(file.read())
+
+            key_hash.update(b'\0')
+
+        return key_hash.hexdigest()
+
+    @staticmethod
+    def tool_key(tool_file_path, module_file_paths):
+        # Cached files are not valid anymore if the tools which generated them change:
+        tools_folder_path = os.path.dirname(os.path.abspath(tool_file_path))
+        file_paths = [os.path.abspath(tool_file_path)]
+
+        for module_file_path in module_file_paths:
+            file_paths.append(tools_folder_path + '/' + module_file_path)
+
+        return AssetCache.build_key([], file_paths)
+
+    def __init__(self, folder_path):
+        self.__folder_path = folder_path
+
+    def read(self, key, output_file_paths):
+        """
+        Copies the cached files of the given key to the given paths.
+        Returns the info stored with them, or None if they are not in the cache.
+        """
+        entry_folder_path = self.__folder_path + '/' + key
+        info_file_path = entry_folder_path + '/info.json'
+
+        try:
+            with open(info_file_path, 'r') as info_file:
+                info = json.load(info_file)
+
+            for output_file_path in output_file_paths:
+                shutil.copyfile(entry_folder_path + '/' + os.path.basename(output_file_path), output_file_path)
+        except (OSError, ValueError):
+            return None
+
+        return info
+
+    def write(self, key, output_file_paths, info):
+        entry_folder_path = self.__folder_path + '/' + key
+
+        if os.path.isdir(entry_folder_path):
+            return
+
+        os.makedirs(self.__folder_path, exist_ok=True)
+
+        # Entries are written in a temporary folder and renamed, so other builds never read incomplete entries:
+        temp_folder_path = tempfile.mkdtemp(prefix='_tmp_', dir=self.__folder_path)
+
+        try:
+            for output_file_path in output_file_paths:
+                shutil.copyfile(output_file_path, temp_folder_path + '/' + os.path.basename(output_file_path))
+
+            with open(temp_folder_path + '/info.json', 'w') as info_file:
+                json.dump(info, info_file)
+
+            os.rename(temp_folder_path, entry_folder_path)
+        except OSError:
+            shutil.rmtree(temp_folder_path, ignore_errors=True)
@@ -8,6 +8,8 @@ import struct
 
 
 class BMP:
+    # Packing stops when the palettes count is too big to be reduced to 16:
+    __max_packing_palettes = 64
 
     def __init__(self, file_path):
         self.width = None
@@ -73,8 +75,7 @@ class BMP:
 
                 file.seek(self.__pixels_offset)
                 pixels_count = self.width * self.height  # no padding, multiple of 8.
-                self.__pixels = [ord(pixel) for pixel in
-                                 struct.unpack(str(pixels_count) + 'c', file.read(pixels_count))]
+                self.__pixels = file.read(pixels_count)
 
                 colors_count = max(self.__pixels) + 1
                 extra_colors = colors_count % 16
@@ -87,7 +88,15 @@ class BMP:
 
             self.colors_count = colors_count
 
-    def quantize(self, output_file_path):
+    def quantize(self, output_file_path, tile_colors_reduction=False):
+        """
+        Packs the colors of each 8x8 tile into up to 16 palettes of 15 colors (plus the transparent one).
+        The palette of each tile is stored in the high nibble of its pixels, so grit can write it in the map.
+
+        If tile_colors_reduction is True, tiles with more than 15 colors are reduced by merging their closest colors.
+
+        Returns the number of colors of the generated image.
+        """
         if self.colors_count == 16:
             shutil.copyfile(self.__file_path, output_file_path)
             return 16
@@ -95,202 +104,245 @@ class BMP:
         width = self.width
         height = self.height
         colors = self.__colors
-        pixels = self.__pixels
+        pixels = self.__pixels.translate(self.__canonical_indexes_table())
+        transparent_color = colors[0]
+        color_distances = None
 
-        # Store used pixels for all tiles:
-        tile_pixel_sets = []
+        # Store the pixels and the used colors mask of each tile:
+        tile_pixels_list = []
+        tile_masks = []
 
         for ty in range(0, height, 8):
             for tx in range(0, width, 8):
-                new_tile_pixel_set = set()
-
-                for y in range(ty, ty + 8):
-                    row = width * y
+                tile_pixels = b''.join([pixels[row:row + 8] for row in range((ty * width) + tx,
+                                                                              ((ty + 8) * width) + tx, width)])
+                tile_pixel_set = set(tile_pixels)
+                tile_pixel_set.discard(0)
 
-                    for x in range(tx, tx + 8):
-                        pixel = pixels[row + x]
+                if len(tile_pixel_set) > 15:
+                    if not tile_colors_reduction:
+                        raise ValueError('There\'s a tile with more than 15 colors: ' + str(tx) + ' - ' +
+                                         str(height - ty - 8) + ' - ' + str(len(tile_pixel_set)) + ': ' +
+                                         str(tile_pixel_set))
 
-                        if pixel > 0:
-                            new_tile_pixel_set.add(pixel)
+                    if color_distances is None:
+                        color_distances = BMP.__color_distances(colors)
 
-                new_tile_pixel_set_len = len(new_tile_pixel_set)
+                    tile_pixels = BMP.__reduce_tile_colors(tile_pixels, tile_pixel_set, color_distances)
+                    tile_pixel_set = set(tile_pixels)
+                    tile_pixel_set.discard(0)
 
-                if new_tile_pixel_set_len > 0:
-                    if new_tile_pixel_set_len > 15:
-                        raise ValueError('There\'s a tile with more than 15 colors: ' + str(tx) + ' - ' +
-                                         str(height - ty - 8) + ' - ' + str(new_tile_pixel_set_len) + ': ' +
-                                         str(new_tile_pixel_set))
+                tile_mask = 0
 
-                    append = True
+                for pixel in tile_pixel_set:
+                    if colors[pixel] == transparent_color:
+                        raise ValueError('There\'s an used color like the transparent one in: ' + str(pixel))
 
-                    for tile_pixel_set in tile_pixel_sets:
-                        if new_tile_pixel_set.issubset(tile_pixel_set):
-                            append = False
-                            break
+                    tile_mask |= 1 << pixel
 
-                    if append:
-                        tile_pixel_sets.append(new_tile_pixel_set)
+                tile_pixels_list.append(tile_pixels)
+                tile_masks.append(tile_mask)
 
-        tile_pixel_sets_count = len(tile_pixel_sets)
+        palette_masks = BMP.__pack_tile_masks(set(tile_masks))
+        palettes_count = len(palette_masks)
 
-        if tile_pixel_sets_count == 0:
+        if palettes_count == 0:
             shutil.copyfile(self.__file_path, output_file_path)
             return 16
 
-        # Merge pixel sets:
-        while True:
-            minimum_i = None
-            minimum_j = None
-            minimum_u_set = None
-            minimum_u_set_length = 16
-            merged = False
-            i = 0
-
-            while i < tile_pixel_sets_count - 1:
-                i_set = tile_pixel_sets[i]
-                i_set_length = len(i_set)
-                j = i + 1
-
-                while j < tile_pixel_sets_count:
-                    j_set = tile_pixel_sets[j]
-                    j_set_length = len(j_set)
-                    u_set = i_set.union(j_set)
-                    u_set_length = len(u_set)
-
-                    if u_set_length == i_set_length or u_set_length == j_set_length:
-                        if u_set_length == j_set_length:
-                            tile_pixel_sets[i] = j_set
-                            i_set = j_set
-                            i_set_length = j_set_length
-
-                        tile_pixel_sets.pop(j)
-                        j -= 1
-                        tile_pixel_sets_count -= 1
-                        minimum_u_set = None
-                        minimum_i = None
-                        minimum_j = None
-                        minimum_u_set_length = 16
-                        merged = True
-                    elif u_set_length < minimum_u_set_length:
-                        minimum_u_set = u_set
-                        minimum_i = i
-                        minimum_j = j
-                        minimum_u_set_length = u_set_length
-
-                    j += 1
-
-                i += 1
-
-            if minimum_u_set is not None:
-                if minimum_i < minimum_j:
-                    minimum_i, minimum_j = minimum_j, minimum_i
-
-                tile_pixel_sets[minimum_i] = minimum_u_set
-                tile_pixel_sets.pop(minimum_j)
-                tile_pixel_sets_count -= 1
-            elif not merged:
-                break
-
-        if tile_pixel_sets_count > 16:
-            raise ValueError('There\'s more than 16 4bpp palettes: ' + str(tile_pixel_sets_count))
-
-        # Generate new colors:
-        transparent_color = colors[0]
-
-        for i in range(tile_pixel_sets_count):
-            for i_pixel in tile_pixel_sets[i]:
-                i_color = colors[i_pixel]
-
-                if i_color == transparent_color:
-                    raise ValueError('There\'s an used color like the transparent one in: ' + str(i_pixel))
-
-                for j in range(i + 1, tile_pixel_sets_count):
-                    for j_pixel in tile_pixel_sets[j]:
-                        if i_pixel != j_pixel and i_color == colors[j_pixel]:
-                            raise ValueError('There\'s two used identical colors in: ' + str(i_pixel) + ' and ' +
-                                             str(j_pixel))
+        if palettes_count > 16:
+            raise ValueError('There\'s more than 16 4bpp palettes: ' + str(palettes_count))
 
+        # Generate new colors and the pixel translation table of each palette:
         new_colors = [transparent_color] * 256
+        palette_tables = []
 
-        for tpi in range(tile_pixel_sets_count):
-            new_tile_pixel_set = tile_pixel_sets[tpi]
-            ci = (tpi * 16) + 1
+        for palette_index in range(palettes_count):
+            palette_mask = palette_masks[palette_index]
+            palette_table = bytearray([palette_index * 16]) * 256
+            color_index = (palette_index * 16) + 1
 
-            for tile_pixel in new_tile_pixel_set:
-                new_colors[ci] = colors[tile_pixel]
-                ci += 1
+            for pixel in range(1, 256):
+                if palette_mask & (1 << pixel):
+                    new_colors[color_index] = colors[pixel]
+                    palette_table[pixel] = color_index
+                    color_index += 1
 
-        # Generate new pixels:
-        new_pixels = list(pixels)
-        tile_pixel_lists = []
+            palette_tables.append(bytes(palette_table))
 
-        for new_tile_pixel_set in tile_pixel_sets:
-            tile_pixel_lists.append(list(new_tile_pixel_set))
+        # Generate new pixels:
+        new_pixels = bytearray(len(pixels))
+        tile_palette_indexes = {}
+        tile_index = 0
 
         for ty in range(0, height, 8):
             for tx in range(0, width, 8):
-                valid_tile_pixel_set = False
-
-                for tpi in range(tile_pixel_sets_count):
-                    new_tile_pixel_set = tile_pixel_sets[tpi]
-                    valid_tile_pixel_set = True
-
-                    for y in range(ty, ty + 8):
-                        row = width * y
-    
-                        for x in range(tx, tx + 8):
-                            pixel = pixels[row + x]
-    
-                            if pixel > 0:
-                                if pixel not in new_tile_pixel_set:
-                                    valid_tile_pixel_set = False
-                                    break
-
-                        if not valid_tile_pixel_set:
+                tile_mask = tile_masks[tile_index]
+                palette_index = tile_palette_indexes.get(tile_mask)
+
+                if palette_index is None:
+                    for palette_index in range(palettes_count):
+                        if tile_mask & ~palette_masks[palette_index] == 0:
                             break
 
-                    if valid_tile_pixel_set:
-                        tile_pixel_list = tile_pixel_lists[tpi]
+                    tile_palette_indexes[tile_mask] = palette_index
+
+                tile_pixels = tile_pixels_list[tile_index].translate(palette_tables[palette_index])
+                tile_row = 0
+
+                for row in range((ty * width) + tx, ((ty + 8) * width) + tx, width):
+                    new_pixels[row:row + 8] = tile_pixels[tile_row:tile_row + 8]
+                    tile_row += 8
+
+                tile_index += 1
+
+        # Write output file:
+        with open(self.__file_path, 'rb') as input_file:
+            input_file_content = bytearray(input_file.read())
+
+        colors_offset = self.__colors_offset
+        input_file_content[colors_offset:colors_offset + 1024] = struct.pack('256I', *new_colors)
+        pixels_offset = self.__pixels_offset
+        input_file_content[pixels_offset:pixels_offset + len(new_pixels)] = new_pixels
+
+        with open(output_file_path, 'wb') as output_file:
+            output_file.write(input_file_content)
+
+        return palettes_count * 16
+
+    def __canonical_indexes_table(self):
+        # Color indexes with the same color are replaced by the first one, so they don't waste palette entries:
+        colors = self.__colors
+        first_indexes = {}
+        table = bytearray(range(256))
 
-                        for y in range(ty, ty + 8):
-                            row = width * y
+        for index in range(1, 256):
+            table[index] = first_indexes.setdefault(colors[index], index)
 
-                            for x in range(tx, tx + 8):
-                                pixel = pixels[row + x]
-                                new_pixel = tpi * 16
+        return bytes(table)
 
-                                if pixel > 0:
-                                    new_pixel += tile_pixel_list.index(pixel) + 1
+    @staticmethod
+    def __color_distances(colors):
+        components = [((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF) for color in colors]
+        return [[((ar - br) * (ar - br)) + ((ag - bg) * (ag - bg)) + ((ab - bb) * (ab - bb))
+                 for br, bg, bb in components] for ar, ag, ab in components]
 
-                                new_pixels[row + x] = new_pixel
+    @staticmethod
+    def __reduce_tile_colors(tile_pixels, tile_pixel_set, color_distances):
+        # The 15 most used colors are kept, and the other ones are replaced by the closest kept color:
+        tile_pixel_list = sorted(tile_pixel_set, key=lambda pixel: (-tile_pixels.count(pixel), pixel))
+        kept_pixels = tile_pixel_list[:15]
+        table = bytearray(range(256))
 
+        for pixel in tile_pixel_list[15:]:
+            table[pixel] = min(kept_pixels, key=color_distances[pixel].__getitem__)
+
+        return tile_pixels.translate(table)
+
+    @staticmethod
+    def __pack_tile_masks(tile_masks):
+        tile_masks = sorted((mask for mask in tile_masks if mask), key=BMP.__mask_colors_count, reverse=True)
+
+        # Tile color sets contained in other ones don't need to be packed
+        # (this is quadratic, so it is skipped for images with lots of different tiles):
+        if len(tile_masks) <= 2048:
+            unique_tile_masks = []
+
+            for tile_mask in tile_masks:
+                for unique_tile_mask in unique_tile_masks:
+                    if tile_mask & ~unique_tile_mask == 0:
                         break
+                else:
+                    unique_tile_masks.append(tile_mask)
 
-                if not valid_tile_pixel_set:
-                    raise ValueError('No valid palette found for tile: ' + str(tx) + ' - ' + str(height - ty - 8))
+            tile_masks = unique_tile_masks
 
-        # Write output file:
-        with open(self.__file_path, 'rb') as input_file:
-            input_file_content = input_file.read()
-            b = bytearray()
-            b.extend(input_file_content)
-            input_file_content = b
-            offset = self.__colors_offset
+        palettes = BMP.__best_fit_packing(tile_masks)
+
+        # Merge packing is cubic, so it is only tried with a few color sets.
+        # Different heuristics are better for different images, so the one which generates less palettes is used:
+        if len(tile_masks) <= 256:
+            merge_palettes = BMP.__merge_packing(tile_masks)
+
+            if len(merge_palettes) < len(palettes):
+                palettes = merge_palettes
+
+        # Try to remove the palettes with less colors by moving their color sets to the other ones:
+        palette_removed = True
+
+        while palette_removed and len(palettes) > 1:
+            palette_removed = False
+
+            for palette in sorted(palettes, key=lambda item: BMP.__mask_colors_count(item[0])):
+                other_palettes = [[other[0], list(other[1])] for other in palettes if other is not palette]
+
+                if all(BMP.__best_fit(other_palettes, tile_mask) for tile_mask in palette[1]):
+                    palettes = other_palettes
+                    palette_removed = True
+                    break
+
+        return [palette[0] for palette in palettes]
+
+    @staticmethod
+    def __best_fit_packing(tile_masks):
+        # Best fit decreasing bin packing: each color set goes to the palette which needs less new colors for it:
+        palettes = []
+
+        for tile_mask in tile_masks:
+            if not BMP.__best_fit(palettes, tile_mask):
+                if len(palettes) == BMP.__max_packing_palettes:
+                    raise ValueError('There\'s more than 16 4bpp palettes: ' + str(len(palettes)) + '+')
+
+                palettes.append([tile_mask, [tile_mask]])
+
+        return palettes
+
+    @staticmethod
+    def __merge_packing(tile_masks):
+        # Agglomerative packing: the pair of palettes with the smallest union is merged until no pair fits:
+        palettes = [[tile_mask, [tile_mask]] for tile_mask in tile_masks]
+
+        while True:
+            best_pair = None
+            best_colors_count = 16
+
+            for i in range(len(palettes)):
+                i_mask = palettes[i][0]
+
+                for j in range(i + 1, len(palettes)):
+                    colors_count = BMP.__mask_colors_count(i_mask | palettes[j][0])
+
+                    if colors_count < best_colors_count:
+                        best_pair = (i, j)
+                        best_colors_count = colors_count
+
+            if best_pair is None:
+                return palettes
+
+            i, j = best_pair
+            palettes[i] = [palettes[i][0] | palettes[j][0], palettes[i][1] + palettes[j][1]]
+            palettes.pop(j)
 
-            for new_color in new_colors:
-                new_color_bytes = struct.unpack('4B', struct.pack('I', new_color))
+    @staticmethod
+    def __best_fit(palettes, tile_mask):
+        best_palette = None
+        best_colors_count = None
 
-                for new_color_byte in new_color_bytes:
-                    input_file_content[offset] = new_color_byte
-                    offset += 1
+        for palette in palettes:
+            colors_count = BMP.__mask_colors_count(palette[0] | tile_mask)
 
-            offset = self.__pixels_offset
+            if colors_count <= 15 and (best_colors_count is None or
+                                       colors_count - BMP.__mask_colors_count(palette[0]) < best_colors_count):
+                best_palette = palette
+                best_colors_count = colors_count - BMP.__mask_colors_count(palette[0])
 
-            for new_pixel in new_pixels:
-                input_file_content[offset] = new_pixel
-                offset += 1
+        if best_palette is None:
+            return False
 
-            with open(output_file_path, 'wb') as output_file:
-                output_file.write(input_file_content)
+        best_palette[0] |= tile_mask
+        best_palette[1].append(tile_mask)
+        return True
 
-        return tile_pixel_sets_count * 16
+    @staticmethod
+    def __mask_colors_count(mask):
+        return bin(mask).count('1')
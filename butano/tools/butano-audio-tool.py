@@ -4,12 +4,58 @@ zlib License, see LICENSE file.
 """
 
 import os
+import json
+import wave
+import struct
 import argparse
 import subprocess
 import sys
 import traceback
+import concurrent.futures
 
 from file_info import FileInfo
+from asset_cache import AssetCache
+
+
+ADPCM_BLOCK_BYTES = 256
+ADPCM_SAMPLES_PER_BLOCK = ((ADPCM_BLOCK_BYTES - 4) * 2) + 1
+ADPCM_MAX_SAMPLE_RATE = 32768
+
+ADPCM_STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88,
+    97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660,
+    4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+    18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+
+ADPCM_INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+class AudioStream:
+
+    def __init__(self, name, file_path, json_file_path):
+        self.name = name
+        self.file_path = file_path
+        self.json_file_path = json_file_path
+
+
+def read_audio_json_file(json_file_path):
+    try:
+        with open(json_file_path) as json_file:
+            info = json.load(json_file)
+    except Exception as exception:
+        raise ValueError(json_file_path + ' audio json file parse failed: ' + str(exception))
+
+    try:
+        audio_type = str(info['type'])
+    except KeyError:
+        raise ValueError('type filed not found in audio json file: ' + json_file_path)
+
+    if audio_type != 'stream':
+        raise ValueError('Unknown type (' + audio_type + ') in audio json file: ' + json_file_path)
+
+    return info
 
 
 def list_audio_files(audio_folder_paths):
@@ -17,6 +63,8 @@ def list_audio_files(audio_folder_paths):
     audio_file_names = []
     audio_file_names_no_ext = []
     audio_file_paths = []
+    audio_streams = []
+    json_file_paths = []
 
     for audio_folder_path in audio_folder_path_list:
         folder_audio_file_names = sorted(os.listdir(audio_folder_path))
@@ -28,11 +76,24 @@ def list_audio_files(audio_folder_paths):
                 if os.path.isfile(audio_file_path):
                     audio_file_name_split = os.path.splitext(audio_file_name)
                     audio_file_name_no_ext = audio_file_name_split[0]
-                    audio_file_names.append(audio_file_name)
-                    audio_file_names_no_ext.append(audio_file_name_no_ext)
-                    audio_file_paths.append(audio_file_path)
+                    audio_file_name_ext = audio_file_name_split[1]
+
+                    if audio_file_name_ext == '.json':
+                        json_file_paths.append(audio_file_path)
+                        continue
 
-    return audio_file_names, audio_file_names_no_ext, audio_file_paths
+                    json_file_path = audio_folder_path + '/' + audio_file_name_no_ext + '.json'
+
+                    if audio_file_name_ext == '.wav' and os.path.isfile(json_file_path):
+                        # Waveform audio files with a json file are streamed instead of being processed by mmutil:
+                        read_audio_json_file(json_file_path)
+                        audio_streams.append(AudioStream(audio_file_name_no_ext, audio_file_path, json_file_path))
+                    else:
+                        audio_file_names.append(audio_file_name)
+                        audio_file_names_no_ext.append(audio_file_name_no_ext)
+                        audio_file_paths.append(audio_file_path)
+
+    return audio_file_names, audio_file_names_no_ext, audio_file_paths, audio_streams, json_file_paths
 
 
 def process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_path, build_folder_path):
@@ -60,7 +121,8 @@ def process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_p
     return os.path.getsize(soundbank_bin_path)
 
 
-def write_output_file(items, include_guard, include_file, namespace, item_class, output_file_path):
+def write_output_file(items, include_guard, include_file, namespace, item_class, output_file_path,
+                      declaration=None):
     if len(items) > 0:
         with open(output_file_path, 'w') as output_file:
             output_file.write('#ifndef ' + include_guard + '\n')
@@ -68,6 +130,11 @@ def write_output_file(items, include_guard, include_file, namespace, item_class,
             output_file.write('\n')
             output_file.write('#include "' + include_file + '"' + '\n')
             output_file.write('\n')
+
+            if declaration is not None:
+                output_file.write(declaration + '\n')
+                output_file.write('\n')
+
             output_file.write('namespace ' + namespace + '\n')
             output_file.write('{' + '\n')
 
@@ -123,35 +190,250 @@ def write_output_files(audio_file_names_no_ext, soundbank_header_path, build_fol
                       build_folder_path + '/btn_sound_items.h')
 
 
-def process(audio_folder_paths, build_folder_path):
-    audio_file_names, audio_file_names_no_ext, audio_file_paths = list_audio_files(audio_folder_paths)
-    file_info_path = build_folder_path + '/_btn_audio_files_info.txt'
-    old_file_info = FileInfo.read(file_info_path)
-    new_file_info = FileInfo.build_from_files(audio_file_paths)
+def read_wav_file(file_path):
+    try:
+        with wave.open(file_path, 'rb') as wav_file:
+            channels = wav_file.getnchannels()
+            sample_width = wav_file.getsampwidth()
+            sample_rate = wav_file.getframerate()
+            frames = wav_file.readframes(wav_file.getnframes())
+    except Exception as exception:
+        raise ValueError(file_path + ' waveform audio file read failed: ' + str(exception))
+
+    if sample_width == 1:
+        values = [(value - 128) << 8 for value in frames]
+    elif sample_width == 2:
+        values = list(struct.unpack('<' + str(len(frames) // 2) + 'h', frames))
+    else:
+        raise ValueError(file_path + ' waveform audio file sample width not supported: ' + str(sample_width * 8))
 
-    if old_file_info == new_file_info:
-        return
+    # Multichannel files are downmixed to mono:
+    samples = [sum(values[index:index + channels]) // channels for index in range(0, len(values), channels)]
+    return samples, sample_rate
 
-    for audio_file_name in audio_file_names:
-        print(audio_file_name)
 
-    soundbank_bin_path = build_folder_path + '/_btn_audio_soundbank.bin'
+def resample(samples, sample_rate, new_sample_rate):
+    if sample_rate == new_sample_rate or len(samples) < 2:
+        return samples
+
+    new_samples_count = max((len(samples) * new_sample_rate) // sample_rate, 1)
+    result = []
+
+    for index in range(new_samples_count):
+        position = (index * sample_rate) / new_sample_rate
+        first_index = min(int(position), len(samples) - 2)
+        weight = min(position - first_index, 1)
+        result.append(int(round((samples[first_index] * (1 - weight)) + (samples[first_index + 1] * weight))))
+
+    return result
+
+
+def decode_adpcm_code(code, predictor, step_index):
+    # Same decoding as btn::adpcm_decoder, so the encoder keeps track of the decoder state:
+    step = ADPCM_STEP_TABLE[step_index]
+    difference = step >> 3
+
+    if code & 4:
+        difference += step
+
+    if code & 2:
+        difference += step >> 1
+
+    if code & 1:
+        difference += step >> 2
+
+    if code & 8:
+        predictor = max(predictor - difference, -32768)
+    else:
+        predictor = min(predictor + difference, 32767)
+
+    step_index = min(max(step_index + ADPCM_INDEX_TABLE[code & 7], 0), len(ADPCM_STEP_TABLE) - 1)
+    return predictor, step_index
+
+
+def encode_adpcm(samples):
+    result = bytearray()
+    step_index = 0
+
+    for block_index in range(0, len(samples), ADPCM_SAMPLES_PER_BLOCK):
+        block_samples = samples[block_index:block_index + ADPCM_SAMPLES_PER_BLOCK]
+        block_samples += [block_samples[-1]] * (ADPCM_SAMPLES_PER_BLOCK - len(block_samples))
+        predictor = block_samples[0]
+        result += struct.pack('<hBB', predictor, step_index, 0)
+        pending_code = None
+
+        for sample in block_samples[1:]:
+            step = ADPCM_STEP_TABLE[step_index]
+            difference = sample - predictor
+            code = 0
+
+            if difference < 0:
+                code = 8
+                difference = -difference
+
+            for bit in (4, 2, 1):
+                if difference >= step:
+                    code |= bit
+                    difference -= step
+
+                step >>= 1
+
+            predictor, step_index = decode_adpcm_code(code, predictor, step_index)
+
+            if pending_code is None:
+                pending_code = code
+            else:
+                result.append(pending_code | (code << 4))
+                pending_code = None
+
+    return result
+
+
+def process_soundbank(audio_file_names, audio_file_names_no_ext, audio_file_paths, soundbank_bin_path,
+                      build_folder_path, cache_folder_path, tool_key):
+    # mmutil can't update a soundbank, so it is cached as a whole:
+    output_file_paths = [soundbank_bin_path, build_folder_path + '/btn_music_items.h',
+                         build_folder_path + '/btn_sound_items.h']
+    cache = AssetCache(cache_folder_path)
+    cache_key = AssetCache.build_key([tool_key, 'soundbank'] + audio_file_names, audio_file_paths)
+    cache_info = cache.read(cache_key, output_file_paths)
+
+    if cache_info is not None:
+        print('    Soundbank read from cache')
+        return int(cache_info['total_size'])
+
     soundbank_header_path = build_folder_path + '/_btn_audio_soundbank.h'
     total_size = process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_path, build_folder_path)
     write_output_files(audio_file_names_no_ext, soundbank_header_path, build_folder_path)
-    print('    Processed audio size: ' + str(total_size) + ' bytes')
     os.remove(soundbank_header_path)
-    new_file_info.write(file_info_path)
+    cache.write(cache_key, output_file_paths, {'total_size': total_size})
+    return total_size
+
+
+def encode_audio_stream(audio_stream, build_folder_path, cache_folder_path, tool_key):
+    stream_bin_path = build_folder_path + '/_btn_' + audio_stream.name + '_audio_stream.bin'
+    cache = AssetCache(cache_folder_path)
+    cache_key = AssetCache.build_key([tool_key, 'stream', audio_stream.name],
+                                     [audio_stream.file_path, audio_stream.json_file_path])
+    cache_info = cache.read(cache_key, [stream_bin_path])
+
+    if cache_info is not None:
+        return stream_bin_path, int(cache_info['sample_rate'])
+
+    info = read_audio_json_file(audio_stream.json_file_path)
+    samples, sample_rate = read_wav_file(audio_stream.file_path)
+
+    if 'sample_rate' in info:
+        try:
+            new_sample_rate = int(info['sample_rate'])
+        except ValueError:
+            raise ValueError('Invalid sample_rate field in audio json file: ' + audio_stream.json_file_path)
+
+        samples = resample(samples, sample_rate, new_sample_rate)
+        sample_rate = new_sample_rate
+
+    if sample_rate <= 0 or sample_rate > ADPCM_MAX_SAMPLE_RATE:
+        raise ValueError('Invalid sample rate (' + str(sample_rate) + '), max is ' +
+                         str(ADPCM_MAX_SAMPLE_RATE) + ': ' + audio_stream.file_path)
+
+    if len(samples) == 0:
+        raise ValueError('Empty waveform audio file: ' + audio_stream.file_path)
+
+    with open(stream_bin_path, 'wb') as stream_bin_file:
+        stream_bin_file.write(encode_adpcm(samples))
+
+    cache.write(cache_key, [stream_bin_path], {'sample_rate': sample_rate})
+    return stream_bin_path, sample_rate
+
+
+def process_audio_streams(audio_streams, streams_bin_path, build_folder_path, cache_folder_path, tool_key, jobs):
+    streams_data = bytearray()
+    stream_items_list = []
+
+    if jobs > 1 and len(audio_streams) > 1:
+        with concurrent.futures.ProcessPoolExecutor(max_workers=jobs) as executor:
+            futures = [executor.submit(encode_audio_stream, audio_stream, build_folder_path, cache_folder_path,
+                                       tool_key)
+                       for audio_stream in audio_streams]
+            results = [future.result() for future in futures]
+    else:
+        results = [encode_audio_stream(audio_stream, build_folder_path, cache_folder_path, tool_key)
+                   for audio_stream in audio_streams]
+
+    for audio_stream, (stream_bin_path, sample_rate) in zip(audio_streams, results):
+        with open(stream_bin_path, 'rb') as stream_bin_file:
+            stream_data = stream_bin_file.read()
+
+        stream_items_list.append([audio_stream.name, '_btn_audio_streams_bin + ' + str(len(streams_data)) + ', ' +
+                                  str(len(stream_data) // ADPCM_BLOCK_BYTES) + ', ' + str(sample_rate)])
+        streams_data += stream_data
+
+    if not streams_data:
+        # bin2o requires a non empty file:
+        streams_data += bytes(4)
+
+    with open(streams_bin_path, 'wb') as streams_bin_file:
+        streams_bin_file.write(streams_data)
+
+    write_output_file(stream_items_list, 'BTN_AUDIO_STREAM_ITEMS_H', 'btn_audio_stream_item.h',
+                      'btn::audio_stream_items', 'audio_stream_item',
+                      build_folder_path + '/btn_audio_stream_items.h',
+                      'extern const uint8_t _btn_audio_streams_bin[];')
+
+    return len(streams_data)
+
+
+def process(audio_folder_paths, build_folder_path, jobs):
+    audio_file_names, audio_file_names_no_ext, audio_file_paths, audio_streams, json_file_paths = \
+        list_audio_files(audio_folder_paths)
+    cache_folder_path = AssetCache.folder_path(build_folder_path)
+    tool_key = AssetCache.tool_key(__file__, [])
+    soundbank_bin_path = build_folder_path + '/_btn_audio_soundbank.bin'
+    streams_bin_path = build_folder_path + '/_btn_audio_streams.bin'
+    total_size = 0
+    processed = False
+
+    # Soundbank and streams are processed separately, so changing a stream doesn't call mmutil again:
+    files_info_path = build_folder_path + '/_btn_audio_files_info.txt'
+    old_files_info = FileInfo.read(files_info_path)
+    new_files_info = FileInfo.build_from_files(audio_file_paths)
+
+    if old_files_info != new_files_info or not os.path.isfile(soundbank_bin_path):
+        for audio_file_name in audio_file_names:
+            print(audio_file_name)
+
+        total_size += process_soundbank(audio_file_names, audio_file_names_no_ext, audio_file_paths,
+                                        soundbank_bin_path, build_folder_path, cache_folder_path, tool_key)
+        new_files_info.write(files_info_path)
+        processed = True
+
+    streams_info_path = build_folder_path + '/_btn_audio_streams_info.txt'
+    old_streams_info = FileInfo.read(streams_info_path)
+    new_streams_info = FileInfo.build_from_files([audio_stream.file_path for audio_stream in audio_streams] +
+                                                 json_file_paths)
+
+    if old_streams_info != new_streams_info or not os.path.isfile(streams_bin_path):
+        for audio_stream in audio_streams:
+            print(os.path.basename(audio_stream.file_path) + ' (stream)')
+
+        total_size += process_audio_streams(audio_streams, streams_bin_path, build_folder_path, cache_folder_path,
+                                            tool_key, jobs)
+        new_streams_info.write(streams_info_path)
+        processed = True
+
+    if processed:
+        print('    Processed audio size: ' + str(total_size) + ' bytes')
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='butano audio tool.')
     parser.add_argument('--audio', required=True, help='audio folder paths')
     parser.add_argument('--build', required=True, help='build folder path')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='max number of parallel jobs')
 
     try:
         args = parser.parse_args()
-        process(args.audio, args.build)
+        process(args.audio, args.build, max(args.jobs or 1, 1))
     except Exception as ex:
         sys.stderr.write('Error: ' + str(ex) + '\n')
         traceback.print_exc()
@@ -0,0 +1,290 @@
+"""
+Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+zlib License, see LICENSE file.
+"""
+
+import argparse
+import importlib.util
+import json
+import math
+import os
+import shlex
+import struct
+import subprocess
+import sys
+import threading
+import traceback
+
+
+def load_profiler_tool():
+    file_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'butano-profiler-tool.py')
+    spec = importlib.util.spec_from_file_location('butano_profiler_tool', file_path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def percentile(values, percent):
+    if len(values) == 0:
+        return 0
+
+    sorted_values = sorted(values)
+    return sorted_values[int(math.ceil(len(sorted_values) * percent / 100)) - 1]
+
+
+def read_log_dump(lines, tag):
+    data = None
+    current_data = None
+
+    for line in lines:
+        if tag + '_begin' in line:
+            current_data = bytearray()
+        elif tag + '_end' in line:
+            if current_data is not None:
+                data = current_data
+                current_data = None
+        elif current_data is not None:
+            position = line.find(tag + ':')
+
+            if position >= 0:
+                current_data += bytes.fromhex(line[position + len(tag) + 1:].strip())
+
+    return None if data is None else bytes(data)
+
+
+class BenchmarkResults:
+
+    def __init__(self, name, lines, skip_frames):
+        data = read_log_dump(lines, 'btn_benchmark')
+
+        if data is None:
+            raise ValueError('Benchmark results not found in ' + name + ' log '
+                             '(is BTN_CFG_CORE_BENCHMARK_FRAMES defined?)')
+
+        version, ticks_per_frame, ticks_per_vblank, frames_count = struct.unpack_from('<BIIH', data, 0)
+
+        if version != 1:
+            raise ValueError('Unsupported benchmark results version: ' + str(version))
+
+        offset = struct.calcsize('<BIIH')
+        cpu_ticks = struct.unpack_from('<' + str(frames_count) + 'H', data, offset)
+        vblank_ticks = struct.unpack_from('<' + str(frames_count) + 'H', data, offset + (frames_count * 2))
+
+        # The first frames are usually slower since they include initialization code:
+        self.name = name
+        self.frames_count = frames_count
+        self.skip_frames = min(skip_frames, frames_count - 1)
+        self.cpu_usages = [ticks / ticks_per_frame for ticks in cpu_ticks[self.skip_frames:]]
+        self.vblank_usages = [ticks / ticks_per_vblank for ticks in vblank_ticks[self.skip_frames:]]
+        self.missed_frames = sum(1 for usage in self.cpu_usages if usage > 1)
+        self.profiler_results = None
+
+        profiler_data = read_log_dump(lines, 'btn_profiler')
+
+        if profiler_data is not None:
+            self.profiler_results = load_profiler_tool().ProfilerResults(profiler_data)
+
+    def metrics(self):
+        result = {}
+
+        for percent in (50, 95, 99, 100):
+            result['cpu_p' + str(percent)] = round(percentile(self.cpu_usages, percent), 4)
+            result['vblank_p' + str(percent)] = round(percentile(self.vblank_usages, percent), 4)
+
+        result['missed_frames'] = self.missed_frames
+
+        if self.profiler_results is not None:
+            for entry in self.profiler_results.entries:
+                stack = self.profiler_results.stack(entry)
+                result['profiler:' + stack + ':p50'] = entry.percentile(50)
+                result['profiler:' + stack + ':p99'] = entry.percentile(99)
+
+        return result
+
+
+def build_rom(project_path, frames, keypad_commands, profile):
+    project_name = os.path.basename(os.path.abspath(project_path))
+    target = project_name + '_benchmark'
+    benchmark_flags = ['-DBTN_CFG_LOG_ENABLED=true', '-DBTN_CFG_CORE_BENCHMARK_FRAMES=' + str(frames)]
+
+    if keypad_commands is not None:
+        benchmark_flags.append('-DBTN_CFG_CORE_BENCHMARK_KEYPAD_COMMANDS=\'"' + keypad_commands + '"\'')
+
+    if profile:
+        benchmark_flags.append('-DBTN_CFG_PROFILER_ENABLED=true')
+        benchmark_flags.append('-DBTN_CFG_PROFILER_LOG_ENGINE=true')
+
+    # Benchmark ROMs are built in their own folder, so regular builds are not invalidated.
+    # USERFLAGS is not overridden, so benchmark ROMs keep the project flags (-flto, backends, etc):
+    command = ['make', '-C', project_path, '-j' + str(os.cpu_count() or 1), 'BUILD=build_benchmark',
+               'TARGET=' + target, 'BENCHMARKFLAGS=' + ' '.join(benchmark_flags)]
+    print('Building ' + project_name + '...')
+    subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+    return os.path.join(project_path, target + '.gba')
+
+
+def run_rom(rom_path, emulator, timeout):
+    command = [part.replace('{rom}', rom_path) for part in shlex.split(emulator)]
+
+    if '{rom}' not in emulator:
+        command.append(rom_path)
+
+    print('Running ' + os.path.basename(rom_path) + '...')
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL,
+                               text=True, errors='replace')
+    lines = []
+
+    # The emulator is stopped as soon as the benchmark results have been logged:
+    def read_lines():
+        for line in process.stdout:
+            lines.append(line)
+
+            if 'btn_benchmark_end' in line:
+                break
+
+    reader = threading.Thread(target=read_lines, daemon=True)
+    reader.start()
+    reader.join(timeout)
+    process.kill()
+    process.wait()
+
+    if reader.is_alive():
+        raise ValueError(os.path.basename(rom_path) + ' timed out (' + str(timeout) + ' seconds)')
+
+    return lines
+
+
+def print_results(results):
+    metrics = results.metrics()
+    print()
+    print(results.name + ': ' + str(results.frames_count) + ' frames (' + str(results.skip_frames) + ' skipped), ' +
+          str(results.missed_frames) + ' missed')
+    print('  CPU usage:     p50 %.4f  p95 %.4f  p99 %.4f  max %.4f' % (
+        metrics['cpu_p50'], metrics['cpu_p95'], metrics['cpu_p99'], metrics['cpu_p100']))
+    print('  V-Blank usage: p50 %.4f  p95 %.4f  p99 %.4f  max %.4f' % (
+        metrics['vblank_p50'], metrics['vblank_p95'], metrics['vblank_p99'], metrics['vblank_p100']))
+
+    if results.profiler_results is not None:
+        for entry in sorted(results.profiler_results.entries, key=lambda e: e.total_ticks, reverse=True):
+            print('  ' + results.profiler_results.stack(entry) + ': p50 ' + str(entry.percentile(50)) + ' ticks, p99 ' +
+                  str(entry.percentile(99)) + ' ticks')
+
+
+def compare(results, baseline, threshold):
+    regressions = []
+    baseline_metrics = baseline.get(results.name)
+
+    if baseline_metrics is None:
+        print('  No baseline found')
+        return regressions
+
+    for key, value in results.metrics().items():
+        baseline_value = baseline_metrics.get(key)
+
+        if baseline_value is None:
+            continue
+
+        # Profiler ticks are integers, so one tick of difference is always allowed:
+        allowed_value = baseline_value * (1 + (threshold / 100))
+
+        if key.startswith('profiler:') or key == 'missed_frames':
+            allowed_value = max(allowed_value, baseline_value + 1)
+
+        if value > allowed_value:
+            regressions.append(results.name + ' ' + key + ': ' + str(baseline_value) + ' -> ' + str(value))
+
+    return regressions
+
+
+def process(args):
+    keypad_commands = None
+
+    if args.keypad_commands is not None:
+        with open(args.keypad_commands, 'r') as keypad_commands_file:
+            keypad_commands = ''.join(keypad_commands_file.read().split())
+
+    all_results = []
+
+    for project_path in args.project or []:
+        rom_path = build_rom(project_path, args.frames, keypad_commands, args.profile)
+        name = os.path.basename(os.path.abspath(project_path))
+        all_results.append(BenchmarkResults(name, run_rom(rom_path, args.emulator, args.timeout), args.skip))
+
+    for rom_path in args.rom or []:
+        name = os.path.splitext(os.path.basename(rom_path))[0]
+        all_results.append(BenchmarkResults(name, run_rom(rom_path, args.emulator, args.timeout), args.skip))
+
+    for log_path in args.log or []:
+        with open(log_path, 'r', errors='replace') as log_file:
+            name = os.path.splitext(os.path.basename(log_path))[0]
+            all_results.append(BenchmarkResults(name, log_file.readlines(), args.skip))
+
+    if len(all_results) == 0:
+        raise ValueError('No projects, ROMs or logs specified')
+
+    baseline = {}
+
+    if args.baseline is not None and os.path.isfile(args.baseline):
+        with open(args.baseline, 'r') as baseline_file:
+            baseline = json.load(baseline_file)
+
+    regressions = []
+
+    for results in all_results:
+        print_results(results)
+
+        if args.baseline is not None and not args.update_baseline:
+            regressions += compare(results, baseline, args.threshold)
+
+    if args.baseline is not None and args.update_baseline:
+        for results in all_results:
+            baseline[results.name] = results.metrics()
+
+        with open(args.baseline, 'w') as baseline_file:
+            json.dump(baseline, baseline_file, indent=4, sort_keys=True)
+            baseline_file.write('\n')
+
+        print()
+        print('Baseline updated: ' + args.baseline)
+
+    if len(regressions) > 0:
+        print()
+        print('Regressions (threshold: ' + str(args.threshold) + '%):')
+
+        for regression in regressions:
+            print('  ' + regression)
+
+        return False
+
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description='butano benchmark tool: runs ROMs in a headless emulator and checks frame time regressions.')
+    parser.add_argument('--project', action='append',
+                        help='project folder to build and run (it can be specified more than once)')
+    parser.add_argument('--rom', action='append',
+                        help='ROM built with BTN_CFG_CORE_BENCHMARK_FRAMES to run (it can be specified more than once)')
+    parser.add_argument('--log', action='append',
+                        help='emulator log file to process instead of running a ROM (it can be specified more than '
+                             'once)')
+    parser.add_argument('--emulator', default='mgba-rom-test {rom}',
+                        help='emulator command, which must print the logged messages to stdout ({rom} is replaced '
+                             'with the ROM path)')
+    parser.add_argument('--frames', type=int, default=600, help='number of frames to run when building projects')
+    parser.add_argument('--skip', type=int, default=1, help='number of initial frames to ignore')
+    parser.add_argument('--keypad-commands', help='file with keypad commands to replay when building projects')
+    parser.add_argument('--profile', action='store_true', help='enable the profiler when building projects')
+    parser.add_argument('--timeout', type=int, default=120, help='maximum seconds to wait for each ROM')
+    parser.add_argument('--baseline', help='baseline results JSON file path')
+    parser.add_argument('--update-baseline', action='store_true', help='store results in the baseline file')
+    parser.add_argument('--threshold', type=float, default=5, help='allowed regression percentage (5 by default)')
+
+    try:
+        if not process(parser.parse_args()):
+            exit(1)
+    except Exception as ex:
+        sys.stderr.write('Error: ' + str(ex) + '\n')
+        traceback.print_exc()
+        exit(-1)
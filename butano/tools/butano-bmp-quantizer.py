@@ -8,14 +8,17 @@ import argparse
 from bmp import BMP
 
 
-def process(input_file_path, output_file_path):
+def process(input_file_path, output_file_path, tile_colors_reduction):
     bmp = BMP(input_file_path)
-    bmp.quantize(output_file_path)
+    colors_count = bmp.quantize(output_file_path, tile_colors_reduction)
+    print('bpp4 image with ' + str(colors_count) + ' colors generated in ' + output_file_path)
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='butano BMP quantizer.')
     parser.add_argument('--input', required=True, help='input file path')
     parser.add_argument('--output', required=True, help='output file path')
+    parser.add_argument('--tile-colors-reduction', action='store_true',
+                        help='reduce the colors of tiles with more than 15 colors')
     args = parser.parse_args()
-    process(args.input, args.output)
+    process(args.input, args.output, args.tile_colors_reduction)
@@ -3,16 +3,21 @@ Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
 zlib License, see LICENSE file.
 """
 
+import io
 import os
-import json
-import argparse
-import subprocess
+import re
 import sys
+import json
 import time
+import argparse
 import traceback
+import contextlib
+import subprocess
+import concurrent.futures
 
 from bmp import BMP
 from file_info import FileInfo
+from asset_cache import AssetCache
 
 
 def remove_file(file_path):
@@ -20,6 +25,102 @@ def remove_file(file_path):
         os.remove(file_path)
 
 
+def flip_tile_h(tile):
+    # 4bpp rows: the first pixel is stored in the lowest nibble:
+    result = []
+
+    for row in tile:
+        flipped_row = 0
+
+        for pixel_index in range(8):
+            flipped_row |= ((row >> (pixel_index * 4)) & 0xF) << ((7 - pixel_index) * 4)
+
+        result.append(flipped_row)
+
+    return tuple(result)
+
+
+def flip_tile_v(tile):
+    return tuple(reversed(tile))
+
+
+def deduplicate_tiles(tiles):
+    # Returns the unique tiles and the index of each tile in them (bit 14 is h flip and bit 15 is v flip):
+    unique_tiles = []
+    unique_tiles_map = {}
+    tile_indexes = []
+
+    for tile in tiles:
+        tile_index = unique_tiles_map.get(tile)
+
+        if tile_index is None:
+            tile_index = len(unique_tiles)
+
+            if tile_index > 0x3FFF:
+                raise ValueError('Too many unique tiles: ' + str(tile_index + 1))
+
+            unique_tiles.append(tile)
+            h_tile = flip_tile_h(tile)
+            v_tile = flip_tile_v(tile)
+            hv_tile = flip_tile_v(h_tile)
+
+            # The same tile flipped by the same flags gives the tile back, so they can be stored in the map:
+            unique_tiles_map.setdefault(hv_tile, tile_index | 0xC000)
+            unique_tiles_map.setdefault(v_tile, tile_index | 0x8000)
+            unique_tiles_map.setdefault(h_tile, tile_index | 0x4000)
+            unique_tiles_map[tile] = tile_index
+
+        tile_indexes.append(tile_index)
+
+    return unique_tiles, tile_indexes
+
+
+def read_compression(info):
+    try:
+        compression = str(info['compression'])
+    except KeyError:
+        compression = 'none'
+
+    if compression not in ('none', 'lz77', 'run_length', 'huffman'):
+        raise ValueError('Invalid compression: ' + compression)
+
+    return compression
+
+
+def grit_compression_flag(compression, prefix):
+    if compression == 'lz77':
+        return prefix + 'zl'
+    elif compression == 'run_length':
+        return prefix + 'zr'
+
+    return prefix + 'zh'
+
+
+def compression_label(compression):
+    return 'compression_type::' + compression.upper()
+
+
+def compressed_grit_header(grit_data, grit_file_path, label, type_name, type_size):
+    # Compressed arrays are declared with their decompressed size, read from the header of the compressed data:
+    with open(grit_file_path, 'r') as grit_file:
+        grit_lines = grit_file.read().splitlines()
+
+    data_line = grit_lines[grit_lines.index(label + ':') + 1].split(None, 1)
+    directive = data_line[0]
+    values = [int(value, 16) for value in data_line[1].split(',') if value.strip()]
+
+    if directive == '.word':
+        header = values[0]
+    elif directive == '.hword':
+        header = values[0] | (values[1] << 16)
+    else:
+        header = values[0] | (values[1] << 8) | (values[2] << 16) | (values[3] << 24)
+
+    decompressed_size = header >> 8
+    return re.sub(r'unsigned \w+ ' + label + r'\[\d+\]',
+                  type_name + ' ' + label + '[' + str(int(decompressed_size / type_size)) + ']', grit_data)
+
+
 class SpriteItem:
 
     @staticmethod
@@ -34,6 +135,19 @@ class SpriteItem:
         self.__colors_count = bmp.colors_count
         self.__bpp_8 = self.__colors_count > 16
 
+        try:
+            self.__tiles_deduplication = bool(info['tiles_deduplication'])
+        except KeyError:
+            self.__tiles_deduplication = False
+
+        if self.__tiles_deduplication and self.__bpp_8:
+            raise ValueError('Tiles deduplication is not supported for 8BPP sprites')
+
+        self.__compression = read_compression(info)
+
+        if self.__tiles_deduplication and self.__compression != 'none':
+            raise ValueError('Tiles deduplication is not supported for compressed sprites')
+
         try:
             height = int(info['height'])
 
@@ -46,6 +160,9 @@ class SpriteItem:
         self.__graphics = int(bmp.height / height)
         width = bmp.width
 
+        if self.__graphics > 1 and self.__compression != 'none':
+            raise ValueError('Compressed sprites must contain only one sprite image: ' + str(self.__graphics))
+
         if width == 8:
             if height == 8:
                 self.__shape = 'SQUARE'
@@ -116,10 +233,24 @@ class SpriteItem:
 
         with open(grit_file_path, 'r') as grit_file:
             grit_data = grit_file.read()
-            grit_data = grit_data.replace('unsigned int', 'btn::tile')
-            grit_data = grit_data.replace(']', ' / (sizeof(btn::tile) / sizeof(uint32_t))]', 1)
+
+            if self.__tiles_deduplication:
+                grit_data = self.__deduplicated_grit_header(grit_data)
+
+            if self.__compression != 'none':
+                grit_data = compressed_grit_header(grit_data, grit_file_path[:-2] + '.s', name + '_btn_graphicsTiles',
+                                                   'btn::tile', 32)
+            else:
+                grit_data = grit_data.replace('unsigned int', 'btn::tile')
+                grit_data = grit_data.replace(']', ' / (sizeof(btn::tile) / sizeof(uint32_t))]', 1)
+
             grit_data = grit_data.replace('unsigned short', 'btn::color')
 
+            if self.__tiles_deduplication:
+                grit_data += '\n#define ' + name + '_btn_graphicsTileIndexesLen ' + str(self.__tiles_count * 2) + '\n'
+                grit_data += 'extern const uint16_t ' + name + '_btn_graphicsTileIndexes[' + \
+                             str(self.__tiles_count) + '];\n'
+
             for grit_line in grit_data.splitlines():
                 if 'Total size:' in grit_line:
                     total_size = int(grit_line.split()[-1])
@@ -142,12 +273,32 @@ class SpriteItem:
             header_file.write('\n')
             header_file.write('namespace btn::sprite_items' + '\n')
             header_file.write('{' + '\n')
-            header_file.write('    constexpr const sprite_item ' + name + '(' +
-                              'sprite_shape_size(sprite_shape::' + self.__shape + ', ' +
-                              'sprite_size::' + self.__size + '), ' + '\n            ' +
-                              'span<const tile>(' + name + '_btn_graphicsTiles), ' + '\n            ' +
-                              'span<const color>(' + name + '_btn_graphicsPal, ' + str(self.__colors_count) + '), ' +
-                              bpp_mode_label + ', ' + str(self.__graphics) + ');' + '\n')
+
+            if self.__tiles_deduplication:
+                header_file.write('    constexpr const sprite_item ' + name + '(' +
+                                  'sprite_shape_size(sprite_shape::' + self.__shape + ', ' +
+                                  'sprite_size::' + self.__size + '), ' + '\n            ' +
+                                  'sprite_tiles_item(span<const tile>(' + name + '_btn_graphicsTiles), ' +
+                                  'span<const uint16_t>(' + name + '_btn_graphicsTileIndexes), ' +
+                                  str(self.__graphics) + '), ' + '\n            ' +
+                                  'sprite_palette_item(span<const color>(' + name + '_btn_graphicsPal, ' +
+                                  str(self.__colors_count) + '), ' + bpp_mode_label + '));' + '\n')
+            elif self.__compression != 'none':
+                header_file.write('    constexpr const sprite_item ' + name + '(' +
+                                  'sprite_shape_size(sprite_shape::' + self.__shape + ', ' +
+                                  'sprite_size::' + self.__size + '), ' + '\n            ' +
+                                  'sprite_tiles_item(span<const tile>(' + name + '_btn_graphicsTiles), ' +
+                                  str(self.__graphics) + ', ' + compression_label(self.__compression) + '), ' +
+                                  '\n            ' +
+                                  'sprite_palette_item(span<const color>(' + name + '_btn_graphicsPal, ' +
+                                  str(self.__colors_count) + '), ' + bpp_mode_label + '));' + '\n')
+            else:
+                header_file.write('    constexpr const sprite_item ' + name + '(' +
+                                  'sprite_shape_size(sprite_shape::' + self.__shape + ', ' +
+                                  'sprite_size::' + self.__size + '), ' + '\n            ' +
+                                  'span<const tile>(' + name + '_btn_graphicsTiles), ' + '\n            ' +
+                                  'span<const color>(' + name + '_btn_graphicsPal, ' + str(self.__colors_count) +
+                                  '), ' + bpp_mode_label + ', ' + str(self.__graphics) + ');' + '\n')
             header_file.write('}' + '\n')
             header_file.write('\n')
             header_file.write('#endif' + '\n')
@@ -165,6 +316,9 @@ class SpriteItem:
         else:
             command.append('-gB8')
 
+        if self.__compression != 'none':
+            command.append(grit_compression_flag(self.__compression, '-g'))
+
         command.append('-o' + self.__build_folder_path + '/' + self.__file_name_no_ext + '_btn_graphics')
         command = ' '.join(command)
 
@@ -173,12 +327,73 @@ class SpriteItem:
         except subprocess.CalledProcessError as e:
             raise ValueError('grit call failed (return code ' + str(e.returncode) + '): ' + str(e.output))
 
+        if self.__tiles_deduplication:
+            self.__deduplicate_tiles()
+
+    def __deduplicate_tiles(self):
+        name = self.__file_name_no_ext
+        grit_file_path = self.__build_folder_path + '/' + name + '_btn_graphics.s'
+        tiles_label = name + '_btn_graphicsTiles'
+
+        with open(grit_file_path, 'r') as grit_file:
+            grit_lines = grit_file.read().splitlines()
+
+        # Replace the tiles words of the assembler file with the unique ones:
+        tiles_begin = grit_lines.index(tiles_label + ':') + 1
+        tiles_end = tiles_begin
+        words = []
+
+        while tiles_end < len(grit_lines) and grit_lines[tiles_end].strip().startswith('.word'):
+            words_text = grit_lines[tiles_end].strip()[len('.word'):]
+            words += [int(word, 16) for word in words_text.split(',') if word.strip()]
+            tiles_end += 1
+
+        tiles = [tuple(words[index:index + 8]) for index in range(0, len(words), 8)]
+        unique_tiles, tile_indexes = deduplicate_tiles(tiles)
+        tiles_lines = []
+
+        for tile in unique_tiles:
+            tiles_lines.append('\t.word ' + ','.join('0x%08X' % word for word in tile))
+
+        indexes_lines = ['', '\t.section .rodata', '\t.align\t2',
+                         '\t.global ' + name + '_btn_graphicsTileIndexes\t\t@ ' + str(len(tile_indexes) * 2) +
+                         ' unsigned chars', '\t.hidden ' + name + '_btn_graphicsTileIndexes',
+                         name + '_btn_graphicsTileIndexes:']
+
+        for index in range(0, len(tile_indexes), 8):
+            indexes_lines.append('\t.hword ' + ','.join('0x%04X' % tile_index
+                                                         for tile_index in tile_indexes[index:index + 8]))
+
+        grit_lines = grit_lines[:tiles_begin] + tiles_lines + grit_lines[tiles_end:] + indexes_lines
+
+        with open(grit_file_path, 'w') as grit_file:
+            grit_file.write('\n'.join(grit_lines) + '\n')
+
+        self.__tiles_count = len(tiles)
+        self.__unique_tiles_count = len(unique_tiles)
+        print('    Tiles deduplicated: ' + str(self.__tiles_count) + ' -> ' + str(self.__unique_tiles_count))
+
+    def __deduplicated_grit_header(self, grit_data):
+        name = self.__file_name_no_ext
+        tiles_bytes = self.__unique_tiles_count * 32
+        indexes_bytes = self.__tiles_count * 2
+        tiles_label = name + '_btn_graphicsTiles'
+        grit_data = re.sub(r'#define ' + tiles_label + r'Len \d+', '#define ' + tiles_label + 'Len ' +
+                           str(tiles_bytes), grit_data)
+        grit_data = re.sub(tiles_label + r'\[\d+\]', tiles_label + '[' + str(self.__unique_tiles_count * 8) + ']',
+                           grit_data)
+        grit_data = re.sub(r'Total size: (\d+) \+ (\d+) = (\d+)',
+                           lambda m: 'Total size: ' + m.group(1) + ' + ' + str(tiles_bytes) + ' + ' +
+                           str(indexes_bytes) + ' = ' + str(int(m.group(1)) + tiles_bytes + indexes_bytes), grit_data)
+        return grit_data
+
 
 class RegularBgItem:
 
     @staticmethod
     def valid_sizes_message():
-        return ' (valid regular BG sizes: 256x256, 512x256, 256x512, 512x512)'
+        return ' (valid regular BG sizes: 256x256, 512x256, 256x512, 512x512, ' \
+               'or big maps with width and height >= 256 and multiple of 8)'
 
     def __init__(self, file_path, file_name_no_ext, build_folder_path, info):
         bmp = BMP(file_path)
@@ -189,11 +404,19 @@ class RegularBgItem:
 
         width = bmp.width
         height = bmp.height
+        self.__compression = read_compression(info)
 
         if width == 256 and height == 256:
             self.__sbb = False
         elif (width == 256 and height == 512) or (width == 512 and height == 256) or (width == 512 and height == 512):
             self.__sbb = True
+        elif width >= 256 and height >= 256 and width % 8 == 0 and height % 8 == 0 and \
+                width <= 65536 and height <= 65536:
+            # Big maps are streamed row by row, so they are not split in screen blocks:
+            self.__sbb = False
+
+            if self.__compression != 'none':
+                raise ValueError('Big regular BGs can\'t be compressed: (' + str(width) + 'x' + str(height) + ')')
         else:
             raise ValueError('Invalid regular BG size: (' + str(width) + 'x' + str(height) + ')' +
                              RegularBgItem.valid_sizes_message())
@@ -221,10 +444,15 @@ class RegularBgItem:
             if bpp_mode == 'bpp_8':
                 self.__bpp_8 = True
             elif bpp_mode == 'bpp_4_auto':
+                try:
+                    tile_colors_reduction = bool(info['tile_colors_reduction'])
+                except KeyError:
+                    tile_colors_reduction = False
+
                 self.__file_path = self.__build_folder_path + '/' + file_name_no_ext + '.btn_quantized.bmp'
                 print('    Generating bpp4 image in ' + self.__file_path + '...')
                 start = time.time()
-                self.__colors_count = bmp.quantize(self.__file_path)
+                self.__colors_count = bmp.quantize(self.__file_path, tile_colors_reduction)
                 end = time.time()
                 print('    bpp4 image with ' + str(self.__colors_count) + ' colors generated in ' +
                       str(int((end - start) * 1000)) + ' milliseconds')
@@ -238,9 +466,18 @@ class RegularBgItem:
 
         with open(grit_file_path, 'r') as grit_file:
             grit_data = grit_file.read()
-            grit_data = grit_data.replace('unsigned int', 'btn::tile', 1)
-            grit_data = grit_data.replace(']', ' / (sizeof(btn::tile) / sizeof(uint32_t))]', 1)
-            grit_data = grit_data.replace('unsigned short', 'btn::regular_bg_map_cell', 1)
+
+            if self.__compression != 'none':
+                grit_asm_file_path = grit_file_path[:-2] + '.s'
+                grit_data = compressed_grit_header(grit_data, grit_asm_file_path, name + '_btn_graphicsTiles',
+                                                   'btn::tile', 32)
+                grit_data = compressed_grit_header(grit_data, grit_asm_file_path, name + '_btn_graphicsMap',
+                                                   'btn::regular_bg_map_cell', 2)
+            else:
+                grit_data = grit_data.replace('unsigned int', 'btn::tile', 1)
+                grit_data = grit_data.replace(']', ' / (sizeof(btn::tile) / sizeof(uint32_t))]', 1)
+                grit_data = grit_data.replace('unsigned short', 'btn::regular_bg_map_cell', 1)
+
             grit_data = grit_data.replace('unsigned short', 'btn::color', 1)
 
             for grit_line in grit_data.splitlines():
@@ -265,12 +502,25 @@ class RegularBgItem:
             header_file.write('\n')
             header_file.write('namespace btn::regular_bg_items' + '\n')
             header_file.write('{' + '\n')
-            header_file.write('    constexpr const regular_bg_item ' + name + '(' +
-                              'span<const tile>(' + name + '_btn_graphicsTiles), ' + '\n            ' +
-                              'span<const color>(' + name + '_btn_graphicsPal, ' + str(self.__colors_count) + '), ' +
-                              bpp_mode_label + ', ' + '\n            ' +
-                              name + '_btn_graphicsMap[0], ' +
-                              'size(' + str(self.__width) + ', ' + str(self.__height) + '));' + '\n')
+
+            if self.__compression != 'none':
+                compression_label_text = compression_label(self.__compression)
+                header_file.write('    constexpr const regular_bg_item ' + name + '(' +
+                                  'bg_tiles_item(span<const tile>(' + name + '_btn_graphicsTiles), ' +
+                                  compression_label_text + '), ' + '\n            ' +
+                                  'bg_palette_item(span<const color>(' + name + '_btn_graphicsPal, ' +
+                                  str(self.__colors_count) + '), ' + bpp_mode_label + '), ' + '\n            ' +
+                                  'regular_bg_map_item(' + name + '_btn_graphicsMap[0], ' +
+                                  'size(' + str(self.__width) + ', ' + str(self.__height) + '), ' +
+                                  compression_label_text + '));' + '\n')
+            else:
+                header_file.write('    constexpr const regular_bg_item ' + name + '(' +
+                                  'span<const tile>(' + name + '_btn_graphicsTiles), ' + '\n            ' +
+                                  'span<const color>(' + name + '_btn_graphicsPal, ' + str(self.__colors_count) +
+                                  '), ' + bpp_mode_label + ', ' + '\n            ' +
+                                  name + '_btn_graphicsMap[0], ' +
+                                  'size(' + str(self.__width) + ', ' + str(self.__height) + '));' + '\n')
+
             header_file.write('}' + '\n')
             header_file.write('\n')
             header_file.write('#endif' + '\n')
@@ -305,6 +555,126 @@ class RegularBgItem:
         else:
             command.append('-mLf')
 
+        if self.__compression != 'none':
+            command.append(grit_compression_flag(self.__compression, '-g'))
+            command.append(grit_compression_flag(self.__compression, '-m'))
+
+        command.append('-o' + self.__build_folder_path + '/' + self.__file_name_no_ext + '_btn_graphics')
+        command = ' '.join(command)
+
+        try:
+            subprocess.check_output(command, shell=True, stderr=subprocess.STDOUT)
+        except subprocess.CalledProcessError as e:
+            raise ValueError('grit call failed (return code ' + str(e.returncode) + '): ' + str(e.output))
+
+
+class AffineBgItem:
+
+    @staticmethod
+    def valid_sizes_message():
+        return ' (valid affine BG sizes: 128x128, 256x256, 512x512 and 1024x1024)'
+
+    def __init__(self, file_path, file_name_no_ext, build_folder_path, info):
+        bmp = BMP(file_path)
+        self.__file_path = file_path
+        self.__file_name_no_ext = file_name_no_ext
+        self.__build_folder_path = build_folder_path
+        self.__colors_count = bmp.colors_count
+
+        width = bmp.width
+        height = bmp.height
+
+        if width != height or width not in (128, 256, 512, 1024):
+            raise ValueError('Invalid affine BG size: (' + str(width) + 'x' + str(height) + ')' +
+                             AffineBgItem.valid_sizes_message())
+
+        self.__width = int(width / 8)
+        self.__height = int(height / 8)
+
+        try:
+            self.__repeated_tiles_reduction = bool(info['repeated_tiles_reduction'])
+        except KeyError:
+            self.__repeated_tiles_reduction = True
+
+        self.__compression = read_compression(info)
+
+    def write_header(self):
+        name = self.__file_name_no_ext
+        grit_file_path = self.__build_folder_path + '/' + name + '_btn_graphics.h'
+        header_file_path = self.__build_folder_path + '/btn_affine_bg_items_' + name + '.h'
+
+        with open(grit_file_path, 'r') as grit_file:
+            grit_data = grit_file.read()
+
+            if self.__compression != 'none':
+                grit_asm_file_path = grit_file_path[:-2] + '.s'
+                grit_data = compressed_grit_header(grit_data, grit_asm_file_path, name + '_btn_graphicsTiles',
+                                                   'btn::tile', 32)
+                grit_data = compressed_grit_header(grit_data, grit_asm_file_path, name + '_btn_graphicsMap',
+                                                   'btn::affine_bg_map_cell', 1)
+            else:
+                grit_data = grit_data.replace('unsigned int', 'btn::tile', 1)
+                grit_data = grit_data.replace(']', ' / (sizeof(btn::tile) / sizeof(uint32_t))]', 1)
+                grit_data = grit_data.replace('unsigned char', 'btn::affine_bg_map_cell', 1)
+
+            grit_data = grit_data.replace('unsigned short', 'btn::color', 1)
+
+            for grit_line in grit_data.splitlines():
+                if 'Total size:' in grit_line:
+                    total_size = int(grit_line.split()[-1])
+                    break
+
+        remove_file(grit_file_path)
+
+        with open(header_file_path, 'w') as header_file:
+            include_guard = 'BTN_AFFINE_BG_ITEMS_' + name.upper() + '_H'
+            header_file.write('#ifndef ' + include_guard + '\n')
+            header_file.write('#define ' + include_guard + '\n')
+            header_file.write('\n')
+            header_file.write('#include "btn_affine_bg_item.h"' + '\n')
+            header_file.write(grit_data)
+            header_file.write('\n')
+            header_file.write('namespace btn::affine_bg_items' + '\n')
+            header_file.write('{' + '\n')
+
+            if self.__compression != 'none':
+                compression_label_text = compression_label(self.__compression)
+                header_file.write('    constexpr const affine_bg_item ' + name + '(' +
+                                  'bg_tiles_item(span<const tile>(' + name + '_btn_graphicsTiles), ' +
+                                  compression_label_text + '), ' + '\n            ' +
+                                  'bg_palette_item(span<const color>(' + name + '_btn_graphicsPal, ' +
+                                  str(self.__colors_count) + '), palette_bpp_mode::BPP_8), ' + '\n            ' +
+                                  'affine_bg_map_item(' + name + '_btn_graphicsMap[0], ' +
+                                  'size(' + str(self.__width) + ', ' + str(self.__height) + '), ' +
+                                  compression_label_text + '));' + '\n')
+            else:
+                header_file.write('    constexpr const affine_bg_item ' + name + '(' +
+                                  'span<const tile>(' + name + '_btn_graphicsTiles), ' + '\n            ' +
+                                  'span<const color>(' + name + '_btn_graphicsPal, ' + str(self.__colors_count) +
+                                  '), ' + '\n            ' +
+                                  name + '_btn_graphicsMap[0], ' +
+                                  'size(' + str(self.__width) + ', ' + str(self.__height) + '));' + '\n')
+
+            header_file.write('}' + '\n')
+            header_file.write('\n')
+            header_file.write('#endif' + '\n')
+            header_file.write('\n')
+
+        print('    Graphics size: ' + str(total_size) + ' bytes')
+        print('    affine_bg_item file written in ' + header_file_path)
+        return total_size
+
+    def process(self):
+        # Affine maps have one byte per map cell and their tiles can't be flipped:
+        command = ['grit', self.__file_path, '-gB8', '-mLa', '-mu8']
+
+        if self.__repeated_tiles_reduction:
+            command.append('-mRt')
+
+        if self.__compression != 'none':
+            command.append(grit_compression_flag(self.__compression, '-g'))
+            command.append(grit_compression_flag(self.__compression, '-m'))
+
         command.append('-o' + self.__build_folder_path + '/' + self.__file_name_no_ext + '_btn_graphics')
         command = ' '.join(command)
 
@@ -316,11 +686,12 @@ class RegularBgItem:
 
 class GraphicsFileInfo:
 
-    def __init__(self, graphics_type, info, file_path, file_name, file_name_no_ext, new_file_info,
+    def __init__(self, graphics_type, info, file_path, json_file_path, file_name, file_name_no_ext, new_file_info,
                  file_info_path, new_json_file_info, json_file_info_path):
         self.__graphics_type = graphics_type
         self.__info = info
         self.__file_path = file_path
+        self.__json_file_path = json_file_path
         self.__file_name = file_name
         self.__file_name_no_ext = file_name_no_ext
         self.__new_file_info = new_file_info
@@ -328,19 +699,44 @@ class GraphicsFileInfo:
         self.__new_json_file_info = new_json_file_info
         self.__json_file_info_path = json_file_info_path
 
-    def process(self, build_folder_path):
-        print(self.__file_name)
+    def process(self, build_folder_path, cache_folder_path, tool_key):
+        # Output is captured so items processed in parallel don't mix their messages:
+        output = io.StringIO()
+
+        with contextlib.redirect_stdout(output):
+            print(self.__file_name)
+            name = self.__file_name_no_ext
+            output_file_paths = [build_folder_path + '/' + name + '_btn_graphics.s',
+                                 build_folder_path + '/btn_' + self.__graphics_type + '_items_' + name + '.h']
+            cache = AssetCache(cache_folder_path)
+            cache_key = AssetCache.build_key([tool_key, self.__graphics_type, name],
+                                             [self.__file_path, self.__json_file_path])
+            cache_info = cache.read(cache_key, output_file_paths)
+
+            if cache_info is not None:
+                file_size = int(cache_info['total_size'])
+                print('    Graphics size: ' + str(file_size) + ' bytes')
+                print('    ' + self.__graphics_type + '_item file read from cache')
+            else:
+                try:
+                    if self.__graphics_type == 'sprite':
+                        item = SpriteItem(self.__file_path, name, build_folder_path, self.__info)
+                    elif self.__graphics_type == 'regular_bg':
+                        item = RegularBgItem(self.__file_path, name, build_folder_path, self.__info)
+                    else:
+                        item = AffineBgItem(self.__file_path, name, build_folder_path, self.__info)
 
-        if self.__graphics_type == 'sprite':
-            item = SpriteItem(self.__file_path, self.__file_name_no_ext, build_folder_path, self.__info)
-        else:
-            item = RegularBgItem(self.__file_path, self.__file_name_no_ext, build_folder_path, self.__info)
+                    item.process()
+                    file_size = item.write_header()
+                except Exception as exception:
+                    raise ValueError(self.__file_name + ' processing failed: ' + str(exception))
 
-        item.process()
-        file_size = item.write_header()
-        self.__new_file_info.write(self.__file_info_path)
-        self.__new_json_file_info.write(self.__json_file_info_path)
-        return file_size
+                cache.write(cache_key, output_file_paths, {'total_size': file_size})
+
+            self.__new_file_info.write(self.__file_info_path)
+            self.__new_json_file_info.write(self.__json_file_info_path)
+
+        return output.getvalue(), file_size
 
 
 def list_graphics_file_infos(graphics_folder_paths, build_folder_path):
@@ -348,6 +744,7 @@ def list_graphics_file_infos(graphics_folder_paths, build_folder_path):
     graphics_file_infos = []
     sprite_file_names_set = set()
     regular_bg_file_names_set = set()
+    affine_bg_file_names_set = set()
 
     for graphics_folder_path in graphics_folder_path_list:
         graphics_file_names = sorted(os.listdir(graphics_folder_path))
@@ -381,6 +778,8 @@ def list_graphics_file_infos(graphics_folder_paths, build_folder_path):
                         file_names_set = sprite_file_names_set
                     elif graphics_type == 'regular_bg':
                         file_names_set = regular_bg_file_names_set
+                    elif graphics_type == 'affine_bg':
+                        file_names_set = affine_bg_file_names_set
                     else:
                         raise ValueError('Unknown type (' + graphics_type + ') in graphics json file: ' +
                                          json_file_path)
@@ -401,20 +800,41 @@ def list_graphics_file_infos(graphics_folder_paths, build_folder_path):
 
                     if old_file_info != new_file_info or old_json_file_info != new_json_file_info:
                         graphics_file_infos.append(GraphicsFileInfo(
-                            graphics_type, info, graphics_file_path, graphics_file_name, graphics_file_name_no_ext,
-                            new_file_info, file_info_path, new_json_file_info, json_file_info_path))
+                            graphics_type, info, graphics_file_path, json_file_path, graphics_file_name,
+                            graphics_file_name_no_ext, new_file_info, file_info_path, new_json_file_info, json_file_info_path))
 
     return graphics_file_infos
 
 
-def process(graphics_folder_paths, build_folder_path):
+def process_graphics_file_info(graphics_file_info, build_folder_path, cache_folder_path, tool_key):
+    return graphics_file_info.process(build_folder_path, cache_folder_path, tool_key)
+
+
+def process(graphics_folder_paths, build_folder_path, jobs):
     graphics_file_infos = list_graphics_file_infos(graphics_folder_paths, build_folder_path)
 
     if len(graphics_file_infos) > 0:
+        cache_folder_path = AssetCache.folder_path(build_folder_path)
+        tool_key = AssetCache.tool_key(__file__, ['bmp.py'])
         total_size = 0
 
-        for graphics_file_info in graphics_file_infos:
-            total_size += graphics_file_info.process(build_folder_path)
+        if jobs > 1 and len(graphics_file_infos) > 1:
+            with concurrent.futures.ProcessPoolExecutor(max_workers=jobs) as executor:
+                futures = [executor.submit(process_graphics_file_info, graphics_file_info, build_folder_path,
+                                           cache_folder_path, tool_key)
+                           for graphics_file_info in graphics_file_infos]
+
+                # Results are printed in submission order, so the build log is deterministic:
+                for future in futures:
+                    output, file_size = future.result()
+                    sys.stdout.write(output)
+                    total_size += file_size
+        else:
+            for graphics_file_info in graphics_file_infos:
+                output, file_size = process_graphics_file_info(graphics_file_info, build_folder_path,
+                                                               cache_folder_path, tool_key)
+                sys.stdout.write(output)
+                total_size += file_size
 
         print('    ' + 'Processed graphics size: ' + str(total_size) + ' bytes')
 
@@ -423,10 +843,11 @@ if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='butano graphics tool.')
     parser.add_argument('--graphics', required=True, help='graphics folder paths')
     parser.add_argument('--build', required=True, help='build folder path')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='max number of parallel jobs')
 
     try:
         args = parser.parse_args()
-        process(args.graphics, args.build)
+        process(args.graphics, args.build, max(args.jobs or 1, 1))
     except Exception as ex:
         sys.stderr.write('Error: ' + str(ex) + '\n')
         traceback.print_exc()
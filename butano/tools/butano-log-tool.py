@@ -0,0 +1,225 @@
+"""
+Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+zlib License, see LICENSE file.
+"""
+
+import argparse
+import struct
+import sys
+import traceback
+
+ROM_ADDRESS = 0x08000000
+FIXED_TAG = 0x80
+
+
+class LogDump:
+
+    def __init__(self, dropped_messages_count, data):
+        self.dropped_messages_count = dropped_messages_count
+        self.data = data
+
+
+def read_dumps(input_file_path):
+    dumps = []
+    current_data = None
+
+    with open(input_file_path, 'r', errors='replace') as input_file:
+        for line in input_file:
+            if 'btn_log_begin' in line:
+                current_data = bytearray()
+            elif 'btn_log_end' in line:
+                if current_data is not None and len(current_data) >= 5:
+                    version, dropped_messages_count = struct.unpack_from('<BI', current_data, 0)
+
+                    if version != 1:
+                        raise ValueError('Unsupported log dump version: ' + str(version))
+
+                    dumps.append(LogDump(dropped_messages_count, bytes(current_data[5:])))
+
+                current_data = None
+            elif current_data is not None:
+                position = line.find('btn_log:')
+
+                if position >= 0:
+                    current_data += bytes.fromhex(line[position + len('btn_log:'):].strip())
+
+    return dumps
+
+
+class Rom:
+
+    def __init__(self, rom_file_path):
+        with open(rom_file_path, 'rb') as rom_file:
+            self._data = rom_file.read()
+
+    def read_text(self, address):
+        offset = address - ROM_ADDRESS
+
+        if offset < 0 or offset >= len(self._data):
+            raise ValueError('Address out of ROM: ' + hex(address))
+
+        end = self._data.find(b'\0', offset)
+
+        if end < 0:
+            end = len(self._data)
+
+        return self._data[offset:end]
+
+
+class WordsReader:
+
+    def __init__(self, data):
+        self._data = data
+        self._offset = 0
+
+    def offset(self):
+        return self._offset
+
+    def done(self):
+        return self._offset + 4 > len(self._data)
+
+    def read(self):
+        if self.done():
+            raise EOFError()
+
+        result = struct.unpack_from('<I', self._data, self._offset)[0]
+        self._offset += 4
+        return result
+
+    def read_signed(self):
+        word = self.read()
+        return word - (1 << 32) if word & 0x80000000 else word
+
+    def read_text(self):
+        size = self.read()
+        words = (size + 3) // 4
+
+        if self._offset + (words * 4) > len(self._data):
+            raise EOFError()
+
+        result = self._data[self._offset:self._offset + size]
+        self._offset += words * 4
+        return result.decode('utf-8', 'replace')
+
+
+def fixed_text(data, precision):
+    # Same output as btn::ostringstream::append(fixed_t<Precision>) with the default decimal precision:
+    if data < 0:
+        return '-' + fixed_text(-data, precision)
+
+    scale = 1 << precision
+    result = str(data // scale)
+    fraction_digits = 6 - len(result)
+    fraction = data & (scale - 1)
+
+    if fraction_digits > 0 and fraction:
+        fraction_result = (fraction * (10 ** fraction_digits)) // scale
+
+        if fraction_result:
+            result += '.' + str(fraction_result).rjust(fraction_digits, '0')
+
+    return result
+
+
+def read_arg(tag, reader, rom):
+    if tag == ord('b'):
+        return 'true' if reader.read() else 'false'
+
+    if tag == ord('c'):
+        return chr(reader.read() & 0xFF)
+
+    if tag == ord('i'):
+        return str(reader.read_signed())
+
+    if tag == ord('u'):
+        return str(reader.read())
+
+    if tag == ord('l') or tag == ord('L'):
+        low = reader.read()
+        value = (reader.read() << 32) | low
+
+        if tag == ord('l') and value & (1 << 63):
+            value -= 1 << 64
+
+        return str(value)
+
+    if tag == ord('p'):
+        return hex(reader.read())
+
+    if tag == ord('n'):
+        return 'nullptr'
+
+    if tag == ord('s'):
+        address = reader.read()
+
+        if address:
+            return rom.read_text(address).decode('utf-8', 'replace')
+
+        return reader.read_text()
+
+    if tag == ord('t'):
+        return reader.read_text()
+
+    if tag >= FIXED_TAG:
+        return fixed_text(reader.read_signed(), tag - FIXED_TAG)
+
+    raise ValueError('Invalid argument tag: ' + str(tag))
+
+
+def read_messages(dumps, rom):
+    data = bytearray()
+    dropped_messages = []
+    last_dropped_messages_count = 0
+
+    for dump in dumps:
+        data += dump.data
+
+        if dump.dropped_messages_count > last_dropped_messages_count:
+            dropped_messages.append((len(data), dump.dropped_messages_count - last_dropped_messages_count))
+            last_dropped_messages_count = dump.dropped_messages_count
+
+    reader = WordsReader(bytes(data))
+    messages = []
+
+    while not reader.done():
+        # Messages are dropped when the ring buffer is full, so they are reported after the dump which counted them:
+        while len(dropped_messages) > 0 and dropped_messages[0][0] <= reader.offset():
+            messages.append('[' + str(dropped_messages.pop(0)[1]) + ' messages dropped]')
+
+        try:
+            tags = rom.read_text(reader.read())
+            messages.append(''.join(read_arg(tag, reader, rom) for tag in tags))
+        except EOFError:
+            messages.append('[incomplete message]')
+
+    for _, dropped_messages_count in dropped_messages:
+        messages.append('[' + str(dropped_messages_count) + ' messages dropped]')
+
+    return messages
+
+
+def process(input_file_path, rom_file_path, output_file_path):
+    messages = read_messages(read_dumps(input_file_path), Rom(rom_file_path))
+
+    if output_file_path is None:
+        for message in messages:
+            print(message)
+    else:
+        with open(output_file_path, 'w') as output_file:
+            for message in messages:
+                output_file.write(message + '\n')
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='butano deferred log tool.')
+    parser.add_argument('--input', required=True, help='emulator log file path')
+    parser.add_argument('--rom', required=True, help='ROM file path (used to retrieve messages format and texts)')
+    parser.add_argument('--output', help='messages output file path (they are printed by default)')
+
+    try:
+        args = parser.parse_args()
+        process(args.input, args.rom, args.output)
+    except Exception as ex:
+        sys.stderr.write('Error: ' + str(ex) + '\n')
+        traceback.print_exc()
+        exit(-1)
@@ -0,0 +1,182 @@
+"""
+Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+zlib License, see LICENSE file.
+"""
+
+import argparse
+import math
+import struct
+import sys
+import traceback
+
+
+class ProfilerEntry:
+
+    def __init__(self, entry_id, parent_index, total_ticks, max_ticks, max_frame_ticks, max_frame_index, frames):
+        self.id = entry_id
+        self.parent_index = parent_index
+        self.total_ticks = total_ticks
+        self.max_ticks = max_ticks
+        self.max_frame_ticks = max_frame_ticks
+        self.max_frame_index = max_frame_index
+        self.frames = frames
+
+    def percentile(self, percent):
+        if len(self.frames) == 0:
+            return 0
+
+        sorted_frames = sorted(self.frames)
+        return sorted_frames[int(math.ceil(len(sorted_frames) * percent / 100)) - 1]
+
+    def spike_frames(self, first_frame_index):
+        p50 = self.percentile(50)
+        return [first_frame_index + index for index, ticks in enumerate(self.frames) if ticks > p50 * 2]
+
+
+class ProfilerResults:
+
+    def __init__(self, data):
+        self._data = data
+        self._offset = 0
+
+        version = self._read('<B')
+
+        if version != 1:
+            raise ValueError('Unsupported profiler dump version: ' + str(version))
+
+        self.ticks_per_frame = self._read('<I')
+        self.frames_count = self._read('<I')
+        stored_frames = self._read('<H')
+        entries_count = self._read('<H')
+        self.first_frame_index = self.frames_count - stored_frames
+        self.entries = []
+
+        for _ in range(entries_count):
+            id_size = self._read('<B')
+            entry_id = self._data[self._offset:self._offset + id_size].decode('utf-8', 'replace')
+            self._offset += id_size
+            parent_index = self._read('<H')
+            total_ticks = self._read('<Q')
+            max_ticks = self._read('<I')
+            max_frame_ticks = self._read('<I')
+            max_frame_index = self._read('<I')
+            frames = [self._read('<I') for _ in range(stored_frames)]
+
+            if parent_index == 0xFFFF:
+                parent_index = None
+
+            self.entries.append(ProfilerEntry(entry_id, parent_index, total_ticks, max_ticks, max_frame_ticks,
+                                              max_frame_index, frames))
+
+    def stack(self, entry):
+        ids = []
+        visited = set()
+
+        while entry is not None and id(entry) not in visited:
+            visited.add(id(entry))
+            ids.append(entry.id)
+            entry = None if entry.parent_index is None else self.entries[entry.parent_index]
+
+        return ';'.join(reversed(ids))
+
+    def folded_stacks(self, frame_index):
+        if frame_index is None:
+            values = [entry.total_ticks for entry in self.entries]
+        else:
+            frame = frame_index - self.first_frame_index
+
+            if frame < 0 or frame >= len(self.entries[0].frames if len(self.entries) > 0 else []):
+                raise ValueError('Frame not stored in profiler dump: ' + str(frame_index))
+
+            values = [entry.frames[frame] for entry in self.entries]
+
+        # Flame charts expect self ticks, so children ticks are removed from their parents:
+        self_values = list(values)
+
+        for index, entry in enumerate(self.entries):
+            if entry.parent_index is not None:
+                self_values[entry.parent_index] -= values[index]
+
+        lines = []
+
+        for index, entry in enumerate(self.entries):
+            if self_values[index] > 0:
+                lines.append(self.stack(entry) + ' ' + str(self_values[index]))
+
+        return lines
+
+    def _read(self, fmt):
+        result = struct.unpack_from(fmt, self._data, self._offset)[0]
+        self._offset += struct.calcsize(fmt)
+        return result
+
+
+def read_dump(input_file_path):
+    data = None
+    current_data = None
+
+    with open(input_file_path, 'r', errors='replace') as input_file:
+        for line in input_file:
+            if 'btn_profiler_begin' in line:
+                current_data = bytearray()
+            elif 'btn_profiler_end' in line:
+                if current_data is not None:
+                    data = current_data
+                    current_data = None
+            elif current_data is not None:
+                position = line.find('btn_profiler:')
+
+                if position >= 0:
+                    current_data += bytes.fromhex(line[position + len('btn_profiler:'):].strip())
+
+    if data is None:
+        raise ValueError('Profiler dump not found in ' + input_file_path)
+
+    return ProfilerResults(bytes(data))
+
+
+def print_summary(results):
+    print('Frames: ' + str(results.frames_count) + ' (last ' + str(len(results.entries[0].frames)
+                                                                      if len(results.entries) > 0 else 0) + ' stored)')
+    print('Ticks per frame: ' + str(results.ticks_per_frame))
+    print()
+
+    header = ('id', 'total', 'max', 'p50', 'p95', 'p99', 'worst frame', 'spike frames')
+    rows = []
+
+    for entry in sorted(results.entries, key=lambda e: e.total_ticks, reverse=True):
+        spike_frames = entry.spike_frames(results.first_frame_index)
+        rows.append((results.stack(entry), str(entry.total_ticks), str(entry.max_ticks), str(entry.percentile(50)),
+                     str(entry.percentile(95)), str(entry.percentile(99)),
+                     str(entry.max_frame_index) + ' (' + str(entry.max_frame_ticks) + ')',
+                     ' '.join(str(frame) for frame in spike_frames[:8]) + (' ...' if len(spike_frames) > 8 else '')))
+
+    widths = [max(len(row[column]) for row in rows + [header]) for column in range(len(header))]
+
+    for row in [header] + rows:
+        print('  '.join(value.ljust(widths[column]) for column, value in enumerate(row)).rstrip())
+
+
+def process(input_file_path, output_file_path, frame_index):
+    results = read_dump(input_file_path)
+    print_summary(results)
+
+    if output_file_path is not None:
+        with open(output_file_path, 'w') as output_file:
+            for line in results.folded_stacks(frame_index):
+                output_file.write(line + '\n')
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='butano profiler tool.')
+    parser.add_argument('--input', required=True, help='emulator log file path')
+    parser.add_argument('--output', help='folded stacks output file path (for flamegraph.pl or speedscope)')
+    parser.add_argument('--frame', type=int, help='frame index to export (all frames are exported by default)')
+
+    try:
+        args = parser.parse_args()
+        process(args.input, args.output, args.frame)
+    except Exception as ex:
+        sys.stderr.write('Error: ' + str(ex) + '\n')
+        traceback.print_exc()
+        exit(-1)
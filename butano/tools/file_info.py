@@ -5,6 +5,7 @@ zlib License, see LICENSE file.
 
 import os
 import string
+import hashlib
 
 
 class FileInfo:
@@ -52,7 +53,10 @@ class FileInfo:
         for file_path in file_paths:
             info.append(file_path)
             info.append(str(os.path.getsize(file_path)))
-            info.append(str(os.path.getmtime(file_path)))
+
+            # Contents are compared instead of modification times, so checkouts don't force asset rebuilds:
+            with open(file_path, 'rb') as file:
+                info.append(hashlib.sha1(file.read()).hexdigest())
 
         return FileInfo('\n'.join(info), False)
 
@@ -176,7 +176,8 @@ int main()
         info.update();
         stats.update();
         btn::core::update();
-        btn::hw::hdma::start(hdma_source_data, 4 * max_polygon_sprites,
+        // H-Blank effects are committed with the IRQ backend (see Makefile), so HDMA channels are free to use:
+        btn::hw::hdma::start(1, hdma_source_data, 4 * max_polygon_sprites,
                              &btn::hw::sprites::vram()[128 - max_polygon_sprites].attr0);
     }
 }
@@ -35,7 +35,8 @@ int main()
         user_polygon_sprite.update(max_polygon_sprites, hdma_source_data);
 
         btn::core::update();
-        btn::hw::hdma::start(hdma_source_data, 4 * max_polygon_sprites,
+        // H-Blank effects are committed with the IRQ backend (see Makefile), so HDMA channels are free to use:
+        btn::hw::hdma::start(1, hdma_source_data, 4 * max_polygon_sprites,
                              &btn::hw::sprites::vram()[128 - max_polygon_sprites].attr0);
     }
 }
@@ -0,0 +1,1503 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+// Microbenchmarks of the hardware independent parts of the engine.
+//
+// Usage: benchmarks [--csv] [filter]
+//
+// Each benchmark is run several times and the best time is reported, since the worst ones are usually caused by the
+// operating system. Only the benchmarks which name contains the filter are run.
+//
+// Host timings don't match GBA timings, but they are good enough to detect regressions and to compare algorithms.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "btn_list.h"
+#include "btn_math.h"
+#include "btn_vector.h"
+#include "btn_optional.h"
+#include "btn_cstdlib.h"
+#include "btn_sprites.h"
+#include "btn_sprite_ptr.h"
+#include "btn_sprite_font.h"
+#include "btn_sprite_item.h"
+#include "btn_sprite_affine_mats.h"
+#include "btn_unordered_map.h"
+#include "btn_collision_grid.h"
+#include "btn_reciprocal_division.h"
+#include "btn_sprite_text.h"
+#include "btn_bg_tiles.h"
+#include "btn_bg_tiles_ptr.h"
+#include "btn_sprite_tiles.h"
+#include "btn_sprite_tiles_ptr.h"
+#include "btn_bg_palette_ptr.h"
+#include "btn_regular_bg_map_ptr.h"
+#include "btn_sprite_text_generator.h"
+#include "btn_bgs_manager.h"
+#include "btn_memory_manager.h"
+#include "btn_cameras_manager.h"
+#include "btn_display_manager.h"
+#include "btn_sprites_manager.h"
+#include "btn_palettes_manager.h"
+#include "btn_bg_blocks_manager.h"
+#include "btn_sprite_tiles_manager.h"
+#include "btn_hw_tonc.h"
+#include "btn_decompressor.h"
+#include "btn_palette_effects.h"
+#include "btn_audio_stream_mixer.h"
+#include "btn_hw_sprites.h"
+#include "btn_hw_bg_blocks.h"
+#include "btn_hw_sprite_tiles.h"
+#include "btn_vram_commits_manager.h"
+
+#include "bios_compressors.h"
+#include "legacy_unordered_map.h"
+#include "software_division.h"
+
+namespace
+{
+    constexpr const int runs = 9;
+
+    bool csv_output = false;
+    const char* name_filter = nullptr;
+
+    // Prevents the compiler from removing the benchmarked code:
+    volatile int sink;
+
+
+    class random_generator
+    {
+
+    public:
+        [[nodiscard]] unsigned get()
+        {
+            _state ^= _state << 13;
+            _state ^= _state >> 17;
+            _state ^= _state << 5;
+            return _state;
+        }
+
+        [[nodiscard]] int get_int(int limit)
+        {
+            return int(get() % unsigned(limit));
+        }
+
+    private:
+        unsigned _state = 123456789;
+    };
+
+
+    // Synthetic 8x8 font, with the minimum number of characters and a fixed width:
+    const btn::tile font_tiles[btn::sprite_font::minimum_graphics] = {};
+    const btn::color font_colors[16] = {};
+    constexpr const btn::sprite_item font_item(
+            btn::sprite_shape_size(btn::sprite_shape::SQUARE, btn::sprite_size::SMALL), font_tiles, font_colors,
+            btn::palette_bpp_mode::BPP_4, btn::sprite_font::minimum_graphics);
+    constexpr const btn::sprite_font font(font_item, btn::span<const btn::string_view>());
+
+
+    // Synthetic 16x16 animation with deduplicated tiles, in which only one tile changes between frames:
+    const btn::tile animation_tiles[4] = {};
+    constexpr const uint16_t animation_tile_indexes[] = {
+        0, 1, 1, 0,
+        0, 1, 1, 0x4000 | 2,
+        0, 1, 1, 0x8000 | 2,
+        0, 1, 1, 0xC000 | 2,
+        0, 1, 1, 3,
+        0, 1, 1, 0x4000 | 3,
+        0, 1, 1, 0x8000 | 3,
+        0, 1, 1, 0xC000 | 3,
+    };
+    constexpr const btn::sprite_tiles_item animation_tiles_item(
+            animation_tiles, animation_tile_indexes, 8);
+
+
+    // Synthetic 4bpp tiles with the usual mix of flat areas, repeated patterns and noise:
+    [[nodiscard]] std::vector<uint8_t> synthetic_tiles_data(int tiles_count)
+    {
+        std::vector<uint8_t> result;
+        random_generator random;
+
+        for(int tile_index = 0; tile_index < tiles_count; ++tile_index)
+        {
+            int kind = random.get_int(4);
+            uint8_t color = uint8_t(random.get_int(16) * 0x11);
+
+            for(int byte_index = 0; byte_index < int(sizeof(btn::tile)); ++byte_index)
+            {
+                switch(kind)
+                {
+
+                case 0:
+                    result.push_back(color);
+                    break;
+
+                case 1:
+                    result.push_back(uint8_t(byte_index % 4 < 2 ? color : 0x12));
+                    break;
+
+                case 2:
+                    result.push_back(uint8_t(random.get_int(3)));
+                    break;
+
+                default:
+                    result.push_back(uint8_t(random.get()));
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    void frame()
+    {
+        btn::cameras_manager::update();
+        btn::sprites_manager::update();
+        btn::sprite_tiles_manager::update();
+        btn::bgs_manager::update();
+        btn::bg_blocks_manager::update();
+        btn::palettes_manager::update();
+        btn::display_manager::update();
+
+        btn::vram_commits_manager::start();
+        btn::display_manager::commit();
+        btn::sprites_manager::commit();
+        btn::bgs_manager::commit();
+        btn::palettes_manager::commit();
+        btn::sprite_tiles_manager::commit();
+        btn::bg_blocks_manager::commit();
+    }
+
+    template<typename Function>
+    void run(const char* name, int operations, const Function& function)
+    {
+        if(name_filter && ! std::strstr(name, name_filter))
+        {
+            return;
+        }
+
+        using clock = std::chrono::steady_clock;
+        double best_ns = 0;
+
+        for(int run_index = 0; run_index < runs; ++run_index)
+        {
+            auto start = clock::now();
+            function();
+
+            double elapsed_ns = double(std::chrono::nanoseconds(clock::now() - start).count());
+
+            if(! run_index || elapsed_ns < best_ns)
+            {
+                best_ns = elapsed_ns;
+            }
+        }
+
+        if(csv_output)
+        {
+            std::printf("%s,%d,%.1f,%.2f\n", name, operations, best_ns, best_ns / operations);
+        }
+        else
+        {
+            std::printf("%-36s %10d %14.1f %12.2f\n", name, operations, best_ns, best_ns / operations);
+        }
+    }
+
+    void container_benchmarks()
+    {
+        run("vector push_back/pop_back", 2048, []
+        {
+            btn::vector<int, 1024> vector;
+
+            for(int index = 0; index < 1024; ++index)
+            {
+                vector.push_back(index);
+            }
+
+            while(! vector.empty())
+            {
+                sink = vector.back();
+                vector.pop_back();
+            }
+        });
+
+        run("vector front insert/erase", 512, []
+        {
+            btn::vector<int, 256> vector;
+
+            for(int index = 0; index < 256; ++index)
+            {
+                vector.insert(vector.begin(), index);
+            }
+
+            while(! vector.empty())
+            {
+                sink = vector.front();
+                vector.erase(vector.begin());
+            }
+        });
+
+        run("list push_back/pop_front", 2048, []
+        {
+            btn::list<int, 1024> list;
+
+            for(int index = 0; index < 1024; ++index)
+            {
+                list.push_back(index);
+            }
+
+            while(! list.empty())
+            {
+                sink = list.front();
+                list.pop_front();
+            }
+        });
+
+        run("unordered_map insert/find/erase", 3 * 512, []
+        {
+            btn::unordered_map<int, int, 1024> map;
+            random_generator random;
+            int keys[512];
+
+            for(int& key : keys)
+            {
+                key = int(random.get());
+                map.insert_or_assign(key, key);
+            }
+
+            for(int key : keys)
+            {
+                sink = map.find(key)->second;
+            }
+
+            for(int key : keys)
+            {
+                map.erase(key);
+            }
+        });
+
+        // Find, insert and erase mix with pointer keys and a 50% max load factor, like the VRAM items maps.
+        // Operations follow a fixed pattern, so branch mispredictions don't hide the cost of the maps:
+        constexpr int mix_keys_count = 256;
+        constexpr int mix_operations_count = 4096;
+        static char mix_keys_data[mix_keys_count * 32];
+        static const void* mix_keys[mix_keys_count];
+        static int mix_key_indexes[mix_operations_count];
+        random_generator random;
+
+        for(int index = 0; index < mix_keys_count; ++index)
+        {
+            mix_keys[index] = mix_keys_data + (index * 32);
+        }
+
+        for(int index = 0; index < mix_operations_count; ++index)
+        {
+            mix_key_indexes[index] = random.get_int(mix_keys_count);
+        }
+
+        run("unordered_map ops mix", mix_operations_count, []
+        {
+            btn::unordered_map<const void*, int, mix_keys_count> map;
+
+            for(int index = 0; index < mix_operations_count; ++index)
+            {
+                const void* key = mix_keys[mix_key_indexes[index]];
+
+                switch(index % 8)
+                {
+
+                case 0:
+                    map.insert(key, index);
+                    break;
+
+                case 1:
+                    map.erase(key);
+                    break;
+
+                default:
+                    {
+                        auto it = map.find(key);
+                        sink = it == map.end() ? 0 : it->second;
+                    }
+                    break;
+                }
+            }
+        });
+
+        run("legacy unordered_map ops mix", mix_operations_count, []
+        {
+            legacy_unordered_map<const void*, int, mix_keys_count> map;
+
+            for(int index = 0; index < mix_operations_count; ++index)
+            {
+                const void* key = mix_keys[mix_key_indexes[index]];
+
+                switch(index % 8)
+                {
+
+                case 0:
+                    map.insert(key, index);
+                    break;
+
+                case 1:
+                    map.erase(key);
+                    break;
+
+                default:
+                    {
+                        auto value = map.find(key);
+                        sink = value ? value->second : 0;
+                    }
+                    break;
+                }
+            }
+        });
+    }
+
+    // Divisions of many values by the same divisor, like the ones of a frame of game logic:
+    void division_benchmarks()
+    {
+        static int numerators[1024];
+        static int divisors[1024];
+        static int results[1024];
+        static btn::fixed fixed_results[1024];
+        random_generator random;
+
+        for(int index = 0; index < 1024; ++index)
+        {
+            numerators[index] = int(random.get()) >> random.get_int(32);
+            divisors[index] = 1 + random.get_int(1 << random.get_int(31));
+        }
+
+        int mismatches = 0;
+
+        for(int divisor_index = 0; divisor_index < 64; ++divisor_index)
+        {
+            int divisor = divisors[divisor_index];
+            btn::reciprocal_division division(divisor);
+            btn::fixed_reciprocal_division fixed_division(btn::fixed::from_data(divisor));
+
+            for(int numerator : numerators)
+            {
+                btn::fixed fixed_numerator = btn::fixed::from_data(numerator);
+                mismatches += division.divide(numerator) != numerator / divisor;
+                mismatches += software_division::sdiv32(numerator, divisor) != numerator / divisor;
+                mismatches += fixed_division.divide(fixed_numerator) !=
+                        fixed_numerator.safe_division(btn::fixed::from_data(divisor));
+            }
+        }
+
+        std::printf("# reciprocal_division mismatches: %d\n", mismatches);
+
+        run("division operator", 1024, []
+        {
+            int divisor = divisors[sink & 1];
+            int result = 0;
+
+            for(int numerator : numerators)
+            {
+                result += numerator / divisor;
+            }
+
+            sink = result;
+        });
+
+        run("software sdiv32", 1024, []
+        {
+            int divisor = divisors[sink & 1];
+            int result = 0;
+
+            for(int numerator : numerators)
+            {
+                result += software_division::sdiv32(numerator, divisor);
+            }
+
+            sink = result;
+        });
+
+        run("reciprocal_division setup", 1024, []
+        {
+            int result = 0;
+
+            for(int divisor : divisors)
+            {
+                result += btn::reciprocal_division(divisor).divide(0x7FFFFFFF);
+            }
+
+            sink = result;
+        });
+
+        run("reciprocal_division divide", 1024, []
+        {
+            btn::reciprocal_division division(divisors[sink & 1]);
+            int result = 0;
+
+            for(int numerator : numerators)
+            {
+                result += division.divide(numerator);
+            }
+
+            sink = result;
+        });
+
+        run("reciprocal_division batch", 1024, []
+        {
+            btn::reciprocal_division division(divisors[sink & 1]);
+            division.divide(numerators, results);
+            sink = results[1023];
+        });
+
+        run("fixed safe_division", 1024, []
+        {
+            btn::fixed divisor = btn::fixed::from_data(divisors[sink & 1]);
+            int result = 0;
+
+            for(int numerator : numerators)
+            {
+                result += btn::fixed::from_data(numerator).safe_division(divisor).data();
+            }
+
+            sink = result;
+        });
+
+        run("fixed_reciprocal_division divide", 1024, []
+        {
+            btn::fixed_reciprocal_division division(btn::fixed::from_data(divisors[sink & 1]));
+            int result = 0;
+
+            for(int numerator : numerators)
+            {
+                result += division.divide(btn::fixed::from_data(numerator)).data();
+            }
+
+            sink = result;
+        });
+
+        run("fixed_reciprocal_division batch", 1024, []
+        {
+            btn::fixed_reciprocal_division division(btn::fixed::from_data(divisors[sink & 1]));
+            division.divide(btn::span<const btn::fixed>(reinterpret_cast<const btn::fixed*>(numerators), 1024),
+                            fixed_results);
+            sink = fixed_results[1023].data();
+        });
+    }
+
+    void math_benchmarks()
+    {
+        static btn::fixed values[1024];
+        random_generator random;
+
+        for(btn::fixed& value : values)
+        {
+            value = btn::fixed::from_data(1 + random.get_int(256 << btn::fixed().precision()));
+        }
+
+        run("fixed multiplication", 1024, []
+        {
+            btn::fixed result = 1;
+
+            for(btn::fixed value : values)
+            {
+                result = (result * value) + 1;
+            }
+
+            sink = result.data();
+        });
+
+        run("fixed division", 1024, []
+        {
+            btn::fixed result = 1;
+
+            for(btn::fixed value : values)
+            {
+                result = (result / value) + 1;
+            }
+
+            sink = result.data();
+        });
+
+        run("fixed sqrt", 1024, []
+        {
+            int result = 0;
+
+            for(btn::fixed value : values)
+            {
+                result += btn::sqrt(value).data();
+            }
+
+            sink = result;
+        });
+
+        run("fixed degrees_sin", 1024, []
+        {
+            int result = 0;
+
+            for(btn::fixed value : values)
+            {
+                result += btn::degrees_sin(value.integer() % 360).data();
+            }
+
+            sink = result;
+        });
+    }
+
+    void memory_benchmarks()
+    {
+        run("malloc/free small", 2 * 512, []
+        {
+            static void* ptrs[512];
+            random_generator random;
+
+            for(void*& ptr : ptrs)
+            {
+                ptr = btn::malloc(1 + random.get_int(60));
+            }
+
+            for(void* ptr : ptrs)
+            {
+                btn::free(ptr);
+            }
+        });
+
+        run("malloc/free big", 2 * 64, []
+        {
+            static void* ptrs[64];
+            random_generator random;
+
+            for(void*& ptr : ptrs)
+            {
+                ptr = btn::malloc(256 + random.get_int(2048));
+            }
+
+            for(int index = 0; index < 64; index += 2)
+            {
+                btn::free(ptrs[index]);
+            }
+
+            for(int index = 1; index < 64; index += 2)
+            {
+                btn::free(ptrs[index]);
+            }
+        });
+    }
+
+    void sprite_benchmarks()
+    {
+        run("sprite_tiles_ptr allocate/release", 2 * 64, []
+        {
+            btn::vector<btn::sprite_tiles_ptr, 64> tiles;
+            random_generator random;
+
+            for(int index = 0; index < 64; ++index)
+            {
+                constexpr const int tiles_counts[] = { 1, 2, 4, 8, 16 };
+                tiles.push_back(btn::sprite_tiles_ptr::allocate(tiles_counts[random.get_int(5)]));
+            }
+
+            for(int index = 0; index < 64; index += 2)
+            {
+                tiles[index] = btn::sprite_tiles_ptr::allocate(1);
+            }
+
+            tiles.clear();
+            frame();
+        });
+
+        run("sprite_tiles_ptr deduplicated animation", 64, []
+        {
+            btn::sprite_tiles_ptr tiles = btn::sprite_tiles_ptr::create(animation_tiles_item, 0);
+
+            for(int index = 0; index < 64; ++index)
+            {
+                tiles.set_tiles_ref(animation_tiles_item, index % animation_tiles_item.graphics_count());
+                frame();
+            }
+        });
+
+        run("sprite create/update", 128, []
+        {
+            btn::vector<btn::sprite_ptr, 128> sprites;
+            random_generator random;
+
+            for(int index = 0; index < 128; ++index)
+            {
+                btn::sprite_ptr sprite = btn::sprite_ptr::create(random.get_int(240) - 120, random.get_int(160) - 80,
+                                                                 font_item, random.get_int(32));
+                sprite.set_bg_priority(random.get_int(4));
+                sprite.set_z_order(random.get_int(4));
+                sprites.push_back(btn::move(sprite));
+            }
+
+            frame();
+
+            for(btn::sprite_ptr& sprite : sprites)
+            {
+                sprite.set_z_order(random.get_int(4));
+            }
+
+            frame();
+            sprites.clear();
+            frame();
+        });
+
+        // Bullets falling across the screen, more than the hardware can show without the multiplexer:
+        btn::sprites::set_multiplexer_enabled(true);
+
+        run("sprite multiplexer", 256 * 8, []
+        {
+            btn::vector<btn::sprite_ptr, 256> sprites;
+            random_generator random;
+
+            for(int index = 0; index < 256; ++index)
+            {
+                sprites.push_back(btn::sprite_ptr::create(random.get_int(232) - 116, (index * 5 / 8) - 80, font_item,
+                                                          0));
+            }
+
+            for(int update = 0; update < 8; ++update)
+            {
+                for(btn::sprite_ptr& sprite : sprites)
+                {
+                    btn::fixed y = sprite.y() + 3;
+                    sprite.set_y(y < 80 ? y : y - 160);
+                }
+
+                frame();
+                BTN_ASSERT(btn::sprites::multiplexing(), "Sprites are not multiplexed");
+
+                // Bands with more new sprites than rewrites drop them:
+                int rewrites_count = 0;
+
+                for(int band = 0; band < btn::sprites::multiplexer_bands_count(); ++band)
+                {
+                    int band_rewrites_count = btn::sprites::multiplexer_band_rewrites_count(band);
+                    BTN_ASSERT(btn::sprites::multiplexer_band_used_count(band) <= btn::hw::sprites::count(),
+                               "Invalid band used count: ", btn::sprites::multiplexer_band_used_count(band));
+                    BTN_ASSERT(band_rewrites_count <= BTN_CFG_SPRITES_MULTIPLEXER_MAX_BAND_REWRITES,
+                               "Invalid band rewrites count: ", band_rewrites_count);
+                    rewrites_count += band_rewrites_count;
+                }
+
+                BTN_ASSERT(btn::hw::sprites::count() + rewrites_count + btn::sprites::multiplexer_dropped_count() ==
+                           sprites.size(), "Invalid dropped count: ", btn::sprites::multiplexer_dropped_count());
+            }
+
+            sprites.clear();
+            frame();
+            BTN_ASSERT(! btn::sprites::multiplexing(), "Sprites are still multiplexed");
+        });
+
+        btn::sprites::set_multiplexer_enabled(false);
+
+        // Sprites rotating at a few different angles share their affine mats:
+        btn::sprite_affine_mats::set_sharing_enabled(true);
+
+        run("sprite rotation shared affine mats", 128 * 8, []
+        {
+            constexpr const int angles_count = 16;
+
+            btn::vector<btn::sprite_ptr, 128> sprites;
+            random_generator random;
+
+            for(int index = 0; index < 128; ++index)
+            {
+                sprites.push_back(btn::sprite_ptr::create(random.get_int(240) - 120, random.get_int(160) - 80,
+                                                          font_item, 0));
+            }
+
+            for(int update = 0; update < 8; ++update)
+            {
+                for(int index = 0; index < 128; ++index)
+                {
+                    int angle_index = (index + update) % angles_count;
+                    sprites[index].set_rotation_angle(angle_index * (btn::fixed(360) / angles_count));
+                }
+
+                BTN_ASSERT(btn::sprite_affine_mats::used_count() < angles_count,
+                           "Invalid used affine mats count: ", btn::sprite_affine_mats::used_count());
+
+                frame();
+            }
+
+            sprites.clear();
+            frame();
+            BTN_ASSERT(btn::sprite_affine_mats::used_count() == 0,
+                       "Invalid used affine mats count: ", btn::sprite_affine_mats::used_count());
+        });
+
+        btn::sprite_affine_mats::set_sharing_enabled(false);
+
+        run("sprite_text_generator generate", 4 * 30, []
+        {
+            btn::sprite_text_generator text_generator(font);
+            btn::vector<btn::sprite_ptr, 32> text_sprites;
+
+            for(int index = 0; index < 4; ++index)
+            {
+                text_generator.generate(-100, -60 + (index * 16), "The quick brown fox jumps over", text_sprites);
+            }
+
+            text_sprites.clear();
+            frame();
+        });
+    }
+
+    void decompression_benchmarks()
+    {
+        constexpr const int tiles_count = 256;
+        constexpr const int bytes = tiles_count * int(sizeof(btn::tile));
+
+        static std::vector<uint8_t> raw_data = synthetic_tiles_data(tiles_count);
+        static std::vector<uint8_t> lz77_data = bios_compressors::lz77(raw_data);
+        static std::vector<uint8_t> run_length_data = bios_compressors::run_length(raw_data);
+        static std::vector<uint8_t> huffman_data = bios_compressors::huffman_4(raw_data);
+        static uint16_t destination[bytes / 2];
+
+        struct compressed_data
+        {
+            const char* name;
+            const std::vector<uint8_t>* data;
+            btn::compression_type compression;
+        };
+
+        const compressed_data compressed_datas[] = {
+            { "decompress lz77", &lz77_data, btn::compression_type::LZ77 },
+            { "decompress run_length", &run_length_data, btn::compression_type::RUN_LENGTH },
+            { "decompress huffman", &huffman_data, btn::compression_type::HUFFMAN },
+        };
+
+        for(const compressed_data& data : compressed_datas)
+        {
+            std::printf("# %s ratio: %d%%\n", data.name, int((data.data->size() * 100) / raw_data.size()));
+
+            btn::decompressor decompressor;
+            decompressor.start(data.data->data(), data.compression, destination);
+            decompressor.decompress_all();
+            BTN_ASSERT(! std::memcmp(destination, raw_data.data(), bytes), "Decompressed data mismatch: ", data.name);
+        }
+
+        run("copy raw tiles", bytes, []
+        {
+            std::memcpy(destination, raw_data.data(), bytes);
+            sink = destination[0];
+        });
+
+        for(const compressed_data& data : compressed_datas)
+        {
+            run(data.name, bytes, [&data]
+            {
+                btn::decompressor decompressor;
+                decompressor.start(data.data->data(), data.compression, destination);
+                decompressor.decompress_all();
+                sink = destination[0];
+            });
+        }
+
+        // Compressed tiles which don't fit in the VRAM commits budget are decompressed over multiple frames:
+        static std::vector<uint8_t> first_half_data = bios_compressors::lz77(
+                    std::vector<uint8_t>(raw_data.begin(), raw_data.begin() + (bytes / 2)));
+        static std::vector<uint8_t> second_half_data = bios_compressors::lz77(
+                    std::vector<uint8_t>(raw_data.begin() + (bytes / 2), raw_data.end()));
+        constexpr const int half_tiles_count = tiles_count / 2;
+        int old_max_bytes_per_frame = btn::vram_commits_manager::max_bytes_per_frame();
+        btn::vram_commits_manager::set_max_bytes_per_frame(1024);
+
+        run("sprite_tiles_ptr streamed lz77", bytes / 2, []
+        {
+            btn::sprite_tiles_item first_item(btn::span<const btn::tile>(
+                    reinterpret_cast<const btn::tile*>(first_half_data.data()), half_tiles_count), 1,
+                    btn::compression_type::LZ77);
+            btn::sprite_tiles_item second_item(btn::span<const btn::tile>(
+                    reinterpret_cast<const btn::tile*>(second_half_data.data()), half_tiles_count), 1,
+                    btn::compression_type::LZ77);
+            btn::sprite_tiles_ptr tiles = btn::sprite_tiles_ptr::create(first_item);
+            frame();
+
+            tiles.set_tiles_ref(second_item);
+
+            // Tiles are decompressed in a staging buffer, so the displayed ones are never partially uploaded:
+            for(int index = 0; index < ((bytes / 2) / 1024) * 2; ++index)
+            {
+                const btn::tile* vram = btn::hw::sprite_tiles::vram(tiles.id());
+                BTN_ASSERT(! std::memcmp(vram, raw_data.data(), bytes / 2) ||
+                           ! std::memcmp(vram, raw_data.data() + (bytes / 2), bytes / 2),
+                           "Streamed data partially uploaded");
+                frame();
+            }
+
+            BTN_ASSERT(! std::memcmp(btn::hw::sprite_tiles::vram(tiles.id()), raw_data.data() + (bytes / 2),
+                                     bytes / 2), "Streamed data mismatch");
+        });
+
+        btn::vram_commits_manager::set_max_bytes_per_frame(old_max_bytes_per_frame);
+    }
+
+    // Releasing every other item fragments VRAM, so big items can't be created until the used ones are moved:
+    void vram_compaction_benchmarks()
+    {
+        constexpr const int tile_sets_count = 120;
+        constexpr const int tile_set_tiles_count = 8;
+        constexpr const int big_tile_set_tiles_count = 128;
+        static std::vector<uint8_t> tiles_data = synthetic_tiles_data(tile_sets_count * tile_set_tiles_count);
+
+        run("sprite_tiles compaction", tile_sets_count / 2, []
+        {
+            const btn::tile* tiles_ptr = reinterpret_cast<const btn::tile*>(tiles_data.data());
+            btn::vector<btn::sprite_tiles_ptr, tile_sets_count> tiles;
+
+            for(int index = 0; index < tile_sets_count; ++index)
+            {
+                tiles.push_back(btn::sprite_tiles_ptr::create(
+                                    btn::span<const btn::tile>(tiles_ptr + (index * tile_set_tiles_count),
+                                                               tile_set_tiles_count)));
+            }
+
+            frame();
+
+            btn::vector<btn::sprite_tiles_ptr, tile_sets_count> used_tiles;
+
+            for(int index = 1; index < tile_sets_count; index += 2)
+            {
+                used_tiles.push_back(btn::move(tiles[index]));
+            }
+
+            tiles.clear();
+
+            btn::sprite_ptr sprite = btn::sprite_ptr::create(
+                        0, 0, btn::sprite_shape_size(btn::sprite_shape::WIDE, btn::sprite_size::BIG),
+                        used_tiles.back(), font_item.palette_item().create_palette());
+
+            BTN_ASSERT(! btn::sprite_tiles_ptr::create_optional(btn::span<const btn::tile>(
+                           tiles_ptr + 1, big_tile_set_tiles_count)), "Sprite tiles are not fragmented");
+
+            for(int index = 0; index < 16 && btn::sprite_tiles::fragmentation() != 0; ++index)
+            {
+                frame();
+            }
+
+            // Sprites are updated one frame after their tiles have been moved:
+            frame();
+
+            BTN_ASSERT(btn::sprite_tiles::fragmentation() == 0, "Sprite tiles are still fragmented: ",
+                       btn::sprite_tiles::fragmentation());
+
+            for(int index = 0, limit = used_tiles.size(); index < limit; ++index)
+            {
+                int source_tile_index = ((index * 2) + 1) * tile_set_tiles_count;
+                BTN_ASSERT(! std::memcmp(btn::hw::sprite_tiles::vram(used_tiles[index].id()),
+                                         tiles_ptr + source_tile_index, tile_set_tiles_count * sizeof(btn::tile)),
+                           "Moved sprite tiles mismatch: ", index);
+            }
+
+            auto oam = reinterpret_cast<const btn::hw::sprites::handle_type*>(MEM_OAM);
+            BTN_ASSERT(btn::hw::sprites::tiles_id(oam[*btn::sprites_manager::hw_id(const_cast<void*>(sprite.handle()))]) ==
+                       used_tiles.back().id(), "Sprite tiles id not updated");
+
+            BTN_ASSERT(btn::sprite_tiles_ptr::create_optional(btn::span<const btn::tile>(
+                           tiles_ptr + 1, big_tile_set_tiles_count)), "Sprite tiles are still fragmented");
+            frame();
+        });
+
+        constexpr const int maps_count = 10;
+        constexpr const int map_cells_count = 32 * 32;
+        static std::vector<btn::regular_bg_map_cell> map_cells(maps_count * map_cells_count);
+
+        for(int index = 0, limit = int(map_cells.size()); index < limit; ++index)
+        {
+            map_cells[index] = btn::regular_bg_map_cell((index * 7) % 64);
+        }
+
+        run("bg_blocks compaction", maps_count / 2, []
+        {
+            const btn::tile* tiles_ptr = reinterpret_cast<const btn::tile*>(tiles_data.data());
+            btn::bg_tiles_ptr tiles = btn::bg_tiles_ptr::create(btn::span<const btn::tile>(tiles_ptr, 64));
+            static const btn::color colors[16] = {};
+            btn::bg_palette_ptr palette = btn::bg_palette_ptr::create(colors, btn::palette_bpp_mode::BPP_4);
+            btn::vector<btn::regular_bg_map_ptr, maps_count> maps;
+
+            for(int index = 0; index < maps_count; ++index)
+            {
+                maps.push_back(btn::regular_bg_map_ptr::create(map_cells[index * map_cells_count],
+                                                                   btn::size(32, 32), tiles, palette));
+            }
+
+            frame();
+
+            btn::vector<btn::regular_bg_map_ptr, maps_count> used_maps;
+            btn::vector<std::vector<uint16_t>, maps_count> used_maps_vram;
+
+            for(int index = 1; index < maps_count; index += 2)
+            {
+                const uint16_t* vram = btn::hw::bg_blocks::vram(maps[index].id());
+                used_maps_vram.push_back(std::vector<uint16_t>(vram, vram + map_cells_count));
+                used_maps.push_back(btn::move(maps[index]));
+            }
+
+            maps.clear();
+            frame();
+
+            BTN_ASSERT(btn::bg_tiles::fragmentation() != 0, "BG blocks are not fragmented");
+
+            for(int index = 0; index < 16 && btn::bg_tiles::fragmentation() != 0; ++index)
+            {
+                frame();
+            }
+
+            frame();
+
+            BTN_ASSERT(btn::bg_tiles::fragmentation() == 0, "BG blocks are still fragmented: ",
+                       btn::bg_tiles::fragmentation());
+
+            for(int index = 0, limit = used_maps.size(); index < limit; ++index)
+            {
+                BTN_ASSERT(! std::memcmp(btn::hw::bg_blocks::vram(used_maps[index].id()),
+                                         used_maps_vram[index].data(), map_cells_count * sizeof(uint16_t)),
+                           "Moved map cells mismatch: ", index);
+            }
+
+            used_maps.clear();
+            frame();
+        });
+    }
+
+    void palette_effects_benchmarks()
+    {
+        constexpr const int colors_count = 512;
+
+        static btn::color source_colors[colors_count];
+        static btn::color fused_colors[colors_count];
+        static btn::color passes_colors[colors_count];
+        random_generator random;
+
+        for(btn::color& source_color : source_colors)
+        {
+            source_color = btn::color(int(random.get() & 0x7FFF));
+        }
+
+        struct effects_combination
+        {
+            const char* name;
+            int brightness;
+            int contrast;
+            int intensity;
+            bool inverted;
+            int grayscale_intensity;
+            int fade_intensity;
+        };
+
+        static const effects_combination combinations[] = {
+            { "brightness", 64, 0, 0, false, 0, 0 },
+            { "contrast", 0, -96, 0, false, 0, 0 },
+            { "intensity", 0, 0, 48, false, 0, 0 },
+            { "inversion", 0, 0, 0, true, 0, 0 },
+            { "grayscale", 0, 0, 0, false, 16, 0 },
+            { "fade", 0, 0, 0, false, 0, 20 },
+            { "adjustments", 64, -96, 48, false, 0, 0 },
+            { "all", 64, -96, 48, true, 16, 20 },
+        };
+
+        static const effects_combination* combination;
+        static constexpr const btn::color fade_color(31, 8, 0);
+
+        // Same order as palettes_bank global effects:
+        auto apply_fused = []
+        {
+            btn::palette_effects effects;
+
+            if(combination->brightness)
+            {
+                effects.add_brightness(combination->brightness);
+            }
+
+            if(combination->contrast)
+            {
+                effects.add_contrast(combination->contrast);
+            }
+
+            if(combination->intensity)
+            {
+                effects.add_intensity(combination->intensity);
+            }
+
+            if(combination->inverted)
+            {
+                effects.add_inversion();
+            }
+
+            if(combination->grayscale_intensity)
+            {
+                effects.add_grayscale(combination->grayscale_intensity);
+            }
+
+            if(combination->fade_intensity)
+            {
+                effects.add_fade(fade_color, combination->fade_intensity);
+            }
+
+            effects.apply(source_colors, colors_count, fused_colors);
+            sink = fused_colors[0].data();
+        };
+
+        // One tonc function call per effect, as palettes were updated before fusing the effects:
+        auto apply_passes = []
+        {
+            auto colors = reinterpret_cast<COLOR*>(passes_colors);
+            std::memcpy(passes_colors, source_colors, sizeof(source_colors));
+
+            if(combination->brightness)
+            {
+                clr_adj_brightness(colors, colors, colors_count, combination->brightness);
+            }
+
+            if(combination->contrast)
+            {
+                clr_adj_contrast(colors, colors, colors_count, combination->contrast);
+            }
+
+            if(combination->intensity)
+            {
+                clr_adj_intensity(colors, colors, colors_count, combination->intensity);
+            }
+
+            if(combination->inverted)
+            {
+                for(int index = 0; index < colors_count; ++index)
+                {
+                    colors[index] = COLOR(32767 ^ colors[index]);
+                }
+            }
+
+            if(combination->grayscale_intensity)
+            {
+                COLOR gray_colors[colors_count];
+                clr_grayscale(gray_colors, colors, colors_count);
+                clr_blend_fast(colors, gray_colors, colors, colors_count, unsigned(combination->grayscale_intensity));
+            }
+
+            if(combination->fade_intensity)
+            {
+                clr_fade_fast(colors, COLOR(fade_color.data()), colors, colors_count,
+                              unsigned(combination->fade_intensity));
+            }
+
+            sink = passes_colors[0].data();
+        };
+
+        for(const effects_combination& current_combination : combinations)
+        {
+            combination = &current_combination;
+            apply_fused();
+            apply_passes();
+            BTN_ASSERT(! std::memcmp(fused_colors, passes_colors, sizeof(fused_colors)),
+                       "Fused palette effects mismatch: ", current_combination.name);
+
+            std::string fused_name = std::string("palette effects fused ") + current_combination.name;
+            std::string passes_name = std::string("palette effects passes ") + current_combination.name;
+            run(fused_name.c_str(), colors_count, apply_fused);
+            run(passes_name.c_str(), colors_count, apply_passes);
+        }
+    }
+
+    void sprite_text_benchmarks()
+    {
+        constexpr const int graphics_count = btn::sprite_font::minimum_graphics;
+
+        // Synthetic fonts in which each character has different pixels:
+        static btn::tile glyph_tiles[graphics_count * 2];
+        static int8_t glyph_widths[graphics_count + 1];
+
+        for(int tile_index = 0; tile_index < graphics_count * 2; ++tile_index)
+        {
+            for(int row = 0; row < 8; ++row)
+            {
+                glyph_tiles[tile_index].data[row] = (unsigned(tile_index + 1) * 0x01234567U) ^ unsigned(row * 0x11111111);
+            }
+        }
+
+        for(int index = 0; index <= graphics_count; ++index)
+        {
+            glyph_widths[index] = int8_t(3 + (index % 6));
+        }
+
+        static const btn::color glyph_colors[16] = {};
+        static const btn::sprite_item fixed_8x8_item(
+                btn::sprite_shape_size(btn::sprite_shape::SQUARE, btn::sprite_size::SMALL),
+                btn::span<const btn::tile>(glyph_tiles, graphics_count), glyph_colors, btn::palette_bpp_mode::BPP_4,
+                graphics_count);
+        static const btn::sprite_item variable_8x16_item(
+                btn::sprite_shape_size(btn::sprite_shape::TALL, btn::sprite_size::SMALL), glyph_tiles, glyph_colors,
+                btn::palette_bpp_mode::BPP_4, graphics_count);
+        static const btn::sprite_font fixed_8x8_font(fixed_8x8_item, btn::span<const btn::string_view>());
+        static const btn::sprite_font variable_8x16_font(variable_8x16_item, btn::span<const btn::string_view>(),
+                                                         glyph_widths);
+
+        // In place updates must show the same pixels as generating the text again:
+        auto check = [](btn::sprite_text_generator& text_generator)
+        {
+            static const char* const texts[] = {
+                "SCORE 000000", "SCORE 000001", "SCORE 000019", "SCORE 100019", "LIVES 3", "", "A\tB C",
+                "The quick brown fox jumps over", "The quick brown fox", "Xhe quick brown fox"
+            };
+
+            btn::sprite_text<32, 64> text(text_generator, btn::fixed_point(-60, 20));
+
+            for(const char* current_text : texts)
+            {
+                text.set_text(current_text);
+
+                btn::vector<btn::sprite_ptr, 32> expected_sprites;
+                text_generator.generate(text.position(), current_text, expected_sprites);
+                BTN_ASSERT(text.sprites().size() == expected_sprites.size(), "Invalid sprites count: ",
+                           text.sprites().size(), " - ", expected_sprites.size(), " (", current_text, ")");
+
+                for(int index = 0; index < expected_sprites.size(); ++index)
+                {
+                    const btn::sprite_ptr& sprite = text.sprites()[index];
+                    const btn::sprite_ptr& expected_sprite = expected_sprites[index];
+                    BTN_ASSERT(sprite.position() == expected_sprite.position(), "Invalid position: ", current_text);
+
+                    if(text_generator.one_sprite_per_character())
+                    {
+                        BTN_ASSERT(sprite.tiles() == expected_sprite.tiles(), "Invalid tiles: ", current_text);
+                    }
+                    else
+                    {
+                        btn::sprite_tiles_ptr tiles = sprite.tiles();
+                        btn::sprite_tiles_ptr expected_tiles = expected_sprite.tiles();
+                        btn::span<btn::tile> tiles_vram = *tiles.vram();
+                        btn::span<btn::tile> expected_tiles_vram = *expected_tiles.vram();
+                        BTN_ASSERT(! std::memcmp(tiles_vram.data(), expected_tiles_vram.data(),
+                                                 size_t(tiles_vram.size()) * sizeof(btn::tile)),
+                                   "Invalid tiles: ", current_text);
+                    }
+                }
+            }
+        };
+
+        btn::sprite_text_generator fixed_text_generator(fixed_8x8_font);
+        btn::sprite_text_generator variable_text_generator(variable_8x16_font);
+        variable_text_generator.set_center_alignment();
+        check(fixed_text_generator);
+        check(variable_text_generator);
+        variable_text_generator.set_one_sprite_per_character(true);
+        check(variable_text_generator);
+        variable_text_generator.set_one_sprite_per_character(false);
+        frame();
+
+        // Scoreboard in which only the last digit changes in each frame:
+        constexpr const int updates = 60;
+
+        auto score_text = [](int score)
+        {
+            static char text[16];
+            std::snprintf(text, sizeof(text), "SCORE %06d", score);
+            return text;
+        };
+
+        run("sprite_text generate scoreboard", updates, [&variable_text_generator, &score_text]
+        {
+            btn::vector<btn::sprite_ptr, 8> text_sprites;
+
+            for(int score = 0; score < updates; ++score)
+            {
+                text_sprites.clear();
+                variable_text_generator.generate(0, 0, score_text(score), text_sprites);
+                frame();
+            }
+        });
+
+        run("sprite_text set_text scoreboard", updates, [&variable_text_generator, &score_text]
+        {
+            btn::sprite_text<8> text(variable_text_generator, btn::fixed_point());
+
+            for(int score = 0; score < updates; ++score)
+            {
+                text.set_text(score_text(score));
+                frame();
+            }
+        });
+    }
+    void collision_benchmarks()
+    {
+        // Bullets moving each frame against enemies:
+        constexpr const int bullets_count = 256;
+        constexpr const int enemies_count = 32;
+        constexpr const int updates = 16;
+
+        static btn::fixed_rect bullets[bullets_count];
+        static btn::fixed_point bullet_speeds[bullets_count];
+        static btn::fixed_rect enemies[enemies_count];
+        random_generator generator;
+
+        for(int index = 0; index < bullets_count; ++index)
+        {
+            bullets[index] = btn::fixed_rect(generator.get_int(240) - 120, generator.get_int(160) - 80, 4, 4);
+            bullet_speeds[index] = btn::fixed_point(btn::fixed::from_data(generator.get_int(4096) - 2048),
+                                                    btn::fixed::from_data(generator.get_int(4096) - 2048));
+        }
+
+        for(btn::fixed_rect& enemy : enemies)
+        {
+            enemy = btn::fixed_rect(generator.get_int(240) - 120, generator.get_int(160) - 80, 16, 16);
+        }
+
+        auto move_bullets = []
+        {
+            for(int index = 0; index < bullets_count; ++index)
+            {
+                btn::fixed_rect& bullet = bullets[index];
+                bullet.set_position(bullet.position() + bullet_speeds[index]);
+            }
+        };
+
+        auto linear_pairs_count = []
+        {
+            int result = 0;
+
+            for(const btn::fixed_rect& bullet : bullets)
+            {
+                for(const btn::fixed_rect& enemy : enemies)
+                {
+                    result += bullet.intersects(enemy);
+                }
+            }
+
+            return result;
+        };
+
+        using bullets_grid_type = btn::collision_grid<bullets_count, 16, 16, 16>;
+        using enemies_grid_type = btn::collision_grid<enemies_count, 16, 16, 16>;
+        static bullets_grid_type bullets_grid;
+        static enemies_grid_type enemies_grid;
+        static btn::vector<btn::pair<int, int>, bullets_count * 4> pairs;
+
+        auto fill_grids = []
+        {
+            bullets_grid.clear();
+            enemies_grid.clear();
+
+            // Ids are the indexes of the rects, since the grids have been cleared:
+            for(int index = 0; index < bullets_count; ++index)
+            {
+                [[maybe_unused]] int id = bullets_grid.add(bullets[index]);
+                BTN_ASSERT(id == index, "Invalid bullet id: ", id, " - ", index);
+            }
+
+            for(int index = 0; index < enemies_count; ++index)
+            {
+                [[maybe_unused]] int id = enemies_grid.add(enemies[index]);
+                BTN_ASSERT(id == index, "Invalid enemy id: ", id, " - ", index);
+            }
+        };
+
+        auto grid_pairs_count = []
+        {
+            for(int index = 0; index < bullets_count; ++index)
+            {
+                bullets_grid.set_rect(index, bullets[index]);
+            }
+
+            pairs.clear();
+            BTN_ASSERT(enemies_grid.intersecting_pairs(bullets_grid, pairs), "Too many pairs");
+            return pairs.size();
+        };
+
+        // Both algorithms must find the same pairs:
+        fill_grids();
+
+        for(int update = 0; update < updates; ++update)
+        {
+            move_bullets();
+
+            int expected_pairs_count = linear_pairs_count();
+            int pairs_count = grid_pairs_count();
+            BTN_ASSERT(pairs_count == expected_pairs_count, "Invalid pairs count: ", pairs_count, " - ",
+                       expected_pairs_count);
+
+            for(const btn::pair<int, int>& pair : pairs)
+            {
+                BTN_ASSERT(enemies[pair.first].intersects(bullets[pair.second]), "Invalid pair");
+            }
+        }
+
+        run("collisions linear scan", bullets_count * updates, [&move_bullets, &linear_pairs_count]
+        {
+            for(int update = 0; update < updates; ++update)
+            {
+                move_bullets();
+                sink = linear_pairs_count();
+            }
+        });
+
+        fill_grids();
+        run("collisions collision_grid", bullets_count * updates, [&move_bullets, &grid_pairs_count]
+        {
+            for(int update = 0; update < updates; ++update)
+            {
+                move_bullets();
+                sink = grid_pairs_count();
+            }
+        });
+    }
+
+    void audio_stream_benchmarks()
+    {
+        constexpr const int blocks_count = 64;
+        constexpr const int samples_count = blocks_count * btn::adpcm_decoder::samples_per_block();
+        constexpr const int mixing_rate = 15768;
+        constexpr const int frame_samples = 264;
+
+        // Random IMA-ADPCM blocks:
+        static uint8_t blocks[blocks_count * btn::adpcm_decoder::block_bytes()];
+        random_generator generator;
+
+        for(int block_index = 0; block_index < blocks_count; ++block_index)
+        {
+            uint8_t* block = blocks + (block_index * btn::adpcm_decoder::block_bytes());
+
+            for(int byte_index = 0; byte_index < btn::adpcm_decoder::block_bytes(); ++byte_index)
+            {
+                block[byte_index] = uint8_t(generator.get());
+            }
+
+            block[2] = uint8_t(generator.get_int(89));
+            block[3] = 0;
+        }
+
+        // Straightforward IMA-ADPCM decoder:
+        static int16_t expected_samples[samples_count];
+
+        for(int block_index = 0; block_index < blocks_count; ++block_index)
+        {
+            const int steps[] = {
+                7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80,
+                88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598,
+                658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+                3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+                16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+            };
+            const int indexes[] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+            const uint8_t* block = blocks + (block_index * btn::adpcm_decoder::block_bytes());
+            int16_t* output = expected_samples + (block_index * btn::adpcm_decoder::samples_per_block());
+            int predictor = int16_t(block[0] | (block[1] << 8));
+            int step_index = block[2];
+            output[0] = int16_t(predictor);
+
+            for(int sample_index = 1; sample_index < btn::adpcm_decoder::samples_per_block(); ++sample_index)
+            {
+                int byte = block[4 + ((sample_index - 1) / 2)];
+                int code = (sample_index & 1) ? byte & 0xF : byte >> 4;
+                int step = steps[step_index];
+                int difference = (step >> 3) + ((code & 4) ? step : 0) + ((code & 2) ? step >> 1 : 0) +
+                        ((code & 1) ? step >> 2 : 0);
+                predictor = btn::clamp((code & 8) ? predictor - difference : predictor + difference, -32768, 32767);
+                step_index = btn::clamp(step_index + indexes[code], 0, 88);
+                output[sample_index] = int16_t(predictor);
+            }
+        }
+
+        // Resumable decoding must match it no matter the chunk size:
+        static int16_t samples[samples_count];
+        btn::adpcm_decoder decoder;
+        decoder.start(blocks, blocks_count, false);
+
+        for(int decoded_samples = 0, chunk = 1; decoded_samples < samples_count; chunk = (chunk * 3) % 700 + 1)
+        {
+            decoded_samples += decoder.decode(chunk, samples + decoded_samples);
+        }
+
+        BTN_ASSERT(decoder.done(), "Decoder is not done");
+        BTN_ASSERT(! decoder.decode(1, samples), "Decoder is not done");
+        BTN_ASSERT(! std::memcmp(samples, expected_samples, sizeof(samples)), "Decoded samples mismatch");
+
+        // Mixing a stream with the same sample rate as the mixing rate adds its samples:
+        static int8_t left_samples[frame_samples];
+        static int8_t right_samples[frame_samples];
+        btn::audio_stream_item item(blocks, blocks_count, mixing_rate);
+        btn::audio_stream_mixer mixer;
+        mixer.play(item, mixing_rate, 256, false);
+
+        for(int sample_index = 0; sample_index < samples_count; sample_index += frame_samples)
+        {
+            std::memset(left_samples, 0, sizeof(left_samples));
+            std::memset(right_samples, 0, sizeof(right_samples));
+            mixer.mix(frame_samples, left_samples, right_samples);
+
+            for(int index = 0; index < frame_samples && sample_index + index < samples_count; ++index)
+            {
+                int expected_sample = expected_samples[sample_index + index] >> 8;
+                BTN_ASSERT(left_samples[index] == expected_sample && right_samples[index] == expected_sample,
+                           "Mixed samples mismatch: ", sample_index + index);
+            }
+        }
+
+        mixer.mix(frame_samples, left_samples, right_samples);
+        BTN_ASSERT(! mixer.playing(), "Mixer is still playing");
+
+        run("adpcm_decoder decode", samples_count, [&decoder]
+        {
+            decoder.start(blocks, blocks_count, false);
+            sink = decoder.decode(samples_count, samples);
+        });
+
+        // 22050 Hz stream mixed at 16 KHz, one frame per iteration:
+        btn::audio_stream_item looped_item(blocks, blocks_count, 22050);
+        mixer.play(looped_item, mixing_rate, 128, true);
+
+        run("audio_stream_mixer mix", frame_samples, [&mixer]
+        {
+            mixer.mix(frame_samples, left_samples, right_samples);
+            sink = left_samples[0];
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    for(int index = 1; index < argc; ++index)
+    {
+        if(! std::strcmp(argv[index], "--csv"))
+        {
+            csv_output = true;
+        }
+        else
+        {
+            name_filter = argv[index];
+        }
+    }
+
+    btn::display_manager::init();
+    btn::memory_manager::init();
+    btn::cameras_manager::init();
+    btn::sprite_tiles_manager::init();
+    btn::sprites_manager::init();
+    btn::bg_blocks_manager::init();
+
+    if(csv_output)
+    {
+        std::printf("name,operations,best_ns,ns_per_operation\n");
+    }
+    else
+    {
+        std::printf("%-36s %10s %14s %12s\n", "benchmark", "ops", "best ns", "ns/op");
+    }
+
+    container_benchmarks();
+    math_benchmarks();
+    division_benchmarks();
+    memory_benchmarks();
+    sprite_benchmarks();
+    vram_compaction_benchmarks();
+    decompression_benchmarks();
+    palette_effects_benchmarks();
+    sprite_text_benchmarks();
+    collision_benchmarks();
+    audio_stream_benchmarks();
+    return 0;
+}
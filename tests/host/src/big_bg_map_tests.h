@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BIG_BG_MAP_TESTS_H
+#define BIG_BG_MAP_TESTS_H
+
+// Host only tests: the 32x32 hardware map of big regular BG maps is compared with the source map cells.
+
+#include <vector>
+
+#include "btn_size.h"
+#include "btn_color.h"
+#include "btn_display.h"
+#include "btn_optional.h"
+#include "btn_bg_tiles_ptr.h"
+#include "btn_bg_palette_ptr.h"
+#include "btn_regular_bg_ptr.h"
+#include "btn_regular_bg_map_ptr.h"
+#include "btn_regular_bg_builder.h"
+#include "btn_bgs_manager.h"
+#include "btn_display_manager.h"
+#include "btn_cameras_manager.h"
+#include "btn_palettes_manager.h"
+#include "btn_bg_blocks_manager.h"
+#include "btn_vram_commits_manager.h"
+#include "../hw/include/btn_hw_bg_blocks.h"
+#include "tests.h"
+
+class big_bg_map_tests : public tests
+{
+
+public:
+    big_bg_map_tests() :
+        tests("big_bg_map")
+    {
+        // Map sizes which aren't multiples of 32:
+        const btn::size map_sizes[] = {
+            btn::size(40, 37),
+            btn::size(33, 70),
+            btn::size(100, 32),
+            btn::size(64, 96),
+        };
+
+        for(const btn::size& map_size : map_sizes)
+        {
+            std::vector<btn::regular_bg_map_cell> cells = _cells(map_size);
+            _test_hw_rows_and_columns(cells, map_size);
+            _test_scroll(cells, map_size);
+
+            // Released BG blocks are removed in the next update, before the map cells are destroyed:
+            _frame();
+        }
+    }
+
+private:
+    static constexpr const int hw_size = btn::hw::bg_blocks::big_map_hw_size();
+
+    [[nodiscard]] static std::vector<btn::regular_bg_map_cell> _cells(const btn::size& map_size)
+    {
+        int cells_count = map_size.width() * map_size.height();
+        std::vector<btn::regular_bg_map_cell> result(cells_count);
+
+        for(int index = 0; index < cells_count; ++index)
+        {
+            result[index] = btn::regular_bg_map_cell(((index * 37) + (index >> 5)) & 0x0FFF);
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] static int _wrap(int value, int size)
+    {
+        int result = value % size;
+        return result < 0 ? result + size : result;
+    }
+
+    // Checks that each hardware cell holds the source cell of the 32x32 window whose top-left map cell is (x, y):
+    static void _check_window(const std::vector<btn::regular_bg_map_cell>& cells, const btn::size& map_size,
+                              int x, int y, int cells_offset, int block_index)
+    {
+        const uint16_t* vram = btn::hw::bg_blocks::vram(block_index);
+
+        for(int map_y = y; map_y < y + hw_size; ++map_y)
+        {
+            for(int map_x = x; map_x < x + hw_size; ++map_x)
+            {
+                int source_index = (_wrap(map_y, map_size.height()) * map_size.width()) +
+                        _wrap(map_x, map_size.width());
+                int expected = uint16_t(cells[source_index] + cells_offset);
+                int hw_cell = vram[(_wrap(map_y, hw_size) * hw_size) + _wrap(map_x, hw_size)];
+                BTN_ASSERT(hw_cell == expected, "Invalid hw cell: ", map_size.width(), " - ", map_size.height(),
+                           " - ", x, " - ", y, " - ", map_x, " - ", map_y, " - ", hw_cell, " - ", expected);
+            }
+        }
+    }
+
+    static void _test_hw_rows_and_columns(const std::vector<btn::regular_bg_map_cell>& cells,
+                                          const btn::size& map_size)
+    {
+        constexpr const int block_index = 0;
+        constexpr const int tiles_offset = 3;
+        constexpr const int palette_offset = 5;
+        constexpr const int cells_offset = tiles_offset + (palette_offset << 12);
+
+        const int positions[][2] = {
+            { 0, 0 }, { 7, 9 }, { -1, -1 }, { -33, -70 }, { -1000, 517 }, { map_size.width() - 1, -hw_size },
+            { 3 * map_size.width(), 5 * map_size.height() + 31 },
+        };
+
+        const uint16_t* data_ptr = cells.data();
+        int width = map_size.width();
+        int height = map_size.height();
+
+        for(const auto& position : positions)
+        {
+            int x = position[0];
+            int y = position[1];
+
+            for(int row = y; row < y + hw_size; ++row)
+            {
+                btn::hw::bg_blocks::commit_big_map_row(data_ptr, width, height, x, row, tiles_offset,
+                                                       palette_offset, block_index);
+            }
+
+            _check_window(cells, map_size, x, y, cells_offset, block_index);
+
+            for(int column = x; column < x + hw_size; ++column)
+            {
+                btn::hw::bg_blocks::commit_big_map_column(data_ptr, width, height, column, y, tiles_offset,
+                                                          palette_offset, block_index);
+            }
+
+            _check_window(cells, map_size, x, y, cells_offset, block_index);
+        }
+    }
+
+    static void _test_scroll(const std::vector<btn::regular_bg_map_cell>& cells, const btn::size& map_size)
+    {
+        static const btn::tile tiles_data[16] = {};
+        static const btn::color colors[16] = {};
+        btn::bg_tiles_ptr tiles = btn::bg_tiles_ptr::create(tiles_data);
+        btn::bg_palette_ptr palette = btn::bg_palette_ptr::create(colors, btn::palette_bpp_mode::BPP_4);
+        btn::regular_bg_map_ptr map = btn::regular_bg_map_ptr::create(cells[0], map_size, tiles, palette);
+        BTN_ASSERT(map.big(), "Map is not big: ", map_size.width(), " - ", map_size.height());
+
+        int tiles_offset = (tiles.id() % btn::hw::bg_blocks::tiles_alignment_blocks_count()) *
+                btn::hw::bg_blocks::half_words_per_block() / 16;
+        int cells_offset = tiles_offset + (palette.id() << 12);
+        btn::regular_bg_ptr bg = btn::regular_bg_ptr::create(btn::regular_bg_builder(map));
+
+        // Scrolled by less than a cell, by one cell and by whole rows or columns, then moved by 32 or more cells:
+        const int moves[][2] = {
+            { 0, 0 }, { 1, 0 }, { 7, 3 }, { 8, 8 }, { -8, -16 }, { -5, 0 }, { 0, -13 }, { 31 * 8, 0 },
+            { 0, 31 * 8 }, { -32 * 8, 0 }, { 0, 32 * 8 }, { 33 * 8, -45 * 8 }, { -1000, 1000 },
+            { 3, -3 }, { -8, 8 }, { 16, 16 },
+        };
+
+        int x = 0;
+        int y = 0;
+
+        for(const auto& move : moves)
+        {
+            x += move[0];
+            y += move[1];
+            bg.set_position(x, y);
+            _frame();
+            _check_bg(cells, map_size, bg, cells_offset, map.id());
+        }
+
+        // Scrolled one pixel at a time across the map edges in both directions:
+        for(int step = 0; step < map_size.width() * 8 + 20; ++step)
+        {
+            bg.set_position(--x, ++y);
+            _frame();
+            _check_bg(cells, map_size, bg, cells_offset, map.id());
+        }
+
+        for(int step = 0; step < map_size.height() * 8 + 20; ++step)
+        {
+            x += 9;
+            bg.set_position(x, --y);
+            _frame();
+            _check_bg(cells, map_size, bg, cells_offset, map.id());
+        }
+    }
+
+    // The bgs manager sets the hardware position of a regular BG so it is centered in the screen:
+    static void _check_bg(const std::vector<btn::regular_bg_map_cell>& cells, const btn::size& map_size,
+                          const btn::regular_bg_ptr& bg, int cells_offset, int block_index)
+    {
+        int x = bg.x().right_shift_integer();
+        int y = bg.y().right_shift_integer();
+        int hw_x = -x - (btn::display::width() / 2) + (map_size.width() * 4);
+        int hw_y = -y - (btn::display::height() / 2) + (map_size.height() * 4);
+        int map_x = hw_x >> 3;
+        int map_y = hw_y >> 3;
+        const BG_POINT& hw_position = REG_BG_OFS[*btn::bgs_manager::hw_id(const_cast<void*>(bg.handle()))];
+        BTN_ASSERT(_wrap(hw_position.x >> 3, hw_size) == _wrap(map_x, hw_size), "Invalid hw x: ", x, " - ", hw_position.x);
+        BTN_ASSERT(_wrap(hw_position.y >> 3, hw_size) == _wrap(map_y, hw_size), "Invalid hw y: ", y, " - ", hw_position.y);
+
+        _check_window(cells, map_size, map_x, map_y, cells_offset, block_index);
+    }
+
+    static void _frame()
+    {
+        btn::cameras_manager::update();
+        btn::bgs_manager::update();
+        btn::bg_blocks_manager::update();
+        btn::palettes_manager::update();
+        btn::display_manager::update();
+
+        btn::vram_commits_manager::start();
+        btn::display_manager::commit();
+        btn::bgs_manager::commit();
+        btn::palettes_manager::commit();
+        btn::bg_blocks_manager::commit();
+    }
+};
+
+#endif
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BIOS_COMPRESSORS_H
+#define BIOS_COMPRESSORS_H
+
+// Simple GBA BIOS compatible compressors, used to generate the data decompressed by the benchmarks.
+// They don't try to give the best compression ratio like grit does, only valid data.
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace bios_compressors
+{
+    inline std::vector<uint8_t> header(int type, int size)
+    {
+        return { uint8_t(type), uint8_t(size), uint8_t(size >> 8), uint8_t(size >> 16) };
+    }
+
+    inline void align(std::vector<uint8_t>& output)
+    {
+        while(output.size() % 4)
+        {
+            output.push_back(0);
+        }
+    }
+
+    inline std::vector<uint8_t> lz77(const std::vector<uint8_t>& input)
+    {
+        int size = int(input.size());
+        std::vector<uint8_t> output = header(0x10, size);
+
+        int position = 0;
+
+        while(position < size)
+        {
+            std::size_t flags_index = output.size();
+            output.push_back(0);
+
+            for(int block = 0; block < 8 && position < size; ++block)
+            {
+                int best_length = 0;
+                int best_displacement = 0;
+
+                for(int displacement = 1; displacement <= std::min(position, 4096); ++displacement)
+                {
+                    int length = 0;
+
+                    while(length < 18 && position + length < size &&
+                          input[std::size_t(position + length - displacement)] ==
+                          input[std::size_t(position + length)])
+                    {
+                        ++length;
+                    }
+
+                    if(length > best_length)
+                    {
+                        best_length = length;
+                        best_displacement = displacement;
+                    }
+                }
+
+                if(best_length >= 3)
+                {
+                    int value = best_displacement - 1;
+                    output[flags_index] |= uint8_t(0x80 >> block);
+                    output.push_back(uint8_t(((best_length - 3) << 4) | (value >> 8)));
+                    output.push_back(uint8_t(value));
+                    position += best_length;
+                }
+                else
+                {
+                    output.push_back(input[std::size_t(position)]);
+                    ++position;
+                }
+            }
+        }
+
+        align(output);
+        return output;
+    }
+
+    inline std::vector<uint8_t> run_length(const std::vector<uint8_t>& input)
+    {
+        int size = int(input.size());
+        std::vector<uint8_t> output = header(0x30, size);
+
+        int position = 0;
+
+        while(position < size)
+        {
+            int run = 1;
+
+            while(run < 130 && position + run < size && input[std::size_t(position + run)] ==
+                  input[std::size_t(position)])
+            {
+                ++run;
+            }
+
+            if(run >= 3)
+            {
+                output.push_back(uint8_t(0x80 | (run - 3)));
+                output.push_back(input[std::size_t(position)]);
+                position += run;
+            }
+            else
+            {
+                int raw_begin = position;
+
+                while(position < size && position - raw_begin < 128 &&
+                      (position + 2 >= size || input[std::size_t(position)] != input[std::size_t(position + 1)] ||
+                       input[std::size_t(position)] != input[std::size_t(position + 2)]))
+                {
+                    ++position;
+                }
+
+                output.push_back(uint8_t(position - raw_begin - 1));
+                output.insert(output.end(), input.begin() + raw_begin, input.begin() + position);
+            }
+        }
+
+        align(output);
+        return output;
+    }
+
+    // 4 bits Huffman: with 16 symbols at most, the children offsets of a breadth first tree always fit in 6 bits.
+    inline std::vector<uint8_t> huffman_4(const std::vector<uint8_t>& input)
+    {
+        struct node
+        {
+            int weight;
+            int children[2];
+            int symbol;
+        };
+
+        std::vector<node> nodes;
+        int frequencies[16] = {};
+
+        for(uint8_t byte : input)
+        {
+            ++frequencies[byte & 0xF];
+            ++frequencies[byte >> 4];
+        }
+
+        std::vector<int> roots;
+
+        for(int symbol = 0; symbol < 16; ++symbol)
+        {
+            if(frequencies[symbol])
+            {
+                roots.push_back(int(nodes.size()));
+                nodes.push_back(node{ frequencies[symbol], { -1, -1 }, symbol });
+            }
+        }
+
+        // Trees need at least two leaves:
+        for(int symbol = 0; roots.size() < 2; ++symbol)
+        {
+            if(! frequencies[symbol])
+            {
+                roots.push_back(int(nodes.size()));
+                nodes.push_back(node{ 0, { -1, -1 }, symbol });
+            }
+        }
+
+        while(roots.size() > 1)
+        {
+            std::sort(roots.begin(), roots.end(), [&](int a, int b) { return nodes[std::size_t(a)].weight >
+                                                                             nodes[std::size_t(b)].weight; });
+            int a = roots.back();
+            roots.pop_back();
+
+            int b = roots.back();
+            roots.pop_back();
+            roots.push_back(int(nodes.size()));
+            nodes.push_back(node{ nodes[std::size_t(a)].weight + nodes[std::size_t(b)].weight, { a, b }, -1 });
+        }
+
+        // Codes:
+        std::vector<std::vector<int>> codes(16);
+        std::vector<std::pair<int, std::vector<int>>> pending = { { roots[0], {} } };
+
+        while(! pending.empty())
+        {
+            auto [node_index, code] = pending.back();
+            pending.pop_back();
+
+            const node& current = nodes[std::size_t(node_index)];
+
+            if(current.symbol >= 0)
+            {
+                codes[std::size_t(current.symbol)] = code;
+            }
+            else
+            {
+                for(int bit = 0; bit < 2; ++bit)
+                {
+                    std::vector<int> child_code = code;
+                    child_code.push_back(bit);
+                    pending.push_back({ current.children[bit], child_code });
+                }
+            }
+        }
+
+        // Breadth first tree: children pairs are stored in the same order as their parents:
+        std::vector<int> order = { roots[0] };
+        std::vector<uint8_t> tree = { 0 };
+
+        for(std::size_t index = 0; index < order.size(); ++index)
+        {
+            const node& current = nodes[std::size_t(order[index])];
+
+            if(current.symbol < 0)
+            {
+                order.push_back(current.children[0]);
+                order.push_back(current.children[1]);
+            }
+        }
+
+        std::vector<int> positions(nodes.size());
+        positions[std::size_t(order[0])] = 1;
+
+        for(std::size_t index = 1; index < order.size(); ++index)
+        {
+            positions[std::size_t(order[index])] = int(index) + 1;
+        }
+
+        for(int node_index : order)
+        {
+            const node& current = nodes[std::size_t(node_index)];
+
+            if(current.symbol >= 0)
+            {
+                tree.push_back(uint8_t(current.symbol));
+            }
+            else
+            {
+                int position = positions[std::size_t(node_index)];
+                int child_position = positions[std::size_t(current.children[0])];
+                int value = (child_position - (position & ~1) - 2) / 2;
+
+                if(nodes[std::size_t(current.children[0])].symbol >= 0)
+                {
+                    value |= 0x80;
+                }
+
+                if(nodes[std::size_t(current.children[1])].symbol >= 0)
+                {
+                    value |= 0x40;
+                }
+
+                tree.push_back(uint8_t(value));
+            }
+        }
+
+        while(tree.size() % 4)
+        {
+            tree.push_back(0);
+        }
+
+        tree[0] = uint8_t((tree.size() / 2) - 1);
+
+        std::vector<uint8_t> output = header(0x24, int(input.size()));
+        output.reserve(output.size() + tree.size() + input.size());
+
+        for(uint8_t tree_byte : tree)
+        {
+            output.push_back(tree_byte);
+        }
+
+        uint32_t word = 0;
+        int word_bits = 0;
+
+        auto write_symbol = [&](int symbol)
+        {
+            for(int bit : codes[std::size_t(symbol)])
+            {
+                word = (word << 1) | uint32_t(bit);
+                ++word_bits;
+
+                if(word_bits == 32)
+                {
+                    for(int shift = 0; shift < 32; shift += 8)
+                    {
+                        output.push_back(uint8_t(word >> shift));
+                    }
+
+                    word = 0;
+                    word_bits = 0;
+                }
+            }
+        };
+
+        for(uint8_t byte : input)
+        {
+            write_symbol(byte & 0xF);
+            write_symbol(byte >> 4);
+        }
+
+        if(word_bits)
+        {
+            word <<= 32 - word_bits;
+
+            for(int shift = 0; shift < 32; shift += 8)
+            {
+                output.push_back(uint8_t(word >> shift));
+            }
+        }
+
+        return output;
+    }
+}
+
+#endif
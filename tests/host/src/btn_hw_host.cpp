@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+// Stub hardware layer for host builds.
+//
+// Only the hardware functions needed by the hardware independent parts of the engine are provided (allocation,
+// sorting, text layout...). GBA I/O registers, palettes, VRAM and OAM are mapped to host memory, so writing to them
+// doesn't crash, but they are not emulated.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+#include "btn_array.h"
+#include "btn_string_view.h"
+#include "btn_hw_log.h"
+#include "btn_hw_text.h"
+#include "btn_hw_tonc.h"
+#include "btn_hw_memory.h"
+
+namespace
+{
+    alignas(8) char ewram_heap[240 * 1024];
+
+    [[gnu::constructor(101)]] void map_gba_memory()
+    {
+        // From I/O registers (0x04000000) to OAM (0x07000000):
+        void* address = reinterpret_cast<void*>(0x04000000);
+        std::size_t bytes = 0x04000000;
+
+        if(mmap(address, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) !=
+                address)
+        {
+            std::perror("GBA memory map failed");
+            std::abort();
+        }
+    }
+
+    template<typename Type>
+    [[nodiscard]] int parse_impl(const char* format, Type value, btn::array<char, 32>& output)
+    {
+        return std::snprintf(output.data(), std::size_t(output.size()), format, value);
+    }
+
+    [[nodiscard]] unsigned blend_color(unsigned a, unsigned b, unsigned alpha)
+    {
+        constexpr const unsigned rb_mask = 0x7C1F;
+        constexpr const unsigned g_mask = 0x03E0;
+
+        unsigned rb = ((((b & rb_mask) - (a & rb_mask)) * alpha) + ((a & rb_mask) * 32) + 0x4010) / 32;
+        unsigned g = ((((b & g_mask) - (a & g_mask)) * alpha) + ((a & g_mask) * 32) + 0x0200) / 32;
+        return (rb & rb_mask) | (g & g_mask);
+    }
+
+    [[nodiscard]] unsigned clamp_channel(int value)
+    {
+        return unsigned(value < 0 ? 0 : value > 31 ? 31 : value);
+    }
+
+    [[nodiscard]] unsigned rgb(int red, int green, int blue)
+    {
+        return clamp_channel(red) | (clamp_channel(green) << 5) | (clamp_channel(blue) << 10);
+    }
+}
+
+namespace _btn::assert
+{
+    void show(const char* condition, const char* file_name, const char* function, int line, const char* message)
+    {
+        std::fflush(stdout);
+        std::fprintf(stderr, "ASSERT FAILED: %s\n%s:%d (%s)\n%s\n", condition, file_name, line, function, message);
+        std::abort();
+    }
+
+    void show(const char* condition, const char* file_name, const char* function, int line,
+              const btn::istring_base& message)
+    {
+        btn::string_view message_view = message;
+        std::fflush(stdout);
+        std::fprintf(stderr, "ASSERT FAILED: %s\n%s:%d (%s)\n%.*s\n", condition, file_name, line, function,
+                     message_view.size(), message_view.data());
+        std::abort();
+    }
+}
+
+namespace btn::hw
+{
+    #if BTN_CFG_LOG_ENABLED
+        void log(const istring_base& message)
+        {
+            std::printf("%.*s\n", message.size(), message.data());
+        }
+    #endif
+}
+
+namespace btn::hw::memory
+{
+    int used_static_iwram()
+    {
+        return 0;
+    }
+
+    int used_static_ewram()
+    {
+        return 0;
+    }
+
+    char* ewram_heap_start()
+    {
+        return ewram_heap;
+    }
+
+    char* ewram_heap_end()
+    {
+        return ewram_heap + sizeof(ewram_heap);
+    }
+}
+
+namespace btn::hw::text
+{
+    int parse(int value, array<char, 32>& output)
+    {
+        return parse_impl("%d", value, output);
+    }
+
+    int parse(long value, array<char, 32>& output)
+    {
+        return parse_impl("%ld", value, output);
+    }
+
+    int parse(long long value, array<char, 32>& output)
+    {
+        return parse_impl("%lld", value, output);
+    }
+
+    int parse(unsigned value, array<char, 32>& output)
+    {
+        return parse_impl("%u", value, output);
+    }
+
+    int parse(unsigned long value, array<char, 32>& output)
+    {
+        return parse_impl("%lu", value, output);
+    }
+
+    int parse(unsigned long long value, array<char, 32>& output)
+    {
+        return parse_impl("%llu", value, output);
+    }
+
+    int parse(const void* ptr, array<char, 32>& output)
+    {
+        return parse_impl("%p", ptr, output);
+    }
+}
+
+// libtonc and gba-modern functions implemented in assembler or with GBA specific code:
+
+extern "C"
+{
+    // Interrupts are never raised by themselves: host tests call the enabled handlers of __isr_table instead
+    // (handlers are stored in the index of their interrupt, and enabled interrupts are flagged in REG_IE):
+    IRQ_REC __isr_table[II_MAX + 1];
+
+    void irq_init(fnptr)
+    {
+        std::memset(__isr_table, 0, sizeof(__isr_table));
+        REG_IE = 0;
+    }
+
+    fnptr irq_add(eIrqIndex irq_id, fnptr isr)
+    {
+        IRQ_REC& record = __isr_table[irq_id];
+        fnptr old_isr = record.isr;
+        record.flag = 1u << irq_id;
+        record.isr = isr;
+        return old_isr;
+    }
+
+    fnptr irq_delete(eIrqIndex irq_id)
+    {
+        return irq_add(irq_id, nullptr);
+    }
+
+    void irq_enable(eIrqIndex irq_id)
+    {
+        REG_IE = uint16_t(REG_IE | (1u << irq_id));
+    }
+
+    void irq_disable(eIrqIndex irq_id)
+    {
+        REG_IE = uint16_t(REG_IE & ~(1u << irq_id));
+    }
+
+    const u8 oam_sizes[3][4][2] =
+    {
+        { { 8, 8}, {16,16}, {32,32}, {64,64} },
+        { {16, 8}, {32, 8}, {32,16}, {64,32} },
+        { { 8,16}, { 8,32}, {16,32}, {32,64} },
+    };
+
+    void memcpy16(void* dst, const void* src, uint hwcount)
+    {
+        std::memmove(dst, src, hwcount * 2);
+    }
+
+    void memcpy32(void* dst, const void* src, uint wcount)
+    {
+        std::memmove(dst, src, wcount * 4);
+    }
+
+    void memset16(void* dst, u16 hw, uint hwcount)
+    {
+        auto dst_ptr = static_cast<u16*>(dst);
+
+        for(uint index = 0; index < hwcount; ++index)
+        {
+            dst_ptr[index] = hw;
+        }
+    }
+
+    void memset32(void* dst, u32 wd, uint wcount)
+    {
+        auto dst_ptr = static_cast<u32*>(dst);
+
+        for(uint index = 0; index < wcount; ++index)
+        {
+            dst_ptr[index] = wd;
+        }
+    }
+
+    u32 isqrt32(u32 x)
+    {
+        u32 result = 0;
+        u32 bit = 1U << 30;
+
+        while(bit > x)
+        {
+            bit >>= 2;
+        }
+
+        while(bit)
+        {
+            if(x >= result + bit)
+            {
+                x -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+
+            bit >>= 2;
+        }
+
+        return result;
+    }
+
+    void clr_rotate(COLOR* clrs, uint nclrs, int ror)
+    {
+        if(nclrs)
+        {
+            int count = int(nclrs);
+            int shift = ((ror % count) + count) % count;
+            COLOR temp[256];
+            std::memcpy(temp, clrs, nclrs * sizeof(COLOR));
+
+            for(int index = 0; index < count; ++index)
+            {
+                clrs[(index + shift) % count] = temp[index];
+            }
+        }
+    }
+
+    void clr_grayscale(COLOR* dst, const COLOR* src, uint nclrs)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            unsigned color = src[index];
+            unsigned gray = (((color & 31) * 0x4C) + (((color >> 5) & 31) * 0x96) + (((color >> 10) & 31) * 0x1E) +
+                             0x80) >> 8;
+            dst[index] = COLOR(gray | (gray << 5) | (gray << 10));
+        }
+    }
+
+    void clr_blend_fast(COLOR* srca, COLOR* srcb, COLOR* dst, uint nclrs, u32 alpha)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            dst[index] = COLOR(blend_color(srca[index], srcb[index], alpha));
+        }
+    }
+
+    void clr_fade_fast(COLOR* src, COLOR clr, COLOR* dst, uint nclrs, u32 alpha)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            dst[index] = COLOR(blend_color(src[index], clr, alpha));
+        }
+    }
+
+    void clr_adj_brightness(COLOR* dst, const COLOR* src, uint nclrs, FIXED bright)
+    {
+        bright >>= 3;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int color = src[index];
+            dst[index] = COLOR(rgb((color & 31) + bright, ((color >> 5) & 31) + bright, ((color >> 10) & 31) + bright));
+        }
+    }
+
+    void clr_adj_contrast(COLOR* dst, const COLOR* src, uint nclrs, FIXED contrast)
+    {
+        int ca = contrast + 256;
+        int cb = (-contrast >> 1) * 32;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int color = src[index];
+            dst[index] = COLOR(rgb(((ca * (color & 31)) + cb) >> 8, ((ca * ((color >> 5) & 31)) + cb) >> 8,
+                                   ((ca * ((color >> 10) & 31)) + cb) >> 8));
+        }
+    }
+
+    void clr_adj_intensity(COLOR* dst, const COLOR* src, uint nclrs, FIXED intensity)
+    {
+        int ia = intensity + 256;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int color = src[index];
+            dst[index] = COLOR(rgb((ia * (color & 31)) >> 8, (ia * ((color >> 5) & 31)) >> 8,
+                                   (ia * ((color >> 10) & 31)) >> 8));
+        }
+    }
+}
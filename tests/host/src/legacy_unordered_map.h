@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef LEGACY_UNORDERED_MAP_H
+#define LEGACY_UNORDERED_MAP_H
+
+// Previous btn::unordered_map implementation (linear probing with an allocated flag per index, keys hashed again
+// when an element is erased), used by the benchmarks to compare it with the current one.
+// Only the operations used by the benchmarks are provided.
+
+#include <new>
+#include "btn_utility.h"
+#include "btn_algorithm.h"
+#include "btn_functional.h"
+
+template<typename Key, typename Value, int MaxSize>
+class legacy_unordered_map
+{
+
+public:
+    using value_type = btn::pair<const Key, Value>;
+
+    legacy_unordered_map() = default;
+
+    legacy_unordered_map(const legacy_unordered_map& other) = delete;
+
+    legacy_unordered_map& operator=(const legacy_unordered_map& other) = delete;
+
+    ~legacy_unordered_map()
+    {
+        clear();
+    }
+
+    [[nodiscard]] value_type* find(const Key& key)
+    {
+        if(! _size)
+        {
+            return nullptr;
+        }
+
+        value_type* storage = _storage();
+        int index = _index(btn::hash<Key>()(key));
+        int its = 0;
+
+        while(its < MaxSize && _allocated[index])
+        {
+            if(key == storage[index].first)
+            {
+                return storage + index;
+            }
+
+            index = _index(index + 1);
+            ++its;
+        }
+
+        return nullptr;
+    }
+
+    bool insert(const Key& key, const Value& value)
+    {
+        value_type* storage = _storage();
+        int index = _index(btn::hash<Key>()(key));
+        int current_index = index;
+
+        while(_allocated[current_index])
+        {
+            if(key == storage[current_index].first)
+            {
+                return false;
+            }
+
+            current_index = _index(current_index + 1);
+            BTN_ASSERT(current_index != index, "All indices are allocated");
+        }
+
+        ::new(storage + current_index) value_type(key, value);
+        _allocated[current_index] = true;
+        _first_valid_index = btn::min(_first_valid_index, current_index);
+        _last_valid_index = btn::max(_last_valid_index, current_index);
+        ++_size;
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        value_type* storage = _storage();
+        value_type* value = find(key);
+
+        if(! value)
+        {
+            return false;
+        }
+
+        int index = int(value - storage);
+        bool* allocated = _allocated;
+        storage[index].~value_type();
+        allocated[index] = false;
+        --_size;
+
+        if(_size == 0)
+        {
+            _first_valid_index = MaxSize;
+            _last_valid_index = 0;
+            return true;
+        }
+
+        btn::hash<Key> hasher_functor;
+        int current_index = index;
+        int next_index = _index(index + 1);
+
+        // Elements of the same cluster which can't be reached anymore are moved back to the erased position:
+        while(allocated[next_index])
+        {
+            int next_home_index = _index(hasher_functor(storage[next_index].first));
+            bool reachable = current_index <= next_index ?
+                        current_index < next_home_index && next_home_index <= next_index :
+                        current_index < next_home_index || next_home_index <= next_index;
+
+            if(! reachable)
+            {
+                ::new(storage + current_index) value_type(btn::move(storage[next_index]));
+                storage[next_index].~value_type();
+                allocated[current_index] = true;
+                allocated[next_index] = false;
+                current_index = next_index;
+            }
+
+            next_index = _index(next_index + 1);
+        }
+
+        while(! allocated[_first_valid_index])
+        {
+            ++_first_valid_index;
+        }
+
+        while(! allocated[_last_valid_index])
+        {
+            --_last_valid_index;
+        }
+
+        return true;
+    }
+
+    void clear()
+    {
+        value_type* storage = _storage();
+
+        for(int index = _first_valid_index; index <= _last_valid_index; ++index)
+        {
+            if(_allocated[index])
+            {
+                storage[index].~value_type();
+                _allocated[index] = false;
+            }
+        }
+
+        _first_valid_index = MaxSize;
+        _last_valid_index = 0;
+        _size = 0;
+    }
+
+private:
+    alignas(value_type) char _storage_buffer[sizeof(value_type) * MaxSize];
+    bool _allocated[MaxSize] = {};
+    int _first_valid_index = MaxSize;
+    int _last_valid_index = 0;
+    int _size = 0;
+
+    [[nodiscard]] value_type* _storage()
+    {
+        return reinterpret_cast<value_type*>(_storage_buffer);
+    }
+
+    [[nodiscard]] static int _index(unsigned key_hash)
+    {
+        return int(key_hash & (MaxSize - 1));
+    }
+};
+
+#endif
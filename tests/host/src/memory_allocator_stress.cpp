@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+// Compares the EWRAM allocator against the previous one (a best-fit allocator with its free blocks sorted by size
+// in a vector) with random allocations and deallocations, checking that allocated memory is not corrupted.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "btn_list.h"
+#include "btn_vector.h"
+#include "btn_memory_allocator.h"
+
+#include "btn_memory_allocator.cpp.h"
+
+namespace
+{
+    constexpr const int heap_size = 240 * 1024;
+    constexpr const int max_live_items = 512;
+    constexpr const int operations_count = 2000000;
+
+    alignas(16) char heap[heap_size];
+
+
+    template<int MaxItems>
+    class legacy_allocator
+    {
+
+    public:
+        void init(void* start, int bytes)
+        {
+            item_type new_item;
+            new_item.data = static_cast<char*>(start);
+            new_item.size = bytes;
+            _items.push_front(new_item);
+            _free_items.push_back(_items.begin());
+            _total_bytes_count = bytes;
+            _free_bytes_count = bytes;
+        }
+
+        [[nodiscard]] void* alloc(int bytes)
+        {
+            int alignment_bytes = sizeof(items_iterator);
+
+            if(int extra_bytes = bytes % alignment_bytes)
+            {
+                bytes += alignment_bytes - extra_bytes;
+            }
+
+            bytes += sizeof(items_iterator);
+
+            if(bytes > _free_bytes_count)
+            {
+                return nullptr;
+            }
+
+            auto free_items_end = _free_items.end();
+            auto free_items_it = btn::lower_bound(_free_items.begin(), free_items_end, bytes,
+                                                  lower_bound_comparator);
+
+            if(free_items_it == free_items_end)
+            {
+                return nullptr;
+            }
+
+            items_iterator items_it = *free_items_it;
+            item_type& item = *items_it;
+
+            if(int new_item_size = item.size - bytes)
+            {
+                if(_items.full())
+                {
+                    return nullptr;
+                }
+
+                item_type new_item;
+                new_item.data = item.data;
+                new_item.size = new_item_size;
+
+                items_iterator new_items_it = _items.insert(items_it, new_item);
+                _insert_free_item(new_items_it, free_items_it);
+                ++free_items_it;
+                item.data += new_item_size;
+                item.size = bytes;
+            }
+
+            item.used = true;
+            _free_items.erase(free_items_it);
+
+            auto items_it_ptr = reinterpret_cast<items_iterator*>(item.data);
+            *items_it_ptr = items_it;
+            _free_bytes_count -= bytes;
+            return items_it_ptr + 1;
+        }
+
+        void free(void* ptr)
+        {
+            if(ptr)
+            {
+                auto items_it_ptr = reinterpret_cast<items_iterator*>(ptr) - 1;
+                items_iterator items_it = *items_it_ptr;
+                item_type& item = *items_it;
+                item.used = false;
+                _free_bytes_count += item.size;
+
+                if(items_it != _items.begin())
+                {
+                    items_iterator previous_items_it = items_it;
+                    --previous_items_it;
+
+                    item_type& previous_item = *previous_items_it;
+
+                    if(! previous_item.used && previous_item.data + previous_item.size == item.data)
+                    {
+                        item.data = previous_item.data;
+                        item.size += previous_item.size;
+                        _erase_free_item(previous_items_it);
+                        _items.erase(previous_items_it);
+                    }
+                }
+
+                items_iterator next_items_it = items_it;
+                ++next_items_it;
+
+                if(next_items_it != _items.end())
+                {
+                    item_type& next_item = *next_items_it;
+
+                    if(! next_item.used && item.data + item.size == next_item.data)
+                    {
+                        item.size += next_item.size;
+                        _erase_free_item(next_items_it);
+                        _items.erase(next_items_it);
+                    }
+                }
+
+                _insert_free_item(items_it, _free_items.end());
+            }
+        }
+
+        [[nodiscard]] int available_bytes() const
+        {
+            return _free_bytes_count;
+        }
+
+        [[nodiscard]] int free_blocks() const
+        {
+            return _free_items.size();
+        }
+
+        [[nodiscard]] int largest_available_bytes() const
+        {
+            return _free_items.empty() ? 0 : _free_items.back()->size - int(sizeof(items_iterator));
+        }
+
+    private:
+        class item_type
+        {
+
+        public:
+            char* data = nullptr;
+            int size: 24 = 0;
+            bool used = false;
+        };
+
+        using items_list = btn::list<item_type, MaxItems>;
+        using items_iterator = typename items_list::iterator;
+
+        static constexpr const auto lower_bound_comparator = [](const items_iterator& items_it, int size)
+        {
+            return items_it->size < size;
+        };
+
+        static constexpr const auto upper_bound_comparator = [](int size, const items_iterator& items_it)
+        {
+            return size < items_it->size;
+        };
+
+        items_list _items;
+        btn::vector<items_iterator, MaxItems> _free_items;
+        int _total_bytes_count = 0;
+        int _free_bytes_count = 0;
+
+        void _insert_free_item(items_iterator items_it, typename btn::ivector<items_iterator>::iterator last)
+        {
+            auto free_items_it = btn::upper_bound(_free_items.begin(), last, items_it->size, upper_bound_comparator);
+            _free_items.insert(free_items_it, items_it);
+        }
+
+        void _erase_free_item(items_iterator items_it)
+        {
+            auto free_items_it = btn::lower_bound(_free_items.begin(), _free_items.end(), items_it->size,
+                                                  lower_bound_comparator);
+
+            while(*free_items_it != items_it)
+            {
+                ++free_items_it;
+            }
+
+            _free_items.erase(free_items_it);
+        }
+    };
+
+
+    class random_generator
+    {
+
+    public:
+        [[nodiscard]] unsigned get()
+        {
+            _state ^= _state << 13;
+            _state ^= _state >> 17;
+            _state ^= _state << 5;
+            return _state;
+        }
+
+        [[nodiscard]] int get_int(int limit)
+        {
+            return int(get() % unsigned(limit));
+        }
+
+    private:
+        unsigned _state = 123456789;
+    };
+
+
+    class live_item
+    {
+
+    public:
+        unsigned char* data = nullptr;
+        int bytes = 0;
+        unsigned char pattern = 0;
+    };
+
+
+    class results
+    {
+
+    public:
+        long long total_ns = 0;
+        long long p999_ns = 0;
+        long long worst_ns = 0;
+        int failed_allocs = 0;
+        int available_bytes = 0;
+        int largest_available_bytes = 0;
+        int free_blocks = 0;
+    };
+
+
+    // 70% of the items are small (up to 64 bytes), 25% are medium (up to 1KB) and 5% are big (up to 8KB):
+    [[nodiscard]] int random_size(random_generator& random, bool small_only)
+    {
+        int kind = small_only ? 0 : random.get_int(100);
+
+        if(kind < 70)
+        {
+            return random.get_int(61);
+        }
+
+        if(kind < 95)
+        {
+            return 64 + random.get_int(1024 - 64);
+        }
+
+        return 1024 + random.get_int(8 * 1024 - 1024);
+    }
+
+    template<class Allocator>
+    [[nodiscard]] results run(Allocator& allocator, bool small_only)
+    {
+        using clock = std::chrono::steady_clock;
+
+        static live_item items[max_live_items];
+        static long long elapsed_ns[operations_count];
+        random_generator random;
+        results result;
+        allocator.init(heap, heap_size);
+
+        for(live_item& item : items)
+        {
+            item = live_item();
+        }
+
+        for(int operation = 0; operation < operations_count; ++operation)
+        {
+            live_item& item = items[random.get_int(max_live_items)];
+
+            if(item.data)
+            {
+                for(int index = 0; index < item.bytes; ++index)
+                {
+                    if(item.data[index] != item.pattern)
+                    {
+                        std::printf("Memory corrupted at operation %d\n", operation);
+                        std::exit(EXIT_FAILURE);
+                    }
+                }
+
+                auto start = clock::now();
+                allocator.free(item.data);
+                elapsed_ns[operation] = std::chrono::nanoseconds(clock::now() - start).count();
+                item.data = nullptr;
+            }
+            else
+            {
+                int bytes = random_size(random, small_only);
+                auto start = clock::now();
+                void* data = allocator.alloc(bytes);
+                elapsed_ns[operation] = std::chrono::nanoseconds(clock::now() - start).count();
+
+                if(data)
+                {
+                    item.data = static_cast<unsigned char*>(data);
+                    item.bytes = bytes;
+                    item.pattern = static_cast<unsigned char>(operation);
+
+                    for(int index = 0; index < bytes; ++index)
+                    {
+                        item.data[index] = item.pattern;
+                    }
+                }
+                else
+                {
+                    ++result.failed_allocs;
+                }
+            }
+        }
+
+        // The worst case is usually an operating system hiccup, so the 99.9th percentile is also reported:
+        for(long long operation_ns : elapsed_ns)
+        {
+            result.total_ns += operation_ns;
+            result.worst_ns = btn::max(result.worst_ns, operation_ns);
+        }
+
+        std::nth_element(elapsed_ns, elapsed_ns + (operations_count * 999 / 1000), elapsed_ns + operations_count);
+        result.p999_ns = elapsed_ns[operations_count * 999 / 1000];
+        result.available_bytes = allocator.available_bytes();
+        result.largest_available_bytes = allocator.largest_available_bytes();
+        result.free_blocks = allocator.free_blocks();
+
+        for(live_item& item : items)
+        {
+            allocator.free(item.data);
+        }
+
+        return result;
+    }
+
+    void print(const char* name, const results& result)
+    {
+        double fragmentation = result.available_bytes ?
+                    1 - (double(result.largest_available_bytes) / result.available_bytes) : 0;
+        std::printf("%-28s %10.1f %10lld %12lld %10d %10d %10d %8.3f\n", name,
+                    double(result.total_ns) / operations_count, result.p999_ns, result.worst_ns, result.failed_allocs,
+                    result.available_bytes, result.free_blocks, fragmentation);
+    }
+}
+
+int main()
+{
+    // The legacy allocator can't handle more than BTN_CFG_MEMORY_MAX_EWRAM_ALLOC_ITEMS items,
+    // so it is tested with a bigger limit:
+    static legacy_allocator<max_live_items * 2> legacy;
+    std::printf("%-28s %10s %10s %12s %10s %10s %10s %8s\n", "allocator", "ns/op", "p99.9 ns", "worst ns", "failed",
+                "available", "free blks", "frag");
+
+    for(int small_only = 0; small_only < 2; ++small_only)
+    {
+        const char* workload = small_only ? " (small)" : " (mixed)";
+        char name[64];
+
+        static btn::memory_allocator allocator;
+        allocator = btn::memory_allocator();
+        std::snprintf(name, sizeof(name), "segregated fit%s", workload);
+        print(name, run(allocator, small_only));
+
+        if(allocator.used_bytes() || allocator.used_items())
+        {
+            std::printf("Memory leaked: %d bytes, %d items\n", allocator.used_bytes(), allocator.used_items());
+            return EXIT_FAILURE;
+        }
+
+        legacy = legacy_allocator<max_live_items * 2>();
+        std::snprintf(name, sizeof(name), "legacy best fit%s", workload);
+        print(name, run(legacy, small_only));
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef SOFTWARE_DIVISION_H
+#define SOFTWARE_DIVISION_H
+
+// C version of the shift and subtract division used by GBA ARM assembly routines like gba-modern's udiv32/sdiv32
+// (https://github.com/JoaoBaptMG/gba-modern/blob/master/source/math/udiv32.s): one step per quotient bit,
+// skipping the leading zero bits of the quotient.
+// Used by the benchmarks to compare it with btn::reciprocal_division, since the GBA has no division instruction.
+
+namespace software_division
+{
+    [[nodiscard]] inline unsigned udiv32(unsigned numerator, unsigned denominator)
+    {
+        if(denominator > numerator)
+        {
+            return 0;
+        }
+
+        int bits = __builtin_clz(denominator) - __builtin_clz(numerator);
+        unsigned shifted_denominator = denominator << bits;
+        unsigned quotient = 0;
+
+        for(int bit = bits; bit >= 0; --bit)
+        {
+            quotient <<= 1;
+
+            if(numerator >= shifted_denominator)
+            {
+                numerator -= shifted_denominator;
+                quotient |= 1;
+            }
+
+            shifted_denominator >>= 1;
+        }
+
+        return quotient;
+    }
+
+    [[nodiscard]] inline int sdiv32(int numerator, int denominator)
+    {
+        unsigned unsigned_numerator = numerator < 0 ? 0u - unsigned(numerator) : unsigned(numerator);
+        unsigned unsigned_denominator = denominator < 0 ? 0u - unsigned(denominator) : unsigned(denominator);
+        unsigned quotient = udiv32(unsigned_numerator, unsigned_denominator);
+        return (numerator < 0) != (denominator < 0) ? int(0u - quotient) : int(quotient);
+    }
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef SPRITES_MULTIPLEXER_TESTS_H
+#define SPRITES_MULTIPLEXER_TESTS_H
+
+// Host only tests: the VCOUNT interrupts of a frame are raised by hand, since interrupts are not emulated.
+
+#include "btn_hw_hblank_effects.h"
+#include "btn_hw_sprites_multiplexer.h"
+#include "tests.h"
+
+class sprites_multiplexer_tests : public tests
+{
+
+public:
+    sprites_multiplexer_tests() :
+        tests("sprites_multiplexer")
+    {
+        namespace hw = btn::hw;
+
+        // H-Blank effects committed with HDMA:
+        static uint16_t first_values[160];
+        static uint16_t second_values[160];
+        static volatile uint16_t first_register;
+        static volatile uint16_t second_register;
+
+        for(int index = 0; index < 160; ++index)
+        {
+            first_values[index] = uint16_t(index + 1);
+            second_values[index] = uint16_t(index + 1000);
+        }
+
+        hw::hblank_effects::entry hdma_entries[] = {
+            { first_values, &first_register },
+            { second_values, &second_register },
+        };
+
+        hw::hblank_effects::init();
+        hw::hblank_effects::commit_hdma_entries(hdma_entries, 2);
+        hw::hblank_effects::enable_hdma();
+
+        // Multiplexed hardware sprites:
+        hw::sprites::handle_type band_entries[2] = {};
+        band_entries[0] = { 10, 11, 12, 5 };
+        band_entries[1] = { 20, 21, 22, 6 };
+
+        hw::sprites_multiplexer::band bands[] = {
+            { band_entries, 1, 40 },
+            { band_entries + 1, 1, 100 },
+        };
+
+        auto oam = reinterpret_cast<volatile hw::sprites::handle_type*>(MEM_OAM);
+
+        for(int frame = 0; frame < 2; ++frame)
+        {
+            first_register = 0;
+            second_register = 0;
+            oam[5].attr0 = 0;
+            oam[6].attr0 = 0;
+
+            for(int channel = 0; channel < 4; ++channel)
+            {
+                REG_DMA[channel].cnt = 0;
+            }
+
+            // Bands are committed at the start of VBlank:
+            hw::sprites_multiplexer::commit(bands, 2);
+            _run_frame();
+
+            BTN_ASSERT(first_register == first_values[0] && second_register == second_values[0],
+                       "HDMA channels not restarted: ", frame);
+            BTN_ASSERT(REG_DMA[0].cnt && REG_DMA[3].cnt, "HDMA channels not started: ", frame);
+            BTN_ASSERT(! REG_DMA[1].cnt && ! REG_DMA[2].cnt, "Audio DMA channels used by HDMA: ", frame);
+            BTN_ASSERT(oam[5].attr0 == 10 && oam[5].attr2 == 12 && oam[6].attr0 == 20 && oam[6].attr2 == 22,
+                       "Hardware sprites not rewritten: ", frame);
+        }
+
+        hw::sprites_multiplexer::stop();
+        hw::hblank_effects::commit_hdma_entries(hdma_entries, 0);
+        hw::hblank_effects::disable_hdma();
+    }
+
+private:
+    // Raises the VCOUNT interrupts from the first VBlank scanline to the last visible one:
+    static void _run_frame()
+    {
+        REG_DISPSTAT = uint16_t(REG_DISPSTAT | DSTAT_IN_HBL);
+
+        for(int scanline = 160; scanline < 228 + 160; ++scanline)
+        {
+            int vcount = scanline % 228;
+            REG_VCOUNT = uint16_t(vcount);
+
+            if((REG_IE & (1u << II_VCOUNT)) && (REG_DISPSTAT & DSTAT_VCT_MASK) >> DSTAT_VCT_SHIFT == unsigned(vcount))
+            {
+                __isr_table[II_VCOUNT].isr();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+// Runs the hardware independent tests of the GBA tests project on the host,
+// plus host only tests of hardware interrupt handlers and of the VRAM contents written by the engine.
+
+#include <cstdio>
+
+#include "btn_config_assert.h"
+#include "btn_memory_manager.h"
+#include "btn_display_manager.h"
+#include "btn_cameras_manager.h"
+#include "btn_bg_blocks_manager.h"
+
+#include "fixed_tests.h"
+#include "math_tests.h"
+#include "sqrt_tests.h"
+#include "any_tests.h"
+#include "malloc_tests.h"
+#include "scheduled_actions_tests.h"
+#include "collision_grid_tests.h"
+#include "unordered_map_tests.h"
+#include "reciprocal_division_tests.h"
+#include "sprites_multiplexer_tests.h"
+#include "big_bg_map_tests.h"
+
+#if ! BTN_CFG_ASSERT_ENABLED
+    static_assert(false, "Enable asserts to run tests");
+#endif
+
+int main()
+{
+    btn::display_manager::init();
+    btn::memory_manager::init();
+    btn::cameras_manager::init();
+    btn::bg_blocks_manager::init();
+
+    fixed_tests();
+    math_tests();
+    sqrt_tests();
+    any_tests();
+    malloc_tests();
+    scheduled_actions_tests();
+    collision_grid_tests();
+    unordered_map_tests();
+    reciprocal_division_tests();
+    sprites_multiplexer_tests();
+    big_bg_map_tests();
+
+    std::printf("All tests passed :D\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef COLLISION_GRID_TESTS_H
+#define COLLISION_GRID_TESTS_H
+
+#include "btn_collision_grid.h"
+#include "tests.h"
+
+class collision_grid_tests : public tests
+{
+
+public:
+    collision_grid_tests() :
+        tests("collision_grid")
+    {
+        using pair = btn::pair<int, int>;
+
+        btn::collision_grid<8, 4, 4, 16> grid;
+        BTN_ASSERT(grid.empty());
+        BTN_ASSERT(grid.cell_size() == 16);
+
+        int a = grid.add(btn::fixed_rect(0, 0, 8, 8));
+        int b = grid.add(btn::fixed_rect(20, 0, 8, 8));
+        BTN_ASSERT(grid.size() == 2);
+        BTN_ASSERT(grid.contains(a));
+        BTN_ASSERT(grid.rect(b) == btn::fixed_rect(20, 0, 8, 8));
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(10, 0, 4, 4)) == -1);
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(5, 0, 4, 4)) == a);
+
+        // Rects which touch their neighbor cells are found:
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(14.5, 0, 4, 4)) == b);
+
+        // Edges don't intersect, like in fixed_rect::intersects:
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(8, 0, 8, 8)) == -1);
+
+        btn::vector<pair, 4> pairs;
+        BTN_ASSERT(grid.intersecting_pairs(pairs));
+        BTN_ASSERT(pairs.empty());
+
+        // Moved rects change of cell:
+        grid.set_rect(b, btn::fixed_rect(4.5, 0, 8, 8));
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(20, 0, 4, 4)) == -1);
+        BTN_ASSERT(grid.intersecting_pairs(pairs));
+        BTN_ASSERT(pairs.size() == 1 && pairs[0] == pair(a, b));
+
+        // Rects outside the grid are stored in its border cells:
+        int c = grid.add(btn::fixed_rect(-500, 300, 4, 4));
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(-501, 301, 4, 4)) == c);
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(-20, 20, 4, 4)) == -1);
+
+        btn::vector<int, 4> ids;
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(2, 0, 2, 2), ids));
+        BTN_ASSERT(ids.size() == 2);
+
+        grid.remove(a);
+        BTN_ASSERT(! grid.contains(a));
+        BTN_ASSERT(grid.size() == 2);
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(0, 0, 2, 2)) == b);
+        BTN_ASSERT(grid.add(btn::fixed_rect(40, 40, 2, 2)) == a);
+
+        // Pairs between grids:
+        btn::collision_grid<4, 4, 4, 16> other_grid;
+        int d = other_grid.add(btn::fixed_rect(40, 41, 2, 2));
+        BTN_ASSERT(other_grid.add(btn::fixed_rect(-40, -40, 2, 2)) >= 0);
+        pairs.clear();
+        BTN_ASSERT(grid.intersecting_pairs(other_grid, pairs));
+        BTN_ASSERT(pairs.size() == 1 && pairs[0] == pair(a, d));
+
+        grid.clear();
+        BTN_ASSERT(grid.empty());
+        BTN_ASSERT(grid.intersecting(btn::fixed_rect(0, 0, 64, 64)) == -1);
+    }
+};
+
+#endif
@@ -17,28 +17,78 @@ public:
     malloc_tests() :
         tests("malloc")
     {
+        // Allocations are word aligned and have a one word header:
+        constexpr const auto alloc_size = [](int bytes)
+        {
+            constexpr const int word_size = sizeof(void*);
+            return (((bytes + word_size - 1) / word_size) + 1) * word_size;
+        };
+
         BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
 
         void* ptr = btn::malloc(4);
         BTN_ASSERT(ptr);
-        BTN_ASSERT(btn::memory::used_alloc_ewram() == 8);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == alloc_size(4));
 
         btn::free(ptr);
         BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
 
         ptr = btn::malloc(0);
         BTN_ASSERT(ptr);
-        BTN_ASSERT(btn::memory::used_alloc_ewram() == 4);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == alloc_size(0));
 
         btn::free(ptr);
         BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
 
         auto integer = new int(123);
         BTN_ASSERT(integer);
-        BTN_ASSERT(btn::memory::used_alloc_ewram() == 8);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == alloc_size(sizeof(int)));
 
         delete integer;
         BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
+
+        ptr = btn::malloc(1024);
+        BTN_ASSERT(ptr);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == alloc_size(1024));
+        BTN_ASSERT(btn::memory::used_items_ewram() == 1);
+
+        btn::free(ptr);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
+        BTN_ASSERT(btn::memory::used_items_ewram() == 0);
+
+        int free_blocks = btn::memory::free_blocks_ewram();
+        void* first_ptr = btn::malloc(1024);
+        void* second_ptr = btn::malloc(1024);
+        void* third_ptr = btn::malloc(1024);
+        BTN_ASSERT(first_ptr && second_ptr && third_ptr);
+
+        btn::free(second_ptr);
+        BTN_ASSERT(btn::memory::free_blocks_ewram() == free_blocks + 1);
+        BTN_ASSERT(btn::memory::fragmentation_ewram() > 0);
+
+        btn::free(first_ptr);
+        btn::free(third_ptr);
+        BTN_ASSERT(btn::memory::free_blocks_ewram() == free_blocks);
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
+
+        void* small_ptrs[64];
+
+        for(void*& small_ptr : small_ptrs)
+        {
+            small_ptr = btn::malloc(12);
+            BTN_ASSERT(small_ptr);
+        }
+
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == 64 * alloc_size(12));
+        BTN_ASSERT(btn::memory::used_pools_ewram() > 0);
+
+        for(void* small_ptr : small_ptrs)
+        {
+            btn::free(small_ptr);
+        }
+
+        BTN_ASSERT(btn::memory::used_alloc_ewram() == 0);
+        BTN_ASSERT(btn::memory::used_items_ewram() == 0);
     }
 };
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef RECIPROCAL_DIVISION_TESTS_H
+#define RECIPROCAL_DIVISION_TESTS_H
+
+#include "btn_reciprocal_division.h"
+#include "tests.h"
+
+class reciprocal_division_tests : public tests
+{
+
+public:
+    reciprocal_division_tests() :
+        tests("reciprocal_division")
+    {
+        constexpr btn::reciprocal_division constexpr_division(7);
+        static_assert(constexpr_division.divide(100) == 14);
+        static_assert(constexpr_division.divide(-100) == -14);
+        static_assert(constexpr_division.divide(btn::fixed(3)) == btn::fixed(3).division(7));
+
+        constexpr btn::fixed_reciprocal_division constexpr_fixed_division(btn::fixed(0.75));
+        static_assert(constexpr_fixed_division.divide(btn::fixed(3)) == btn::fixed(4));
+
+        const int divisors[] = { 1, -1, 2, 3, -3, 7, 10, 64, 255, 1000, 4096, 123456789, 0x7FFFFFFF, -0x7FFFFFFF - 1 };
+        const int values[] = { 0, 1, -1, 5, -5, 99, 4095, -4097, 65536, 1000000, -123456789, 0x7FFFFFFF };
+
+        for(int divisor : divisors)
+        {
+            btn::reciprocal_division division(divisor);
+            btn::fixed_reciprocal_division fixed_division(btn::fixed::from_data(divisor));
+
+            for(int value : values)
+            {
+                int result = division.divide(value);
+                BTN_ASSERT(result == value / divisor, "Invalid division: ", value, " - ", divisor, " - ", result);
+
+                btn::fixed fixed_value = btn::fixed::from_data(value);
+                btn::fixed fixed_result = fixed_division.divide(fixed_value);
+                BTN_ASSERT(fixed_result == fixed_value.safe_division(btn::fixed::from_data(divisor)),
+                           "Invalid fixed division: ", value, " - ", divisor, " - ", fixed_result.data());
+            }
+        }
+
+        _random_tests();
+        _batch_tests();
+    }
+
+private:
+    // Random divisions are compared with the division operator:
+    static void _random_tests()
+    {
+        unsigned random = 12345;
+
+        for(int step = 0; step < 1024; ++step)
+        {
+            random = random * 1664525 + 1013904223;
+
+            int divisor = int(random >> (random % 31));
+
+            if(! divisor)
+            {
+                continue;
+            }
+
+            btn::reciprocal_division division(divisor);
+
+            for(int value_index = 0; value_index < 16; ++value_index)
+            {
+                random = random * 1664525 + 1013904223;
+
+                int value = int(random) >> (random % 32);
+                int result = division.divide(value);
+                BTN_ASSERT(result == value / divisor, "Invalid division: ", value, " - ", divisor, " - ", result);
+            }
+        }
+    }
+
+    static void _batch_tests()
+    {
+        int values[] = { 10, -10, 25, 0, 49 };
+        int results[5];
+        btn::reciprocal_division division(-5);
+        division.divide(values, results);
+        BTN_ASSERT(results[0] == -2 && results[1] == 2 && results[2] == -5 && results[3] == 0 && results[4] == -9);
+
+        btn::fixed fixed_values[] = { btn::fixed(1), btn::fixed(-3), btn::fixed(0.5) };
+        btn::fixed_reciprocal_division fixed_division(btn::fixed(0.5));
+        fixed_division.divide(fixed_values, fixed_values);
+        BTN_ASSERT(fixed_values[0] == 2 && fixed_values[1] == -6 && fixed_values[2] == 1);
+    }
+};
+
+#endif
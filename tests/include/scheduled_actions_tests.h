@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef SCHEDULED_ACTIONS_TESTS_H
+#define SCHEDULED_ACTIONS_TESTS_H
+
+#include "btn_scheduled_actions.h"
+#include "tests.h"
+
+class scheduled_actions_tests_manager
+{
+
+public:
+    static inline int properties[2] = {};
+    static inline int set_calls = 0;
+
+    [[nodiscard]] static int get(int index)
+    {
+        return properties[index];
+    }
+
+    static void set(int property, int& index)
+    {
+        properties[index] = property;
+        ++set_calls;
+    }
+};
+
+
+class scheduled_actions_tests_global_manager
+{
+
+public:
+    static inline int property = 0;
+    static inline int set_calls = 0;
+
+    [[nodiscard]] static int get()
+    {
+        return property;
+    }
+
+    static void set(int new_property)
+    {
+        property = new_property;
+        ++set_calls;
+    }
+};
+
+
+class scheduled_actions_tests_by_action :
+        public btn::by_value_template_action<int, int, scheduled_actions_tests_manager>
+{
+
+public:
+    scheduled_actions_tests_by_action(int index, int delta_property) :
+        by_value_template_action(index, delta_property)
+    {
+    }
+};
+
+
+class scheduled_actions_tests_to_action :
+        public btn::to_value_template_action<int, int, scheduled_actions_tests_manager>
+{
+
+public:
+    scheduled_actions_tests_to_action(int index, int duration_updates, int final_property) :
+        to_value_template_action(index, duration_updates, final_property)
+    {
+    }
+};
+
+
+class scheduled_actions_tests_global_by_action :
+        public btn::by_template_action<int, scheduled_actions_tests_global_manager>
+{
+
+public:
+    explicit scheduled_actions_tests_global_by_action(int delta_property) :
+        by_template_action(delta_property)
+    {
+    }
+};
+
+
+class scheduled_actions_tests : public tests
+{
+
+public:
+    scheduled_actions_tests() :
+        tests("scheduled_actions")
+    {
+        using manager = scheduled_actions_tests_manager;
+        using global_manager = scheduled_actions_tests_global_manager;
+
+        // Writes to the same target are collapsed:
+        btn::scheduled_actions<scheduled_actions_tests_by_action, 4> by_actions;
+        by_actions.emplace(0, 1);
+        by_actions.emplace(1, 10);
+        by_actions.push(scheduled_actions_tests_by_action(0, 2));
+        BTN_ASSERT(by_actions.size() == 3);
+
+        manager::set_calls = 0;
+        by_actions.update();
+        BTN_ASSERT(manager::properties[0] == 3);
+        BTN_ASSERT(manager::properties[1] == 10);
+        BTN_ASSERT(manager::set_calls == 2);
+
+        by_actions.update();
+        BTN_ASSERT(manager::properties[0] == 6);
+        BTN_ASSERT(manager::properties[1] == 20);
+        BTN_ASSERT(manager::set_calls == 4);
+
+        by_actions.erase(by_actions.begin());
+        by_actions.update();
+        BTN_ASSERT(manager::properties[0] == 8);
+        BTN_ASSERT(manager::properties[1] == 30);
+
+        // Done actions are removed:
+        btn::scheduled_actions<scheduled_actions_tests_to_action, 4> to_actions;
+        to_actions.emplace(1, 2, 40);
+        to_actions.update();
+        BTN_ASSERT(manager::properties[1] == 35);
+        BTN_ASSERT(to_actions.size() == 1);
+
+        to_actions.update();
+        BTN_ASSERT(manager::properties[1] == 40);
+        BTN_ASSERT(to_actions.empty());
+
+        // Actions without target write the property once:
+        btn::scheduled_actions<scheduled_actions_tests_global_by_action, 4> global_by_actions;
+        global_by_actions.emplace(1);
+        global_by_actions.emplace(2);
+        global_by_actions.emplace(3);
+
+        global_manager::set_calls = 0;
+        global_by_actions.update();
+        BTN_ASSERT(global_manager::property == 6);
+        BTN_ASSERT(global_manager::set_calls == 1);
+    }
+};
+
+#endif
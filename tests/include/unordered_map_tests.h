@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef UNORDERED_MAP_TESTS_H
+#define UNORDERED_MAP_TESTS_H
+
+#include "btn_unordered_map.h"
+#include "tests.h"
+
+class unordered_map_tests : public tests
+{
+
+public:
+    unordered_map_tests() :
+        tests("unordered_map")
+    {
+        btn::unordered_map<int, int, 8> map;
+        BTN_ASSERT(map.empty());
+        BTN_ASSERT(map.insert(1, 10) != map.end());
+        BTN_ASSERT(map.insert(9, 90) != map.end());
+        BTN_ASSERT(map.insert(1, 11) == map.end());
+        BTN_ASSERT(map.size() == 2);
+        BTN_ASSERT(map.at(1) == 10);
+        BTN_ASSERT(map.at(9) == 90);
+        BTN_ASSERT(! map.contains(17));
+
+        map.insert_or_assign(1, 11);
+        BTN_ASSERT(map.at(1) == 11);
+        BTN_ASSERT(map.erase(1));
+        BTN_ASSERT(! map.erase(1));
+        BTN_ASSERT(map.at(9) == 90);
+
+        // Full maps:
+        for(int index = 0; index < 7; ++index)
+        {
+            map[index * 8] = index;
+        }
+
+        BTN_ASSERT(map.full());
+        BTN_ASSERT(map.at(9) == 90);
+        BTN_ASSERT(map.insert(9, 91) == map.end());
+        BTN_ASSERT(erase_if(map, [](const auto& pair){ return pair.second < 4; }) == 4);
+        BTN_ASSERT(map.size() == 4 && map.at(9) == 90 && map.at(48) == 6);
+
+        _same_hash_tests();
+        _random_tests();
+    }
+
+private:
+    struct same_hash
+    {
+        [[nodiscard]] unsigned operator()(int) const
+        {
+            return 3;
+        }
+    };
+
+    // Keys with the same hash are stored in a long cluster with saturated distances:
+    static void _same_hash_tests()
+    {
+        btn::unordered_map<int, int, 512, same_hash> map;
+
+        for(int key = 0; key < 300; ++key)
+        {
+            BTN_ASSERT(map.insert(key, key * 2) != map.end());
+        }
+
+        for(int key = 0; key < 300; key += 2)
+        {
+            BTN_ASSERT(map.erase(key));
+        }
+
+        for(int key = 0; key < 300; ++key)
+        {
+            auto it = map.find(key);
+            BTN_ASSERT((it != map.end()) == bool(key % 2));
+            BTN_ASSERT(it == map.end() || it->second == key * 2);
+        }
+
+        BTN_ASSERT(map.size() == 150);
+        BTN_ASSERT(erase_if(map, [](const auto& pair){ return pair.first < 200; }) == 100);
+        BTN_ASSERT(map.size() == 50 && map.begin()->first >= 200);
+
+        // Erased elements of full maps are not iterated:
+        btn::unordered_map<int, int, 8, same_hash> full_map;
+
+        for(int key = 0; key < 8; ++key)
+        {
+            full_map.insert(key, key);
+        }
+
+        BTN_ASSERT(erase_if(full_map, [](const auto& pair){ return pair.first % 2; }) == 4);
+        BTN_ASSERT(full_map.size() == 4 && full_map.contains(6) && ! full_map.contains(7));
+    }
+
+    // Insertions and erasures are compared with an array of the inserted keys:
+    static void _random_tests()
+    {
+        btn::unordered_map<int, int, 128> map;
+        bool inserted[256] = {};
+        int inserted_count = 0;
+        unsigned random = 12345;
+
+        for(int step = 0; step < 4096; ++step)
+        {
+            random = random * 1664525 + 1013904223;
+
+            int key = int(random >> 24);
+            bool erase = (random >> 8) & 1;
+
+            if(erase)
+            {
+                BTN_ASSERT(map.erase(key) == inserted[key]);
+                inserted_count -= inserted[key];
+                inserted[key] = false;
+            }
+            else if(inserted_count < 120 || inserted[key])
+            {
+                inserted_count += ! inserted[key];
+                inserted[key] = true;
+                map.insert_or_assign(key, -key);
+            }
+
+            BTN_ASSERT(map.size() == inserted_count);
+        }
+
+        for(int key = 0; key < 256; ++key)
+        {
+            auto it = map.find(key);
+            BTN_ASSERT((it != map.end()) == inserted[key]);
+            BTN_ASSERT(it == map.end() || it->second == -key);
+        }
+
+        int iterated_count = 0;
+
+        for(const auto& pair : map)
+        {
+            BTN_ASSERT(inserted[pair.first]);
+            ++iterated_count;
+        }
+
+        BTN_ASSERT(iterated_count == inserted_count);
+    }
+};
+
+#endif
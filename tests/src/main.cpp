@@ -16,6 +16,10 @@
 #include "sqrt_tests.h"
 #include "any_tests.h"
 #include "malloc_tests.h"
+#include "scheduled_actions_tests.h"
+#include "collision_grid_tests.h"
+#include "unordered_map_tests.h"
+#include "reciprocal_division_tests.h"
 #include "sram_tests.h"
 #include "variable_8x16_sprite_font.h"
 
@@ -39,6 +43,10 @@ int main()
     sqrt_tests();
     any_tests();
     malloc_tests();
+    scheduled_actions_tests();
+    collision_grid_tests();
+    unordered_map_tests();
+    reciprocal_division_tests();
     sram_tests sram_tests;
 
     if(sram_tests.again())